@@ -0,0 +1,178 @@
+#include "ya_event.h"
+
+#include <event2/buffer.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// 解码基准：对比 ya_parse_event（堆分配参数）、ya_parse_event_inline（参数写入事件内联存储）
+// 与 ya_decode_frame（直接在连续内存上解码，不经过 evbuffer）
+// 每种模式解码 BENCH_FRAMES 个 MOUSE_MOVE 帧，输出平均耗时与每个事件的 malloc 次数
+
+#define BENCH_FRAMES 200000
+
+#ifdef YA_BENCH_WRAP_MALLOC
+// 链接时 -Wl,--wrap=malloc 把所有 malloc 调用转到这里
+static size_t g_malloc_calls = 0;
+void *__real_malloc(size_t size);
+void *__wrap_malloc(size_t size)
+{
+    g_malloc_calls++;
+    return __real_malloc(size);
+}
+#endif
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// 生成 count 个连续的 MOUSE_MOVE 帧
+static uint8_t *build_frames(size_t count, size_t *out_len)
+{
+    YACommonEventRequest move = {.lparam = 3, .rparam = -2};
+    YAEvent event = {
+        .header = {.uid = 1, .type = MOUSE_MOVE, .direction = REQUEST, .index = 0},
+        .param = &move,
+        .param_len = sizeof(move),
+    };
+
+    uint8_t *frame = NULL;
+    int frame_len = ya_serialize_event(&event, &frame);
+    if (frame_len <= 0)
+    {
+        return NULL;
+    }
+
+    uint8_t *frames = malloc((size_t)frame_len * count);
+    if (!frames)
+    {
+        free(frame);
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        memcpy(frames + i * frame_len, frame, frame_len);
+    }
+    free(frame);
+
+    *out_len = (size_t)frame_len * count;
+    return frames;
+}
+
+static int run_decode(const char *name, const uint8_t *frames, size_t frames_len, size_t count, bool use_inline)
+{
+    // 预先把所有帧放进一个连续的 chain，计数期间 evbuffer 自身不再分配
+    struct evbuffer *input = evbuffer_new();
+    evbuffer_add(input, frames, frames_len);
+
+    int64_t checksum = 0;
+#ifdef YA_BENCH_WRAP_MALLOC
+    size_t mallocs_before = g_malloc_calls;
+#endif
+    uint64_t start = now_ns();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        YAPackageSize size = {0};
+        ya_get_package_size(input, &size);
+        evbuffer_drain(input, YA_FRAME_PREFIX_SIZE);
+
+        YAEvent event = {0};
+        int rc = use_inline ? ya_parse_event_inline(input, &event, &size) : ya_parse_event(input, &event, &size);
+        if (rc < 0 || !event.param)
+        {
+            fprintf(stderr, "%s: decode failed at frame %zu\n", name, i);
+            evbuffer_free(input);
+            return -1;
+        }
+
+        const YACommonEventRequest *req = event.param;
+        checksum += req->lparam + req->rparam;
+        ya_free_event_param(&event);
+    }
+
+    uint64_t elapsed = now_ns() - start;
+#ifdef YA_BENCH_WRAP_MALLOC
+    size_t mallocs = g_malloc_calls - mallocs_before;
+    printf("%-8s %zu events  %.1f ns/event  %.3f malloc/event  (checksum %lld)\n", name, count,
+           (double)elapsed / count, (double)mallocs / count, (long long)checksum);
+#else
+    printf("%-8s %zu events  %.1f ns/event  malloc/event n/a  (checksum %lld)\n", name, count,
+           (double)elapsed / count, (long long)checksum);
+#endif
+
+    evbuffer_free(input);
+    return 0;
+}
+
+static int run_span(const char *name, const uint8_t *frames, size_t frames_len, size_t count)
+{
+    int64_t checksum = 0;
+#ifdef YA_BENCH_WRAP_MALLOC
+    size_t mallocs_before = g_malloc_calls;
+#endif
+    uint64_t start = now_ns();
+
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        YAEvent event = {0};
+        int consumed = ya_decode_frame(frames + offset, frames_len - offset, &event);
+        if (consumed <= 0 || !event.param)
+        {
+            fprintf(stderr, "%s: decode failed at frame %zu\n", name, i);
+            return -1;
+        }
+        offset += (size_t)consumed;
+
+        const YACommonEventRequest *req = event.param;
+        checksum += req->lparam + req->rparam;
+        ya_free_event_param(&event);
+    }
+
+    uint64_t elapsed = now_ns() - start;
+#ifdef YA_BENCH_WRAP_MALLOC
+    size_t mallocs = g_malloc_calls - mallocs_before;
+    printf("%-8s %zu events  %.1f ns/event  %.3f malloc/event  (checksum %lld)\n", name, count,
+           (double)elapsed / count, (double)mallocs / count, (long long)checksum);
+#else
+    printf("%-8s %zu events  %.1f ns/event  malloc/event n/a  (checksum %lld)\n", name, count,
+           (double)elapsed / count, (long long)checksum);
+#endif
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = BENCH_FRAMES;
+    if (argc > 1)
+    {
+        count = strtoul(argv[1], NULL, 10);
+    }
+    if (count == 0)
+    {
+        fprintf(stderr, "usage: %s [frames]\n", argv[0]);
+        return 1;
+    }
+
+    size_t frames_len = 0;
+    uint8_t *frames = build_frames(count, &frames_len);
+    if (!frames)
+    {
+        fprintf(stderr, "failed to build frames\n");
+        return 1;
+    }
+
+    int rc = 0;
+    rc |= run_decode("heap", frames, frames_len, count, false);
+    rc |= run_decode("inline", frames, frames_len, count, true);
+    rc |= run_span("span", frames, frames_len, count);
+
+    free(frames);
+    return rc ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+#include "ya_client_manager.h"
+#include "ya_config.h"
+#include "ya_event.h"
+#include "ya_input_queue.h"
+#include "ya_logger.h"
+#include "ya_mouse_filter.h"
+#include "ya_server.h"
+#include "ya_server_handler.h"
+
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// 日志级别检查基准：日志级别为 INFO 时
+// - handler: 经 process_server_event 处理 MOUSE_MOVE（v3 子像素路径，含 3 处 TRACE）的每事件耗时
+// - legacy:  同样 3 处 TRACE 按旧宏展开（无条件调用 ya_logger_log，参数照常求值）的额外耗时
+// - macro:   同样 3 处 TRACE 经 YA_LOG_TRACE（内联级别检查）的耗时
+// 注入线程使用空操作，不会真的移动鼠标
+
+#define BENCH_EVENTS 1000000
+
+YA_ServerContext svr_context;
+YA_Config config;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void noop_execute(const ya_input_action_t *action)
+{
+    (void)action;
+}
+
+// 旧宏的展开：不论级别先调用再在函数内判断
+#define LEGACY_LOG_TRACE(format, ...)                                                                                  \
+    ya_logger_log(g_logger, YA_LOG_LEVEL_TRACE, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+
+// 与 MOUSE_MOVE 路径上 3 处 TRACE 相同的参数
+static void legacy_sites(const YAEvent *event, const ya_client_t *client, int i)
+{
+    LEGACY_LOG_TRACE("Processing event type: %d, index: %d", event->header.type, event->header.index);
+    LEGACY_LOG_TRACE("[handler v3] Received: raw=(%d,%d) -> float=(%.3f,%.3f)", i, -i, i / 100.0, -i / 100.0);
+    LEGACY_LOG_TRACE("[handler v3] Subpixel: frac=(%.3f,%.3f) output=(%d,%d)", client->mouse_filter->frac_x,
+                     client->mouse_filter->frac_y, i, -i);
+}
+
+static void macro_sites(const YAEvent *event, const ya_client_t *client, int i)
+{
+    YA_LOG_TRACE("Processing event type: %d, index: %d", event->header.type, event->header.index);
+    YA_LOG_TRACE("[handler v3] Received: raw=(%d,%d) -> float=(%.3f,%.3f)", i, -i, i / 100.0, -i / 100.0);
+    YA_LOG_TRACE("[handler v3] Subpixel: frac=(%.3f,%.3f) output=(%d,%d)", client->mouse_filter->frac_x,
+                 client->mouse_filter->frac_y, i, -i);
+}
+
+static void report(const char *name, uint64_t elapsed, int count)
+{
+    printf("%-8s %8.1f ns/event\n", name, (double)elapsed / count);
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : BENCH_EVENTS;
+    if (count <= 0)
+    {
+        fprintf(stderr, "usage: %s [events]\n", argv[0]);
+        return 1;
+    }
+
+    ya_logger_config_t logger_config = {.level = YA_LOG_LEVEL_INFO, .use_console = 0};
+    if (!ya_logger_init(&logger_config))
+    {
+        fprintf(stderr, "failed to init logger\n");
+        return 1;
+    }
+
+    ya_config_init(&config);
+    svr_context.base = event_base_new();
+    ya_client_manager_init(&svr_context.client_manager);
+    if (!svr_context.base || ya_input_queue_start(noop_execute) != 0)
+    {
+        fprintf(stderr, "failed to init server context\n");
+        return 1;
+    }
+
+    // 客户端只需要一个 bufferevent，不做实际 I/O
+    struct bufferevent *bev = bufferevent_socket_new(svr_context.base, -1, 0);
+    ya_client_t *client = bev ? ya_client_create(&svr_context.client_manager, 0, bev) : NULL;
+    if (!client || !client->mouse_filter)
+    {
+        fprintf(stderr, "failed to create client\n");
+        return 1;
+    }
+    client->protocol_version = YA_PROTOCOL_VERSION;
+
+    YACommonEventRequest move = {0};
+    YAEvent event = {
+        .header = {.type = MOUSE_MOVE, .direction = REQUEST, .uid = client->uid},
+        .param = &move,
+        .param_len = sizeof(move),
+    };
+
+    printf("compiled level %d, runtime level %s, %d events\n", YA_LOG_COMPILED_LEVEL,
+           ya_logger_level_name(logger_config.level), count);
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < count; i++)
+    {
+        // 交替方向，子像素累积每次都输出一步
+        move.lparam = (i & 1) ? -150 : 150;
+        event.header.index = (uint32_t)i + 1;
+        process_server_event(bev, &event, client);
+    }
+    report("handler", now_ns() - start, count);
+
+    start = now_ns();
+    for (int i = 0; i < count; i++)
+    {
+        legacy_sites(&event, client, i);
+    }
+    report("legacy", now_ns() - start, count);
+
+    start = now_ns();
+    for (int i = 0; i < count; i++)
+    {
+        macro_sites(&event, client, i);
+    }
+    report("macro", now_ns() - start, count);
+
+    ya_input_queue_stop();
+    ya_client_manager_cleanup(&svr_context.client_manager);
+    event_base_free(svr_context.base);
+    ya_logger_destroy(g_logger);
+    return 0;
+}
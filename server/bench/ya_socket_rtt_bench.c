@@ -0,0 +1,190 @@
+#include "ya_config.h"
+#include "ya_socket_tuning.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+// 回环 RTT 基准：模拟会话服务对一个请求回复两个小帧（例如 HEARTBEAT 响应后紧跟一个状态帧），
+// 对比默认套接字选项与 [network] 调优后的往返时延。
+// 默认选项下第二个小帧会被 Nagle 扣住，直到对端的延迟 ACK 到达（Linux 上约 40ms）。
+
+#define BENCH_ROUNDS 200
+#define BENCH_FRAME_SIZE 16
+
+YA_Config config;
+
+typedef struct
+{
+    int listen_fd;
+    const ya_socket_tuning_t *tuning; // NULL 表示保持默认选项
+    size_t rounds;
+} server_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int read_full(int fd, uint8_t *buf, size_t len)
+{
+    size_t got = 0;
+    while (got < len)
+    {
+        ssize_t n = recv(fd, buf + got, len - got, 0);
+        if (n <= 0)
+        {
+            return -1;
+        }
+        got += (size_t)n;
+    }
+    return 0;
+}
+
+static void *serve(void *arg)
+{
+    server_t *server = arg;
+    int fd = accept(server->listen_fd, NULL, NULL);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    if (server->tuning)
+    {
+        ya_socket_tuning_apply(fd, server->tuning);
+    }
+
+    uint8_t request;
+    uint8_t frame[BENCH_FRAME_SIZE] = {0};
+    for (size_t i = 0; i < server->rounds; i++)
+    {
+        if (read_full(fd, &request, 1) < 0)
+        {
+            break;
+        }
+        if (server->tuning)
+        {
+            ya_socket_tuning_rearm_quickack(fd, server->tuning);
+        }
+
+        // 两次独立的写：与事件循环里连续写出两个响应帧的情形一致
+        send(fd, frame, sizeof(frame), 0);
+        send(fd, frame, sizeof(frame), 0);
+    }
+
+    close(fd);
+    return NULL;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int run_mode(const char *name, const ya_socket_tuning_t *tuning, size_t rounds)
+{
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    socklen_t addr_len = sizeof(addr);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 1) < 0 ||
+        getsockname(listen_fd, (struct sockaddr *)&addr, &addr_len) < 0)
+    {
+        perror("listen");
+        close(listen_fd);
+        return -1;
+    }
+
+    server_t server = {.listen_fd = listen_fd, .tuning = tuning, .rounds = rounds};
+    pthread_t thread;
+    pthread_create(&thread, NULL, serve, &server);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror("connect");
+        close(fd);
+        close(listen_fd);
+        pthread_join(thread, NULL);
+        return -1;
+    }
+
+    uint64_t *samples = calloc(rounds, sizeof(uint64_t));
+    uint8_t reply[BENCH_FRAME_SIZE * 2];
+    uint8_t request = 1;
+    size_t done = 0;
+    for (; done < rounds; done++)
+    {
+        uint64_t start = now_ns();
+        send(fd, &request, 1, 0);
+        if (read_full(fd, reply, sizeof(reply)) < 0)
+        {
+            break;
+        }
+        samples[done] = now_ns() - start;
+    }
+
+    close(fd);
+    pthread_join(thread, NULL);
+    close(listen_fd);
+
+    if (done == 0)
+    {
+        free(samples);
+        return -1;
+    }
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < done; i++)
+    {
+        total += samples[i];
+    }
+    qsort(samples, done, sizeof(uint64_t), compare_u64);
+    printf("%-8s %zu rounds  mean %.1f us  p50 %.1f us  p99 %.1f us  max %.1f us\n", name, done,
+           (double)total / done / 1000.0, samples[done / 2] / 1000.0, samples[done * 99 / 100] / 1000.0,
+           samples[done - 1] / 1000.0);
+
+    free(samples);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    size_t rounds = BENCH_ROUNDS;
+    if (argc > 1)
+    {
+        rounds = strtoul(argv[1], NULL, 10);
+    }
+    if (rounds == 0)
+    {
+        fprintf(stderr, "usage: %s [rounds] [server.conf]\n", argv[0]);
+        return 1;
+    }
+
+    // 调优参数取自配置文件的 [network] 段，未指定时使用内置默认值
+    ya_config_init(&config);
+    if (argc > 2 && ya_config_parse(argv[2], &config) != 0)
+    {
+        fprintf(stderr, "failed to parse %s\n", argv[2]);
+        return 1;
+    }
+    ya_socket_tuning_init();
+
+    int rc = 0;
+    rc |= run_mode("default", NULL, rounds);
+    rc |= run_mode("tuned", ya_socket_tuning(), rounds);
+
+    ya_config_free(&config);
+    return rc ? 1 : 0;
+}
@@ -0,0 +1,150 @@
+#include "input/keyboard/clipboard.h"
+#include "input/keyboard/sequencer.h"
+#include "input/keyboard/text.h"
+#include "ya_config.h"
+
+#ifdef USE_UINPUT
+#include "input/backend/linux_uinput.h"
+#include "input/backend/xkb_mapper.h"
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// TEXT_INPUT 注入基准：分别输入 ASCII、Latin-1 与 CJK 文本，输出每秒字符数、
+// 按键/剪贴板字符数与写入次数，并与整段走剪贴板的旧路径对比。
+// 会向当前焦点窗口真实输入文本，运行前请把焦点切到一个空白编辑器
+
+#define BENCH_REPEAT 20
+#define BENCH_FOCUS_DELAY_S 3
+
+YA_Config config;
+
+typedef struct
+{
+    const char *name;
+    const char *text;
+} corpus_t;
+
+static const corpus_t corpora[] = {
+    {"ascii", "The quick brown fox jumps over the lazy dog 0123456789. "},
+    {"latin1", "Grüße aus Köln, señor! Ça coûte 5 € à l'été. "},
+    {"cjk", "你好，世界。键盘输入测试。"},
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static size_t count_chars(const char *text)
+{
+    size_t chars = 0;
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++)
+    {
+        if ((*p & 0xC0) != 0x80)
+        {
+            chars++;
+        }
+    }
+    return chars;
+}
+
+static int run_corpus(const corpus_t *corpus, int repeat)
+{
+    size_t chars = count_chars(corpus->text) * (size_t)repeat;
+    keyboard_text_stats_t total = {0};
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < repeat; i++)
+    {
+        keyboard_text_stats_t stats = {0};
+        if (keyboard_type_text(corpus->text, &stats) != Success)
+        {
+            fprintf(stderr, "%s: keyboard_type_text failed\n", corpus->name);
+            return -1;
+        }
+        total.chars_typed += stats.chars_typed;
+        total.chars_pasted += stats.chars_pasted;
+        total.writes += stats.writes;
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    printf("%-7s xkb   %5zu chars  %9.0f chars/s  typed=%zu pasted=%zu writes=%zu\n", corpus->name, chars,
+           elapsed ? chars * 1e9 / (double)elapsed : 0.0, total.chars_typed, total.chars_pasted, total.writes);
+
+    // 旧路径：整段文本走剪贴板（备份、设置、粘贴、恢复）
+    start = now_ns();
+    for (int i = 0; i < repeat; i++)
+    {
+        if (clipboard_paste_text(corpus->text) != Success)
+        {
+            printf("%-7s paste unavailable\n", corpus->name);
+            return 0;
+        }
+    }
+    elapsed = now_ns() - start;
+    printf("%-7s paste %5zu chars  %9.0f chars/s\n", corpus->name, chars,
+           elapsed ? chars * 1e9 / (double)elapsed : 0.0);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int repeat = BENCH_REPEAT;
+    const char *delay = "0";
+    if (argc > 1)
+    {
+        repeat = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        delay = argv[2];
+    }
+    if (repeat <= 0)
+    {
+        fprintf(stderr, "usage: %s [repeat] [key_step_delay_ms]\n", argv[0]);
+        return 1;
+    }
+
+    ya_config_init(&config);
+    ya_config_set(&config, "input", "key_step_delay_ms", delay);
+    key_sequencer_init();
+    clipboard_helper_init();
+
+#ifdef USE_UINPUT
+    if (input_linux_init() != INPUT_BACKEND_OK)
+    {
+        fprintf(stderr, "uinput backend not available, skipping\n");
+        ya_config_free(&config);
+        return 0;
+    }
+    if (xkbmap_init_auto() != 0)
+    {
+        fprintf(stderr, "xkb mapping not available, every character will use the clipboard\n");
+    }
+#endif
+
+    printf("typing into the focused window in %d s (key_step_delay_ms=%s, repeat=%d)\n", BENCH_FOCUS_DELAY_S, delay,
+           repeat);
+    sleep(BENCH_FOCUS_DELAY_S);
+
+    int rc = 0;
+    for (size_t i = 0; i < sizeof(corpora) / sizeof(corpora[0]); i++)
+    {
+        rc |= run_corpus(&corpora[i], repeat);
+    }
+
+#ifdef USE_UINPUT
+    xkbmap_free();
+    input_linux_shutdown();
+#endif
+    ya_config_free(&config);
+    return rc ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+#include "ya_config.h"
+#include "ya_event.h"
+#include "ya_server.h"
+#include "ya_server_command.h"
+
+#include <arpa/inet.h>
+#include <event2/event.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+// UDP 命令服务接收基准：本地线程以最快速度发送 HEARTBEAT 数据报，
+// 分别用 recv_batch=1（逐个 recvfrom）和 recv_batch=N（recvmmsg/sendmmsg）接收，
+// 对比每次唤醒处理的数据报数、吞吐和丢包
+
+#define BENCH_DATAGRAMS 200000
+#define BENCH_IDLE_MS 200
+
+YA_ServerContext svr_context;
+YA_Config config;
+
+typedef struct
+{
+    struct sockaddr_in target;
+    size_t count;
+    atomic_bool done;
+} blaster_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void *blast(void *arg)
+{
+    blaster_t *blaster = arg;
+
+    YAEvent heartbeat = {.header = {.uid = 0, .type = HEARTBEAT, .direction = REQUEST, .index = 1}};
+    uint8_t frame[YA_EVENT_FRAME_STACK_SIZE];
+    int frame_len = ya_serialize_event_to(&heartbeat, frame, sizeof(frame));
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    for (size_t i = 0; i < blaster->count && frame_len > 0; i++)
+    {
+        sendto(fd, frame, (size_t)frame_len, 0, (struct sockaddr *)&blaster->target, sizeof(blaster->target));
+    }
+    close(fd);
+
+    atomic_store(&blaster->done, true);
+    return NULL;
+}
+
+typedef struct
+{
+    blaster_t *blaster;
+    uint64_t last_datagrams;
+    uint64_t last_progress_ns;
+    struct event *timer;
+} watch_t;
+
+// 发送结束且一段时间没有新数据报时退出事件循环
+static void watch_cb(evutil_socket_t fd, short events, void *arg)
+{
+    watch_t *watch = arg;
+    uint64_t now = now_ns();
+    if (svr_context.stats.command_datagrams != watch->last_datagrams)
+    {
+        watch->last_datagrams = svr_context.stats.command_datagrams;
+        watch->last_progress_ns = now;
+    }
+    else if (atomic_load(&watch->blaster->done) && now - watch->last_progress_ns > BENCH_IDLE_MS * 1000000ull)
+    {
+        event_base_loopexit(svr_context.base, NULL);
+    }
+}
+
+static int run_mode(unsigned int batch, size_t count)
+{
+    char batch_str[16];
+    snprintf(batch_str, sizeof(batch_str), "%u", batch);
+    ya_config_init(&config);
+    ya_config_set(&config, "command", "recv_batch", batch_str);
+
+    memset(&svr_context, 0, sizeof(svr_context));
+    svr_context.base = event_base_new();
+    ya_client_manager_init(&svr_context.client_manager);
+    svr_context.command_sock_addr.sin_family = AF_INET;
+    svr_context.command_sock_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    svr_context.command_sock_addr.sin_port = 0;
+
+    if (run_command_server() != 0)
+    {
+        fprintf(stderr, "failed to start command server\n");
+        return -1;
+    }
+
+    blaster_t blaster = {.count = count};
+    socklen_t addr_len = sizeof(blaster.target);
+    getsockname(svr_context.command_fd, (struct sockaddr *)&blaster.target, &addr_len);
+
+    watch_t watch = {.blaster = &blaster, .last_progress_ns = now_ns()};
+    watch.timer = event_new(svr_context.base, -1, EV_PERSIST, watch_cb, &watch);
+    struct timeval tick = {0, 10000};
+    event_add(watch.timer, &tick);
+
+    uint64_t start = now_ns();
+    pthread_t thread;
+    pthread_create(&thread, NULL, blast, &blaster);
+    event_base_dispatch(svr_context.base);
+    pthread_join(thread, NULL);
+    uint64_t elapsed = watch.last_progress_ns - start;
+
+    const ya_server_stats_t *stats = &svr_context.stats;
+    printf("recv_batch=%-3u sent=%zu received=%llu dropped=%llu wakeups=%llu datagrams/wakeup=%.2f max=%u "
+           "%.0f datagrams/s\n",
+           batch, count, (unsigned long long)stats->command_datagrams,
+           (unsigned long long)(count - stats->command_datagrams), (unsigned long long)stats->command_wakeups,
+           stats->command_wakeups ? (double)stats->command_datagrams / (double)stats->command_wakeups : 0.0,
+           stats->max_datagrams_per_wakeup, elapsed ? stats->command_datagrams * 1e9 / (double)elapsed : 0.0);
+
+    event_free(watch.timer);
+    evutil_closesocket(svr_context.command_fd);
+    event_base_free(svr_context.base);
+    ya_config_free(&config);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = BENCH_DATAGRAMS;
+    unsigned int batch = 32;
+    if (argc > 1)
+    {
+        count = strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2)
+    {
+        batch = (unsigned int)strtoul(argv[2], NULL, 10);
+    }
+    if (count == 0 || batch == 0)
+    {
+        fprintf(stderr, "usage: %s [datagrams] [recv_batch]\n", argv[0]);
+        return 1;
+    }
+
+    int rc = 0;
+    rc |= run_mode(1, count);
+    rc |= run_mode(batch, count);
+    return rc ? 1 : 0;
+}
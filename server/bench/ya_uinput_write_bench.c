@@ -0,0 +1,122 @@
+#include "input/backend/linux_uinput.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// uinput 写入基准：对比逐个 input_event 调用 write()（旧实现）与按 SYN 帧批量写入
+// 动作：双轴 MOUSE_MOVE，以及带修饰键的单击（Shift 按下 → F24 单击 → Shift 释放）
+// 输出每个动作的 write() 次数与平均耗时。需要 /dev/uinput 写权限，
+// 鼠标来回移动 1 像素，F24 通常没有绑定
+
+#define BENCH_ACTIONS 20000
+
+#ifdef __linux__
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// 旧实现：每个事件单独 write()
+static void emit_per_event(input_linux_batch_t *batch, uint16_t type, uint16_t code, int32_t value)
+{
+    input_linux_batch_add(batch, type, code, value);
+    input_linux_batch_flush(batch);
+}
+
+static void add_key_frame(input_linux_batch_t *batch, uint16_t code, int32_t value, int per_event)
+{
+    if (per_event)
+    {
+        emit_per_event(batch, EV_KEY, code, value);
+        emit_per_event(batch, EV_SYN, SYN_REPORT, 0);
+    }
+    else
+    {
+        input_linux_batch_add(batch, EV_KEY, code, value);
+        input_linux_batch_syn(batch);
+    }
+}
+
+static void move_action(int i, int per_event)
+{
+    int32_t d = (i & 1) ? -1 : 1;
+    if (!per_event)
+    {
+        input_linux_mouse_move(d, d);
+        return;
+    }
+
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    emit_per_event(&batch, EV_REL, REL_X, d);
+    emit_per_event(&batch, EV_REL, REL_Y, d);
+    emit_per_event(&batch, EV_SYN, SYN_REPORT, 0);
+}
+
+static void chord_action(int i, int per_event)
+{
+    (void)i;
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    add_key_frame(&batch, KEY_LEFTSHIFT, 1, per_event);
+    add_key_frame(&batch, KEY_F24, 1, per_event);
+    add_key_frame(&batch, KEY_F24, 0, per_event);
+    add_key_frame(&batch, KEY_LEFTSHIFT, 0, per_event);
+    input_linux_batch_flush(&batch);
+}
+
+static void run(const char *name, void (*action)(int, int), int per_event, int count)
+{
+    input_linux_write_stats_t before, after;
+    input_linux_write_stats(&before);
+    uint64_t start = now_ns();
+    for (int i = 0; i < count; i++)
+    {
+        action(i, per_event);
+    }
+    uint64_t elapsed = now_ns() - start;
+    input_linux_write_stats(&after);
+
+    printf("%-6s %-9s  writes/action=%5.2f  events/action=%5.2f  %8.0f ns/action\n", name,
+           per_event ? "per-event" : "framed", (double)(after.writes - before.writes) / count,
+           (double)(after.events - before.events) / count, (double)elapsed / count);
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : BENCH_ACTIONS;
+    if (count <= 0)
+    {
+        fprintf(stderr, "usage: %s [actions]\n", argv[0]);
+        return 1;
+    }
+
+    if (input_linux_init() != INPUT_BACKEND_OK)
+    {
+        fprintf(stderr, "uinput backend not available, skipping\n");
+        return 0;
+    }
+
+    run("move", move_action, 1, count);
+    run("move", move_action, 0, count);
+    run("chord", chord_action, 1, count);
+    run("chord", chord_action, 0, count);
+
+    input_linux_shutdown();
+    return 0;
+}
+
+#else
+
+int main(void)
+{
+    fprintf(stderr, "uinput backend is Linux only, skipping\n");
+    return 0;
+}
+
+#endif
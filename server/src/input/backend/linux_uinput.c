@@ -8,6 +8,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <stdatomic.h>
 #include <linux/uinput.h>
 #include <linux/input-event-codes.h>
 
@@ -428,72 +429,116 @@ void input_linux_shutdown(void) {
     }
 }
 
-// Helper function to emit input event
-static int emit_event(int type, int code, int value) {
-    struct input_event ev;
-    memset(&ev, 0, sizeof(ev));
-    ev.type = type;
-    ev.code = code;
-    ev.value = value;
-    
-    if (write(uinput_fd, &ev, sizeof(ev)) < 0) {
-        return -1;
-    }
-    return 0;
-}
+// ============================================================================
+// Event batches: every action is built as complete SYN frames and written with
+// a single write() instead of one syscall per input_event
+// ============================================================================
+
+static atomic_uint_fast64_t g_write_calls;
+static atomic_uint_fast64_t g_write_events;
 
-// Helper function to emit SYN event
-static int emit_syn(void) {
-    return emit_event(EV_SYN, SYN_REPORT, 0);
+void input_linux_batch_init(input_linux_batch_t *batch) {
+    batch->count = 0;
 }
 
-int input_linux_mouse_move(int32_t dx, int32_t dy) {
+int input_linux_batch_flush(input_linux_batch_t *batch) {
+    if (batch->count == 0) {
+        return INPUT_BACKEND_OK;
+    }
     if (uinput_fd < 0) {
+        batch->count = 0;
         return INPUT_BACKEND_ERROR_INIT;
     }
-    
-    // Emit relative movement events
-    if (dx != 0) {
-        if (emit_event(EV_REL, REL_X, dx) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
+
+    size_t len = batch->count * sizeof(batch->events[0]);
+    ssize_t written = write(uinput_fd, batch->events, len);
+    atomic_fetch_add_explicit(&g_write_calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_write_events, batch->count, memory_order_relaxed);
+    batch->count = 0;
+
+    if (written != (ssize_t)len) {
+        YA_LOG_ERROR("uinput write failed (%zd of %zu bytes): %s", written, len, strerror(errno));
+        return INPUT_BACKEND_ERROR_DEVICE;
     }
-    
-    if (dy != 0) {
-        if (emit_event(EV_REL, REL_Y, dy) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
+    return INPUT_BACKEND_OK;
+}
+
+int input_linux_batch_add(input_linux_batch_t *batch, uint16_t type, uint16_t code, int32_t value) {
+    if (batch->count == INPUT_LINUX_BATCH_MAX) {
+        int result = input_linux_batch_flush(batch);
+        if (result != INPUT_BACKEND_OK) {
+            return result;
         }
     }
-    
-    // Synchronize
-    if (emit_syn() < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
-    }
-    
+
+    struct input_event *ev = &batch->events[batch->count++];
+    memset(ev, 0, sizeof(*ev));
+    ev->type = type;
+    ev->code = code;
+    ev->value = value;
     return INPUT_BACKEND_OK;
 }
 
-int input_linux_mouse_press(mouse_button_t button) {
-    if (uinput_fd < 0) {
-        return INPUT_BACKEND_ERROR_INIT;
+int input_linux_batch_syn(input_linux_batch_t *batch) {
+    return input_linux_batch_add(batch, EV_SYN, SYN_REPORT, 0);
+}
+
+void input_linux_write_stats(input_linux_write_stats_t *stats) {
+    stats->writes = atomic_load_explicit(&g_write_calls, memory_order_relaxed);
+    stats->events = atomic_load_explicit(&g_write_events, memory_order_relaxed);
+}
+
+// Append one key transition as its own frame
+static int batch_key(input_linux_batch_t *batch, int code, int value) {
+    int result = input_linux_batch_add(batch, EV_KEY, (uint16_t)code, value);
+    if (result == INPUT_BACKEND_OK) {
+        result = input_linux_batch_syn(batch);
     }
+    return result;
+}
 
-    int btn_code = button_to_linux_code(button);
-    if (btn_code < 0) {
-        return INPUT_BACKEND_ERROR_INVALID_PARAM;
+// Append press/release frames for a key direction
+static int batch_key_direction(input_linux_batch_t *batch, int code, enum CDirection direction) {
+    int result = INPUT_BACKEND_OK;
+    if (direction == Press || direction == Click) {
+        result = batch_key(batch, code, 1);
+    }
+    if (result == INPUT_BACKEND_OK && (direction == Release || direction == Click)) {
+        result = batch_key(batch, code, 0);
     }
+    return result;
+}
 
-    if (emit_event(EV_KEY, btn_code, 1) < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
+// Flush the batch, keeping the first error
+static int batch_finish(input_linux_batch_t *batch, int result) {
+    if (result != INPUT_BACKEND_OK) {
+        batch->count = 0;
+        return result;
     }
-    if (emit_syn() < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
+    return input_linux_batch_flush(batch);
+}
+
+int input_linux_mouse_move(int32_t dx, int32_t dy) {
+    if (uinput_fd < 0) {
+        return INPUT_BACKEND_ERROR_INIT;
     }
 
-    return INPUT_BACKEND_OK;
+    // Relative movement on both axes + SYN in one frame
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    if (dx != 0) {
+        input_linux_batch_add(&batch, EV_REL, REL_X, dx);
+    }
+    if (dy != 0) {
+        input_linux_batch_add(&batch, EV_REL, REL_Y, dy);
+    }
+    input_linux_batch_syn(&batch);
+
+    return input_linux_batch_flush(&batch);
 }
 
-int input_linux_mouse_release(mouse_button_t button) {
+// Press, release or click a mouse button in one write
+static int mouse_button_action(mouse_button_t button, enum CDirection direction) {
     if (uinput_fd < 0) {
         return INPUT_BACKEND_ERROR_INIT;
     }
@@ -503,28 +548,21 @@ int input_linux_mouse_release(mouse_button_t button) {
         return INPUT_BACKEND_ERROR_INVALID_PARAM;
     }
 
-    if (emit_event(EV_KEY, btn_code, 0) < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
-    }
-    if (emit_syn() < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
-    }
-
-    return INPUT_BACKEND_OK;
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    return batch_finish(&batch, batch_key_direction(&batch, btn_code, direction));
 }
 
-int input_linux_mouse_click(mouse_button_t button) {
-    int result = input_linux_mouse_press(button);
-    if (result != INPUT_BACKEND_OK) {
-        return result;
-    }
+int input_linux_mouse_press(mouse_button_t button) {
+    return mouse_button_action(button, Press);
+}
 
-    result = input_linux_mouse_release(button);
-    if (result != INPUT_BACKEND_OK) {
-        return result;
-    }
+int input_linux_mouse_release(mouse_button_t button) {
+    return mouse_button_action(button, Release);
+}
 
-    return INPUT_BACKEND_OK;
+int input_linux_mouse_click(mouse_button_t button) {
+    return mouse_button_action(button, Click);
 }
 
 int input_linux_mouse_scroll(scroll_direction_t direction, int32_t amount) {
@@ -561,40 +599,61 @@ int input_linux_mouse_scroll(scroll_direction_t direction, int32_t amount) {
             return INPUT_BACKEND_ERROR_INVALID_PARAM;
     }
     
-    // Emit scroll event
-    if (emit_event(EV_REL, event_type, value) < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
-    }
-    if (emit_syn() < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
+    // The device advertises the hi-res wheel axes, so readers like libinput take the
+    // distance from REL_*_HI_RES; send the matching 120 units per notch in the same frame
+    int hires_type = event_type == REL_WHEEL ? REL_WHEEL_HI_RES : REL_HWHEEL_HI_RES;
+    int64_t hires = (int64_t)value * 120;
+    if (hires > INT32_MAX || hires < -INT32_MAX) {
+        return INPUT_BACKEND_ERROR_INVALID_PARAM;
     }
-    
-    return INPUT_BACKEND_OK;
+
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    input_linux_batch_add(&batch, EV_REL, (uint16_t)hires_type, (int32_t)hires);
+    input_linux_batch_add(&batch, EV_REL, (uint16_t)event_type, value);
+    input_linux_batch_syn(&batch);
+
+    return input_linux_batch_flush(&batch);
 }
 
-int input_linux_key_press(uint32_t keycode) {
+int input_linux_mouse_scroll_hires(int32_t hires_x, int32_t hires_y, int32_t notch_x, int32_t notch_y) {
     if (uinput_fd < 0) {
         return INPUT_BACKEND_ERROR_INIT;
     }
-    
-    // keycode is expected to be a Linux KEY_* code
-    // Press
-    if (emit_event(EV_KEY, keycode, 1) < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
+
+    if (hires_x == 0 && hires_y == 0 && notch_x == 0 && notch_y == 0) {
+        return INPUT_BACKEND_OK;
     }
-    if (emit_syn() < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
+
+    // Hi-res units and any completed legacy notches go out together in one frame
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    if (hires_y != 0) {
+        input_linux_batch_add(&batch, EV_REL, REL_WHEEL_HI_RES, hires_y);
     }
-    
-    // Release
-    if (emit_event(EV_KEY, keycode, 0) < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
+    if (notch_y != 0) {
+        input_linux_batch_add(&batch, EV_REL, REL_WHEEL, notch_y);
     }
-    if (emit_syn() < 0) {
-        return INPUT_BACKEND_ERROR_DEVICE;
+    if (hires_x != 0) {
+        input_linux_batch_add(&batch, EV_REL, REL_HWHEEL_HI_RES, hires_x);
+    }
+    if (notch_x != 0) {
+        input_linux_batch_add(&batch, EV_REL, REL_HWHEEL, notch_x);
+    }
+    input_linux_batch_syn(&batch);
+
+    return input_linux_batch_flush(&batch);
+}
+
+int input_linux_key_press(uint32_t keycode) {
+    if (uinput_fd < 0) {
+        return INPUT_BACKEND_ERROR_INIT;
     }
     
-    return INPUT_BACKEND_OK;
+    // keycode is expected to be a Linux KEY_* code; press and release frames in one write
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    return batch_finish(&batch, batch_key_direction(&batch, (int)keycode, Click));
 }
 
 int input_linux_diagnose(input_linux_diagnose_t *result) {
@@ -653,40 +712,9 @@ int input_linux_key_action(enum CKey key, enum CDirection direction) {
         return INPUT_BACKEND_ERROR_INVALID_PARAM;
     }
     
-    // Handle different directions
-    if (direction == Press) {
-        // Press only
-        if (emit_event(EV_KEY, linux_keycode, 1) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_syn() < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-    } else if (direction == Release) {
-        // Release only
-        if (emit_event(EV_KEY, linux_keycode, 0) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_syn() < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-    } else if (direction == Click) {
-        // Press and release
-        if (emit_event(EV_KEY, linux_keycode, 1) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_syn() < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_event(EV_KEY, linux_keycode, 0) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_syn() < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-    }
-    
-    return INPUT_BACKEND_OK;
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    return batch_finish(&batch, batch_key_direction(&batch, linux_keycode, direction));
 }
 
 // Raw evdev keycode injection (for xkb mapping)
@@ -696,37 +724,28 @@ int input_linux_key_action_raw(int evdev_key, enum CDirection direction) {
         return INPUT_BACKEND_ERROR_INIT;
     }
     
-    // Handle different directions
-    if (direction == Press) {
-        if (emit_event(EV_KEY, evdev_key, 1) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_syn() < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-    } else if (direction == Release) {
-        if (emit_event(EV_KEY, evdev_key, 0) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_syn() < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-    } else if (direction == Click) {
-        if (emit_event(EV_KEY, evdev_key, 1) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_syn() < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_event(EV_KEY, evdev_key, 0) < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
-        if (emit_syn() < 0) {
-            return INPUT_BACKEND_ERROR_DEVICE;
-        }
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    return batch_finish(&batch, batch_key_direction(&batch, evdev_key, direction));
+}
+
+// Batched raw key injection: one EV_KEY + SYN_REPORT frame per entry, one write() per full batch
+int input_linux_key_events_raw(const input_linux_key_event_t *events, size_t count) {
+    if (uinput_fd < 0) {
+        YA_LOG_ERROR("Input backend not initialized");
+        return INPUT_BACKEND_ERROR_INIT;
     }
-    
-    return INPUT_BACKEND_OK;
+    if (!events && count > 0) {
+        return INPUT_BACKEND_ERROR_INVALID_PARAM;
+    }
+
+    input_linux_batch_t batch;
+    input_linux_batch_init(&batch);
+    int result = INPUT_BACKEND_OK;
+    for (size_t i = 0; i < count && result == INPUT_BACKEND_OK; i++) {
+        result = batch_key(&batch, events[i].code, events[i].value);
+    }
+    return batch_finish(&batch, result);
 }
 
 #endif // __linux__
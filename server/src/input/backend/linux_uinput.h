@@ -1,6 +1,7 @@
 #ifndef INPUT_LINUX_UINPUT_H
 #define INPUT_LINUX_UINPUT_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -46,9 +47,49 @@ int input_linux_mouse_click(mouse_button_t button);
 int input_linux_mouse_press(mouse_button_t button);
 int input_linux_mouse_release(mouse_button_t button);
 int input_linux_mouse_scroll(scroll_direction_t direction, int32_t amount);
+// Smooth scroll: REL_WHEEL_HI_RES/REL_HWHEEL_HI_RES units (120 per notch) plus the
+// legacy notches completed by them, in one frame. Vertical positive = up, horizontal positive = right
+int input_linux_mouse_scroll_hires(int32_t hires_x, int32_t hires_y, int32_t notch_x, int32_t notch_y);
 int input_linux_key_press(uint32_t keycode);
 int input_linux_diagnose(input_linux_diagnose_t *result);
 
+#ifdef __linux__
+#include <linux/input.h>
+
+// Event batch: input_events for one or more complete SYN frames, written to
+// uinput with a single write() on flush
+#define INPUT_LINUX_BATCH_MAX 256
+
+typedef struct {
+    struct input_event events[INPUT_LINUX_BATCH_MAX];
+    size_t count;
+} input_linux_batch_t;
+
+// Cumulative write() statistics of the backend
+typedef struct {
+    uint64_t writes; // write() syscalls
+    uint64_t events; // input_events written
+} input_linux_write_stats_t;
+
+void input_linux_batch_init(input_linux_batch_t *batch);
+// Append an event; a full batch is flushed first (returns its error, if any)
+int input_linux_batch_add(input_linux_batch_t *batch, uint16_t type, uint16_t code, int32_t value);
+// Append EV_SYN/SYN_REPORT, closing the current frame
+int input_linux_batch_syn(input_linux_batch_t *batch);
+// Write all pending events with one write(), the batch is empty afterwards
+int input_linux_batch_flush(input_linux_batch_t *batch);
+void input_linux_write_stats(input_linux_write_stats_t *stats);
+#endif
+
+// Max key transitions per write() in input_linux_key_events_raw (EV_KEY + SYN each)
+#define INPUT_LINUX_KEY_BATCH_MAX 128
+
+// One key transition for batched injection
+typedef struct {
+    uint16_t code;  // evdev KEY_* code
+    int32_t value;  // 1 = press, 0 = release
+} input_linux_key_event_t;
+
 // High-level key action wrapper (for key_inject.c integration)
 // Takes CKey enum and direction, returns 0 on success, negative on error
 #ifdef USE_UINPUT
@@ -58,6 +99,12 @@ int input_linux_key_action(enum CKey key, enum CDirection direction);
 // Raw evdev keycode injection (for xkb mapping)
 // Takes Linux evdev KEY_* code and direction, returns 0 on success, negative on error
 int input_linux_key_action_raw(int evdev_key, enum CDirection direction);
+
+// Batched raw key injection (for text input)
+// Each entry becomes its own EV_KEY + SYN_REPORT frame, so ordering and modifier
+// registration are the same as separate calls, but up to INPUT_LINUX_KEY_BATCH_MAX
+// transitions go out in a single write(). Returns 0 on success, negative on error
+int input_linux_key_events_raw(const input_linux_key_event_t *events, size_t count);
 #endif
 
 #endif // INPUT_LINUX_UINPUT_H
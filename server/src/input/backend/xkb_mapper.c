@@ -33,6 +33,9 @@
 // XKB to evdev keycode offset
 #define XKB_KEYCODE_OFFSET 8
 
+// Code points below this are looked up by direct index instead of scanning the cache
+#define XKB_DIRECT_INDEX_SIZE 256
+
 // Mapping cache entry
 typedef struct {
     uint32_t codepoint;
@@ -51,6 +54,7 @@ static struct {
     xkb_cache_entry_t* cache;
     size_t cache_size;
     size_t cache_capacity;
+    int16_t direct[XKB_DIRECT_INDEX_SIZE]; // ASCII/Latin-1 → cache index, -1 = unmapped
 #endif
 } g_xkb = {0};
 
@@ -135,6 +139,16 @@ static void build_cache(void) {
     // Reset state
     xkb_state_update_mask(g_xkb.state, 0, 0, 0, 0, 0, 0);
     
+    // Direct index for ASCII/Latin-1, the bulk of typed text
+    for (size_t cp = 0; cp < XKB_DIRECT_INDEX_SIZE; ++cp) {
+        g_xkb.direct[cp] = -1;
+    }
+    for (size_t i = 0; i < g_xkb.cache_size; ++i) {
+        if (g_xkb.cache[i].codepoint < XKB_DIRECT_INDEX_SIZE) {
+            g_xkb.direct[g_xkb.cache[i].codepoint] = (int16_t)i;
+        }
+    }
+    
     YA_LOG_INFO("xkbmap: built cache with %zu entries", g_xkb.cache_size);
 }
 
@@ -306,6 +320,40 @@ void xkbmap_free(void) {
 #endif
 }
 
+bool xkbmap_map_codepoint(uint32_t cp, int* evdev_key, unsigned* mods_mask) {
+#ifdef HAVE_LIBXKBCOMMON
+    if (!g_xkb.initialized || !g_xkb.cache || !evdev_key || !mods_mask) {
+        return false;
+    }
+    
+    if (cp < XKB_DIRECT_INDEX_SIZE) {
+        int16_t index = g_xkb.direct[cp];
+        if (index < 0) {
+            return false;
+        }
+        *evdev_key = g_xkb.cache[index].evdev_key;
+        *mods_mask = g_xkb.cache[index].mods_mask;
+        return true;
+    }
+    
+    // Search cache
+    for (size_t i = 0; i < g_xkb.cache_size; ++i) {
+        if (g_xkb.cache[i].codepoint == cp) {
+            *evdev_key = g_xkb.cache[i].evdev_key;
+            *mods_mask = g_xkb.cache[i].mods_mask;
+            return true;
+        }
+    }
+    
+    return false; // Not found (dead key/compose/unmappable)
+#else
+    (void)cp;
+    (void)evdev_key;
+    (void)mods_mask;
+    return false;
+#endif
+}
+
 bool xkbmap_map_utf8_to_evdev(const char* utf8, int* evdev_key, unsigned* mods_mask) {
 #ifdef HAVE_LIBXKBCOMMON
     if (!g_xkb.initialized || !utf8 || !evdev_key || !mods_mask) {
@@ -328,16 +376,7 @@ bool xkbmap_map_utf8_to_evdev(const char* utf8, int* evdev_key, unsigned* mods_m
         return false;
     }
     
-    // Search cache
-    for (size_t i = 0; i < g_xkb.cache_size; ++i) {
-        if (g_xkb.cache[i].codepoint == cp) {
-            *evdev_key = g_xkb.cache[i].evdev_key;
-            *mods_mask = g_xkb.cache[i].mods_mask;
-            return true;
-        }
-    }
-    
-    return false; // Not found (dead key/compose/unmappable)
+    return xkbmap_map_codepoint(cp, evdev_key, mods_mask);
 #else
     (void)utf8;
     (void)evdev_key;
@@ -362,6 +401,13 @@ int xkbmap_init_auto(void) {
 
 void xkbmap_free(void) {}
 
+bool xkbmap_map_codepoint(uint32_t cp, int* evdev_key, unsigned* mods_mask) {
+    (void)cp;
+    (void)evdev_key;
+    (void)mods_mask;
+    return false;
+}
+
 bool xkbmap_map_utf8_to_evdev(const char* utf8, int* evdev_key, unsigned* mods_mask) {
     (void)utf8;
     (void)evdev_key;
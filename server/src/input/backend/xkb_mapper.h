@@ -41,6 +41,14 @@ void xkbmap_free(void);
  */
 bool xkbmap_map_utf8_to_evdev(const char* utf8, int* evdev_key, unsigned* mods_mask);
 
+/**
+ * Map a Unicode code point to evdev keycode and modifiers (same cache as
+ * xkbmap_map_utf8_to_evdev, without the UTF-8 round trip; ASCII/Latin-1 are
+ * looked up by direct index)
+ * @return true if mapped successfully, false if unmappable
+ */
+bool xkbmap_map_codepoint(uint32_t cp, int* evdev_key, unsigned* mods_mask);
+
 /**
  * Get layout source description for logging
  * @return String like "X11", "env:us", "fallback:us", or "uninitialized"
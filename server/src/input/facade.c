@@ -139,6 +139,28 @@ YAError input_mouse_scroll(int amount, int dir) {
 #endif
 }
 
+YAError input_mouse_scroll_smooth(int hires_x, int hires_y, int notch_x, int notch_y) {
+#ifdef USE_UINPUT
+    int result = input_linux_mouse_scroll_hires(hires_x, hires_y, notch_x, notch_y);
+    if (result != INPUT_BACKEND_OK) {
+        YA_LOG_ERROR("input_mouse_scroll_smooth failed: backend error %d", result);
+    }
+    return translate_backend_status(result);
+#else
+    // Non-Linux: RS only has whole wheel clicks, emit the completed notches
+    (void)hires_x;
+    (void)hires_y;
+    YAError err = Success;
+    if (notch_y != 0) {
+        err = input_mouse_scroll(notch_y > 0 ? notch_y : -notch_y, notch_y > 0 ? 0 : 1);
+    }
+    if (err == Success && notch_x != 0) {
+        err = input_mouse_scroll(notch_x > 0 ? notch_x : -notch_x, notch_x > 0 ? 3 : 2);
+    }
+    return err;
+#endif
+}
+
 YAError input_key_action(enum CKey key, enum CDirection dir) {
 #ifdef USE_UINPUT
     int result = input_linux_key_action(key, dir);
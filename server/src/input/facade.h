@@ -42,6 +42,19 @@ YAError input_mouse_button(enum CButton btn, enum CDirection dir);
  */
 YAError input_mouse_scroll(int amount, int dir);
 
+/**
+ * Smooth (hi-res) scroll
+ * @param hires_x Horizontal distance in 1/120 notch (positive = right)
+ * @param hires_y Vertical distance in 1/120 notch (positive = up)
+ * @param notch_x Whole horizontal notches completed by this step
+ * @param notch_y Whole vertical notches completed by this step
+ * @return Success or error code
+ *
+ * Linux sends both in one uinput frame; other platforms only have whole
+ * wheel clicks and emit the notches.
+ */
+YAError input_mouse_scroll_smooth(int hires_x, int hires_y, int notch_x, int notch_y);
+
 /**
  * Perform keyboard key action
  * @param key Key to act on (CKey enum)
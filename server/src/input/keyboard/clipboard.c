@@ -1,5 +1,6 @@
 #include "input/keyboard/clipboard.h"
 #include "input/facade.h"
+#include "input/keyboard/sequencer.h"
 #include "ya_logger.h"
 #include "ya_config.h"
 #include <string.h>
@@ -13,44 +14,6 @@ static clipboard_fallback_config_t g_clipboard_config = {
     .use_ctrl_v = false,  // Default: Shift+Insert
 };
 
-// Timing constants (from ya_server_handler.c)
-#define YA_KEY_DELAY_MS 10
-
-// Forward declarations for lock/sleep (from ya_server_handler.c)
-#if defined(_WIN32)
-#include <windows.h>
-static CRITICAL_SECTION g_key_inject_cs;
-static INIT_ONCE g_key_inject_once = INIT_ONCE_STATIC_INIT;
-static BOOL CALLBACK ya_init_key_cs(PINIT_ONCE InitOnce, PVOID Parameter, PVOID *Context) {
-    (void)InitOnce; (void)Parameter; (void)Context;
-    InitializeCriticalSection(&g_key_inject_cs);
-    return TRUE;
-}
-static inline void ya_key_lock(void) {
-    InitOnceExecuteOnce(&g_key_inject_once, ya_init_key_cs, NULL, NULL);
-    EnterCriticalSection(&g_key_inject_cs);
-}
-static inline void ya_key_unlock(void) {
-    LeaveCriticalSection(&g_key_inject_cs);
-}
-static inline void ya_key_sleep_ms(int ms) {
-    Sleep(ms);
-}
-#else
-#include <pthread.h>
-#include <unistd.h>
-static pthread_mutex_t g_key_inject_mutex = PTHREAD_MUTEX_INITIALIZER;
-static inline void ya_key_lock(void) {
-    (void)pthread_mutex_lock(&g_key_inject_mutex);
-}
-static inline void ya_key_unlock(void) {
-    (void)pthread_mutex_unlock(&g_key_inject_mutex);
-}
-static inline void ya_key_sleep_ms(int ms) {
-    usleep(ms * 1000);
-}
-#endif
-
 void clipboard_helper_init(void) {
     // Read [input].clipboard_fallback
     const char* fallback_str = ya_config_get(&config, "input", "clipboard_fallback");
@@ -102,39 +65,24 @@ YAError clipboard_paste_text(const char* text) {
         return set_err;
     }
     
-    // Send paste shortcut (with lock and timing)
-    ya_key_lock();
-
-    YAError key_err = Success;
+    // Send paste shortcut; must finish before the clipboard is restored
+    key_program_t program;
+    key_program_init(&program);
+    int modifier;
     if (g_clipboard_config.use_ctrl_v) {
         YA_LOG_DEBUG("clipboard fallback: sending Ctrl+V");
-        key_err = input_key_action(Control, Press);
-        if (key_err == Success) {
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-            key_err = input_key_action(V, Click);
-        }
-        if (key_err == Success) {
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-            key_err = input_key_action(Control, Release);
-        }
+        modifier = key_program_add(&program, KEY_STEP_KEY, Control, Press, true);
+        key_program_add(&program, KEY_STEP_KEY, V, Click, true);
     } else {
         YA_LOG_DEBUG("clipboard fallback: sending Shift+Insert");
-        key_err = input_key_action(Shift, Press);
-        if (key_err == Success) {
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-            key_err = input_key_action(Insert, Click);
-        }
-        if (key_err == Success) {
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-            key_err = input_key_action(Shift, Release);
-        }
+        modifier = key_program_add(&program, KEY_STEP_KEY, Shift, Press, true);
+        key_program_add(&program, KEY_STEP_KEY, Insert, Click, true);
     }
+    program.release_from = program.count;
+    key_program_add_release(&program, modifier, true);
 
-    ya_key_unlock();
-
-    if (key_err == Success) {
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
-    }
+    // The trailing step delay gives the target time to read the clipboard before it is restored
+    YAError key_err = key_sequencer_run_sync(&program);
 
     // Restore original clipboard if configured
     if (backup) {
@@ -2,9 +2,12 @@
 #include "input/keyboard/handler.h"
 #include "input/facade.h"
 #include "input/keyboard/clipboard.h"
+#include "input/keyboard/sequencer.h"
 #include "ya_logger.h"
 #include "ya_event.h"
+#include <stdatomic.h>
 #include <string.h>
+#include <time.h>
 
 #ifdef USE_UINPUT
 #include "input/backend/linux_uinput.h"
@@ -19,43 +22,6 @@ void encode_codepoint_to_utf8(int32_t codepoint, char* utf8_out);
 YAError map_char_to_platform(int32_t codepoint, uint32_t* platform_code, bool* need_shift);
 #endif
 
-// Timing and lock (from ya_server_handler.c)
-#define YA_KEY_DELAY_MS 10
-
-#if defined(_WIN32)
-#include <windows.h>
-static CRITICAL_SECTION g_key_inject_cs;
-static INIT_ONCE g_key_inject_once = INIT_ONCE_STATIC_INIT;
-static BOOL CALLBACK ya_init_key_cs(PINIT_ONCE InitOnce, PVOID Parameter, PVOID *Context) {
-    (void)InitOnce; (void)Parameter; (void)Context;
-    InitializeCriticalSection(&g_key_inject_cs);
-    return TRUE;
-}
-static inline void ya_key_lock(void) {
-    InitOnceExecuteOnce(&g_key_inject_once, ya_init_key_cs, NULL, NULL);
-    EnterCriticalSection(&g_key_inject_cs);
-}
-static inline void ya_key_unlock(void) {
-    LeaveCriticalSection(&g_key_inject_cs);
-}
-static inline void ya_key_sleep_ms(int ms) {
-    Sleep(ms);
-}
-#else
-#include <pthread.h>
-#include <unistd.h>
-static pthread_mutex_t g_key_inject_mutex = PTHREAD_MUTEX_INITIALIZER;
-static inline void ya_key_lock(void) {
-    (void)pthread_mutex_lock(&g_key_inject_mutex);
-}
-static inline void ya_key_unlock(void) {
-    (void)pthread_mutex_unlock(&g_key_inject_mutex);
-}
-static inline void ya_key_sleep_ms(int ms) {
-    usleep(ms * 1000);
-}
-#endif
-
 // ============================================================================
 // Modifier Management
 // ============================================================================
@@ -90,321 +56,355 @@ static unsigned merge_modifiers(uint32_t user_mods, unsigned xkb_mods) {
     return final_mods;
 }
 
+// Append releases for the pressed steps in reverse order; starts the release phase
+static void add_releases(key_program_t* program, const int* pressed, int count) {
+    program->release_from = program->count;
+    for (int i = count - 1; i >= 0; i--) {
+        if (pressed[i] >= 0) {
+            key_program_add_release(program, pressed[i], true);
+        }
+    }
+}
+
 #ifdef USE_UINPUT
 
-// Press modifiers with timing
-static YAError press_modifiers_unified(unsigned mods_mask, bool user_alt, bool* pressed_state) {
-    // pressed_state[0]=Shift, [1]=AltGr, [2]=Ctrl, [3]=Meta, [4]=Alt
-    memset(pressed_state, 0, 5 * sizeof(bool));
-    
+// Modifier presses, each followed by a step delay
+// pressed[0]=Shift, [1]=AltGr, [2]=Ctrl, [3]=Meta, [4]=Alt
+static void add_modifiers_unified(key_program_t* program, unsigned mods_mask, bool user_alt, int* pressed) {
+    for (int i = 0; i < 5; i++) pressed[i] = -1;
+
     if (mods_mask & (1 << 0)) { // Shift
-        YA_LOG_DEBUG("Pressing Shift modifier");
-        YAError err = input_key_action(Shift, Press);
-        if (err != Success) {
-            YA_LOG_ERROR("Failed to press Shift: error %d", err);
-            return err;
-        }
-        pressed_state[0] = true;
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+        pressed[0] = key_program_add(program, KEY_STEP_KEY, Shift, Press, true);
     }
-    
     if (mods_mask & (1 << 1)) { // AltGr → RightAlt
-        int result = input_linux_key_action_raw(KEY_RIGHTALT, Press);
-        if (result != INPUT_BACKEND_OK) {
-            if (pressed_state[0]) input_key_action(Shift, Release);
-            return PlatformError;
-        }
-        pressed_state[1] = true;
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+        pressed[1] = key_program_add(program, KEY_STEP_RAW, KEY_RIGHTALT, Press, true);
     }
-    
     if (mods_mask & (1 << 2)) { // Ctrl
-        YAError err = input_key_action(Control, Press);
-        if (err != Success) {
-            if (pressed_state[1]) input_linux_key_action_raw(KEY_RIGHTALT, Release);
-            if (pressed_state[0]) input_key_action(Shift, Release);
-            return err;
-        }
-        pressed_state[2] = true;
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+        pressed[2] = key_program_add(program, KEY_STEP_KEY, Control, Press, true);
     }
-    
     if (mods_mask & (1 << 3)) { // Meta
-        YAError err = input_key_action(Meta, Press);
-        if (err != Success) {
-            if (pressed_state[2]) input_key_action(Control, Release);
-            if (pressed_state[1]) input_linux_key_action_raw(KEY_RIGHTALT, Release);
-            if (pressed_state[0]) input_key_action(Shift, Release);
-            return err;
-        }
-        pressed_state[3] = true;
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+        pressed[3] = key_program_add(program, KEY_STEP_KEY, Meta, Press, true);
     }
-    
     if (user_alt) { // User-requested Alt
-        YAError err = input_key_action(Alt, Press);
-        if (err != Success) {
-            if (pressed_state[3]) input_key_action(Meta, Release);
-            if (pressed_state[2]) input_key_action(Control, Release);
-            if (pressed_state[1]) input_linux_key_action_raw(KEY_RIGHTALT, Release);
-            if (pressed_state[0]) input_key_action(Shift, Release);
-            return err;
-        }
-        pressed_state[4] = true;
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+        pressed[4] = key_program_add(program, KEY_STEP_KEY, Alt, Press, true);
     }
-    
-    return Success;
 }
 
-// Release modifiers in reverse order
-static void release_modifiers_unified(const bool* pressed_state) {
-    if (pressed_state[4]) { // Alt
-        input_key_action(Alt, Release);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
-    }
-    if (pressed_state[3]) { // Meta
-        input_key_action(Meta, Release);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
-    }
-    if (pressed_state[2]) { // Ctrl
-        input_key_action(Control, Release);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
-    }
-    if (pressed_state[1]) { // AltGr
-        input_linux_key_action_raw(KEY_RIGHTALT, Release);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
-    }
-    if (pressed_state[0]) { // Shift
-        input_key_action(Shift, Release);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
-    }
-}
+// Linux character program with unified modifier handling
+// Returns NotFound (with fallback_utf8 set) when xkb has no mapping for the codepoint
+static YAError compile_char(int32_t codepoint, uint32_t user_mods, enum CDirection dir, key_program_t* program) {
+    key_program_init(program);
+    encode_codepoint_to_utf8(codepoint, program->fallback_utf8);
 
-// Linux character injection with unified modifier handling
-static YAError input_char_linux_unified(int32_t codepoint, uint32_t user_mods, enum CDirection dir) {
     int evdev_key = 0;
     unsigned xkb_mods = 0;
-    
-    // Try xkb mapping
-    YAError map_result = map_char_to_evdev_linux(codepoint, &evdev_key, &xkb_mods);
-    
-    if (map_result == Success) {
-        // Merge user and xkb modifiers
-        unsigned final_mods = merge_modifiers(user_mods, xkb_mods);
-        bool user_alt = (user_mods & CHORD_MOD_ALT) != 0;
-        
-        YA_LOG_DEBUG("Injecting U+%04X: user_mods=0x%X, xkb_mods=0x%X, final_mods=0x%X, evdev=%d",
-                     codepoint, user_mods, xkb_mods, final_mods, evdev_key);
-        
-        // Press modifiers
-        bool pressed_state[5];
-        YAError err = press_modifiers_unified(final_mods, user_alt, pressed_state);
-        if (err != Success) {
-            // Fallback to clipboard if modifier press fails
-            char utf8[5] = {0};
-            encode_codepoint_to_utf8(codepoint, utf8);
-            return clipboard_paste_text(utf8);
-        }
-        
-        // Inject main key
-        // When modifiers are present and direction is Click, split into Press+Release
-        // to ensure proper modifier registration
-        YA_LOG_DEBUG("Injecting main key: evdev=%d, dir=%d", evdev_key, dir);
-        int result;
-        if (dir == Click && final_mods != 0) {
-            // Press main key
-            result = input_linux_key_action_raw(evdev_key, Press);
-            if (result == INPUT_BACKEND_OK) {
-                ya_key_sleep_ms(YA_KEY_DELAY_MS);
-                // Release main key
-                result = input_linux_key_action_raw(evdev_key, Release);
-            }
-        } else {
-            // Normal injection without modifiers
-            result = input_linux_key_action_raw(evdev_key, dir);
-        }
-        YA_LOG_DEBUG("Main key injection result: %d", result);
-        
-        // Release modifiers
-        release_modifiers_unified(pressed_state);
-        
-        if (result != INPUT_BACKEND_OK) {
-            YA_LOG_ERROR("xkb inject failed for U+%04X (evdev %d): backend error %d", codepoint, evdev_key, result);
-            // Fallback to clipboard
-            char utf8[5] = {0};
-            encode_codepoint_to_utf8(codepoint, utf8);
-            return clipboard_paste_text(utf8);
-        }
-        
-        return Success;
+    if (map_char_to_evdev_linux(codepoint, &evdev_key, &xkb_mods) != Success) {
+        // xkb mapping miss → clipboard fallback
+        return NotFound;
     }
-    
-    // xkb mapping miss → clipboard fallback
-    char utf8[5] = {0};
-    encode_codepoint_to_utf8(codepoint, utf8);
-    return clipboard_paste_text(utf8);
-}
 
-// Linux function key with modifiers
-static YAError input_function_key_linux(enum CKey key, uint32_t user_mods, enum CDirection dir) {
+    // Merge user and xkb modifiers
+    unsigned final_mods = merge_modifiers(user_mods, xkb_mods);
     bool user_alt = (user_mods & CHORD_MOD_ALT) != 0;
+
+    YA_LOG_DEBUG("Injecting U+%04X: user_mods=0x%X, xkb_mods=0x%X, final_mods=0x%X, evdev=%d",
+                 codepoint, user_mods, xkb_mods, final_mods, evdev_key);
+
+    int pressed[5];
+    add_modifiers_unified(program, final_mods, user_alt, pressed);
+
+    // When modifiers are present and direction is Click, split into Press+Release
+    // to ensure proper modifier registration
+    if (dir == Click && final_mods != 0) {
+        int main_key = key_program_add(program, KEY_STEP_RAW, (uint32_t)evdev_key, Press, true);
+        key_program_add_release(program, main_key, false);
+    } else {
+        key_program_add(program, KEY_STEP_RAW, (uint32_t)evdev_key, dir, false);
+    }
+
+    add_releases(program, pressed, 5);
+    return Success;
+}
+
+// Linux function key program with modifiers
+static YAError compile_function_key(enum CKey key, uint32_t user_mods, enum CDirection dir, key_program_t* program) {
+    key_program_init(program);
+
     unsigned mods_mask = 0;
-    
     if (user_mods & CHORD_MOD_SHIFT) mods_mask |= (1 << 0);
     if (user_mods & CHORD_MOD_CTRL) mods_mask |= (1 << 2);
     if (user_mods & CHORD_MOD_META) mods_mask |= (1 << 3);
-    
-    bool pressed_state[5];
-    YAError err = press_modifiers_unified(mods_mask, user_alt, pressed_state);
-    if (err != Success) return err;
-    
-    // Inject function key
-    err = input_key_action(key, dir);
-    
-    // Release modifiers
-    release_modifiers_unified(pressed_state);
-    
-    return err;
+
+    int pressed[5];
+    add_modifiers_unified(program, mods_mask, (user_mods & CHORD_MOD_ALT) != 0, pressed);
+    key_program_add(program, KEY_STEP_KEY, key, dir, false);
+    add_releases(program, pressed, 5);
+    return Success;
 }
 
 #else // Non-Linux
 
-// Non-Linux character injection
-static YAError input_char_unified(int32_t codepoint, uint32_t user_mods, enum CDirection dir) {
-    uint32_t platform_code = 0;
-    bool platform_shift = false;
-    
-    // Try platform mapping
-    if (map_char_to_platform(codepoint, &platform_code, &platform_shift) == Success) {
-        
-        // Press user modifiers
-        if (user_mods & CHORD_MOD_SHIFT) {
-            input_key_action(Shift, Press);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        if (user_mods & CHORD_MOD_CTRL) {
-            input_key_action(Control, Press);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        if (user_mods & CHORD_MOD_ALT) {
-            input_key_action(Alt, Press);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        if (user_mods & CHORD_MOD_META) {
-            input_key_action(Meta, Press);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        
-        // Press platform shift if needed (and not already pressed)
-        if (platform_shift && !(user_mods & CHORD_MOD_SHIFT)) {
-            input_key_action(Shift, Press);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        
-        // Inject key
-        YAError err = key_action_with_platform_code(platform_code, dir);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        
-        // Release modifiers in reverse
-        if (platform_shift && !(user_mods & CHORD_MOD_SHIFT)) {
-            input_key_action(Shift, Release);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        if (user_mods & CHORD_MOD_META) {
-            input_key_action(Meta, Release);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        if (user_mods & CHORD_MOD_ALT) {
-            input_key_action(Alt, Release);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        if (user_mods & CHORD_MOD_CTRL) {
-            input_key_action(Control, Release);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        if (user_mods & CHORD_MOD_SHIFT) {
-            input_key_action(Shift, Release);
-            ya_key_sleep_ms(YA_KEY_DELAY_MS);
-        }
-        
-        return err;
-    }
-    
-    // Fallback to unicode
-    return key_unicode_action(codepoint, dir);
-}
+// User modifier presses, each followed by a step delay
+// pressed[0]=Shift, [1]=Ctrl, [2]=Alt, [3]=Meta
+static void add_user_modifiers(key_program_t* program, uint32_t user_mods, int* pressed) {
+    for (int i = 0; i < 4; i++) pressed[i] = -1;
 
-// Non-Linux function key
-static YAError input_function_key(enum CKey key, uint32_t user_mods, enum CDirection dir) {
     if (user_mods & CHORD_MOD_SHIFT) {
-        input_key_action(Shift, Press);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+        pressed[0] = key_program_add(program, KEY_STEP_KEY, Shift, Press, true);
     }
     if (user_mods & CHORD_MOD_CTRL) {
-        input_key_action(Control, Press);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+        pressed[1] = key_program_add(program, KEY_STEP_KEY, Control, Press, true);
     }
     if (user_mods & CHORD_MOD_ALT) {
-        input_key_action(Alt, Press);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+        pressed[2] = key_program_add(program, KEY_STEP_KEY, Alt, Press, true);
     }
     if (user_mods & CHORD_MOD_META) {
-        input_key_action(Meta, Press);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
-    }
-    
-    YAError err = input_key_action(key, dir);
-    ya_key_sleep_ms(YA_KEY_DELAY_MS);
-    
-    if (user_mods & CHORD_MOD_META) {
-        input_key_action(Meta, Release);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
-    }
-    if (user_mods & CHORD_MOD_ALT) {
-        input_key_action(Alt, Release);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+        pressed[3] = key_program_add(program, KEY_STEP_KEY, Meta, Press, true);
     }
-    if (user_mods & CHORD_MOD_CTRL) {
-        input_key_action(Control, Release);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+}
+
+// Non-Linux character program
+static YAError compile_char(int32_t codepoint, uint32_t user_mods, enum CDirection dir, key_program_t* program) {
+    key_program_init(program);
+
+    uint32_t platform_code = 0;
+    bool platform_shift = false;
+    if (map_char_to_platform(codepoint, &platform_code, &platform_shift) != Success) {
+        // Fallback to unicode
+        key_program_add(program, KEY_STEP_UNICODE, (uint32_t)codepoint, dir, false);
+        program->release_from = program->count;
+        return Success;
     }
-    if (user_mods & CHORD_MOD_SHIFT) {
-        input_key_action(Shift, Release);
-        ya_key_sleep_ms(YA_KEY_DELAY_MS);
+
+    // pressed[4] = platform shift (if needed and not already pressed)
+    int pressed[5];
+    add_user_modifiers(program, user_mods, pressed);
+    pressed[4] = -1;
+    if (platform_shift && !(user_mods & CHORD_MOD_SHIFT)) {
+        pressed[4] = key_program_add(program, KEY_STEP_KEY, Shift, Press, true);
     }
-    
-    return err;
+
+    key_program_add(program, KEY_STEP_PLATFORM, platform_code, dir, true);
+    add_releases(program, pressed, 5);
+    return Success;
+}
+
+// Non-Linux function key program
+static YAError compile_function_key(enum CKey key, uint32_t user_mods, enum CDirection dir, key_program_t* program) {
+    key_program_init(program);
+
+    int pressed[4];
+    add_user_modifiers(program, user_mods, pressed);
+    key_program_add(program, KEY_STEP_KEY, key, dir, true);
+    add_releases(program, pressed, 4);
+    return Success;
 }
 
 #endif
 
 // ============================================================================
-// Public API
+// Latched modifiers (bulk typing)
 // ============================================================================
 
-YAError keyboard_char(int32_t codepoint, uint32_t mods, enum CDirection dir) {
-    ya_key_lock();
-    
+// Modifier slots use the merge_modifiers bits plus bit 4 for Alt:
+// 0=Shift, 1=AltGr, 2=Ctrl, 3=Meta, 4=Alt
+#define MOD_SLOT_COUNT 5
+#define MOD_SLOT_ALT (1u << 4)
+
+static const struct {
+    key_step_kind_t kind;
+    uint32_t code;
+} k_mod_slots[MOD_SLOT_COUNT] = {
+    {KEY_STEP_KEY, Shift},
 #ifdef USE_UINPUT
-    YAError err = input_char_linux_unified(codepoint, mods, dir);
+    {KEY_STEP_RAW, KEY_RIGHTALT},
 #else
-    YAError err = input_char_unified(codepoint, mods, dir);
+    {KEY_STEP_KEY, RMenu}, // AltGr is never requested off Linux
 #endif
-    
-    ya_key_unlock();
-    return err;
+    {KEY_STEP_KEY, Control},
+    {KEY_STEP_KEY, Meta},
+    {KEY_STEP_KEY, Alt},
+};
+
+// Modifiers held down across consecutive characters; only touched by the injection thread
+static struct {
+    uint32_t owner;   // uid of the client whose characters hold the latch (0 = none)
+    unsigned held;    // latched modifier slots
+    uint64_t last_ms; // last character submitted with the latch
+} g_latch;
+
+// Set by the sequencer when a latched program fails; the physical modifier state is unknown
+static atomic_bool g_latch_stale;
+
+static uint64_t latch_now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000ull + (uint64_t)now.tv_nsec / 1000000ull;
 }
 
-YAError keyboard_function_key(enum CKey key, uint32_t mods, enum CDirection dir) {
-    ya_key_lock();
-    
+static void add_latch_releases(key_program_t* program, unsigned mask);
+
+// Runs before the clipboard fallback of a failed latched program: latched programs have no
+// release phase, so release every modifier slot first or the paste chord picks up the held
+// Shift/AltGr (Ctrl+Shift+V). The next character presses its modifiers again.
+static void latch_failed(void) {
+    key_program_t program;
+    key_program_init(&program);
+    add_latch_releases(&program, (1u << MOD_SLOT_COUNT) - 1);
+    key_sequencer_run_sync(&program);
+    atomic_store(&g_latch_stale, true);
+}
+
+// Modifier slots to release and press to go from the latched state to want
+static void latch_transition(unsigned want, unsigned* release, unsigned* press) {
+    if (atomic_exchange(&g_latch_stale, false)) {
+        // Physical state unknown: release everything and press again
+        *release = (1u << MOD_SLOT_COUNT) - 1;
+        *press = want;
+    } else {
+        *release = g_latch.held & ~want;
+        *press = want & ~g_latch.held;
+    }
+}
+
+// Release transitions for slots in mask, reverse slot order
+static void add_latch_releases(key_program_t* program, unsigned mask) {
+    for (int slot = MOD_SLOT_COUNT - 1; slot >= 0; slot--) {
+        if (mask & (1u << slot)) {
+            key_program_add(program, k_mod_slots[slot].kind, k_mod_slots[slot].code, Release, true);
+        }
+    }
+}
+
+// Resolve a character to its main key step and required modifier slots
+// Returns NotFound when the character has no key mapping
+static YAError resolve_char(int32_t codepoint, uint32_t user_mods, key_step_kind_t* kind, uint32_t* code,
+                            unsigned* mods) {
 #ifdef USE_UINPUT
-    YAError err = input_function_key_linux(key, mods, dir);
+    int evdev_key = 0;
+    unsigned xkb_mods = 0;
+    if (map_char_to_evdev_linux(codepoint, &evdev_key, &xkb_mods) != Success) {
+        return NotFound;
+    }
+    *kind = KEY_STEP_RAW;
+    *code = (uint32_t)evdev_key;
+    *mods = merge_modifiers(user_mods, xkb_mods);
 #else
-    YAError err = input_function_key(key, mods, dir);
+    uint32_t platform_code = 0;
+    bool platform_shift = false;
+    if (map_char_to_platform(codepoint, &platform_code, &platform_shift) != Success) {
+        return NotFound;
+    }
+    *kind = KEY_STEP_PLATFORM;
+    *code = platform_code;
+    *mods = 0;
+    if ((user_mods & CHORD_MOD_SHIFT) || platform_shift) *mods |= (1u << 0);
+    if (user_mods & CHORD_MOD_CTRL) *mods |= (1u << 2);
+    if (user_mods & CHORD_MOD_META) *mods |= (1u << 3);
 #endif
-    
-    ya_key_unlock();
-    return err;
+    if (user_mods & CHORD_MOD_ALT) *mods |= MOD_SLOT_ALT;
+    return Success;
+}
+
+void keyboard_release_latched(uint32_t owner) {
+    if (owner != 0 && owner != g_latch.owner) {
+        return;
+    }
+
+    unsigned release = 0, press = 0;
+    latch_transition(0, &release, &press);
+    g_latch.owner = 0;
+    g_latch.held = 0;
+    if (release == 0) {
+        return;
+    }
+
+    key_program_t program;
+    key_program_init(&program);
+    add_latch_releases(&program, release);
+    key_sequencer_submit(&program);
+}
+
+int keyboard_latch_poll(void) {
+    if (g_latch.held == 0 && !atomic_load(&g_latch_stale)) {
+        return -1;
+    }
+
+    uint64_t idle = latch_now_ms() - g_latch.last_ms;
+    if (idle >= KEY_LATCH_IDLE_MS) {
+        YA_LOG_TRACE("Releasing latched modifiers after %llu ms idle", (unsigned long long)idle);
+        keyboard_release_latched(0);
+        return -1;
+    }
+    return (int)(KEY_LATCH_IDLE_MS - idle);
+}
+
+// Append a compiled program to the sequencer timeline
+static YAError submit_program(YAError compiled, const key_program_t* program) {
+    if (compiled == NotFound) {
+        // The paste must not overtake keys still on the timeline
+        key_sequencer_flush();
+        return clipboard_paste_text(program->fallback_utf8);
+    }
+    return key_sequencer_submit(program);
+}
+
+// Compile a character and append it to the timeline with the full modifier cycle
+static YAError submit_char(int32_t codepoint, uint32_t mods, enum CDirection dir) {
+    key_program_t program;
+    YAError compiled = compile_char(codepoint, mods, dir, &program);
+    return submit_program(compiled, &program);
+}
+
+YAError keyboard_char_latched(uint32_t owner, int32_t codepoint, uint32_t mods, enum CDirection dir) {
+    key_step_kind_t kind;
+    uint32_t code = 0;
+    unsigned want = 0;
+    if (dir != Click || resolve_char(codepoint, mods, &kind, &code, &want) != Success) {
+        // Explicit press/release and unmapped characters take the full cycle
+        keyboard_release_latched(0);
+        return submit_char(codepoint, mods, dir);
+    }
+
+    unsigned release = 0, press = 0;
+    latch_transition(want, &release, &press);
+
+    key_program_t program;
+    key_program_init(&program);
+#ifdef USE_UINPUT
+    encode_codepoint_to_utf8(codepoint, program.fallback_utf8);
+#endif
+    program.on_failure = latch_failed;
+
+    // Only transition the modifiers that changed since the previous character
+    add_latch_releases(&program, release);
+    for (int slot = 0; slot < MOD_SLOT_COUNT; slot++) {
+        if (press & (1u << slot)) {
+            key_program_add(&program, k_mod_slots[slot].kind, k_mod_slots[slot].code, Press, true);
+        }
+    }
+
+    if (want != 0) {
+        // Split Click into Press+Release so the latched modifiers register
+        int main_key = key_program_add(&program, kind, code, Press, true);
+        key_program_add_release(&program, main_key, false);
+    } else {
+        key_program_add(&program, kind, code, Click, false);
+    }
+    program.release_from = program.count;
+
+    g_latch.owner = owner;
+    g_latch.held = want;
+    g_latch.last_ms = latch_now_ms();
+    return key_sequencer_submit(&program);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+YAError keyboard_function_key_submit(enum CKey key, uint32_t mods, enum CDirection dir) {
+    key_program_t program;
+    YAError compiled = compile_function_key(key, mods, dir, &program);
+    return submit_program(compiled, &program);
 }
@@ -9,22 +9,39 @@ extern "C" {
 #endif
 
 /**
- * Keyboard character input handler
- * @param codepoint Unicode codepoint
+ * Function key input: compile the key into a step program and append it to the
+ * key sequencer timeline (see sequencer.h). Steps run as they become due on the
+ * thread that drives key_sequencer_run_due().
+ * @param key Function key (CKey enum)
  * @param mods Modifier bitmask (CHORD_MOD_SHIFT | CHORD_MOD_CTRL | ...)
  * @param dir Direction (Press, Release, Click)
- * @return YAError status code
+ * @return Success once queued
  */
-YAError keyboard_char(int32_t codepoint, uint32_t mods, enum CDirection dir);
+YAError keyboard_function_key_submit(enum CKey key, uint32_t mods, enum CDirection dir);
+
+// Latched modifiers are released after this long without a latched character (ms)
+#define KEY_LATCH_IDLE_MS 200
 
 /**
- * Keyboard function key handler
- * @param key Function key (CKey enum)
- * @param mods Modifier bitmask (CHORD_MOD_SHIFT | CHORD_MOD_CTRL | ...)
- * @param dir Direction (Press, Release, Click)
- * @return YAError status code
+ * Latched character input for streams of characters (injection thread only).
+ * Modifiers stay held across consecutive characters and only the ones that change are
+ * pressed or released, e.g. a run of capitals presses Shift once.
+ * @param owner uid of the client typing; used to release its latch on disconnect
+ * @return Success once queued, or the clipboard fallback result for unmapped characters
+ */
+YAError keyboard_char_latched(uint32_t owner, int32_t codepoint, uint32_t mods, enum CDirection dir);
+
+/**
+ * Release latched modifiers
+ * @param owner Only release if held by this client uid (0 = whoever holds them)
+ */
+void keyboard_release_latched(uint32_t owner);
+
+/**
+ * Release latched modifiers once they have been idle for KEY_LATCH_IDLE_MS
+ * @return ms until the idle deadline, or -1 when nothing is latched
  */
-YAError keyboard_function_key(enum CKey key, uint32_t mods, enum CDirection dir);
+int keyboard_latch_poll(void);
 
 #ifdef __cplusplus
 }
@@ -69,31 +69,13 @@
 // ============================================================================
 
 YAError map_char_to_evdev_linux(int32_t codepoint, int* evdev_key, unsigned* mods_mask) {
-    // UTF-8 encode
-    char utf8[5] = {0};
-    if (codepoint > 0 && codepoint < 0x80) {
-        utf8[0] = (char)codepoint;
-    } else if (codepoint < 0x800) {
-        utf8[0] = (char)(0xC0 | (codepoint >> 6));
-        utf8[1] = (char)(0x80 | (codepoint & 0x3F));
-    } else if (codepoint < 0x10000) {
-        utf8[0] = (char)(0xE0 | (codepoint >> 12));
-        utf8[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
-        utf8[2] = (char)(0x80 | (codepoint & 0x3F));
-    } else if (codepoint < 0x110000) {
-        utf8[0] = (char)(0xF0 | (codepoint >> 18));
-        utf8[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
-        utf8[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
-        utf8[3] = (char)(0x80 | (codepoint & 0x3F));
-    }
-    
-    if (utf8[0] == '\0') {
-        YA_LOG_ERROR("Invalid codepoint for UTF-8 encoding: %d", codepoint);
+    if (codepoint <= 0 || codepoint >= 0x110000) {
+        YA_LOG_ERROR("Invalid codepoint: %d", codepoint);
         return InvalidInput;
     }
     
-    // Try xkb mapping
-    if (xkbmap_map_utf8_to_evdev(utf8, evdev_key, mods_mask)) {
+    // Try xkb mapping (direct code point lookup, no UTF-8 round trip)
+    if (xkbmap_map_codepoint((uint32_t)codepoint, evdev_key, mods_mask)) {
         YA_LOG_DEBUG("xkb mapped U+%04X ('%c') → evdev=%d, mods=0x%X", 
                      codepoint, (codepoint >= 0x20 && codepoint < 0x7F) ? (char)codepoint : '?',
                      *evdev_key, *mods_mask);
@@ -0,0 +1,298 @@
+// Keystroke sequencer - timed step programs instead of inline sleeps
+#include "input/keyboard/sequencer.h"
+#include "input/facade.h"
+#include "input/keyboard/clipboard.h"
+#include "ya_config.h"
+#include "ya_logger.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef USE_UINPUT
+#include "input/backend/linux_uinput.h"
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// External config
+extern YA_Config config;
+
+typedef struct {
+    key_program_t program;
+    int cursor;     // next step to run
+    uint32_t done;  // bitmask of steps that succeeded
+    bool failed;    // a press/main step failed, only the release phase still runs
+} key_run_t;
+
+static YAError execute_step(const key_step_t *step);
+
+static int g_step_delay_ms = KEY_STEP_DEFAULT_DELAY_MS;
+static key_step_fn g_execute = execute_step;
+
+// Timeline of submitted programs (ring), protected by g_lock
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static key_run_t g_timeline[KEY_SEQUENCER_CAPACITY];
+static size_t g_head = 0;
+static size_t g_count = 0;
+static uint64_t g_next_due_ms = 0; // earliest time the next step may run
+static atomic_size_t g_pending;    // mirrors g_count for lock-free idle checks
+
+// Steps run on the injection thread and, for run_sync, on the caller's thread
+static atomic_uint_least64_t g_step_errors[KEY_STEP_ERROR_SLOTS];
+
+static uint64_t now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000ull + (uint64_t)now.tv_nsec / 1000000ull;
+}
+
+static void sleep_ms(int ms) {
+    if (ms <= 0) return;
+#if defined(_WIN32)
+    Sleep(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
+static YAError execute_step(const key_step_t *step) {
+    switch (step->kind) {
+    case KEY_STEP_KEY:
+        return input_key_action((enum CKey)step->code, step->dir);
+    case KEY_STEP_RAW:
+#ifdef USE_UINPUT
+        return input_linux_key_action_raw((int)step->code, step->dir) == INPUT_BACKEND_OK ? Success : PlatformError;
+#else
+        return UnsupportedOperation;
+#endif
+    case KEY_STEP_PLATFORM:
+        return key_action_with_platform_code(step->code, step->dir);
+    case KEY_STEP_UNICODE:
+        return key_unicode_action(step->code, step->dir);
+    }
+    return InvalidInput;
+}
+
+void key_sequencer_init(void) {
+    // Read [input].key_step_delay_ms
+    const char* delay_str = ya_config_get(&config, "input", "key_step_delay_ms");
+    if (delay_str) {
+        char* end = NULL;
+        long delay = strtol(delay_str, &end, 10);
+        if (end != delay_str && *end == '\0' && delay >= 0 && delay <= KEY_STEP_MAX_DELAY_MS) {
+            g_step_delay_ms = (int)delay;
+        } else {
+            YA_LOG_WARN("Invalid [input] key_step_delay_ms '%s', using %d", delay_str, KEY_STEP_DEFAULT_DELAY_MS);
+            g_step_delay_ms = KEY_STEP_DEFAULT_DELAY_MS;
+        }
+    }
+
+    YA_LOG_INFO("Key sequencer initialized: step delay=%d ms", g_step_delay_ms);
+}
+
+int key_sequencer_step_delay_ms(void) {
+    return g_step_delay_ms;
+}
+
+void key_sequencer_set_step_delay_ms(int delay_ms) {
+    if (delay_ms < 0) delay_ms = 0;
+    if (delay_ms > KEY_STEP_MAX_DELAY_MS) delay_ms = KEY_STEP_MAX_DELAY_MS;
+    g_step_delay_ms = delay_ms;
+}
+
+void key_sequencer_set_executor(key_step_fn fn) {
+    g_execute = fn ? fn : execute_step;
+}
+
+// ============================================================================
+// Program builders
+// ============================================================================
+
+void key_program_init(key_program_t *program) {
+    memset(program, 0, sizeof(*program));
+}
+
+int key_program_add(key_program_t *program, key_step_kind_t kind, uint32_t code, enum CDirection dir,
+                    bool delay_after) {
+    if (program->count >= KEY_PROGRAM_MAX_STEPS) {
+        return -1;
+    }
+    int index = program->count++;
+    program->steps[index] = (key_step_t){
+        .kind = kind,
+        .code = code,
+        .dir = dir,
+        .delay_after = delay_after,
+        .press_step = -1,
+    };
+    return index;
+}
+
+int key_program_add_release(key_program_t *program, int press_step, bool delay_after) {
+    if (press_step < 0 || press_step >= program->count) {
+        return -1;
+    }
+    const key_step_t *press = &program->steps[press_step];
+    int index = key_program_add(program, press->kind, press->code, Release, delay_after);
+    if (index >= 0) {
+        program->steps[index].press_step = (int8_t)press_step;
+    }
+    return index;
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+// Run the step under the cursor and advance; *next_due_ms is pushed out by the step delay
+static void run_step(key_run_t *run, uint64_t *next_due_ms) {
+    const key_program_t *program = &run->program;
+    const key_step_t *step = &program->steps[run->cursor];
+    int index = run->cursor++;
+
+    if (step->press_step >= 0 && !(run->done & (1u << step->press_step))) {
+        return; // matching press never happened
+    }
+
+    YAError err = g_execute(step);
+    if (err == Success) {
+        run->done |= 1u << index;
+    } else {
+        if (err < 0 && -err < KEY_STEP_ERROR_SLOTS) {
+            atomic_fetch_add_explicit(&g_step_errors[-err], 1, memory_order_relaxed);
+        }
+        YA_LOG_ERROR("Key step %d failed (kind=%d, code=%u, dir=%d): error %d", index, (int)step->kind,
+                     step->code, (int)step->dir, err);
+        if (index < program->release_from) {
+            // Skip the rest of the press phase, release whatever was pressed
+            run->failed = true;
+            run->cursor = program->release_from;
+        }
+    }
+
+    *next_due_ms = now_ms() + (step->delay_after ? (uint64_t)g_step_delay_ms : 0);
+}
+
+static void finish_run(const key_run_t *run) {
+    if (!run->failed) {
+        return;
+    }
+    if (run->program.on_failure) {
+        run->program.on_failure();
+    }
+    if (run->program.fallback_utf8[0] != '\0') {
+        clipboard_paste_text(run->program.fallback_utf8);
+    }
+}
+
+static bool valid_program(const key_program_t *program) {
+    return program && program->count > 0 && program->count <= KEY_PROGRAM_MAX_STEPS &&
+           program->release_from >= 0 && program->release_from <= program->count;
+}
+
+int key_sequencer_run_due(void) {
+    int wait_ms = -1;
+
+    pthread_mutex_lock(&g_lock);
+    while (g_count > 0) {
+        key_run_t *run = &g_timeline[g_head];
+        if (run->cursor >= run->program.count) {
+            finish_run(run);
+            g_head = (g_head + 1) % KEY_SEQUENCER_CAPACITY;
+            g_count--;
+            atomic_store(&g_pending, g_count);
+            continue;
+        }
+
+        uint64_t now = now_ms();
+        if (g_next_due_ms > now) {
+            wait_ms = (int)(g_next_due_ms - now);
+            break;
+        }
+        run_step(run, &g_next_due_ms);
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    return wait_ms;
+}
+
+YAError key_sequencer_submit(const key_program_t *program) {
+    if (!valid_program(program)) {
+        return InvalidInput;
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&g_lock);
+        if (g_count < KEY_SEQUENCER_CAPACITY) {
+            key_run_t *run = &g_timeline[(g_head + g_count) % KEY_SEQUENCER_CAPACITY];
+            memset(run, 0, sizeof(*run));
+            run->program = *program;
+            g_count++;
+            atomic_store(&g_pending, g_count);
+            pthread_mutex_unlock(&g_lock);
+            break;
+        }
+        pthread_mutex_unlock(&g_lock);
+
+        // Timeline full: make room by running the oldest program
+        sleep_ms(key_sequencer_run_due());
+    }
+
+    key_sequencer_run_due();
+    return Success;
+}
+
+void key_sequencer_flush(void) {
+    int wait_ms;
+    while ((wait_ms = key_sequencer_run_due()) >= 0) {
+        sleep_ms(wait_ms);
+    }
+}
+
+bool key_sequencer_idle(void) {
+    return atomic_load(&g_pending) == 0;
+}
+
+size_t key_sequencer_depth(void) {
+    return atomic_load_explicit(&g_pending, memory_order_relaxed);
+}
+
+uint64_t key_sequencer_step_errors(YAError code) {
+    if (code >= 0 || -code >= KEY_STEP_ERROR_SLOTS) {
+        return 0;
+    }
+    return atomic_load_explicit(&g_step_errors[-code], memory_order_relaxed);
+}
+
+YAError key_sequencer_run_sync(const key_program_t *program) {
+    if (!valid_program(program)) {
+        return InvalidInput;
+    }
+
+    key_run_t run = {.program = *program};
+    uint64_t next_due_ms = 0;
+    while (run.cursor < run.program.count) {
+        uint64_t now = now_ms();
+        if (next_due_ms > now) {
+            sleep_ms((int)(next_due_ms - now));
+        }
+        run_step(&run, &next_due_ms);
+    }
+
+    // Honor the delay after the last step so back-to-back synchronous programs stay spaced
+    uint64_t now = now_ms();
+    if (next_due_ms > now) {
+        sleep_ms((int)(next_due_ms - now));
+    }
+
+    if (run.failed && run.program.on_failure) {
+        run.program.on_failure();
+    }
+    return run.failed ? PlatformError : Success;
+}
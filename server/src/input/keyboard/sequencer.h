@@ -0,0 +1,119 @@
+#ifndef KEY_SEQUENCER_H
+#define KEY_SEQUENCER_H
+
+#include "rs.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Keystroke sequencer
+ *
+ * A chord or character is compiled into a step program (press Shift, +delay press A, ...).
+ * Submitted programs are appended to a timeline and executed step by step when each step
+ * becomes due, so the caller never sleeps between key steps. Consecutive programs pipeline:
+ * the first step of the next program is due one step delay after the last step of the
+ * previous one, not after a fresh wait.
+ */
+
+// Maximum steps in one program (5 modifiers pressed + main key press/release + 5 released)
+#define KEY_PROGRAM_MAX_STEPS 16
+
+// Programs waiting on the timeline
+#define KEY_SEQUENCER_CAPACITY 64
+
+// Default delay between key steps (ms), [input] key_step_delay_ms
+#define KEY_STEP_DEFAULT_DELAY_MS 10
+#define KEY_STEP_MAX_DELAY_MS 1000
+
+// Failed steps are counted per backend error code: slot -code for PlatformError..NotFound
+#define KEY_STEP_ERROR_SLOTS 6
+
+typedef enum {
+    KEY_STEP_KEY = 0,      // input_key_action(CKey)
+    KEY_STEP_RAW = 1,      // input_linux_key_action_raw(evdev code), uinput only
+    KEY_STEP_PLATFORM = 2, // key_action_with_platform_code(platform code)
+    KEY_STEP_UNICODE = 3,  // key_unicode_action(codepoint)
+} key_step_kind_t;
+
+typedef struct {
+    key_step_kind_t kind;
+    uint32_t code;       // CKey / evdev code / platform code / codepoint, depending on kind
+    enum CDirection dir;
+    bool delay_after;    // wait one step delay before the next step
+    int8_t press_step;   // for releases: index of the matching press, skipped if that press failed (-1 = always run)
+} key_step_t;
+
+typedef struct {
+    key_step_t steps[KEY_PROGRAM_MAX_STEPS];
+    int count;
+    int release_from;      // first step of the release phase; still runs after a failure
+    char fallback_utf8[5]; // pasted via clipboard when the program fails ("" = no fallback)
+    void (*on_failure)(void); // called when the program fails, before the fallback (NULL = none)
+} key_program_t;
+
+// Executes one step; tests replace it to record the timeline
+typedef YAError (*key_step_fn)(const key_step_t *step);
+
+/**
+ * Initialize sequencer with configuration from ya_config
+ * Reads [input] section: key_step_delay_ms
+ */
+void key_sequencer_init(void);
+
+// Current delay between key steps (ms), 0 = no waits
+int key_sequencer_step_delay_ms(void);
+void key_sequencer_set_step_delay_ms(int delay_ms);
+
+// Replace the step executor (NULL restores the default input backend)
+void key_sequencer_set_executor(key_step_fn fn);
+
+// Program builders
+void key_program_init(key_program_t *program);
+// Appends a step, returns its index or -1 when the program is full
+int key_program_add(key_program_t *program, key_step_kind_t kind, uint32_t code, enum CDirection dir,
+                    bool delay_after);
+// Appends a release paired with press_step (skipped if that press did not succeed)
+int key_program_add_release(key_program_t *program, int press_step, bool delay_after);
+
+/**
+ * Append a program to the timeline and run any steps that are already due.
+ * Only waits when the timeline is full.
+ */
+YAError key_sequencer_submit(const key_program_t *program);
+
+/**
+ * Run all due steps
+ * @return ms until the next step is due, or -1 when the timeline is empty
+ */
+int key_sequencer_run_due(void);
+
+// Run the timeline to completion, waiting between steps on the calling thread
+void key_sequencer_flush(void);
+
+// True when no program is waiting on the timeline
+bool key_sequencer_idle(void);
+
+// Programs waiting on the timeline (0..KEY_SEQUENCER_CAPACITY)
+size_t key_sequencer_depth(void);
+
+// Steps that failed with the given backend error code since start
+uint64_t key_sequencer_step_errors(YAError code);
+
+/**
+ * Run a program to completion on the calling thread, including the delay after its
+ * last step (for sequences that must finish before the caller continues, e.g. clipboard
+ * paste followed by restore)
+ * @return Success, or the first step error
+ */
+YAError key_sequencer_run_sync(const key_program_t *program);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KEY_SEQUENCER_H
@@ -0,0 +1,231 @@
+// Text input - xkb-mapped key events with batched uinput writes, clipboard only for unmappable runs
+#include "input/keyboard/text.h"
+#include "input/keyboard/clipboard.h"
+#include "input/keyboard/sequencer.h"
+#include "ya_logger.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef USE_UINPUT
+#include "input/backend/linux_uinput.h"
+#include "input/backend/xkb_mapper.h"
+#include <linux/input-event-codes.h>
+#include <unistd.h>
+#endif
+
+// Decode one UTF-8 code point, returns its length in bytes (0 = invalid sequence)
+static size_t utf8_decode(const char* s, uint32_t* cp) {
+    const unsigned char* u = (const unsigned char*)s;
+    if (u[0] < 0x80) {
+        *cp = u[0];
+        return 1;
+    }
+    if ((u[0] & 0xE0) == 0xC0 && (u[1] & 0xC0) == 0x80) {
+        *cp = ((uint32_t)(u[0] & 0x1F) << 6) | (u[1] & 0x3F);
+        return *cp >= 0x80 ? 2 : 0;
+    }
+    if ((u[0] & 0xF0) == 0xE0 && (u[1] & 0xC0) == 0x80 && (u[2] & 0xC0) == 0x80) {
+        *cp = ((uint32_t)(u[0] & 0x0F) << 12) | ((uint32_t)(u[1] & 0x3F) << 6) | (u[2] & 0x3F);
+        return *cp >= 0x800 ? 3 : 0;
+    }
+    if ((u[0] & 0xF8) == 0xF0 && (u[1] & 0xC0) == 0x80 && (u[2] & 0xC0) == 0x80 && (u[3] & 0xC0) == 0x80) {
+        *cp = ((uint32_t)(u[0] & 0x07) << 18) | ((uint32_t)(u[1] & 0x3F) << 12) | ((uint32_t)(u[2] & 0x3F) << 6) |
+              (u[3] & 0x3F);
+        return (*cp >= 0x10000 && *cp < 0x110000) ? 4 : 0;
+    }
+    return 0;
+}
+
+#ifdef USE_UINPUT
+
+// xkb cache modifier bits (see xkbmap_map_utf8_to_evdev)
+#define TEXT_MOD_SHIFT (1u << 0)
+#define TEXT_MOD_LEVEL3 (1u << 1)
+
+// Pause after each full batch so the compositor can drain the evdev queue;
+// a reader that falls too far behind gets SYN_DROPPED and loses keys
+#define TEXT_BATCH_PAUSE_US 1000
+
+typedef struct {
+    input_linux_key_event_t events[INPUT_LINUX_KEY_BATCH_MAX];
+    size_t count;
+    unsigned held; // modifiers currently held (TEXT_MOD_*)
+    keyboard_text_stats_t stats;
+    YAError err;   // first error
+} text_typer_t;
+
+static void typer_fail(text_typer_t* t, YAError err) {
+    if (t->err == Success) {
+        t->err = err;
+    }
+}
+
+static void typer_flush(text_typer_t* t) {
+    if (t->count == 0) return;
+
+    if (input_linux_key_events_raw(t->events, t->count) != INPUT_BACKEND_OK) {
+        typer_fail(t, PlatformError);
+    }
+    t->count = 0;
+    t->stats.writes++;
+}
+
+static void typer_add(text_typer_t* t, int code, int32_t value) {
+    if (t->count == INPUT_LINUX_KEY_BATCH_MAX) {
+        typer_flush(t);
+        usleep(TEXT_BATCH_PAUSE_US);
+    }
+    t->events[t->count].code = (uint16_t)code;
+    t->events[t->count].value = value;
+    t->count++;
+}
+
+// Transition held modifiers to want; only the ones that change are pressed or released
+static void typer_set_mods(text_typer_t* t, unsigned want) {
+    unsigned release = t->held & ~want;
+    unsigned press = want & ~t->held;
+    if (release == 0 && press == 0) return;
+
+    if (release & TEXT_MOD_LEVEL3) typer_add(t, KEY_RIGHTALT, 0);
+    if (release & TEXT_MOD_SHIFT) typer_add(t, KEY_LEFTSHIFT, 0);
+    if (press & TEXT_MOD_SHIFT) typer_add(t, KEY_LEFTSHIFT, 1);
+    if (press & TEXT_MOD_LEVEL3) typer_add(t, KEY_RIGHTALT, 1);
+    t->held = want;
+
+    // Give the compositor time to register the modifier change ([input] key_step_delay_ms)
+    int delay_ms = key_sequencer_step_delay_ms();
+    if (delay_ms > 0) {
+        typer_flush(t);
+        usleep((useconds_t)delay_ms * 1000);
+    }
+}
+
+// Paste a run of unmappable code points [start, end)
+static void typer_paste(text_typer_t* t, const char* start, const char* end) {
+    // The paste shortcut must not combine with held modifiers, and must follow the keys before it
+    typer_set_mods(t, 0);
+    typer_flush(t);
+
+    char* run = strndup(start, (size_t)(end - start));
+    if (!run) {
+        typer_fail(t, PlatformError);
+        return;
+    }
+
+    YA_LOG_DEBUG("Text input: pasting %zu unmappable bytes via clipboard", strlen(run));
+    YAError err = clipboard_paste_text(run);
+    if (err != Success) {
+        YA_LOG_WARN("Text input: clipboard fallback failed: error %d", err);
+        typer_fail(t, err);
+    }
+    free(run);
+    t->stats.writes++;
+}
+
+static bool map_text_char(uint32_t cp, int* key, unsigned* mods) {
+    if (xkbmap_map_codepoint(cp, key, mods)) {
+        *mods &= TEXT_MOD_SHIFT | TEXT_MOD_LEVEL3;
+        return true;
+    }
+
+    // Return has keysym U+000D; line feeds from the phone keyboard mean the same key
+    if (cp == '\n') {
+        *key = KEY_ENTER;
+        *mods = 0;
+        return true;
+    }
+    return false;
+}
+
+YAError keyboard_type_text(const char* text, keyboard_text_stats_t* stats) {
+    if (!text) {
+        return InvalidInput;
+    }
+
+    text_typer_t t;
+    memset(&t, 0, sizeof(t));
+
+    const char* run = NULL; // start of the pending unmappable run
+    const char* p = text;
+    while (*p) {
+        uint32_t cp = 0;
+        size_t len = utf8_decode(p, &cp);
+        if (len == 0) {
+            YA_LOG_WARN("Text input: invalid UTF-8 at byte %zu, skipped", (size_t)(p - text));
+            if (run) {
+                typer_paste(&t, run, p);
+                run = NULL;
+            }
+            p++;
+            continue;
+        }
+
+        // CRLF types a single Return
+        if (cp == '\r' && p[1] == '\n') {
+            p++;
+            continue;
+        }
+
+        int key = 0;
+        unsigned mods = 0;
+        if (map_text_char(cp, &key, &mods)) {
+            if (run) {
+                typer_paste(&t, run, p);
+                run = NULL;
+            }
+            typer_set_mods(&t, mods);
+            typer_add(&t, key, 1);
+            typer_add(&t, key, 0);
+            t.stats.chars_typed++;
+        } else {
+            if (!run) run = p;
+            t.stats.chars_pasted++;
+        }
+        p += len;
+    }
+
+    if (run) {
+        typer_paste(&t, run, p);
+    }
+    typer_set_mods(&t, 0);
+    typer_flush(&t);
+
+    YA_LOG_DEBUG("Text input: %zu typed, %zu pasted, %zu writes", t.stats.chars_typed, t.stats.chars_pasted,
+                 t.stats.writes);
+    if (stats) {
+        *stats = t.stats;
+    }
+    return t.err;
+}
+
+#else // Non-Linux
+
+YAError keyboard_type_text(const char* text, keyboard_text_stats_t* stats) {
+    if (!text) {
+        return InvalidInput;
+    }
+
+    size_t chars = 0;
+    for (const char* p = text; *p;) {
+        uint32_t cp = 0;
+        size_t len = utf8_decode(p, &cp);
+        p += len ? len : 1;
+        chars++;
+    }
+
+    keyboard_text_stats_t result = {.chars_typed = chars, .writes = 1};
+    YAError err = enter_text(text);
+    if (err != Success) {
+        result.chars_typed = 0;
+        result.chars_pasted = chars;
+        err = clipboard_paste_text(text);
+    }
+
+    if (stats) {
+        *stats = result;
+    }
+    return err;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef KEYBOARD_TEXT_H
+#define KEYBOARD_TEXT_H
+
+#include "rs.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Text typing statistics (optional output of keyboard_type_text)
+ */
+typedef struct {
+    size_t chars_typed;  // code points injected as key events
+    size_t chars_pasted; // code points sent through the clipboard fallback
+    size_t writes;       // backend writes (uinput batches or clipboard pastes)
+} keyboard_text_stats_t;
+
+/**
+ * Type a UTF-8 string
+ *
+ * Linux (uinput): each code point is mapped through the xkb cache and typed as key
+ * events, written to uinput in batches. Modifiers stay held across consecutive
+ * characters that need them. Only runs of unmappable code points go through
+ * clipboard_paste_text.
+ * Other platforms: enter_text, with clipboard paste if that fails.
+ *
+ * @param text UTF-8 text
+ * @param stats Optional statistics output (may be NULL)
+ * @return Success, or the first error
+ */
+YAError keyboard_type_text(const char* text, keyboard_text_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KEYBOARD_TEXT_H
@@ -105,6 +105,8 @@ static int init_logger(const char* config_file) {
     const char* use_system_log_str = ya_config_get(&config, "logger", "use_system_log");
     const char* max_file_size_str = ya_config_get(&config, "logger", "max_file_size");
     const char* max_backup_files_str = ya_config_get(&config, "logger", "max_backup_files");
+    const char* async_str = ya_config_get(&config, "logger", "async");
+    const char* async_queue_size_str = ya_config_get(&config, "logger", "async_queue_size");
 
     // 设置默认值
     ya_logger_config_t logger_config = {
@@ -153,6 +155,17 @@ static int init_logger(const char* config_file) {
         logger_config.max_backup_files = atoi(max_backup_files_str);
     }
 
+    if (async_str) {
+        logger_config.async = (strcmp(async_str, "1") == 0 ||
+                               strcmp(async_str, "true") == 0 ||
+                               strcmp(async_str, "on") == 0 ||
+                               strcmp(async_str, "yes") == 0);
+    }
+
+    if (async_queue_size_str) {
+        logger_config.async_queue_size = (size_t)atol(async_queue_size_str);
+    }
+
     // 初始化日志系统
     g_logger = ya_logger_init(&logger_config);
     if (!g_logger) {
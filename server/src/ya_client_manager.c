@@ -5,72 +5,119 @@
 #include "ya_client_manager.h"
 #include "ya_logger.h"
 #include "ya_mouse_filter.h"
+#include "ya_mouse_pacer.h"
+#include "ya_mouse_throttle.h"
 
-// 计算哈希值
-static uint32_t hash_uid(uint32_t uid) {
-    return uid % YA_CLIENT_HASH_SIZE;
-}
-
-// 添加冲突统计（调试用）
-#ifdef DEBUG
-static uint32_t collision_count = 0;
-static uint32_t max_chain_length = 0;
-
-static void update_collision_stats(ya_client_manager_t *manager) {
-    uint32_t max_len = 0;
-    uint32_t total_collisions = 0;
-    
-    for (int i = 0; i < YA_CLIENT_HASH_SIZE; i++) {
-        uint32_t chain_len = 0;
-        ya_client_t *client = manager->buckets[i];
-        while (client) {
-            chain_len++;
-            client = client->next;
-        }
-        if (chain_len > 1) {
-            total_collisions += (chain_len - 1);
-        }
-        if (chain_len > max_len) {
-            max_len = chain_len;
-        }
+// UID 与槽位/代数互相转换
+static uint32_t make_uid(uint32_t slot, uint32_t generation) {
+    return (generation << YA_CLIENT_SLOT_BITS) | slot;
+}
+
+static uint32_t uid_slot(uint32_t uid) {
+    return uid & YA_CLIENT_SLOT_MASK;
+}
+
+static uint32_t uid_generation(uint32_t uid) {
+    return uid >> YA_CLIENT_SLOT_BITS;
+}
+
+// 按2倍扩容数组，保证至少容纳 need 个元素；新增部分清零
+static bool grow_array(void **array, uint32_t *capacity, uint32_t need, size_t elem_size, uint32_t limit) {
+    if (need <= *capacity) return true;
+    if (need > limit) return false;
+
+    uint32_t new_cap = *capacity ? *capacity : 16;
+    while (new_cap < need) {
+        new_cap = new_cap > limit / 2 ? limit : new_cap * 2;
+    }
+
+    void *grown = realloc(*array, (size_t)new_cap * elem_size);
+    if (!grown) return false;
+    memset((char *)grown + (size_t)*capacity * elem_size, 0, (size_t)(new_cap - *capacity) * elem_size);
+    *array = grown;
+    *capacity = new_cap;
+    return true;
+}
+
+static void free_client(ya_client_t *client) {
+    if (client->bev) {
+        bufferevent_free(client->bev);
+    }
+    if (client->mouse_filter) {
+        ya_mouse_filter_destroy(client->mouse_filter);
+        client->mouse_filter = NULL;
+    }
+    ya_mouse_pacer_destroy(client->mouse_pacer);
+    client->mouse_pacer = NULL;
+    ya_mouse_throttle_destroy(client->mouse_throttle);
+    client->mouse_throttle = NULL;
+    free(client);
+}
+
+// 从活跃列表移除（与末尾交换）
+static void deactivate(ya_client_manager_t *manager, ya_client_t *client) {
+    uint32_t index = client->active_index;
+    if (index >= manager->active_count || manager->active[index] != client) {
+        return;
     }
-    
-    collision_count = total_collisions;
-    max_chain_length = max_len;
-    
-    if (max_chain_length > 3) {
-        YA_LOG_WARN("Hash performance degraded: max_chain_length=%u, collisions=%u", 
-                   max_chain_length, collision_count);
+
+    ya_client_t *last = manager->active[--manager->active_count];
+    manager->active[index] = last;
+    last->active_index = index;
+}
+
+// 移除 fd 索引（仅当索引仍指向该客户端的槽位）
+static void unindex_fd(ya_client_manager_t *manager, ya_client_t *client) {
+    uint32_t fd = (uint32_t)client->fd;
+    if (client->fd >= 0 && fd < manager->fd_capacity && manager->fd_index[fd] == uid_slot(client->uid) + 1) {
+        manager->fd_index[fd] = 0;
     }
 }
-#endif
+
+// 释放客户端并回收槽位：代数加一，旧 UID 随之失效
+static void release_slot(ya_client_manager_t *manager, ya_client_t *client) {
+    uint32_t slot = uid_slot(client->uid);
+    ya_client_slot_t *entry = &manager->slots[slot];
+
+    deactivate(manager, client);
+    unindex_fd(manager, client);
+
+    entry->client = NULL;
+    entry->generation = entry->generation >= YA_CLIENT_GENERATION_MAX ? 1 : entry->generation + 1;
+    entry->next_free = manager->free_head;
+    manager->free_head = slot + 1;
+    manager->client_count--;
+
+    YA_LOG_TRACE("Client %u freed (slot %u)", client->uid, slot);
+    free_client(client);
+}
+
+// 查找 UID 对应的客户端（不检查状态）
+static ya_client_t *lookup_uid(ya_client_manager_t *manager, uint32_t uid) {
+    uint32_t slot = uid_slot(uid);
+    if (slot >= manager->slot_count) return NULL;
+
+    ya_client_slot_t *entry = &manager->slots[slot];
+    if (!entry->client || entry->generation != uid_generation(uid)) return NULL;
+    return entry->client;
+}
 
 void ya_client_manager_init(ya_client_manager_t *manager) {
     if (!manager) return;
     memset(manager, 0, sizeof(ya_client_manager_t));
-    manager->next_uid = 1;  // 从1开始分配UID
 }
 
 void ya_client_manager_cleanup(ya_client_manager_t *manager) {
     if (!manager) return;
-    for (int i = 0; i < YA_CLIENT_HASH_SIZE; i++) {
-        ya_client_t *client = manager->buckets[i];
-        while (client) {
-            ya_client_t *next = client->next;
-            if (client->bev) {
-                bufferevent_free(client->bev);
-            }
-            if (client->mouse_filter) {
-                ya_mouse_filter_destroy(client->mouse_filter);
-                client->mouse_filter = NULL;
-            }
-            free(client);
-            client = next;
+    for (uint32_t i = 0; i < manager->slot_count; i++) {
+        if (manager->slots[i].client) {
+            free_client(manager->slots[i].client);
         }
-        manager->buckets[i] = NULL;
     }
-    manager->client_count = 0;
-    manager->next_uid = 1;
+    free(manager->slots);
+    free(manager->fd_index);
+    free(manager->active);
+    memset(manager, 0, sizeof(ya_client_manager_t));
 }
 
 ya_client_t *ya_client_create(ya_client_manager_t *manager, evutil_socket_t fd, struct bufferevent *bev) {
@@ -79,26 +126,38 @@ ya_client_t *ya_client_create(ya_client_manager_t *manager, evutil_socket_t fd,
         return NULL;
     }
 
+    // 预留槽位、fd 索引和活跃列表空间，失败时不改变管理器状态
+    uint32_t slot = manager->free_head ? manager->free_head - 1 : manager->slot_count;
+    if (!grow_array((void **)&manager->slots, &manager->slot_capacity, slot + 1, sizeof(ya_client_slot_t),
+                    YA_CLIENT_MAX_SLOTS) ||
+        !grow_array((void **)&manager->fd_index, &manager->fd_capacity, (uint32_t)fd + 1, sizeof(uint32_t),
+                    UINT32_MAX / 2) ||
+        !grow_array((void **)&manager->active, &manager->active_capacity, manager->active_count + 1,
+                    sizeof(ya_client_t *), YA_CLIENT_MAX_SLOTS)) {
+        YA_LOG_ERROR("Client table full or out of memory (clients=%u, fd=%d)", manager->client_count, (int)fd);
+        return NULL;
+    }
+
     ya_client_t *client = (ya_client_t *)calloc(1, sizeof(ya_client_t));
     if (!client) {
         YA_LOG_ERROR("Failed to allocate memory for client");
         return NULL;
     }
 
+    ya_client_slot_t *entry = &manager->slots[slot];
+    if (manager->free_head) {
+        manager->free_head = entry->next_free;
+    } else {
+        manager->slot_count++;
+    }
+    if (entry->generation == 0) {
+        entry->generation = 1; // 代数从1开始，UID 不会为0
+    }
+    entry->client = client;
+    entry->next_free = 0;
+
     client->fd = fd;
-    
-    // 处理UID溢出 - 确保不会分配UID 0
-    if (manager->next_uid == 0) {
-        manager->next_uid = 1;
-    }
-    client->uid = manager->next_uid++;
-    
-    // 如果UID即将溢出，回绕到1（避免使用0作为有效UID）
-    if (manager->next_uid == 0) {
-        manager->next_uid = 1;
-        YA_LOG_WARN("UID counter wrapped around");
-    }
-    
+    client->uid = make_uid(slot, entry->generation);
     client->ref_count = 1;  // 初始引用计数为1
     client->state = YA_CLIENT_ACTIVE;
     client->bev = bev;
@@ -110,44 +169,31 @@ ya_client_t *ya_client_create(ya_client_manager_t *manager, evutil_socket_t fd,
         // 不中断创建流程，但记录日志
     }
 
-    // 插入到哈希表
-    uint32_t hash = hash_uid(client->uid);
-    client->next = manager->buckets[hash];
-    manager->buckets[hash] = client;
+    manager->fd_index[fd] = slot + 1;
+    client->active_index = manager->active_count;
+    manager->active[manager->active_count++] = client;
     manager->client_count++;
 
-    YA_LOG_TRACE("Created new client with UID: %u", client->uid);
+    YA_LOG_TRACE("Created new client with UID: %u (slot %u)", client->uid, slot);
     return client;
 }
 
 ya_client_t *ya_client_find_by_uid(ya_client_manager_t *manager, uint32_t uid) {
     if (!manager || uid == 0) return NULL;
 
-    uint32_t hash = hash_uid(uid);
-    ya_client_t *client = manager->buckets[hash];
-
-    while (client) {
-        if (client->uid == uid && client->state == YA_CLIENT_ACTIVE) {
-            return client;
-        }
-        client = client->next;
-    }
-
-    return NULL;
+    ya_client_t *client = lookup_uid(manager, uid);
+    return client && client->state == YA_CLIENT_ACTIVE ? client : NULL;
 }
 
 ya_client_t *ya_client_find_by_fd(ya_client_manager_t *manager, evutil_socket_t fd) {
-    if (!manager || fd < 0) return NULL;
-
-    // 由于我们没有为fd建立索引，需要遍历所有bucket
-    for (int i = 0; i < YA_CLIENT_HASH_SIZE; i++) {
-        ya_client_t *client = manager->buckets[i];
-        while (client) {
-            if (client->fd == fd && client->state == YA_CLIENT_ACTIVE) {
-                return client;
-            }
-            client = client->next;
-        }
+    if (!manager || fd < 0 || (uint32_t)fd >= manager->fd_capacity) return NULL;
+
+    uint32_t slot = manager->fd_index[fd];
+    if (slot == 0) return NULL;
+
+    ya_client_t *client = manager->slots[slot - 1].client;
+    if (client && client->fd == fd && client->state == YA_CLIENT_ACTIVE) {
+        return client;
     }
     return NULL;
 }
@@ -165,34 +211,9 @@ void ya_client_unref(ya_client_manager_t *manager, ya_client_t *client) {
         client->ref_count--;
         // YA_LOG_TRACE("Client %u ref count decreased to %u", client->uid, client->ref_count);
 
-        if (client->ref_count == 0 && client->state == YA_CLIENT_DISCONNECTED) {
-            // 找到客户端在哈希表中的位置
-            uint32_t hash = hash_uid(client->uid);
-            ya_client_t *curr = manager->buckets[hash];
-            ya_client_t *prev = NULL;
-
-            while (curr) {
-                if (curr == client) {
-                    if (prev) {
-                        prev->next = curr->next;
-                    } else {
-                        manager->buckets[hash] = curr->next;
-                    }
-                    if (client->bev) {
-                        bufferevent_free(client->bev);
-                    }
-                    if (client->mouse_filter) {
-                        ya_mouse_filter_destroy(client->mouse_filter);
-                        client->mouse_filter = NULL;
-                    }
-                    free(client);
-                    manager->client_count--;
-                    YA_LOG_TRACE("Client %u freed", client->uid);
-                    break;
-                }
-                prev = curr;
-                curr = curr->next;
-            }
+        if (client->ref_count == 0 && client->state == YA_CLIENT_DISCONNECTED &&
+            lookup_uid(manager, client->uid) == client) {
+            release_slot(manager, client);
         }
     } else {
         YA_LOG_WARN("Attempted to unref client %u with ref_count already at 0", client->uid);
@@ -202,53 +223,55 @@ void ya_client_unref(ya_client_manager_t *manager, ya_client_t *client) {
 void ya_client_remove(ya_client_manager_t *manager, uint32_t uid) {
     if (!manager || uid == 0) return;
 
-    uint32_t hash = hash_uid(uid);
-    ya_client_t *client = manager->buckets[hash];
-    ya_client_t *prev = NULL;
-
-    while (client) {
-        if (client->uid == uid) {
-            // 标记为断开连接状态
-            client->state = YA_CLIENT_DISCONNECTED;
-            YA_LOG_TRACE("Client %u marked as disconnected", uid);
-
-            // 如果没有其他引用，立即释放
-            if (client->ref_count == 0) {
-                if (prev) {
-                    prev->next = client->next;
-                } else {
-                    manager->buckets[hash] = client->next;
-                }
-                if (client->bev) {
-                    bufferevent_free(client->bev);
-                }
-                if (client->mouse_filter) {
-                    ya_mouse_filter_destroy(client->mouse_filter);
-                    client->mouse_filter = NULL;
-                }
-                free(client);
-                manager->client_count--;
-                YA_LOG_TRACE("Client %u removed and freed", uid);
-            }
-            return;
-        }
-        prev = client;
-        client = client->next;
+    ya_client_t *client = lookup_uid(manager, uid);
+    if (!client) return;
+
+    // 标记为断开连接状态，不再出现在活跃列表和 fd 索引中
+    if (client->state == YA_CLIENT_ACTIVE) {
+        deactivate(manager, client);
+    }
+    unindex_fd(manager, client);
+    client->state = YA_CLIENT_DISCONNECTED;
+    YA_LOG_TRACE("Client %u marked as disconnected", uid);
+
+    // 如果没有其他引用，立即释放
+    if (client->ref_count == 0) {
+        release_slot(manager, client);
+        YA_LOG_TRACE("Client %u removed and freed", uid);
     }
 }
 
 uint32_t ya_client_get_count(ya_client_manager_t *manager) {
     if (!manager) return 0;
-    
-    uint32_t active_count = 0;
-    for (int i = 0; i < YA_CLIENT_HASH_SIZE; i++) {
-        ya_client_t *client = manager->buckets[i];
-        while (client) {
-            if (client->state == YA_CLIENT_ACTIVE) {
-                active_count++;
-            }
-            client = client->next;
-        }
+    return manager->active_count;
+}
+
+ya_client_t *ya_client_at(ya_client_manager_t *manager, uint32_t index) {
+    if (!manager || index >= manager->active_count) return NULL;
+    return manager->active[index];
+}
+
+void ya_client_count_event(ya_client_t *client, uint32_t now_s) {
+    if (!client) return;
+
+    if (now_s != client->rate_second) {
+        // 跨过一秒：刚结束的这一秒成为“前一秒”，中间空闲了整秒则为0
+        client->events_last = (now_s == client->rate_second + 1) ? client->events_current : 0;
+        client->events_current = 0;
+        client->rate_second = now_s;
     }
-    return active_count;
-} 
\ No newline at end of file
+    client->events_current++;
+    client->events++;
+}
+
+uint32_t ya_client_events_per_sec(const ya_client_t *client, uint32_t now_s) {
+    if (!client) return 0;
+
+    if (now_s == client->rate_second) {
+        return client->events_last;
+    }
+    if (now_s == client->rate_second + 1) {
+        return client->events_current;
+    }
+    return 0;
+}
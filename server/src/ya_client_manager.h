@@ -5,11 +5,22 @@
 #include <stdint.h>
 #include <time.h>
 
-// 哈希表大小（使用质数以减少碰撞）
-#define YA_CLIENT_HASH_SIZE 251
+#include "ya_reorder_window.h"
+
+// UID 编码：低 YA_CLIENT_SLOT_BITS 位为槽位下标，高位为槽位代数（从1开始，永远不为0）
+// 槽位释放后代数加一，旧 UID 不会指向复用该槽位的新客户端
+// 协议头按 int32 编解码 UID，代数上限保证 UID 不超过 INT32_MAX
+#define YA_CLIENT_SLOT_BITS 12
+#define YA_CLIENT_MAX_SLOTS (1u << YA_CLIENT_SLOT_BITS)
+#define YA_CLIENT_SLOT_MASK (YA_CLIENT_MAX_SLOTS - 1)
+#define YA_CLIENT_GENERATION_MAX ((uint32_t)INT32_MAX >> YA_CLIENT_SLOT_BITS)
 
 // 前置声明：每客户端鼠标滤波上下文
 typedef struct ya_mouse_filter ya_mouse_filter_t;
+// 前置声明：每客户端批量采样回放器
+typedef struct ya_mouse_pacer ya_mouse_pacer_t;
+// 前置声明：每客户端 v2 鼠标节流器
+typedef struct ya_mouse_throttle ya_mouse_throttle_t;
 
 // 客户端状态
 typedef enum {
@@ -26,18 +37,50 @@ typedef struct ya_client {
     uint32_t ref_count;         // 引用计数
     ya_client_state_t state;    // 客户端状态
     struct bufferevent *bev;    // 事件缓冲区
-    struct ya_client *next;     // 哈希冲突链表
+    uint32_t active_index;      // 在管理器活跃列表中的下标（仅 ACTIVE 状态有效）
     // 服务器端挂载的鼠标移动平滑上下文（按客户端隔离）
     ya_mouse_filter_t *mouse_filter;
+    // MOUSE_MOVE_BATCH 按时间回放时使用（懒创建，可能为NULL）
+    ya_mouse_pacer_t *mouse_pacer;
+    // 协议 v2 的 MOUSE_MOVE 节流时使用（懒创建，可能为NULL）
+    ya_mouse_throttle_t *mouse_throttle;
     time_t connected_at;        // 连接建立时间（Unix 时间戳，秒）
     uint32_t protocol_version;  // 客户端协议版本 (用于兼容性判断)
+    struct sockaddr_in peer_addr; // TCP 会话对端地址，UDP 指针数据报必须来自同一 IP
+    uint64_t session_token;     // UDP 指针通道的会话令牌（v5，授权时签发，0 表示未启用）
+    ya_reorder_window_t move_window;        // 命令序号上 MOUSE_MOVE 的乱序合并窗口
+    ya_reorder_window_t udp_pointer_window; // UDP 指针通道的乱序合并窗口（与 TCP 命令序号相互独立）
+
+    // 流量统计（TCP 帧与 UDP 数据报合计）
+    uint64_t bytes_in;          // 收到的字节数
+    uint64_t bytes_out;         // 回复的字节数
+    uint64_t events;            // 交给处理函数的事件数
+    uint32_t rate_second;       // events_current 所属的单调时钟秒
+    uint32_t events_current;    // 该秒内的事件数
+    uint32_t events_last;       // 前一秒的事件数
 } ya_client_t;
 
+// 客户端槽位
+typedef struct {
+    ya_client_t *client;        // 占用该槽位的客户端（NULL 表示空闲）
+    uint32_t generation;        // 当前代数，编码在 UID 高位
+    uint32_t next_free;         // 空闲链表中的下一个槽位下标 + 1（0 表示链表结束）
+} ya_client_slot_t;
+
 // 客户端管理器结构体
+// 槽位数组 + 空闲链表：UID 查找是下标检查加代数比较；fd 索引直接映射到槽位；
+// 活跃客户端另存一份紧凑列表，计数和遍历只与在线客户端数量有关
 typedef struct {
-    ya_client_t *buckets[YA_CLIENT_HASH_SIZE];  // 哈希桶
-    uint32_t client_count;                      // 当前客户端数量
-    uint32_t next_uid;                          // 下一个可用的UID
+    ya_client_slot_t *slots;    // 槽位数组（按需扩容）
+    uint32_t slot_capacity;     // 已分配的槽位数
+    uint32_t slot_count;        // 使用过的槽位数（空闲链表之外的新槽位从这里分配）
+    uint32_t free_head;         // 空闲链表头槽位下标 + 1（0 表示为空）
+    uint32_t *fd_index;         // fd -> 槽位下标 + 1（0 表示无）
+    uint32_t fd_capacity;       // fd_index 长度
+    ya_client_t **active;       // ACTIVE 状态客户端的紧凑列表
+    uint32_t active_capacity;
+    uint32_t active_count;      // 当前活跃客户端数量
+    uint32_t client_count;      // 当前客户端数量（含断开后等待释放的）
 } ya_client_manager_t;
 
 // 初始化客户端管理器
@@ -64,5 +107,14 @@ void ya_client_unref(ya_client_manager_t *manager, ya_client_t *client);
 // 移除客户端
 void ya_client_remove(ya_client_manager_t *manager, uint32_t uid);
 
-// 获取客户端数量
-uint32_t ya_client_get_count(ya_client_manager_t *manager); 
\ No newline at end of file
+// 获取活跃客户端数量
+uint32_t ya_client_get_count(ya_client_manager_t *manager);
+
+// 按下标访问活跃客户端，index 范围 [0, ya_client_get_count)；增删客户端后下标会变化
+ya_client_t *ya_client_at(ya_client_manager_t *manager, uint32_t index);
+
+// 记录一个交给处理函数的事件，now_s 为单调时钟秒数
+void ya_client_count_event(ya_client_t *client, uint32_t now_s);
+
+// 每秒事件数：前一个完整秒内的事件数
+uint32_t ya_client_events_per_sec(const ya_client_t *client, uint32_t now_s);
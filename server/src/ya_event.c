@@ -9,101 +9,117 @@
 #include <string.h>
 
 typedef int (*serializer_fn)(const void *param, size_t param_len, mpack_writer_t *writer);
-typedef int (*parser_fn)(const char *data, size_t len, void **out_param, size_t *out_len);
+typedef int (*parser_fn)(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len);
+
+// 定长参数的存放位置：调用方提供了内联存储（ya_parse_event_inline）就直接写入，否则从堆上分配
+static inline void *param_storage(void *inline_dst, size_t size)
+{
+    return inline_dst ? inline_dst : malloc(size);
+}
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint16_t load_be16(const uint8_t *p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8) | (uint16_t)p[1]);
+}
+
+static inline uint64_t load_be64(const uint8_t *p)
+{
+    return ((uint64_t)load_be32(p) << 32) | (uint64_t)load_be32(p + 4);
+}
+
+static inline void store_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline void store_be64(uint8_t *p, uint64_t v)
+{
+    store_be32(p, (uint32_t)(v >> 32));
+    store_be32(p + 4, (uint32_t)v);
+}
 
 // Forward declarations for event-specific (de)serializers
 static int serialize_common_request(const void *param, size_t param_len, mpack_writer_t *writer);
-static int parse_common_request(const char *data, size_t len, void **out_param, size_t *out_len);
+static int parse_common_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len);
 
 static int serialize_text_input_request(const void *param, size_t param_len, mpack_writer_t *writer);
-static int parse_text_input_request(const char *data, size_t len, void **out_param, size_t *out_len);
+static int parse_text_input_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len);
 
 static int serialize_text_get_response(const void *param, size_t param_len, mpack_writer_t *writer);
-static int parse_text_get_response(const char *data, size_t len, void **out_param, size_t *out_len);
+static int parse_text_get_response(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len);
 
 static int serialize_authorize_request(const void *param, size_t param_len, mpack_writer_t *writer);
-static int parse_authorize_request(const char *data, size_t len, void **out_param, size_t *out_len);
+static int parse_authorize_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len);
 static int serialize_authorize_response(const void *param, size_t param_len, mpack_writer_t *writer);
-static int parse_session_option_request(const char *data, size_t len, void **out_param, size_t *out_len);
+static int parse_session_option_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len);
 
-static int parse_discover_request(const char *data, size_t len, void **out_param, size_t *out_len);
+static int parse_discover_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len);
 static int serialize_discover_response(const void *param, size_t param_len, mpack_writer_t *writer);
 
+// Mouse move batch [dt_us, dx, dy, ...]
+static int serialize_mouse_move_batch_request(const void *param, size_t param_len, mpack_writer_t *writer);
+static int parse_mouse_move_batch_request(const char *data, size_t len, void *inline_dst, void **out_param,
+                                          size_t *out_len);
+
 // Keyboard (code, op, mods)
 static int serialize_keyboard_request(const void *param, size_t param_len, mpack_writer_t *writer);
-static int parse_keyboard_request(const char *data, size_t len, void **out_param, size_t *out_len);
+static int parse_keyboard_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len);
+
+// 按事件类型索引的编解码表，由 YA_EVENT_TYPE_TABLE 展开（方向不参与选择）
+static const serializer_fn serializers[YA_EVENT_TYPE_COUNT] = {
+#define YA_EVENT_SERIALIZER(name, value, parser, serializer, ...) [name] = serializer,
+    YA_EVENT_TYPE_TABLE(YA_EVENT_SERIALIZER)
+#undef YA_EVENT_SERIALIZER
+};
+
+static const parser_fn parsers[YA_EVENT_TYPE_COUNT] = {
+#define YA_EVENT_PARSER(name, value, parser, ...) [name] = parser,
+    YA_EVENT_TYPE_TABLE(YA_EVENT_PARSER)
+#undef YA_EVENT_PARSER
+};
+
+static const char *const type_names[YA_EVENT_TYPE_COUNT] = {
+#define YA_EVENT_NAME(name, ...) [name] = #name,
+    YA_EVENT_TYPE_TABLE(YA_EVENT_NAME)
+#undef YA_EVENT_NAME
+};
 
-// Dispatcher for serializers based on event type and direction
 static serializer_fn get_serializer(YAEventType type, YAEventDirection dir)
 {
-    switch (type)
-    {
-    case MOUSE_MOVE:
-    case MOUSE_CLICK:
-    case MOUSE_WHEEL:
-    case CONTROL:
-        return serialize_common_request;
-    case KEYBOARD:
-        return serialize_keyboard_request;
-    case TEXT_INPUT:
-        return serialize_text_input_request;
-    case TEXT_GET:
-        return serialize_text_get_response;
-    case AUTHORIZE:
-        return serialize_authorize_response;
-    case DISCOVER:
-        return serialize_discover_response;
-    case HEARTBEAT:
-        return NULL; // no payload
-    default:
-        return NULL;
-    }
+    (void)dir;
+    return (uint32_t)type < YA_EVENT_TYPE_COUNT ? serializers[type] : NULL;
 }
 
-// Dispatcher for parsers based on event type and direction
 static parser_fn get_parser(YAEventType type, YAEventDirection dir)
 {
-    switch (type)
-    {
-    case MOUSE_MOVE:
-    case MOUSE_CLICK:
-    case MOUSE_WHEEL:
-    case CONTROL:
-        return parse_common_request;
-    case KEYBOARD:
-        return parse_keyboard_request;
-    case TEXT_INPUT:
-        return parse_text_input_request;
-    case TEXT_GET:
-        return parse_text_get_response;
-    case AUTHORIZE:
-        return parse_authorize_request;
-    case SESSION_OPTION:
-        return parse_session_option_request;
-    case DISCOVER:
-        return parse_discover_request;
-    case HEARTBEAT:
-        return NULL;
-    default:
-        return NULL;
-    }
+    (void)dir;
+    return (uint32_t)type < YA_EVENT_TYPE_COUNT ? parsers[type] : NULL;
 }
 
-int ya_parse_event_header(struct evbuffer *buf, YAEventHeader *out_header, uint32_t length)
+const char *ya_event_type_name(uint32_t type)
 {
-    if (evbuffer_get_length(buf) < length)
-    {
-        return -1;
-    }
+    const char *name = type < YA_EVENT_TYPE_COUNT ? type_names[type] : NULL;
+    return name ? name : "UNKNOWN";
+}
 
-    unsigned char *data = evbuffer_pullup(buf, length);
-    if (!data)
+int ya_decode_event_header(const uint8_t *data, size_t len, YAEventHeader *out_header)
+{
+    if (!data || !out_header)
     {
         return -1;
     }
 
+    // 头部 [uid, type, direction, index]
     mpack_reader_t reader;
-    mpack_reader_init_data(&reader, (const char *)data, length);
+    mpack_reader_init_data(&reader, (const char *)data, len);
     uint32_t count = mpack_expect_array(&reader);
     if (count != 4)
     {
@@ -116,119 +132,270 @@ int ya_parse_event_header(struct evbuffer *buf, YAEventHeader *out_header, uint3
     uint32_t index = mpack_expect_i32(&reader);
     mpack_done_array(&reader);
 
-    if (mpack_reader_error(&reader) != mpack_ok)
+    size_t remaining = mpack_reader_remaining(&reader, NULL);
+    if (mpack_reader_destroy(&reader) != mpack_ok)
     {
         return -1;
     }
-    mpack_reader_destroy(&reader);
-
-    // if (buf_len < header_bytes + content_len)
-    //     return -1;
 
     out_header->uid = uid;
     out_header->type = (YAEventType)type;
     out_header->direction = (YAEventDirection)direction;
     out_header->index = index;
 
-    return 0;
+    return (int)(len - remaining);
 }
 
-int ya_parse_event(struct evbuffer *buf, YAEvent *event, YAPackageSize *size)
+int ya_decode_package_size(const uint8_t *data, size_t len, YAPackageSize *info)
 {
-    YAEventHeader header;
-    if (ya_parse_event_header(buf, &header, size->headerSize) < 0)
+    if (!data || !info)
     {
         return -1;
     }
 
-    evbuffer_drain(buf, size->headerSize);
+    if (len < YA_FRAME_PREFIX_SIZE)
+    {
+        return 0;
+    }
 
-    int content_len = size->bodySize;
+    uint32_t total_size = load_be32(data);
+    uint32_t header_size = load_be32(data + 4);
+    if (total_size < sizeof(uint32_t) || header_size > total_size - sizeof(uint32_t) ||
+        (size_t)total_size + sizeof(uint32_t) > INT32_MAX)
+    {
+        return -1;
+    }
+
+    info->totalSize = total_size;
+    info->headerSize = header_size;
+    info->bodySize = total_size - header_size - sizeof(uint32_t);
+
+    return YA_FRAME_PREFIX_SIZE;
+}
 
-    if (content_len == 0)
+int ya_parse_event_header(struct evbuffer *buf, YAEventHeader *out_header, uint32_t length)
+{
+    if (evbuffer_get_length(buf) < length)
     {
-        // no body
-        event->header = header;
-        return 0;
+        return -1;
     }
 
-    unsigned char *payload = evbuffer_pullup(buf, content_len);
-    if (!payload)
+    unsigned char *data = evbuffer_pullup(buf, length);
+    if (!data)
     {
         return -1;
     }
 
+    return ya_decode_event_header(data, length, out_header) < 0 ? -1 : 0;
+}
+
+// 从连续内存解码紧跟在长度前缀之后的 header + body，inline_dst 为 NULL 时参数分配在堆上
+static int decode_payload(const uint8_t *data, const YAPackageSize *size, YAEvent *event, void *inline_dst)
+{
+    YAEventHeader header;
+    if (ya_decode_event_header(data, size->headerSize, &header) < 0)
+    {
+        return -1;
+    }
+
+    event->header = header;
+    if (size->bodySize == 0)
+    {
+        // no body
+        return 0;
+    }
+
     parser_fn parser = get_parser(header.type, header.direction);
     void *param = NULL;
     size_t param_len = 0;
-    if (parser && parser((const char *)payload, content_len, &param, &param_len) < 0)
+    if (parser &&
+        parser((const char *)data + size->headerSize, size->bodySize, inline_dst, &param, &param_len) < 0)
     {
         return -1;
     }
 
-    evbuffer_drain(buf, content_len);
-
-    event->header = header;
     event->param = param;
     event->param_len = param_len;
 
     return 0;
 }
 
-int ya_serialize_event(YAEvent *event, uint8_t **out)
+static int parse_event(struct evbuffer *buf, YAEvent *event, YAPackageSize *size, bool use_inline)
 {
-    // Serialize payload
-    mpack_writer_t pw = {0};
-    char *body_buf = NULL;
-    size_t body_size = 0;
-    mpack_writer_init_growable(&pw, &body_buf, &body_size);
-    serializer_fn ser = get_serializer(event->header.type, event->header.direction);
-    if (ser && ser(event->param, event->param_len, &pw) < 0)
+    size_t payload_len = (size_t)size->headerSize + size->bodySize;
+    if (evbuffer_get_length(buf) < payload_len)
+    {
+        return -1;
+    }
+
+    // header 和 body 一次性拉成连续内存，解码后整体丢弃
+    const uint8_t *payload = evbuffer_pullup(buf, payload_len);
+    if (!payload)
+    {
+        return -1;
+    }
+
+    int rc = decode_payload(payload, size, event, use_inline ? &event->inline_param : NULL);
+    evbuffer_drain(buf, payload_len);
+    return rc;
+}
+
+int ya_parse_event(struct evbuffer *buf, YAEvent *event, YAPackageSize *size)
+{
+    return parse_event(buf, event, size, false);
+}
+
+int ya_parse_event_inline(struct evbuffer *buf, YAEvent *event, YAPackageSize *size)
+{
+    return parse_event(buf, event, size, true);
+}
+
+int ya_decode_frame(const uint8_t *data, size_t len, YAEvent *event)
+{
+    if (!data || !event)
+    {
+        return -1;
+    }
+
+    YAPackageSize size;
+    int prefix = ya_decode_package_size(data, len, &size);
+    if (prefix <= 0)
+    {
+        return prefix;
+    }
+
+    size_t frame_len = (size_t)size.totalSize + sizeof(uint32_t);
+    if (len < frame_len)
+    {
+        return 0;
+    }
+
+    if (decode_payload(data + prefix, &size, event, &event->inline_param) < 0)
     {
-        mpack_writer_destroy(&pw);
         return -1;
     }
-    mpack_writer_destroy(&pw);
+
+    return (int)frame_len;
+}
+
+// 在 writer 中依次写入：8字节长度前缀占位、header、body；header 长度通过 out_hdr_size 返回
+static int write_frame(YAEvent *event, mpack_writer_t *writer, size_t *out_hdr_size)
+{
+    static const char prefix[YA_FRAME_PREFIX_SIZE] = {0};
+    mpack_write_object_bytes(writer, prefix, sizeof(prefix));
 
     // Serialize header
-    mpack_writer_t hw = {0};
-    char *hdr_buf = NULL;
+    mpack_start_array(writer, 4);
+    mpack_write_u32(writer, event->header.uid);
+    mpack_write_u32(writer, (uint32_t)event->header.type);
+    mpack_write_u32(writer, (uint32_t)event->header.direction);
+    mpack_write_u32(writer, event->header.index);
+    mpack_finish_array(writer);
+    *out_hdr_size = mpack_writer_buffer_used(writer) - YA_FRAME_PREFIX_SIZE;
+
+    // Serialize payload；没有参数时只写 header
+    serializer_fn ser = get_serializer(event->header.type, event->header.direction);
+    if (ser && event->param && ser(event->param, event->param_len, writer) < 0)
+    {
+        return -1;
+    }
+
+    return mpack_writer_error(writer) == mpack_ok ? 0 : -1;
+}
+
+// 回填长度前缀：总长度 = header + body + 4
+static void fill_frame_prefix(uint8_t *frame, size_t frame_len, size_t hdr_size)
+{
+    uint32_t _total = (uint32_t)htonl((uint32_t)(frame_len - sizeof(uint32_t)));
+    uint32_t _hdr_size = (uint32_t)htonl((uint32_t)hdr_size);
+
+    memcpy(frame, &_total, 4);
+    memcpy(frame + 4, &_hdr_size, 4);
+}
+
+int ya_serialize_event(YAEvent *event, uint8_t **out)
+{
+    if (!event || !out)
+    {
+        return -1;
+    }
+    *out = NULL;
+
+    mpack_writer_t writer = {0};
+    char *frame = NULL;
+    size_t frame_len = 0;
     size_t hdr_size = 0;
-    mpack_writer_init_growable(&hw, &hdr_buf, &hdr_size);
-    mpack_start_array(&hw, 4);
-    mpack_write_u32(&hw, event->header.uid);
-    mpack_write_u32(&hw, (uint32_t)event->header.type);
-    mpack_write_u32(&hw, (uint32_t)event->header.direction);
-    mpack_write_u32(&hw, event->header.index);
-    mpack_finish_array(&hw);
-    mpack_writer_destroy(&hw);
+    mpack_writer_init_growable(&writer, &frame, &frame_len);
+    int ret = write_frame(event, &writer, &hdr_size);
+    if (mpack_writer_destroy(&writer) != mpack_ok || ret < 0)
+    {
+        free(frame);
+        return -1;
+    }
 
-    // Combine
-    size_t total = hdr_size + body_size + 4;
-    int total_with_size = total + 4;
-    *out = malloc(total_with_size);
-    memset(*out, 0, total_with_size);
+    fill_frame_prefix((uint8_t *)frame, frame_len, hdr_size);
+    *out = (uint8_t *)frame;
 
-    uint32_t _total = (uint32_t)htonl(total);
-    uint32_t _hdr_size = (uint32_t)htonl(hdr_size);
+    return (int)frame_len;
+}
 
-    int start = 0;
-    memcpy(*out + start, &_total, 4);
-    start += 4;
+int ya_serialize_event_to(YAEvent *event, uint8_t *buf, size_t cap)
+{
+    if (!event || !buf || cap < YA_FRAME_PREFIX_SIZE)
+    {
+        return -1;
+    }
 
-    memcpy(*out + start, &_hdr_size, 4);
-    start += 4;
+    mpack_writer_t writer;
+    size_t hdr_size = 0;
+    mpack_writer_init(&writer, (char *)buf, cap);
+    int ret = write_frame(event, &writer, &hdr_size);
+    size_t frame_len = mpack_writer_buffer_used(&writer);
+    if (mpack_writer_destroy(&writer) != mpack_ok || ret < 0)
+    {
+        // 超出 cap 时 mpack 返回 mpack_error_too_big
+        return -1;
+    }
+
+    fill_frame_prefix(buf, frame_len, hdr_size);
+
+    return (int)frame_len;
+}
+
+int ya_serialize_event_to_evbuffer(YAEvent *event, struct evbuffer *out)
+{
+    if (!event || !out)
+    {
+        return -1;
+    }
 
-    memcpy(*out + start, hdr_buf, hdr_size);
-    start += hdr_size;
+    struct evbuffer_iovec vec;
+    if (evbuffer_reserve_space(out, YA_EVENT_FRAME_STACK_SIZE, &vec, 1) == 1)
+    {
+        int length = ya_serialize_event_to(event, vec.iov_base, vec.iov_len);
+        if (length >= 0)
+        {
+            vec.iov_len = (size_t)length;
+            if (evbuffer_commit_space(out, &vec, 1) == 0)
+            {
+                return length;
+            }
+        }
+        // 未提交的预留空间会被后续写入覆盖，无需回滚
+    }
 
-    memcpy(*out + start, body_buf, body_size);
+    // 帧过大（比如授权响应携带了很长的 MAC 列表），退回堆上序列化
+    uint8_t *frame = NULL;
+    int length = ya_serialize_event(event, &frame);
+    if (length < 0)
+    {
+        return -1;
+    }
 
-    // Cleanup
-    free(body_buf);
-    free(hdr_buf);
+    int ret = evbuffer_add(out, frame, (size_t)length);
+    free(frame);
 
-    return total_with_size;
+    return ret == 0 ? length : -1;
 }
 
 void ya_free_event_param(YAEvent *event)
@@ -238,13 +405,22 @@ void ya_free_event_param(YAEvent *event)
         return;
     }
 
+    if (event->param == &event->inline_param)
+    {
+        // 内联参数随事件本身的存储释放
+        event->param = NULL;
+        return;
+    }
+
     switch (event->header.type)
     {
     case TEXT_INPUT:
         free(((YATextInputEventRequest *)event->param)->text);
+        free(event->param);
         break;
     case TEXT_GET:
         free(((YAInputGetEventResponse *)event->param)->text);
+        free(event->param);
         break;
     case AUTHORIZE:
         if (event->header.direction == RESPONSE)
@@ -291,12 +467,12 @@ static int serialize_common_request(const void *param, size_t unused, mpack_writ
     mpack_finish_array(writer);
     return 0;
 }
-static int parse_common_request(const char *data, size_t len, void **out_param, size_t *out_len)
+static int parse_common_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len)
 {
     mpack_reader_t r;
     mpack_reader_init_data(&r, data, len);
     mpack_expect_array(&r);
-    YACommonEventRequest *req = malloc(sizeof(*req));
+    YACommonEventRequest *req = param_storage(inline_dst, sizeof(*req));
     req->lparam = mpack_expect_i32(&r);
     req->rparam = mpack_expect_i32(&r);
     mpack_done_array(&r);
@@ -306,6 +482,63 @@ static int parse_common_request(const char *data, size_t len, void **out_param,
     return 0;
 }
 
+// Mouse move batch
+static int serialize_mouse_move_batch_request(const void *param, size_t unused, mpack_writer_t *writer)
+{
+    const YAMouseMoveBatchEventRequest *req = param;
+    uint32_t count = req->count > YA_MOUSE_BATCH_MAX_SAMPLES ? YA_MOUSE_BATCH_MAX_SAMPLES : req->count;
+    mpack_start_array(writer, count * 3);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        mpack_write_u32(writer, req->samples[i].dt_us);
+        mpack_write_i32(writer, req->samples[i].dx);
+        mpack_write_i32(writer, req->samples[i].dy);
+    }
+    mpack_finish_array(writer);
+    return 0;
+}
+
+static int parse_mouse_move_batch_request(const char *data, size_t len, void *inline_dst, void **out_param,
+                                          size_t *out_len)
+{
+    mpack_reader_t r;
+    mpack_reader_init_data(&r, data, len);
+    uint32_t n = mpack_expect_array_max(&r, YA_MOUSE_BATCH_MAX_SAMPLES * 3);
+    if (mpack_reader_error(&r) != mpack_ok || n % 3 != 0)
+    {
+        mpack_reader_destroy(&r);
+        return -1;
+    }
+
+    YAMouseMoveBatchEventRequest *req = param_storage(inline_dst, sizeof(*req));
+    if (!req)
+    {
+        mpack_reader_destroy(&r);
+        return -1;
+    }
+    req->count = n / 3;
+    for (uint32_t i = 0; i < req->count; i++)
+    {
+        req->samples[i].dt_us = mpack_expect_u32(&r);
+        req->samples[i].dx = mpack_expect_i32(&r);
+        req->samples[i].dy = mpack_expect_i32(&r);
+    }
+    mpack_done_array(&r);
+
+    if (mpack_reader_destroy(&r) != mpack_ok)
+    {
+        if (req != inline_dst)
+        {
+            free(req);
+        }
+        return -1;
+    }
+
+    *out_param = req;
+    *out_len = sizeof(*req);
+    return 0;
+}
+
 // Keyboard (code, op, mods)
 static int serialize_keyboard_request(const void *param, size_t unused, mpack_writer_t *writer)
 {
@@ -318,12 +551,12 @@ static int serialize_keyboard_request(const void *param, size_t unused, mpack_wr
     return 0;
 }
 
-static int parse_keyboard_request(const char *data, size_t len, void **out_param, size_t *out_len)
+static int parse_keyboard_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len)
 {
     mpack_reader_t r;
     mpack_reader_init_data(&r, data, len);
     mpack_expect_array(&r);
-    YAKeyboardEventRequest *req = malloc(sizeof(*req));
+    YAKeyboardEventRequest *req = param_storage(inline_dst, sizeof(*req));
     req->code = mpack_expect_i32(&r);
     req->op = mpack_expect_i32(&r);
     req->mods = mpack_expect_u32(&r);
@@ -341,7 +574,7 @@ static int serialize_text_input_request(const void *param, size_t unused, mpack_
     mpack_write_str(writer, req->text, strlen(req->text));
     return 0;
 }
-static int parse_text_input_request(const char *data, size_t len, void **out_param, size_t *out_len)
+static int parse_text_input_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len)
 {
     mpack_reader_t r;
     mpack_reader_init_data(&r, data, len);
@@ -366,7 +599,7 @@ static int serialize_text_get_response(const void *param, size_t unused, mpack_w
     return 0;
 }
 
-static int parse_text_get_response(const char *data, size_t len, void **out_param, size_t *out_len)
+static int parse_text_get_response(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len)
 {
     mpack_reader_t r;
     mpack_reader_init_data(&r, data, len);
@@ -393,12 +626,12 @@ static int serialize_authorize_request(const void *param, size_t unused, mpack_w
     mpack_finish_array(writer);
     return 0;
 }
-static int parse_authorize_request(const char *data, size_t len, void **out_param, size_t *out_len)
+static int parse_authorize_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len)
 {
     mpack_reader_t r;
     mpack_reader_init_data(&r, data, len);
     mpack_expect_array(&r);
-    YAAuthorizeEventRequest *req = malloc(sizeof(*req));
+    YAAuthorizeEventRequest *req = param_storage(inline_dst, sizeof(*req));
     memset(req, 0, sizeof(*req));
     req->type = (YAClientType)mpack_expect_u32(&r);
     req->version = mpack_expect_u32(&r);
@@ -408,12 +641,12 @@ static int parse_authorize_request(const char *data, size_t len, void **out_para
     *out_len = sizeof(*req);
     return 0;
 }
-static int parse_session_option_request(const char *data, size_t len, void **out_param, size_t *out_len)
+static int parse_session_option_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len)
 {
     mpack_reader_t r;
     mpack_reader_init_data(&r, data, len);
     mpack_expect_array(&r);
-    YASessionOptionEventRequest *req = malloc(sizeof(*req));
+    YASessionOptionEventRequest *req = param_storage(inline_dst, sizeof(*req));
     if (!req)
     {
         mpack_reader_destroy(&r);
@@ -436,7 +669,23 @@ static int serialize_authorize_response(const void *param, size_t unused, mpack_
     
     // 根据客户端版本决定响应格式
     // client_version 字段存储的是客户端版本
-    if (resp->client_version >= 2)
+    if (resp->client_version >= YA_PROTOCOL_UDP_POINTER_VERSION)
+    {
+        // Protocol v5: 9 fields, v2 fields + session_token
+        mpack_start_array(writer, 9);
+        mpack_write_bool(writer, resp->success);
+        mpack_write_u32(writer, resp->os_type);
+        mpack_write_u32(writer, resp->uid);
+        mpack_write_u32(writer, (uint32_t)resp->session_port);
+        mpack_write_u32(writer, (uint32_t)resp->command_port);
+        const char *macs = resp->macs ? resp->macs : "";
+        mpack_write_str(writer, macs, strlen(macs));
+        mpack_write_float(writer, resp->display_scale);
+        mpack_write_u32(writer, YA_PROTOCOL_VERSION);
+        mpack_write_u64(writer, resp->session_token);
+        mpack_finish_array(writer);
+    }
+    else if (resp->client_version >= 2)
     {
         // Protocol v2: 8 fields [success, os_type, uid, session_port, command_port, macs, display_scale, protocol_version]
         mpack_start_array(writer, 8);
@@ -470,11 +719,11 @@ static int serialize_authorize_response(const void *param, size_t unused, mpack_
     return 0;
 }
 
-static int parse_discover_request(const char *data, size_t len, void **out_param, size_t *out_len)
+static int parse_discover_request(const char *data, size_t len, void *inline_dst, void **out_param, size_t *out_len)
 {
     mpack_reader_t r;
     mpack_reader_init_data(&r, data, len);
-    YADiscoverEventRequest *req = malloc(sizeof(*req));
+    YADiscoverEventRequest *req = param_storage(inline_dst, sizeof(*req));
     req->magic = mpack_expect_u32(&r);
     mpack_reader_destroy(&r);
     *out_param = req;
@@ -493,12 +742,156 @@ static int serialize_discover_response(const void *param, size_t unused, mpack_w
 
 int ya_get_package_size(struct evbuffer *buffer, YAPackageSize *info)
 {
-    uint32_t totalSize = to_uint32(buffer, 0);
-    uint32_t headerSize = to_uint32(buffer, 4);
+    // 一次拷出两个长度字段，不做 pullup，也不消费缓冲区
+    uint8_t prefix[YA_FRAME_PREFIX_SIZE];
+    if (evbuffer_copyout(buffer, prefix, sizeof(prefix)) != (ev_ssize_t)sizeof(prefix))
+    {
+        return -1;
+    }
 
-    info->totalSize = totalSize;
-    info->headerSize = headerSize;
-    info->bodySize = totalSize - headerSize - sizeof(uint32_t);
+    return ya_decode_package_size(prefix, sizeof(prefix), info) > 0 ? 0 : -1;
+}
 
-    return 0;
+// --- Packed records (protocol v4) ---
+
+size_t ya_packed_record_size(uint8_t type)
+{
+    switch (type)
+    {
+    case MOUSE_MOVE:
+    case MOUSE_CLICK:
+    case MOUSE_WHEEL:
+    case MOUSE_SMOOTH_SCROLL:
+        return YA_PACKED_POINTER_SIZE;
+    case KEYBOARD:
+        return YA_PACKED_KEYBOARD_SIZE;
+    default:
+        return 0;
+    }
+}
+
+int ya_decode_packed_event(const uint8_t *data, size_t len, YAEvent *event)
+{
+    if (len < 2)
+    {
+        return 0;
+    }
+
+    if (data[0] != YA_PACKED_MAGIC)
+    {
+        return -1;
+    }
+
+    size_t size = ya_packed_record_size(data[1]);
+    if (size == 0)
+    {
+        // 未知类型
+        return -1;
+    }
+
+    // 先确认整条记录都在缓冲区内，再读取保留位
+    if (len < size)
+    {
+        return 0;
+    }
+
+    if (load_be16(data + 2) != 0)
+    {
+        // 保留位非0
+        return -1;
+    }
+
+    event->header.type = (YAEventType)data[1];
+    event->header.direction = REQUEST;
+    event->header.uid = load_be32(data + 4);
+    event->header.index = load_be32(data + 8);
+
+    if (event->header.type == KEYBOARD)
+    {
+        YAKeyboardEventRequest *req = &event->inline_param.keyboard;
+        req->code = (int32_t)load_be32(data + 12);
+        req->op = (int32_t)load_be32(data + 16);
+        req->mods = load_be32(data + 20);
+        event->param_len = sizeof(*req);
+    }
+    else
+    {
+        YACommonEventRequest *req = &event->inline_param.common;
+        req->lparam = (int32_t)load_be32(data + 12);
+        req->rparam = (int32_t)load_be32(data + 16);
+        event->param_len = sizeof(*req);
+    }
+    event->param = &event->inline_param;
+
+    return (int)size;
+}
+
+int ya_encode_packed_event(const YAEvent *event, uint8_t *buf, size_t cap)
+{
+    if (!event || !event->param || !buf)
+    {
+        return -1;
+    }
+
+    size_t size = ya_packed_record_size((uint8_t)event->header.type);
+    if (size == 0 || cap < size)
+    {
+        return -1;
+    }
+
+    buf[0] = YA_PACKED_MAGIC;
+    buf[1] = (uint8_t)event->header.type;
+    buf[2] = 0;
+    buf[3] = 0;
+    store_be32(buf + 4, event->header.uid);
+    store_be32(buf + 8, event->header.index);
+
+    if (event->header.type == KEYBOARD)
+    {
+        const YAKeyboardEventRequest *req = event->param;
+        store_be32(buf + 12, (uint32_t)req->code);
+        store_be32(buf + 16, (uint32_t)req->op);
+        store_be32(buf + 20, req->mods);
+    }
+    else
+    {
+        const YACommonEventRequest *req = event->param;
+        store_be32(buf + 12, (uint32_t)req->lparam);
+        store_be32(buf + 16, (uint32_t)req->rparam);
+    }
+
+    return (int)size;
+}
+
+int ya_decode_pointer_datagram(const uint8_t *data, size_t len, YAEvent *event, uint64_t *out_token)
+{
+    if (!data || !event || !out_token || len != YA_POINTER_DATAGRAM_SIZE || data[0] != YA_PACKED_MAGIC ||
+        data[1] != MOUSE_MOVE)
+    {
+        return -1;
+    }
+
+    if (ya_decode_packed_event(data, YA_PACKED_POINTER_SIZE, event) != YA_PACKED_POINTER_SIZE)
+    {
+        return -1;
+    }
+
+    *out_token = load_be64(data + YA_PACKED_POINTER_SIZE);
+    return YA_POINTER_DATAGRAM_SIZE;
+}
+
+int ya_encode_pointer_datagram(const YAEvent *event, uint64_t token, uint8_t *buf, size_t cap)
+{
+    if (!event || event->header.type != MOUSE_MOVE || cap < YA_POINTER_DATAGRAM_SIZE)
+    {
+        return -1;
+    }
+
+    if (ya_encode_packed_event(event, buf, cap) != YA_PACKED_POINTER_SIZE)
+    {
+        return -1;
+    }
+
+    store_be64(buf + YA_PACKED_POINTER_SIZE, token);
+    return YA_POINTER_DATAGRAM_SIZE;
 }
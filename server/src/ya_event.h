@@ -28,31 +28,119 @@
     YA_HEADER_CONTENT_LENGTH_SIZE + YA_HEADER_UID_SIZE + YA_HEADER_EVENT_TYPE_SIZE + YA_HEADER_DIRECTION_SIZE +        \
         YA_HEADER_INDEX_SIZE
 
+// 帧前缀：总长度(32 bit) + 头部长度(32 bit)
+#define YA_FRAME_PREFIX_SIZE (sizeof(uint32_t) * 2)
+
+// 常见响应帧（心跳、授权、发现等）的栈上/预留缓冲区大小，超出时回退到堆上序列化
+#define YA_EVENT_FRAME_STACK_SIZE 256
+
 #define DISCOVERY_MAGIC 0x4B424D43
 
 // Protocol version for client-server compatibility check
 // Version 2: Legacy (with throttle and full filter)
 // Version 3: New architecture (client-side acceleration, server-side subpixel only)
-#define YA_PROTOCOL_VERSION 3
+// Version 4: Packed binary records for pointer and keyboard events (see YA_PACKED_MAGIC)
+// Version 5: UDP pointer channel bound to the TCP session (session token in the AUTHORIZE response)
+#define YA_PROTOCOL_VERSION 5
+
+// 可以使用紧凑二进制记录的最低协议版本
+#define YA_PROTOCOL_PACKED_VERSION 4
+
+// 可以通过 UDP 指针通道发送鼠标移动的最低协议版本
+#define YA_PROTOCOL_UDP_POINTER_VERSION 5
+
+/**
+ * Packed record (protocol v4), all fields big-endian:
+ *
+ * offset 0  u8  magic (YA_PACKED_MAGIC)
+ * offset 1  u8  type (MOUSE_MOVE, MOUSE_CLICK, MOUSE_WHEEL, MOUSE_SMOOTH_SCROLL, KEYBOARD)
+ * offset 2  u16 flags (reserved, 0)
+ * offset 4  u32 uid
+ * offset 8  u32 index
+ * offset 12 i32 lparam / code
+ * offset 16 i32 rparam / op
+ * offset 20 u32 mods (KEYBOARD only)
+ *
+ * Regular frames start with a 32-bit big-endian total size whose first byte
+ * is always 0 (frames are far below 16MB), so the magic byte tells both
+ * formats apart without any extra framing.
+ **/
+#define YA_PACKED_MAGIC 0xB4
+#define YA_PACKED_POINTER_SIZE 20
+#define YA_PACKED_KEYBOARD_SIZE 24
+#define YA_PACKED_MAX_SIZE YA_PACKED_KEYBOARD_SIZE
+
+/**
+ * UDP pointer datagram (protocol v5): a packed MOUSE_MOVE record followed by
+ * the u64 big-endian session token from the AUTHORIZE response. The server
+ * only accepts it when the token matches the uid's TCP session and the
+ * datagram comes from the session's peer IP. Clicks and keys stay on TCP.
+ **/
+#define YA_SESSION_TOKEN_SIZE 8
+#define YA_POINTER_DATAGRAM_SIZE (YA_PACKED_POINTER_SIZE + YA_SESSION_TOKEN_SIZE)
+
+/**
+ * Event type table: one row per event type, add new types here only.
+ *
+ * X(name, value, parser, serializer, handler, flags)
+ *
+ * Values start at 1 and stay contiguous so every table indexed by the type
+ * is a plain array. ya_event.c expands the parser/serializer columns,
+ * ya_server_handler.c expands handler/flags; each ignores the others, so the
+ * names only need to exist in the file that uses them.
+ **/
+#define YA_EVENT_TYPE_TABLE(X)                                                                                         \
+    X(MOUSE_MOVE, 0x1, parse_common_request, serialize_common_request, handle_mouse_move,                            \
+      YA_EVENT_REORDER | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP | YA_EVENT_UDP)                                         \
+    X(MOUSE_CLICK, 0x2, parse_common_request, serialize_common_request, handle_mouse_click,                          \
+      YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP)                                                          \
+    X(MOUSE_WHEEL, 0x3, parse_common_request, serialize_common_request, handle_mouse_scroll,                         \
+      YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP)                                                          \
+    X(KEYBOARD, 0x4, parse_keyboard_request, serialize_keyboard_request, handle_keyboard,                            \
+      YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP)                                                          \
+    X(TEXT_INPUT, 0x5, parse_text_input_request, serialize_text_input_request, handle_input_text,                    \
+      YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP)                                                          \
+    X(TEXT_GET, 0x6, parse_text_get_response, serialize_text_get_response, handle_input_get,                         \
+      YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP)                                                          \
+    X(DISCOVER, 0x7, parse_discover_request, serialize_discover_response, handle_discover,                           \
+      YA_EVENT_TCP | YA_EVENT_UDP)                                                                                   \
+    X(MOUSE_STOP, 0x8, NULL, NULL, handle_mouse_stop,                                                                \
+      YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP | YA_EVENT_UDP)                                         \
+    X(CONTROL, 0x9, parse_common_request, serialize_common_request, handle_control,                                  \
+      YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP)                                                          \
+    X(AUTHORIZE, 0xA, parse_authorize_request, serialize_authorize_response, handle_authorize, YA_EVENT_TCP)         \
+    X(HEARTBEAT, 0xB, NULL, NULL, handle_heartbeat, YA_EVENT_TCP | YA_EVENT_UDP)                                     \
+    X(SESSION_OPTION, 0xC, parse_session_option_request, NULL, handle_session_option,                                \
+      YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP | YA_EVENT_UDP)                                         \
+    X(MOUSE_MOVE_BATCH, 0xD, parse_mouse_move_batch_request, serialize_mouse_move_batch_request,                     \
+      handle_mouse_move_batch, YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP | YA_EVENT_UDP)                \
+    X(MOUSE_SMOOTH_SCROLL, 0xE, parse_common_request, serialize_common_request, handle_mouse_smooth_scroll,          \
+      YA_EVENT_ORDERED | YA_EVENT_NEED_CLIENT | YA_EVENT_TCP | YA_EVENT_UDP)
+
+// 事件分发标志（flags 列）
+#define YA_EVENT_ORDERED 0x01     // 命令序号必须严格递增，旧序号丢弃
+#define YA_EVENT_REORDER 0x02     // 命令序号经乱序窗口判定，窗口内迟到的合并
+#define YA_EVENT_NEED_CLIENT 0x04 // 请求头 UID 必须与连接绑定的客户端一致（只做 UID 匹配，不校验授权）
+#define YA_EVENT_TCP 0x08         // 允许从会话连接到达
+#define YA_EVENT_UDP 0x10         // 允许从命令数据报到达
 
 typedef enum
 {
-    MOUSE_MOVE = 0x1,
-    MOUSE_CLICK = 0x2,
-    MOUSE_WHEEL = 0x3,
-    KEYBOARD = 0x4,
-
-    TEXT_INPUT = 0x5,
-    TEXT_GET = 0x6,
-
-    DISCOVER = 0x7,
-    MOUSE_STOP = 0x8,
-    CONTROL = 0x9,
-    AUTHORIZE = 0xA,
-    HEARTBEAT = 0xB,
-    SESSION_OPTION = 0xC,
+#define YA_EVENT_TYPE_ENUM(name, value, ...) name = value,
+    YA_EVENT_TYPE_TABLE(YA_EVENT_TYPE_ENUM)
+#undef YA_EVENT_TYPE_ENUM
 } YAEventType;
 
+// 事件类型数量 + 1（类型值从1开始），按类型索引的数组长度
+enum
+{
+#define YA_EVENT_TYPE_SLOT(name, ...) YA_EVENT_SLOT_##name,
+    YA_EVENT_TYPE_TABLE(YA_EVENT_TYPE_SLOT)
+#undef YA_EVENT_TYPE_SLOT
+    YA_EVENT_TYPE_ENTRIES,
+    YA_EVENT_TYPE_COUNT = YA_EVENT_TYPE_ENTRIES + 1
+};
+
 typedef enum
 {
     REQUEST = 0x1,
@@ -96,6 +184,11 @@ typedef struct
  * lparam is distance.
  * rparam is direction: 0 up, 1 down, 2 left, 3 right
  *
+ * Mouse Smooth Scroll:
+ * lparam is horizontal distance (positive = right),
+ * rparam is vertical distance (positive = up),
+ * both in 1/YA_SMOOTH_SCROLL_SCALE notch, fractions accumulate per client.
+ *
  * Power/Restart/Hibernate:
  * lparam
  * 1 is Poweroff
@@ -111,6 +204,32 @@ typedef struct
     int32_t rparam;
 } YACommonEventRequest;
 
+// MOUSE_SMOOTH_SCROLL 距离单位：1/1000 格
+#define YA_SMOOTH_SCROLL_SCALE 1000
+
+/**
+ * Mouse move batch:
+ *
+ * body is a flat array [dt_us, dx, dy, dt_us, dx, dy, ...], one triple per
+ * touch sample, at most YA_MOUSE_BATCH_MAX_SAMPLES samples.
+ * - dt_us: microseconds since the previous sample (the first one is relative
+ *   to the last sample of the previous batch)
+ * - dx/dy: same units as MOUSE_MOVE lparam/rparam
+ **/
+#define YA_MOUSE_BATCH_MAX_SAMPLES 32
+
+typedef struct
+{
+    uint32_t dt_us;
+    int32_t dx;
+    int32_t dy;
+} YAMouseSample;
+
+typedef struct
+{
+    uint32_t count;
+    YAMouseSample samples[YA_MOUSE_BATCH_MAX_SAMPLES];
+} YAMouseMoveBatchEventRequest;
 
 // Mods bitmask for KEYBOARD_CHORD
 #define CHORD_MOD_SHIFT   (1u << 0)
@@ -167,6 +286,7 @@ typedef struct
     char *macs;
     float display_scale; // 主显示器逻辑缩放因子（例如 1.0、1.25、2.0）
     uint32_t client_version; // 客户端协议版本号，用于响应序列化兼容判断
+    uint64_t session_token; // v5: UDP 指针通道的会话令牌，0 表示未启用
 } YAAuthorizeEventResponse;
 
 typedef struct
@@ -199,6 +319,24 @@ typedef struct
     uint16_t port;
 } YADiscoverEventResponse;
 
+/**
+ * Inline storage for fixed-size request bodies, tagged by header.type.
+ *
+ * ya_parse_event_inline() decodes fixed-size payloads (mouse, mouse batch,
+ * keyboard, control, authorize, session option, discover) into this union and points
+ * param at it, so the hot path does no heap allocation. Variable-length
+ * bodies such as TEXT_INPUT still go to the heap.
+ **/
+typedef union
+{
+    YACommonEventRequest common;
+    YAMouseMoveBatchEventRequest mouse_batch;
+    YAKeyboardEventRequest keyboard;
+    YAAuthorizeEventRequest authorize;
+    YASessionOptionEventRequest session_option;
+    YADiscoverEventRequest discover;
+} YAEventInlineParam;
+
 typedef struct
 {
     YAEventHeader header;
@@ -206,6 +344,13 @@ typedef struct
     void *param;
 
     size_t param_len;
+
+    // param may point here (filled by ya_parse_event_inline), it is never freed
+    YAEventInlineParam inline_param;
+
+    // 传输层记录的单调时钟纳秒时刻（0 表示未记录），用于延迟统计
+    uint64_t readable_ns; // 套接字可读（读回调开始）
+    uint64_t decoded_ns;  // 解码完成
 } YAEvent;
 
 typedef struct
@@ -217,11 +362,35 @@ typedef struct
 
 /**
  * get package size
- * @buffer a buffer
+ * @buffer a buffer, it is not drained
  * @info a struct, package info will be set into this struct
+ *
+ * @return -1 if the buffer holds less than 8 bytes or the sizes are
+ * inconsistent, 0 is success
  **/
 int ya_get_package_size(struct evbuffer *buffer, YAPackageSize *info);
 
+/**
+ * Decode the 8-byte length prefix from contiguous memory
+ * @data frame bytes starting at the 32-bit total size
+ * @len available bytes
+ * @info package info will be set into this struct
+ *
+ * @return consumed bytes (YA_FRAME_PREFIX_SIZE), 0 if more data is needed, -1
+ * if the sizes are inconsistent
+ **/
+int ya_decode_package_size(const uint8_t *data, size_t len, YAPackageSize *info);
+
+/**
+ * Decode protocol header [uid, type, direction, index] from contiguous memory
+ * @data header bytes
+ * @len available bytes
+ * @out_header out parameter, @See YAEventHeader
+ *
+ * @return consumed bytes, -1 is failed
+ **/
+int ya_decode_event_header(const uint8_t *data, size_t len, YAEventHeader *out_header);
+
 /**
  * Parse protocol header from buffer
  *
@@ -248,6 +417,93 @@ int ya_parse_event_header(struct evbuffer *buf, YAEventHeader *out_header, uint3
  **/
 int ya_parse_event(struct evbuffer *buf, YAEvent *event, YAPackageSize *size);
 
+/**
+ * Deserialize event from buffer without heap allocation for fixed-size bodies
+ * @buf received data
+ * @event caller-provided event (usually on the stack), fixed-size payloads are
+ * written into event->inline_param and event->param points at it
+ * @size package size
+ *
+ * Variable-length bodies (TEXT_INPUT, TEXT_GET) are still heap allocated, so
+ * always release the event with ya_free_event_param.
+ *
+ * @return -1 is failed, 0 is success
+ **/
+int ya_parse_event_inline(struct evbuffer *buf, YAEvent *event, YAPackageSize *size);
+
+/**
+ * Decode a complete frame from contiguous memory
+ * @data frame bytes starting at the 32-bit total size
+ * @len available bytes
+ * @event caller-provided event, fixed-size payloads are written into
+ * event->inline_param (same rules as ya_parse_event_inline)
+ *
+ * @return consumed bytes (the whole frame), 0 if more data is needed, -1 if
+ * the frame is invalid
+ **/
+int ya_decode_frame(const uint8_t *data, size_t len, YAEvent *event);
+
+/**
+ * Name of an event type, taken from YA_EVENT_TYPE_TABLE
+ * @type event type
+ *
+ * @return static string, "UNKNOWN" for values outside the table
+ **/
+const char *ya_event_type_name(uint32_t type);
+
+/**
+ * Size of the packed record for an event type
+ * @type event type
+ *
+ * @return record size in bytes, 0 if the type has no packed form
+ **/
+size_t ya_packed_record_size(uint8_t type);
+
+/**
+ * Decode a packed record (protocol v4) without any parser or allocation
+ * @data record bytes, data[0] must be YA_PACKED_MAGIC
+ * @len available bytes
+ * @event out event, the body is written into event->inline_param
+ *
+ * @return consumed bytes, 0 if more data is needed, -1 if the record is
+ * invalid
+ **/
+int ya_decode_packed_event(const uint8_t *data, size_t len, YAEvent *event);
+
+/**
+ * Encode a request as a packed record
+ * @event MOUSE_MOVE, MOUSE_CLICK, MOUSE_WHEEL, MOUSE_SMOOTH_SCROLL or KEYBOARD request
+ * @buf destination
+ * @cap capacity of buf
+ *
+ * @return record size, -1 if the type has no packed form or cap is too small
+ **/
+int ya_encode_packed_event(const YAEvent *event, uint8_t *buf, size_t cap);
+
+/**
+ * Decode a UDP pointer datagram (protocol v5)
+ * @data datagram bytes
+ * @len datagram length, must be exactly YA_POINTER_DATAGRAM_SIZE
+ * @event caller-provided event, the MOUSE_MOVE payload is written inline
+ * @out_token session token carried by the datagram
+ *
+ * @return YA_POINTER_DATAGRAM_SIZE, -1 if the datagram is not a pointer
+ * datagram
+ **/
+int ya_decode_pointer_datagram(const uint8_t *data, size_t len, YAEvent *event, uint64_t *out_token);
+
+/**
+ * Encode a MOUSE_MOVE request as a UDP pointer datagram (protocol v5)
+ * @event MOUSE_MOVE request
+ * @token session token from the AUTHORIZE response
+ * @buf destination
+ * @cap capacity of buf
+ *
+ * @return YA_POINTER_DATAGRAM_SIZE, -1 if the event is not a MOUSE_MOVE or
+ * cap is too small
+ **/
+int ya_encode_pointer_datagram(const YAEvent *event, uint64_t token, uint8_t *buf, size_t cap);
+
 /**
  * Serialize an event to buffer
  *
@@ -257,6 +513,29 @@ int ya_parse_event(struct evbuffer *buf, YAEvent *event, YAPackageSize *size);
  **/
 int ya_serialize_event(YAEvent *event, uint8_t **out);
 
+/**
+ * Serialize an event into a caller-provided buffer in a single pass
+ * @event event
+ * @buf destination, the 8-byte length prefix, header and body are written in
+ * place
+ * @cap capacity of buf
+ *
+ * @return frame length, -1 if failed or the frame does not fit in cap
+ **/
+int ya_serialize_event_to(YAEvent *event, uint8_t *buf, size_t cap);
+
+/**
+ * Serialize an event directly into an output evbuffer
+ * @event event
+ * @out output buffer, usually bufferevent_get_output()
+ *
+ * Reserves YA_EVENT_FRAME_STACK_SIZE bytes with evbuffer_reserve_space and
+ * writes the frame there; larger frames fall back to ya_serialize_event.
+ *
+ * @return frame length, -1 is failed
+ **/
+int ya_serialize_event_to_evbuffer(YAEvent *event, struct evbuffer *out);
+
 /**
  * Free all event memory
  * @event event
@@ -0,0 +1,121 @@
+#include "ya_histogram.h"
+
+static unsigned highest_bit(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - (unsigned)__builtin_clzll(value);
+#else
+    unsigned bit = 0;
+    while (value >>= 1)
+    {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+size_t ya_histogram_bucket_index(uint64_t value)
+{
+    if (value < YA_HISTOGRAM_SUB_COUNT)
+    {
+        return (size_t)value;
+    }
+
+    unsigned bit = highest_bit(value);
+    if (bit >= YA_HISTOGRAM_MAX_BITS)
+    {
+        return YA_HISTOGRAM_BUCKETS - 1;
+    }
+
+    // 区间 [2^bit, 2^(bit+1)) 的第 sub 个子桶
+    unsigned shift = bit - YA_HISTOGRAM_SUB_BITS;
+    size_t sub = (size_t)((value >> shift) & (YA_HISTOGRAM_SUB_COUNT - 1));
+    return (size_t)(shift + 1) * YA_HISTOGRAM_SUB_COUNT + sub;
+}
+
+uint64_t ya_histogram_bucket_upper(size_t index)
+{
+    if (index < YA_HISTOGRAM_SUB_COUNT)
+    {
+        return (uint64_t)index;
+    }
+    if (index >= YA_HISTOGRAM_BUCKETS - 1)
+    {
+        return UINT64_MAX;
+    }
+
+    unsigned shift = (unsigned)(index / YA_HISTOGRAM_SUB_COUNT) - 1;
+    uint64_t sub = index % YA_HISTOGRAM_SUB_COUNT;
+    uint64_t lower = (YA_HISTOGRAM_SUB_COUNT + sub) << shift;
+    return lower + ((uint64_t)1 << shift) - 1;
+}
+
+#define LOAD(field) atomic_load_explicit(&(field), memory_order_relaxed)
+#define STORE(field, value) atomic_store_explicit(&(field), (value), memory_order_relaxed)
+
+// 单写者：先读后写即可，不需要原子的读-改-写
+void ya_histogram_record(ya_histogram_t *histogram, uint64_t value)
+{
+    uint64_t count = LOAD(histogram->count);
+    if (count == 0 || value < LOAD(histogram->min))
+    {
+        STORE(histogram->min, value);
+    }
+    if (value > LOAD(histogram->max))
+    {
+        STORE(histogram->max, value);
+    }
+    atomic_uint_least64_t *bucket = &histogram->buckets[ya_histogram_bucket_index(value)];
+    STORE(*bucket, LOAD(*bucket) + 1);
+    STORE(histogram->sum, LOAD(histogram->sum) + value);
+    STORE(histogram->count, count + 1);
+}
+
+uint64_t ya_histogram_count(const ya_histogram_t *histogram)
+{
+    return LOAD(histogram->count);
+}
+
+void ya_histogram_snapshot(const ya_histogram_t *histogram, ya_histogram_snapshot_t *out)
+{
+    out->count = 0;
+    for (size_t i = 0; i < YA_HISTOGRAM_BUCKETS; i++)
+    {
+        out->buckets[i] = LOAD(histogram->buckets[i]);
+        out->count += out->buckets[i];
+    }
+    out->sum = LOAD(histogram->sum);
+    out->min = out->count ? LOAD(histogram->min) : 0;
+    out->max = out->count ? LOAD(histogram->max) : 0;
+}
+
+uint64_t ya_histogram_percentile(const ya_histogram_snapshot_t *histogram, double q)
+{
+    if (histogram->count == 0)
+    {
+        return 0;
+    }
+    if (q <= 0.0)
+    {
+        return histogram->min;
+    }
+
+    // 第 ceil(q * count) 个值所在的桶
+    uint64_t target = (uint64_t)(q * (double)histogram->count);
+    if ((double)target < q * (double)histogram->count || target == 0)
+    {
+        target++;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < YA_HISTOGRAM_BUCKETS; i++)
+    {
+        seen += histogram->buckets[i];
+        if (seen >= target)
+        {
+            uint64_t upper = ya_histogram_bucket_upper(i);
+            return upper < histogram->max ? upper : histogram->max;
+        }
+    }
+    return histogram->max;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * 对数-线性分桶直方图（HDR 风格）
+ *
+ * 每个 2 的幂区间再等分为 YA_HISTOGRAM_SUB_COUNT 个子桶，相对误差不超过 1/YA_HISTOGRAM_SUB_COUNT。
+ * 小于 YA_HISTOGRAM_SUB_COUNT 的值精确记录；不小于 2^YA_HISTOGRAM_MAX_BITS 的值计入最后一个桶
+ * （以纳秒计约 4.3 秒）。记录只有几次整数运算，没有分配。
+ *
+ * 单写者：每个直方图只能由一个线程写入。字段都是原子变量（relaxed 读写，写入不加锁前缀），
+ * 其他线程通过 ya_histogram_snapshot 读取副本，可能看到稍旧的数据。
+ */
+
+#define YA_HISTOGRAM_SUB_BITS 3
+#define YA_HISTOGRAM_SUB_COUNT (1u << YA_HISTOGRAM_SUB_BITS)
+#define YA_HISTOGRAM_MAX_BITS 32
+#define YA_HISTOGRAM_BUCKETS ((YA_HISTOGRAM_MAX_BITS - YA_HISTOGRAM_SUB_BITS + 1) * YA_HISTOGRAM_SUB_COUNT)
+
+typedef struct {
+    atomic_uint_least64_t count;
+    atomic_uint_least64_t sum;
+    atomic_uint_least64_t min;
+    atomic_uint_least64_t max;
+    atomic_uint_least64_t buckets[YA_HISTOGRAM_BUCKETS];
+} ya_histogram_t;
+
+// 读取用的副本，count 取各桶之和，与 buckets 保持一致
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[YA_HISTOGRAM_BUCKETS];
+} ya_histogram_snapshot_t;
+
+// 记录一个值（只能由该直方图的写入线程调用）
+void ya_histogram_record(ya_histogram_t *histogram, uint64_t value);
+
+// 任意线程读取：已记录的值个数
+uint64_t ya_histogram_count(const ya_histogram_t *histogram);
+
+// 任意线程读取：复制一份副本
+void ya_histogram_snapshot(const ya_histogram_t *histogram, ya_histogram_snapshot_t *out);
+
+// 值所在的桶下标
+size_t ya_histogram_bucket_index(uint64_t value);
+
+// 桶覆盖的最大值（含）
+uint64_t ya_histogram_bucket_upper(size_t index);
+
+// 分位数（q 取 0..1），返回所在桶的上界且不超过记录过的最大值；没有记录时返回 0
+uint64_t ya_histogram_percentile(const ya_histogram_snapshot_t *histogram, double q);
@@ -0,0 +1,678 @@
+#include "ya_input_queue.h"
+#include "ya_logger.h"
+#include "ya_trace.h"
+#include "input/facade.h"
+#include "input/keyboard/handler.h"
+#include "input/keyboard/sequencer.h"
+#include "input/keyboard/text.h"
+
+#include <event2/event.h>
+#include <event2/util.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#define YA_INPUT_QUEUE_MASK (YA_INPUT_QUEUE_CAPACITY - 1)
+
+// 生产者、消费者下标分开放在不同的缓存行，避免伪共享
+static ya_input_action_t g_ring[YA_INPUT_QUEUE_CAPACITY];
+static _Alignas(64) atomic_size_t g_head; // 消费者：下一个要执行的位置（执行完才前移）
+static _Alignas(64) atomic_size_t g_tail; // 生产者：下一个写入位置
+
+static atomic_bool g_running;
+static atomic_bool g_consumer_waiting;
+static pthread_t g_thread;
+static pthread_mutex_t g_wait_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_wait_cond = PTHREAD_COND_INITIALIZER;
+static ya_input_execute_fn g_execute = NULL;
+
+// 队列满时暂存的合并位移（高32位 dx、低32位 dy，0 表示没有）。
+// 生产者放入下一个动作前先把它写进队列；注入线程发现队列已空时直接取走执行，
+// 之后不再有输入时位移也不会一直滞留
+static atomic_uint_least64_t g_pending_move;
+static atomic_bool g_pending_running; // 注入线程正在执行取走的暂存位移（drain 据此等待）
+
+// 以下只由生产者（事件循环线程）访问
+static size_t g_max_depth = 0;
+static uint64_t g_dropped = 0;
+
+// 注入线程交回事件循环的 TEXT_GET 结果，按完成顺序排成链表
+typedef struct ya_input_result {
+    struct ya_input_result *next;
+    uint32_t owner;
+    uint32_t index;
+    char *text;
+} ya_input_result_t;
+
+static pthread_mutex_t g_result_mutex = PTHREAD_MUTEX_INITIALIZER;
+static ya_input_result_t *g_result_head = NULL;
+static ya_input_result_t *g_result_tail = NULL;
+static evutil_socket_t g_result_fds[2] = {-1, -1}; // [0] 由事件循环读取，[1] 写入一个字节唤醒
+static struct event *g_result_event = NULL;
+static ya_input_text_result_fn g_on_text = NULL;
+
+// 执行失败的动作数，下标为 -YAError（PlatformError..NotFound），由执行动作的线程写入
+#define YA_INPUT_ERROR_SLOTS 6
+static atomic_uint_least64_t g_errors[YA_INPUT_ERROR_SLOTS];
+
+static void sleep_ms(unsigned ms)
+{
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
+// 全选并复制输入框内容，再读取剪贴板；成功时 *out 为 malloc 分配的文本
+static YAError read_input_text(char **out)
+{
+#ifdef __APPLE__
+    enum CKey modifier = Meta;
+#else
+    enum CKey modifier = Control;
+#endif
+
+    // 全选并复制: Modifier + A, Modifier + C（静默执行）
+    YAError err = input_key_action(modifier, Press);
+    if (err != Success)
+    {
+        return err;
+    }
+
+    err = key_action_with_code('a', Click);
+    if (err == Success)
+    {
+        err = key_action_with_code('c', Click);
+    }
+    YAError release_err = input_key_action(modifier, Release);
+    if (err == Success)
+    {
+        err = release_err;
+    }
+    if (err != Success)
+    {
+        return err;
+    }
+
+    // 取消选择
+    err = mouse_button(Left, Click);
+    if (err != Success)
+    {
+        return err;
+    }
+
+    const char *clipboard_text = clipboard_get();
+    if (clipboard_text == NULL)
+    {
+        return ClipboardError;
+    }
+
+    *out = strdup(clipboard_text);
+    free_string((char *)clipboard_text);
+    return *out ? Success : PlatformError;
+}
+
+void ya_input_execute(const ya_input_action_t *action)
+{
+    YAError err = Success;
+    if (action->type != YA_INPUT_KEY_CHAR && action->type != YA_INPUT_MOVE && action->type != YA_INPUT_KEY_RELEASE)
+    {
+        // 点击、滚轮、功能键、文本不能带上字符锁存的修饰键
+        keyboard_release_latched(0);
+    }
+    if (action->type != YA_INPUT_KEY_CHAR && action->type != YA_INPUT_KEY_FUNCTION &&
+        action->type != YA_INPUT_KEY_RELEASE)
+    {
+        // 其他动作不能越过时间线上尚未执行的按键步骤
+        key_sequencer_flush();
+    }
+
+    switch (action->type)
+    {
+    case YA_INPUT_MOVE:
+        err = input_mouse_move(action->move.dx, action->move.dy);
+        if (err != Success)
+        {
+            YA_LOG_ERROR("Failed to move mouse: (%d,%d) error=%d", action->move.dx, action->move.dy, err);
+        }
+        break;
+    case YA_INPUT_BUTTON:
+        err = input_mouse_button(action->button.button, action->button.dir);
+        if (err == Success && action->button.double_click)
+        {
+            err = input_mouse_button(action->button.button, action->button.dir);
+        }
+        if (err != Success)
+        {
+            YA_LOG_ERROR("Mouse button event failed (dir=%d, double=%d): error %d", (int)action->button.dir,
+                         action->button.double_click, err);
+        }
+        break;
+    case YA_INPUT_SCROLL:
+        err = input_mouse_scroll(action->scroll.amount, action->scroll.dir);
+        if (err != Success)
+        {
+            YA_LOG_ERROR("Mouse scroll failed: error %d", err);
+        }
+        break;
+    case YA_INPUT_SMOOTH_SCROLL:
+        err = input_mouse_scroll_smooth(action->smooth_scroll.hires_x, action->smooth_scroll.hires_y,
+                                        action->smooth_scroll.notch_x, action->smooth_scroll.notch_y);
+        if (err != Success)
+        {
+            YA_LOG_ERROR("Mouse smooth scroll failed: error %d", err);
+        }
+        break;
+    case YA_INPUT_KEY_CHAR:
+        // 编译成按键步骤追加到时间线，步骤之间的等待由注入线程的定时等待完成；
+        // 连续字符之间修饰键保持锁存，只切换变化的修饰键
+        err = keyboard_char_latched(action->key_char.owner, action->key_char.codepoint, action->key_char.mods,
+                                    action->key_char.dir);
+        if (err != Success)
+        {
+            YA_LOG_ERROR("Keyboard input failed: error %d", err);
+        }
+        break;
+    case YA_INPUT_KEY_FUNCTION:
+        err = keyboard_function_key_submit(action->key_function.key, action->key_function.mods,
+                                           action->key_function.dir);
+        if (err != Success)
+        {
+            YA_LOG_ERROR("Keyboard input failed: error %d", err);
+        }
+        break;
+    case YA_INPUT_KEY_RELEASE:
+        keyboard_release_latched(action->key_release.owner);
+        break;
+    case YA_INPUT_TEXT:
+        // Linux 上按 xkb 映射批量写入按键，只有无法映射的片段走剪贴板
+        err = keyboard_type_text(action->text.text, NULL);
+        if (err != Success)
+        {
+            YA_LOG_ERROR("Text input failed: error %d", err);
+        }
+        break;
+    case YA_INPUT_TEXT_GET: {
+        char *text = NULL;
+        err = read_input_text(&text);
+        if (err != Success)
+        {
+            YA_LOG_ERROR("Reading input text failed: error %d", err);
+        }
+        ya_input_queue_complete_text(action, text);
+        break;
+    }
+    }
+
+    if (err < 0 && -err < YA_INPUT_ERROR_SLOTS)
+    {
+        atomic_fetch_add_explicit(&g_errors[-err], 1, memory_order_relaxed);
+    }
+
+    YA_TRACE(.type = (uint16_t)action->type, .stage = YA_TRACE_INJECT,
+             .out_dx = action->type == YA_INPUT_MOVE ? action->move.dx : 0,
+             .out_dy = action->type == YA_INPUT_MOVE ? action->move.dy : 0, .result = (int32_t)err);
+}
+
+static void release_action(ya_input_action_t *action)
+{
+    if (action->type == YA_INPUT_TEXT)
+    {
+        free(action->text.text);
+        action->text.text = NULL;
+    }
+}
+
+// 等待新动作，wait_ms >= 0 时最多等到下一个按键步骤到期
+static void wait_for_work(int wait_ms)
+{
+    if (wait_ms < 0)
+    {
+        pthread_cond_wait(&g_wait_cond, &g_wait_mutex);
+        return;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += wait_ms / 1000;
+    deadline.tv_nsec += (long)(wait_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&g_wait_cond, &g_wait_mutex, &deadline);
+}
+
+static uint64_t pack_move(int32_t dx, int32_t dy)
+{
+    return ((uint64_t)(uint32_t)dx << 32) | (uint32_t)dy;
+}
+
+static void unpack_move(uint64_t packed, int32_t *dx, int32_t *dy)
+{
+    *dx = (int32_t)(uint32_t)(packed >> 32);
+    *dy = (int32_t)(uint32_t)packed;
+}
+
+// 把位移累加到暂存位移
+static void add_pending_move(int32_t dx, int32_t dy)
+{
+    uint64_t cur = atomic_load(&g_pending_move);
+    for (;;)
+    {
+        int32_t pdx, pdy;
+        unpack_move(cur, &pdx, &pdy);
+        uint64_t next = pack_move((int32_t)((uint32_t)pdx + (uint32_t)dx), (int32_t)((uint32_t)pdy + (uint32_t)dy));
+        if (atomic_compare_exchange_weak(&g_pending_move, &cur, next))
+        {
+            return;
+        }
+    }
+}
+
+// 注入线程：队列已空时执行生产者来不及写进队列的暂存位移。
+// 暂存位移只在队列满时产生，之后的动作都要先把它写进队列，
+// 所以队列为空时它之前的动作都已执行，之后的动作还没有放入
+static bool run_pending_move(void)
+{
+    atomic_store(&g_pending_running, true);
+    uint64_t packed = atomic_exchange(&g_pending_move, 0);
+    if (packed != 0)
+    {
+        ya_input_action_t move = {.type = YA_INPUT_MOVE};
+        unpack_move(packed, &move.move.dx, &move.move.dy);
+        g_execute(&move);
+    }
+    atomic_store(&g_pending_running, false);
+    return packed != 0;
+}
+
+static void *injection_main(void *arg)
+{
+    (void)arg;
+    for (;;)
+    {
+        // 先执行已到期的按键步骤；新的按键动作直接追加到时间线，与前一个字符的步骤流水执行。
+        // 锁存的修饰键空闲超时后释放
+        int latch_ms = keyboard_latch_poll();
+        int wait_ms = key_sequencer_run_due();
+        if (latch_ms >= 0 && (wait_ms < 0 || latch_ms < wait_ms))
+        {
+            wait_ms = latch_ms;
+        }
+
+        size_t head = atomic_load_explicit(&g_head, memory_order_relaxed);
+        if (head == atomic_load_explicit(&g_tail, memory_order_acquire))
+        {
+            if (run_pending_move())
+            {
+                continue;
+            }
+
+            if (!atomic_load(&g_running) && wait_ms < 0)
+            {
+                break;
+            }
+
+            // 队列为空：登记等待后再检查一次，生产者看到登记才发信号，避免每次放入都进内核
+            pthread_mutex_lock(&g_wait_mutex);
+            atomic_store(&g_consumer_waiting, true);
+            if (head == atomic_load(&g_tail) && atomic_load(&g_pending_move) == 0 &&
+                (atomic_load(&g_running) || wait_ms >= 0))
+            {
+                wait_for_work(wait_ms);
+            }
+            atomic_store(&g_consumer_waiting, false);
+            pthread_mutex_unlock(&g_wait_mutex);
+            continue;
+        }
+
+        ya_input_action_t *action = &g_ring[head & YA_INPUT_QUEUE_MASK];
+        g_execute(action);
+        ya_latency_record_injected(&action->origin);
+        release_action(action);
+
+        // 执行完成后才归还槽位，drain 据此判断注入是否结束
+        atomic_store_explicit(&g_head, head + 1, memory_order_release);
+    }
+    return NULL;
+}
+
+static void wake_consumer(void)
+{
+    if (atomic_load(&g_consumer_waiting))
+    {
+        pthread_mutex_lock(&g_wait_mutex);
+        pthread_cond_signal(&g_wait_cond);
+        pthread_mutex_unlock(&g_wait_mutex);
+    }
+}
+
+// 尝试写入一个槽位，队列满时返回 false
+static bool try_enqueue(const ya_input_action_t *action)
+{
+    size_t tail = atomic_load_explicit(&g_tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&g_head, memory_order_acquire);
+    if (tail - head >= YA_INPUT_QUEUE_CAPACITY)
+    {
+        return false;
+    }
+
+    g_ring[tail & YA_INPUT_QUEUE_MASK] = *action;
+    atomic_store(&g_tail, tail + 1);
+
+    size_t depth = tail + 1 - head;
+    if (depth > g_max_depth)
+    {
+        g_max_depth = depth;
+    }
+
+    wake_consumer();
+    return true;
+}
+
+// 把暂存位移写进队列，保证它在之后放入的动作之前执行；队列仍满时放回并返回 false
+static bool flush_pending_move(void)
+{
+    uint64_t packed = atomic_exchange(&g_pending_move, 0);
+    if (packed == 0)
+    {
+        return true;
+    }
+
+    ya_input_action_t move = {.type = YA_INPUT_MOVE};
+    unpack_move(packed, &move.move.dx, &move.move.dy);
+    if (try_enqueue(&move))
+    {
+        return true;
+    }
+
+    // 放回后唤醒注入线程：它可能在取出之后、放回之前清空了队列并进入等待
+    add_pending_move(move.move.dx, move.move.dy);
+    wake_consumer();
+    return false;
+}
+
+// 事件循环线程：交回排队期间完成的 TEXT_GET 结果
+static void result_readcb(evutil_socket_t fd, short events, void *arg)
+{
+    (void)events;
+    (void)arg;
+
+    char drain[64];
+    while (recv(fd, drain, sizeof(drain), 0) > 0)
+    {
+    }
+
+    pthread_mutex_lock(&g_result_mutex);
+    ya_input_result_t *result = g_result_head;
+    g_result_head = g_result_tail = NULL;
+    pthread_mutex_unlock(&g_result_mutex);
+
+    while (result)
+    {
+        ya_input_result_t *next = result->next;
+        if (g_on_text)
+        {
+            g_on_text(result->owner, result->index, result->text);
+        }
+        else
+        {
+            free(result->text);
+        }
+        free(result);
+        result = next;
+    }
+}
+
+int ya_input_queue_attach(struct event_base *base, ya_input_text_result_fn on_text)
+{
+    if (!base || !on_text || g_result_event)
+    {
+        return -1;
+    }
+
+#ifdef _WIN32
+    int family = AF_INET;
+#else
+    int family = AF_UNIX;
+#endif
+    evutil_socket_t fds[2];
+    if (evutil_socketpair(family, SOCK_STREAM, 0, fds) < 0)
+    {
+        YA_LOG_ERROR("Failed to create input result socket pair");
+        return -1;
+    }
+    evutil_make_socket_nonblocking(fds[0]);
+    evutil_make_socket_nonblocking(fds[1]);
+
+    g_result_event = event_new(base, fds[0], EV_READ | EV_PERSIST, result_readcb, NULL);
+    if (!g_result_event || event_add(g_result_event, NULL) < 0)
+    {
+        YA_LOG_ERROR("Failed to register input result event");
+        if (g_result_event)
+        {
+            event_free(g_result_event);
+            g_result_event = NULL;
+        }
+        evutil_closesocket(fds[0]);
+        evutil_closesocket(fds[1]);
+        return -1;
+    }
+
+    g_on_text = on_text;
+    pthread_mutex_lock(&g_result_mutex);
+    g_result_fds[0] = fds[0];
+    g_result_fds[1] = fds[1];
+    pthread_mutex_unlock(&g_result_mutex);
+    return 0;
+}
+
+void ya_input_queue_detach(void)
+{
+    if (!g_result_event)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&g_result_mutex);
+    ya_input_result_t *result = g_result_head;
+    g_result_head = g_result_tail = NULL;
+    evutil_socket_t fds[2] = {g_result_fds[0], g_result_fds[1]};
+    g_result_fds[0] = g_result_fds[1] = -1;
+    pthread_mutex_unlock(&g_result_mutex);
+
+    while (result)
+    {
+        ya_input_result_t *next = result->next;
+        free(result->text);
+        free(result);
+        result = next;
+    }
+
+    event_free(g_result_event);
+    g_result_event = NULL;
+    g_on_text = NULL;
+    evutil_closesocket(fds[0]);
+    evutil_closesocket(fds[1]);
+}
+
+void ya_input_queue_complete_text(const ya_input_action_t *action, char *text)
+{
+    ya_input_result_t *result = (ya_input_result_t *)malloc(sizeof(ya_input_result_t));
+    if (!result)
+    {
+        free(text);
+        return;
+    }
+    result->next = NULL;
+    result->owner = action->text_get.owner;
+    result->index = action->text_get.index;
+    result->text = text;
+
+    pthread_mutex_lock(&g_result_mutex);
+    if (g_result_fds[1] < 0)
+    {
+        // 没有事件循环接收结果
+        pthread_mutex_unlock(&g_result_mutex);
+        free(text);
+        free(result);
+        return;
+    }
+
+    bool was_empty = g_result_head == NULL;
+    if (g_result_tail)
+    {
+        g_result_tail->next = result;
+    }
+    else
+    {
+        g_result_head = result;
+    }
+    g_result_tail = result;
+
+    // 链表原本非空时事件循环已被唤醒，还没来得及取走
+    if (was_empty)
+    {
+        send(g_result_fds[1], "r", 1, 0);
+    }
+    pthread_mutex_unlock(&g_result_mutex);
+}
+
+int ya_input_queue_start(ya_input_execute_fn execute)
+{
+    if (!execute || atomic_load(&g_running))
+    {
+        return -1;
+    }
+
+    g_execute = execute;
+    atomic_store(&g_head, 0);
+    atomic_store(&g_tail, 0);
+    atomic_store(&g_consumer_waiting, false);
+    atomic_store(&g_pending_move, 0);
+    atomic_store(&g_running, true);
+    if (pthread_create(&g_thread, NULL, injection_main, NULL) != 0)
+    {
+        atomic_store(&g_running, false);
+        YA_LOG_ERROR("Failed to start input injection thread, injecting on the event loop");
+        return -1;
+    }
+
+    YA_LOG_INFO("Input injection thread started (queue capacity %d)", YA_INPUT_QUEUE_CAPACITY);
+    return 0;
+}
+
+void ya_input_queue_stop(void)
+{
+    if (!atomic_load(&g_running))
+    {
+        return;
+    }
+
+    // 释放锁存的修饰键，再等队列和按键时间线执行完
+    ya_input_action_t release = {.type = YA_INPUT_KEY_RELEASE, .key_release = {.owner = 0}};
+    ya_input_queue_push(&release);
+    ya_input_queue_drain();
+
+    pthread_mutex_lock(&g_wait_mutex);
+    atomic_store(&g_running, false);
+    pthread_cond_signal(&g_wait_cond);
+    pthread_mutex_unlock(&g_wait_mutex);
+    pthread_join(g_thread, NULL);
+
+    YA_LOG_DEBUG("Input injection thread stopped (max depth %zu, dropped %llu)", g_max_depth,
+                 (unsigned long long)g_dropped);
+}
+
+bool ya_input_queue_push(const ya_input_action_t *in)
+{
+    if (!in)
+    {
+        return false;
+    }
+
+    // 带上当前正在处理的事件，注入完成后据此统计延迟
+    ya_input_action_t stamped = *in;
+    stamped.origin = ya_latency_current_origin();
+    const ya_input_action_t *action = &stamped;
+
+    if (!atomic_load(&g_running))
+    {
+        // 注入线程未启动（例如测试环境）：在调用线程上同步执行
+        ya_input_execute(&stamped);
+        ya_latency_record_injected(&stamped.origin);
+        release_action(&stamped);
+        keyboard_release_latched(0);
+        key_sequencer_flush();
+        return true;
+    }
+
+    if (action->type == YA_INPUT_MOVE)
+    {
+        // 移动可以合并：队列满时累加到暂存位移，不阻塞事件循环，也不丢失距离
+        if (flush_pending_move() && try_enqueue(action))
+        {
+            return true;
+        }
+        add_pending_move(action->move.dx, action->move.dy);
+        wake_consumer();
+        return true;
+    }
+
+    // 不在事件循环上等待队列腾出空间：队列满时直接丢弃
+    if (flush_pending_move() && try_enqueue(action))
+    {
+        return true;
+    }
+
+    g_dropped++;
+    YA_LOG_WARN("Input queue full, dropping action type %d", (int)action->type);
+    release_action(&stamped);
+    return false;
+}
+
+void ya_input_queue_drain(void)
+{
+    if (!atomic_load(&g_running))
+    {
+        return;
+    }
+
+    // 暂存位移由注入线程在队列清空后执行；动作执行完后按键步骤可能还在时间线上，一并等待
+    while (atomic_load_explicit(&g_head, memory_order_acquire) != atomic_load_explicit(&g_tail, memory_order_relaxed) ||
+           atomic_load(&g_pending_move) != 0 || atomic_load(&g_pending_running) || !key_sequencer_idle())
+    {
+        sleep_ms(1);
+    }
+}
+
+size_t ya_input_queue_max_depth(void)
+{
+    return g_max_depth;
+}
+
+uint64_t ya_input_queue_dropped(void)
+{
+    return g_dropped;
+}
+
+uint64_t ya_input_queue_errors(YAError code)
+{
+    if (code >= 0 || -code >= YA_INPUT_ERROR_SLOTS)
+    {
+        return 0;
+    }
+    return atomic_load_explicit(&g_errors[-code], memory_order_relaxed);
+}
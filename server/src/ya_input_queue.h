@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rs.h"
+#include "ya_latency.h"
+
+/**
+ * 输入注入队列
+ *
+ * 事件循环线程解码、校验请求后把注入动作放进单生产者/单消费者无锁环形队列，
+ * 由独立的注入线程依次执行。按键动作编译成按键步骤追加到按键时间线
+ * （input/keyboard/sequencer.h），注入线程在步骤到期前做定时等待，期间继续接收新动作，
+ * 不会拖住心跳和其他客户端的指针帧。
+ *
+ * 读取输入框文本（TEXT_GET）同样排队执行，结果经套接字对唤醒事件循环后交回回调。
+ *
+ * 只允许事件循环线程调用 push（单生产者），push 不会阻塞：队列满时移动被合并，其他动作直接丢弃。
+ */
+
+struct event_base;
+
+// 队列容量（必须是2的幂）
+#define YA_INPUT_QUEUE_CAPACITY 1024
+
+typedef enum {
+    YA_INPUT_MOVE = 0,         // 相对移动
+    YA_INPUT_BUTTON = 1,       // 鼠标按键（可选双击）
+    YA_INPUT_SCROLL = 2,       // 滚轮
+    YA_INPUT_KEY_CHAR = 3,     // 字符按键（keyboard_char_latched）
+    YA_INPUT_KEY_FUNCTION = 4, // 功能键（keyboard_function_key_submit）
+    YA_INPUT_TEXT = 5,         // 文本输入，text 由队列接管并在执行后释放
+    YA_INPUT_KEY_RELEASE = 6,  // 释放锁存的修饰键（客户端断开、读取剪贴板前）
+    YA_INPUT_SMOOTH_SCROLL = 7, // 高精度滚动（1/120 格）及同一帧里的整格
+    YA_INPUT_TEXT_GET = 8,     // 全选复制后读取剪贴板，结果经 ya_input_queue_complete_text 交回事件循环
+} ya_input_action_type_t;
+
+typedef struct {
+    ya_input_action_type_t type;
+    ya_latency_origin_t origin; // 产生该动作的事件，由 ya_input_queue_push 填写，用于注入延迟统计
+    union {
+        struct {
+            int32_t dx;
+            int32_t dy;
+        } move;
+        struct {
+            enum CButton button;
+            enum CDirection dir;
+            bool double_click;
+        } button;
+        struct {
+            int amount;
+            int dir; // 0=up, 1=down, 2=left, 3=right
+        } scroll;
+        struct {
+            int32_t hires_x; // 正数向右
+            int32_t hires_y; // 正数向上
+            int32_t notch_x;
+            int32_t notch_y;
+        } smooth_scroll;
+        struct {
+            int32_t codepoint;
+            uint32_t mods;
+            enum CDirection dir;
+            uint32_t owner; // 发送字符的客户端 uid，连续字符之间修饰键保持按下
+        } key_char;
+        struct {
+            enum CKey key;
+            uint32_t mods;
+            enum CDirection dir;
+        } key_function;
+        struct {
+            char *text;
+        } text;
+        struct {
+            uint32_t owner; // 只释放该客户端锁存的修饰键（0 = 任意客户端）
+        } key_release;
+        struct {
+            uint32_t owner; // 请求的客户端 uid
+            uint32_t index; // 请求的事件序号，回复时原样带回
+        } text_get;
+    };
+} ya_input_action_t;
+
+// 执行一个注入动作
+typedef void (*ya_input_execute_fn)(const ya_input_action_t *action);
+
+// TEXT_GET 的结果，在事件循环线程上回调；text 为 NULL 表示读取失败，否则由回调接管
+typedef void (*ya_input_text_result_fn)(uint32_t owner, uint32_t index, char *text);
+
+// 默认执行器：调用输入门面和键盘处理
+void ya_input_execute(const ya_input_action_t *action);
+
+// 启动注入线程；未启动时 push 在调用线程上同步执行
+int ya_input_queue_start(ya_input_execute_fn execute);
+
+// 执行完队列中剩余的动作后停止注入线程
+void ya_input_queue_stop(void);
+
+// 在事件循环上接收 TEXT_GET 结果；未注册时结果被丢弃
+int ya_input_queue_attach(struct event_base *base, ya_input_text_result_fn on_text);
+
+// 取消注册并丢弃尚未交回的结果（在注入线程停止后、释放 event_base 之前调用）
+void ya_input_queue_detach(void);
+
+// 执行器完成 TEXT_GET 后调用（任意线程），text 由队列接管
+void ya_input_queue_complete_text(const ya_input_action_t *action, char *text);
+
+// 放入一个动作；返回 false 表示队列已满而被丢弃（YA_INPUT_TEXT 的 text 同样被释放）
+bool ya_input_queue_push(const ya_input_action_t *action);
+
+// 等待已放入的动作全部执行完毕（停止注入线程和测试使用，会阻塞调用线程）
+void ya_input_queue_drain(void);
+
+// 统计：队列深度峰值、丢弃数
+size_t ya_input_queue_max_depth(void);
+uint64_t ya_input_queue_dropped(void);
+
+// 统计：执行失败的动作数，按后端错误码（rs.h YAError）分类，按键步骤的失败见 key_sequencer_step_errors
+uint64_t ya_input_queue_errors(YAError code);
@@ -0,0 +1,88 @@
+#include "ya_latency.h"
+#include "ya_event.h"
+
+#include <string.h>
+#include <time.h>
+
+static ya_histogram_t g_histograms[YA_EVENT_TYPE_COUNT][YA_LATENCY_STAGE_COUNT];
+
+// 只由事件循环线程访问
+static ya_latency_origin_t g_current = {0};
+
+static const char *stage_names[YA_LATENCY_STAGE_COUNT] = {"decode", "dispatch", "inject", "total"};
+
+uint64_t ya_latency_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+// 时钟不会倒退，但两个时刻可能来自不同线程的读取，差值为负时按 0 记录
+static void record(uint32_t type, ya_latency_stage_t stage, uint64_t from_ns, uint64_t to_ns)
+{
+    ya_histogram_record(&g_histograms[type][stage], to_ns > from_ns ? to_ns - from_ns : 0);
+}
+
+void ya_latency_begin_event(uint32_t type, uint64_t readable_ns, uint64_t decoded_ns)
+{
+    if (readable_ns == 0 || type >= YA_EVENT_TYPE_COUNT)
+    {
+        g_current.readable_ns = 0;
+        return;
+    }
+
+    uint64_t now = ya_latency_now_ns();
+    record(type, YA_LATENCY_DECODE, readable_ns, decoded_ns);
+    record(type, YA_LATENCY_DISPATCH, decoded_ns, now);
+
+    g_current.type = type;
+    g_current.readable_ns = readable_ns;
+    g_current.dispatch_ns = now;
+}
+
+void ya_latency_end_event(void)
+{
+    g_current.readable_ns = 0;
+}
+
+ya_latency_origin_t ya_latency_current_origin(void)
+{
+    return g_current;
+}
+
+void ya_latency_record_injected(const ya_latency_origin_t *origin)
+{
+    if (!origin || origin->readable_ns == 0 || origin->type >= YA_EVENT_TYPE_COUNT)
+    {
+        return;
+    }
+
+    uint64_t now = ya_latency_now_ns();
+    record(origin->type, YA_LATENCY_INJECT, origin->dispatch_ns, now);
+    record(origin->type, YA_LATENCY_TOTAL, origin->readable_ns, now);
+}
+
+const ya_histogram_t *ya_latency_histogram(uint32_t type, ya_latency_stage_t stage)
+{
+    if (type >= YA_EVENT_TYPE_COUNT || (unsigned)stage >= YA_LATENCY_STAGE_COUNT)
+    {
+        return NULL;
+    }
+    return &g_histograms[type][stage];
+}
+
+const char *ya_latency_stage_name(ya_latency_stage_t stage)
+{
+    if ((unsigned)stage >= YA_LATENCY_STAGE_COUNT)
+    {
+        return "unknown";
+    }
+    return stage_names[stage];
+}
+
+void ya_latency_reset(void)
+{
+    memset(g_histograms, 0, sizeof(g_histograms));
+    g_current.readable_ns = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "ya_histogram.h"
+
+/**
+ * 输入事件端到端延迟统计
+ *
+ * 按事件类型为每个阶段维护一个直方图（纳秒）：
+ *   套接字可读 → 解码完成 → 交给处理函数 → 注入后端返回
+ * 传输层在 YAEvent 上记下可读、解码完成的时刻，process_server_event 交给处理函数时调用
+ * ya_latency_begin_event：记录前两段，并把事件登记为“当前事件”。处理函数放入注入队列的动作
+ * 带上当前事件的时刻，注入线程执行完后调用 ya_latency_record_injected 记录后两段。
+ *
+ * 解码、分发两段只由事件循环线程写入，注入、总计两段只由注入线程写入（注入线程未启动时
+ * 由事件循环线程同步执行），每个直方图都是单写者；其他线程用 ya_histogram_snapshot 读取。
+ */
+
+typedef enum {
+    YA_LATENCY_DECODE = 0,   // 套接字可读 → 解码完成
+    YA_LATENCY_DISPATCH = 1, // 解码完成 → 交给处理函数（序号校验、客户端查找）
+    YA_LATENCY_INJECT = 2,   // 交给处理函数 → 注入后端返回（排队 + 后端写入）
+    YA_LATENCY_TOTAL = 3,    // 套接字可读 → 注入后端返回
+    YA_LATENCY_STAGE_COUNT
+} ya_latency_stage_t;
+
+// 注入动作的来源事件，readable_ns 为 0 表示不统计（例如定时器回放的移动）
+typedef struct {
+    uint32_t type;         // YAEventType
+    uint64_t readable_ns;  // 套接字可读的时刻
+    uint64_t dispatch_ns;  // 交给处理函数的时刻
+} ya_latency_origin_t;
+
+// 单调时钟纳秒数
+uint64_t ya_latency_now_ns(void);
+
+// 事件交给处理函数前调用（事件循环线程），readable_ns 为 0 时不统计
+void ya_latency_begin_event(uint32_t type, uint64_t readable_ns, uint64_t decoded_ns);
+
+// 处理函数返回后调用，之后放入队列的动作不再关联该事件
+void ya_latency_end_event(void);
+
+// 当前事件（ya_input_queue_push 填入动作）
+ya_latency_origin_t ya_latency_current_origin(void);
+
+// 注入后端返回后调用（注入线程）
+void ya_latency_record_injected(const ya_latency_origin_t *origin);
+
+// 某事件类型某阶段的直方图，类型越界时返回 NULL
+const ya_histogram_t *ya_latency_histogram(uint32_t type, ya_latency_stage_t stage);
+
+// 阶段名称（decode / dispatch / inject / total）
+const char *ya_latency_stage_name(ya_latency_stage_t stage);
+
+// 清空所有直方图（注入线程未运行时调用）
+void ya_latency_reset(void);
@@ -1,6 +1,7 @@
 #include "ya_logger.h"
 #include <errno.h>
-#include <sys/stat.h> 
+#include <pthread.h>
+#include <sys/stat.h>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -8,6 +9,7 @@
 
 // 全局日志实例
 ya_logger_t* g_logger = NULL;
+atomic_int g_log_level = YA_LOG_LEVEL_OFF;
 
 // 默认日志格式选项
 static ya_log_format_t g_log_format = {
@@ -41,47 +43,125 @@ const char* ya_logger_level_name(ya_log_level_t level) {
     return "UNKNOWN";
 }
 
-// 检查文件大小并进行日志轮转
+// 异步模式的单条记录：seq 为环形队列的序号，生产者写满记录后发布
+typedef struct {
+    atomic_size_t seq;
+    uint16_t len;          // text 中整行的长度（含前缀与换行）
+    uint16_t msg_offset;   // 消息内容在 text 中的偏移（系统日志只写消息内容）
+    uint16_t msg_len;
+    uint8_t level;
+    char text[YA_LOG_ASYNC_RECORD_SIZE - 16];
+} ya_log_record_t;
+
+// 后台线程每次写出的最大批量
+#define ASYNC_BATCH_SIZE (64 * 1024)
+// 队列为空时后台线程的等待时长
+#define ASYNC_IDLE_WAIT_MS 20
+
+// 有界 MPSC 环形队列：生产者 CAS 抢占 enqueue_pos，唯一消费者（后台线程）顺序读取
+struct ya_log_async {
+    ya_log_record_t* ring;
+    size_t mask;
+    char pad0[64];
+    atomic_size_t enqueue_pos;
+    char pad1[64];
+    size_t dequeue_pos;                // 只由后台线程访问
+    atomic_uint_least64_t dropped;     // 队列满时丢弃的条数
+    uint64_t dropped_reported;         // 已写入日志提示的丢弃条数
+    atomic_bool running;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    char* batch;
+    size_t batch_len;
+};
+
+// 日志轮转：关闭当前文件，依次重命名备份后重新打开
+static void rotate_log(ya_logger_t* logger) {
+    fclose(logger->log_fp);
+
+    // 执行日志文件轮转
+    for (int i = logger->config.max_backup_files - 1; i >= 0; i--) {
+        char old_name[256], new_name[256];
+        if (i == 0) {
+            snprintf(old_name, sizeof(old_name), "%s", logger->config.log_file);
+        } else {
+            snprintf(old_name, sizeof(old_name), "%s.%d", logger->config.log_file, i);
+        }
+        snprintf(new_name, sizeof(new_name), "%s.%d", logger->config.log_file, i + 1);
+        rename(old_name, new_name);
+    }
+
+    // 重新打开日志文件
+    logger->log_fp = fopen(logger->config.log_file, "a");
+    if (logger->log_fp) {
+        setvbuf(logger->log_fp, NULL, _IONBF, 0);
+    }
+    logger->file_size = 0;
+}
+
+// 检查文件大小并进行日志轮转：大小按写入量在内存中累计，不再每条日志 stat 一次
+// max_file_size 为 0 时不轮转
 static void check_and_rotate_log(ya_logger_t* logger) {
-    if (!logger->config.log_file || !logger->log_fp) {
+    if (!logger->config.log_file || !logger->log_fp || logger->config.max_file_size == 0) {
         return;
     }
 
-    struct stat st;
-    if (stat(logger->config.log_file, &st) == 0) {
-        if (st.st_size >= logger->config.max_file_size) {
-            fclose(logger->log_fp);
-            
-            // 执行日志文件轮转
-            for (int i = logger->config.max_backup_files - 1; i >= 0; i--) {
-                char old_name[256], new_name[256];
-                if (i == 0) {
-                    snprintf(old_name, sizeof(old_name), "%s", logger->config.log_file);
-                } else {
-                    snprintf(old_name, sizeof(old_name), "%s.%d", logger->config.log_file, i);
-                }
-                snprintf(new_name, sizeof(new_name), "%s.%d", logger->config.log_file, i + 1);
-                rename(old_name, new_name);
-            }
+    if (logger->file_size >= logger->config.max_file_size) {
+        rotate_log(logger);
+    }
+}
+
+// 写出一段已格式化的日志（一行或一批）到文件和控制台
+// 同步模式下事件循环、注入线程和按键时间线都会调用，整段在 write_lock 内完成，
+// 避免 file_size 累计丢失，以及一个线程轮转关闭文件时另一个线程仍在写
+static void write_log_output(ya_logger_t* logger, const char* data, size_t len) {
+    pthread_mutex_lock(&logger->write_lock);
 
-            // 重新打开日志文件
-            logger->log_fp = fopen(logger->config.log_file, "a");
+    if (logger->log_fp) {
+        check_and_rotate_log(logger);
+    }
+
+    // 文件无缓冲，fwrite 直接对应一次 write
+    if (logger->log_fp) {
+        size_t written = fwrite(data, 1, len, logger->log_fp);
+        logger->file_size += written;
+        if (written != len) {
+            if (logger->last_error) {
+                free(logger->last_error);
+            }
+            logger->last_error = strdup(strerror(errno));
+            clearerr(logger->log_fp);
         }
     }
+
+    // 输出到控制台
+    if (logger->config.use_console) {
+        fwrite(data, 1, len, stdout);
+        fflush(stdout);
+    }
+
+    pthread_mutex_unlock(&logger->write_lock);
 }
 
-// 格式化时间戳
+// 格式化时间戳：精度为秒，每个线程缓存当前秒的结果，同一秒内不再调用 localtime/strftime
 static void format_timestamp(char* buffer, size_t size) {
+    static _Thread_local time_t cached_time = (time_t)-1;
+    static _Thread_local char cached[MAX_TIMESTAMP_SIZE];
     time_t now;
-    struct tm tm_now;
-    
+
     time(&now);
+    if (now != cached_time) {
+        struct tm tm_now;
 #ifdef _WIN32
-    localtime_s(&tm_now, &now);
+        localtime_s(&tm_now, &now);
 #else
-    localtime_r(&now, &tm_now);
+        localtime_r(&now, &tm_now);
 #endif
-    strftime(buffer, size, g_log_format.date_format, &tm_now);
+        strftime(cached, sizeof(cached), g_log_format.date_format, &tm_now);
+        cached_time = now;
+    }
+    snprintf(buffer, size, "%s", cached);
 }
 
 // 写入系统日志
@@ -178,6 +258,256 @@ static void write_to_system_log(ya_log_level_t level, const char* message) {
 #endif
 }
 
+// 格式化行前缀（时间戳、级别、文件行号），返回写入长度
+static size_t format_prefix(char* buffer, size_t size, ya_log_level_t level, const char* file, int line) {
+    size_t written = 0;
+    int n;
+
+    if (g_log_format.include_timestamp) {
+        char timestamp[MAX_TIMESTAMP_SIZE] = {0};
+        format_timestamp(timestamp, sizeof(timestamp));
+        n = snprintf(buffer + written, size - written, "[%s] ", timestamp);
+        written += (n > 0) ? (size_t)n : 0;
+        written = written < size ? written : size - 1;
+    }
+
+    if (g_log_format.include_level) {
+        n = snprintf(buffer + written, size - written, "[%s] ", ya_logger_level_name(level));
+        written += (n > 0) ? (size_t)n : 0;
+        written = written < size ? written : size - 1;
+    }
+
+    if (g_log_format.include_file_line && file) {
+        n = snprintf(buffer + written, size - written, "[%s:%d] ", file, line);
+        written += (n > 0) ? (size_t)n : 0;
+        written = written < size ? written : size - 1;
+    }
+
+    return written;
+}
+
+// 异步模式：在抢占到的记录里直接格式化，队列满时只计数不阻塞
+static void async_enqueue(ya_logger_t* logger, ya_log_level_t level, const char* file, int line,
+                          const char* format, va_list args) {
+    ya_log_async_t* async = logger->async;
+    ya_log_record_t* record;
+    size_t pos = atomic_load_explicit(&async->enqueue_pos, memory_order_relaxed);
+
+    for (;;) {
+        record = &async->ring[pos & async->mask];
+        size_t seq = atomic_load_explicit(&record->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&async->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&async->dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&async->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    // 前缀最多占记录的一半，保证消息内容总有空间
+    size_t prefix = format_prefix(record->text, sizeof(record->text) / 2, level, file, line);
+
+    // 预留换行符的位置
+    size_t room = sizeof(record->text) - prefix - 1;
+    int n = vsnprintf(record->text + prefix, room, format, args);
+    size_t msg_len = (n > 0) ? (size_t)n : 0;
+    if (msg_len >= room) {
+        msg_len = room - 1;
+        size_t mark_len = sizeof(TRUNCATE_MARK) - 1;
+        if (msg_len >= mark_len) {
+            memcpy(record->text + prefix + msg_len - mark_len, TRUNCATE_MARK, mark_len);
+        }
+    }
+
+    size_t len = prefix + msg_len;
+    if (g_log_format.auto_newline) {
+        record->text[len++] = '\n';
+    }
+
+    record->level = (uint8_t)level;
+    record->msg_offset = (uint16_t)prefix;
+    record->msg_len = (uint16_t)msg_len;
+    record->len = (uint16_t)len;
+    atomic_store_explicit(&record->seq, pos + 1, memory_order_release);
+
+    // 错误级别的日志尽快落盘
+    if (level >= YA_LOG_LEVEL_ERROR) {
+        pthread_cond_signal(&async->wake);
+    }
+}
+
+static void async_flush_batch(ya_logger_t* logger) {
+    ya_log_async_t* async = logger->async;
+    if (async->batch_len > 0) {
+        write_log_output(logger, async->batch, async->batch_len);
+        async->batch_len = 0;
+    }
+}
+
+static void async_append(ya_logger_t* logger, const char* data, size_t len) {
+    ya_log_async_t* async = logger->async;
+
+    // 批量不跨越轮转边界，轮转时机与逐行写入一致
+    bool rotate_due = logger->log_fp && logger->config.max_file_size > 0 &&
+                      logger->file_size + async->batch_len >= logger->config.max_file_size;
+    if (async->batch_len + len > ASYNC_BATCH_SIZE || (rotate_due && async->batch_len > 0)) {
+        async_flush_batch(logger);
+    }
+
+    memcpy(async->batch + async->batch_len, data, len);
+    async->batch_len += len;
+}
+
+// 有新的丢弃时写一条提示
+static void async_report_dropped(ya_logger_t* logger) {
+    ya_log_async_t* async = logger->async;
+    uint64_t dropped = atomic_load_explicit(&async->dropped, memory_order_relaxed);
+    if (dropped == async->dropped_reported) {
+        return;
+    }
+
+    char line[256];
+    size_t len = format_prefix(line, sizeof(line), YA_LOG_LEVEL_WARN, NULL, 0);
+    int n = snprintf(line + len, sizeof(line) - len, "%llu log records dropped (async queue full)\n",
+                     (unsigned long long)(dropped - async->dropped_reported));
+    len += (n > 0 && (size_t)n < sizeof(line) - len) ? (size_t)n : 0;
+    async->dropped_reported = dropped;
+    async_append(logger, line, len);
+}
+
+// 取出所有已发布的记录，返回条数
+static size_t async_drain(ya_logger_t* logger) {
+    ya_log_async_t* async = logger->async;
+    size_t count = 0;
+
+    for (;;) {
+        ya_log_record_t* record = &async->ring[async->dequeue_pos & async->mask];
+        size_t seq = atomic_load_explicit(&record->seq, memory_order_acquire);
+        if (seq != async->dequeue_pos + 1) {
+            break;
+        }
+
+        async_append(logger, record->text, record->len);
+        if (logger->config.use_system_log) {
+            char message[sizeof(record->text) + 1];
+            memcpy(message, record->text + record->msg_offset, record->msg_len);
+            message[record->msg_len] = '\0';
+            write_to_system_log((ya_log_level_t)record->level, message);
+        }
+
+        atomic_store_explicit(&record->seq, async->dequeue_pos + async->mask + 1, memory_order_release);
+        async->dequeue_pos++;
+        count++;
+    }
+
+    return count;
+}
+
+// 后台写日志线程：批量写出，空闲时定时等待；停止后写完剩余记录再退出
+static void* async_flusher_main(void* arg) {
+    ya_logger_t* logger = (ya_logger_t*)arg;
+    ya_log_async_t* async = logger->async;
+
+    for (;;) {
+        bool running = atomic_load_explicit(&async->running, memory_order_acquire);
+        size_t drained = async_drain(logger);
+        async_report_dropped(logger);
+        async_flush_batch(logger);
+
+        if (drained > 0) {
+            continue;
+        }
+        if (!running) {
+            break;
+        }
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += ASYNC_IDLE_WAIT_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&async->lock);
+        if (atomic_load_explicit(&async->running, memory_order_acquire)) {
+            pthread_cond_timedwait(&async->wake, &async->lock, &deadline);
+        }
+        pthread_mutex_unlock(&async->lock);
+    }
+
+    return NULL;
+}
+
+static void async_free(ya_log_async_t* async) {
+    if (!async) {
+        return;
+    }
+    pthread_cond_destroy(&async->wake);
+    pthread_mutex_destroy(&async->lock);
+    free(async->batch);
+    free(async->ring);
+    free(async);
+}
+
+static ya_log_async_t* async_start(ya_logger_t* logger) {
+    size_t capacity = 1;
+    size_t requested = logger->config.async_queue_size ? logger->config.async_queue_size
+                                                       : YA_LOG_ASYNC_DEFAULT_QUEUE_SIZE;
+    while (capacity < requested) {
+        capacity <<= 1;
+    }
+
+    ya_log_async_t* async = (ya_log_async_t*)calloc(1, sizeof(ya_log_async_t));
+    if (!async) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&async->lock, NULL);
+    pthread_cond_init(&async->wake, NULL);
+    async->ring = (ya_log_record_t*)calloc(capacity, sizeof(ya_log_record_t));
+    async->batch = (char*)malloc(ASYNC_BATCH_SIZE);
+    if (!async->ring || !async->batch) {
+        async_free(async);
+        return NULL;
+    }
+
+    async->mask = capacity - 1;
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&async->ring[i].seq, i);
+    }
+    atomic_init(&async->enqueue_pos, 0);
+    atomic_init(&async->dropped, 0);
+    atomic_init(&async->running, true);
+
+    logger->async = async;
+    if (pthread_create(&async->thread, NULL, async_flusher_main, logger) != 0) {
+        logger->async = NULL;
+        async_free(async);
+        return NULL;
+    }
+
+    return async;
+}
+
+static void async_stop(ya_logger_t* logger) {
+    ya_log_async_t* async = logger->async;
+
+    pthread_mutex_lock(&async->lock);
+    atomic_store_explicit(&async->running, false, memory_order_release);
+    pthread_cond_signal(&async->wake);
+    pthread_mutex_unlock(&async->lock);
+    pthread_join(async->thread, NULL);
+
+    logger->async = NULL;
+    async_free(async);
+}
+
 // 初始化日志系统
 ya_logger_t* ya_logger_init(const ya_logger_config_t* config) {
     if (!config) {
@@ -192,6 +522,7 @@ ya_logger_t* ya_logger_init(const ya_logger_config_t* config) {
     memset(logger, 0, sizeof(ya_logger_t));
     logger->config = *config;
     logger->last_error = NULL;
+    pthread_mutex_init(&logger->write_lock, NULL);
 
     if (config->log_file) {
         // 确保目录存在
@@ -211,11 +542,27 @@ ya_logger_t* ya_logger_init(const ya_logger_config_t* config) {
 
         logger->log_fp = fopen(config->log_file, "a");
         if (!logger->log_fp) {
+            pthread_mutex_destroy(&logger->write_lock);
             free(logger);
             return NULL;
         }
         // 设置无缓冲
         setvbuf(logger->log_fp, NULL, _IONBF, 0);
+
+        // 记录已有大小，之后按写入量累计
+        if (fseek(logger->log_fp, 0, SEEK_END) == 0) {
+            long size = ftell(logger->log_fp);
+            logger->file_size = size > 0 ? (size_t)size : 0;
+        }
+    }
+
+    if (config->async && !async_start(logger)) {
+        if (logger->log_fp) {
+            fclose(logger->log_fp);
+        }
+        pthread_mutex_destroy(&logger->write_lock);
+        free(logger);
+        return NULL;
     }
 
     // 初始化系统日志
@@ -226,6 +573,7 @@ ya_logger_t* ya_logger_init(const ya_logger_config_t* config) {
     }
 
     g_logger = logger;
+    atomic_store_explicit(&g_log_level, logger->config.level, memory_order_relaxed);
     return logger;
 }
 
@@ -238,6 +586,12 @@ void ya_logger_destroy(ya_logger_t* logger) {
     // 如果这是全局logger，先将全局指针设为NULL
     if (g_logger == logger) {
         g_logger = NULL;
+        atomic_store_explicit(&g_log_level, YA_LOG_LEVEL_OFF, memory_order_relaxed);
+    }
+
+    // 写完队列中剩余的日志
+    if (logger->async) {
+        async_stop(logger);
     }
 
     if (logger->log_fp) {
@@ -251,6 +605,7 @@ void ya_logger_destroy(ya_logger_t* logger) {
 #endif
     }
 
+    pthread_mutex_destroy(&logger->write_lock);
     free(logger->last_error);
     free(logger);
 }
@@ -259,9 +614,19 @@ void ya_logger_destroy(ya_logger_t* logger) {
 void ya_logger_set_level(ya_logger_t* logger, ya_log_level_t level) {
     if (logger) {
         logger->config.level = level;
+        if (logger == g_logger) {
+            atomic_store_explicit(&g_log_level, level, memory_order_relaxed);
+        }
     }
 }
 
+uint64_t ya_logger_dropped(const ya_logger_t* logger) {
+    if (!logger || !logger->async) {
+        return 0;
+    }
+    return atomic_load_explicit(&logger->async->dropped, memory_order_relaxed);
+}
+
 // 核心日志函数
 void ya_logger_log(ya_logger_t* logger, ya_log_level_t level,
                   const char* file, int line, const char* func,
@@ -270,60 +635,37 @@ void ya_logger_log(ya_logger_t* logger, ya_log_level_t level,
         return;
     }
 
-    char timestamp[MAX_TIMESTAMP_SIZE] = {0};
-    char message[MAX_MESSAGE_SIZE] = {0};
-    char final_message[MAX_FINAL_MESSAGE_SIZE] = {0};
-    size_t written = 0;
-    
-    // 格式化时间戳
-    if (g_log_format.include_timestamp) {
-        format_timestamp(timestamp, sizeof(timestamp));
-        written += snprintf(final_message + written, sizeof(final_message) - written, 
-                          "[%s] ", timestamp);
-    }
+    va_list args;
+    va_start(args, format);
 
-    // 添加日志级别
-    if (g_log_format.include_level) {
-        written += snprintf(final_message + written, sizeof(final_message) - written, 
-                          "[%s] ", ya_logger_level_name(level));
-    }
-    
-    // 添加文件和行号
-    if (g_log_format.include_file_line && file) {
-        written += snprintf(final_message + written, sizeof(final_message) - written, 
-                          "[%s:%d] ", file, line);
+    // 异步模式：格式化进环形缓冲即返回，写文件/控制台/系统日志都在后台线程
+    if (logger->async) {
+        async_enqueue(logger, level, file, line, format, args);
+        va_end(args);
+        return;
     }
 
+    // message/final_message 总是由 snprintf 写入并以 '\0' 结尾，无需清零 24KB
+    char message[MAX_MESSAGE_SIZE];
+    char final_message[MAX_FINAL_MESSAGE_SIZE];
+    size_t written = format_prefix(final_message, sizeof(final_message), level, file, line);
+
     // 格式化消息内容
-    va_list args;
-    va_start(args, format);
     vsnprintf(message, sizeof(message), format, args);
     va_end(args);
 
     // 添加消息内容
-    written += snprintf(final_message + written, sizeof(final_message) - written, 
-                       "%s%s", message, g_log_format.auto_newline ? "\n" : "");
-
-    // 写入日志文件
-    if (logger->log_fp) {
-        check_and_rotate_log(logger);
-        if (fputs(final_message, logger->log_fp) == EOF) {
-            if (logger->last_error) {
-                free(logger->last_error);
-            }
-            logger->last_error = strdup(strerror(errno));
-        }
-        fflush(logger->log_fp);
+    int n = snprintf(final_message + written, sizeof(final_message) - written,
+                     "%s%s", message, g_log_format.auto_newline ? "\n" : "");
+    written += (n > 0) ? (size_t)n : 0;
+    if (written >= sizeof(final_message)) {
+        written = sizeof(final_message) - 1;
     }
 
-    // 输出到控制台
-    if (logger->config.use_console) {
-        fputs(final_message, stdout);
-        fflush(stdout);
-    }
+    write_log_output(logger, final_message, written);
 
     // 写入系统日志
     if (logger->config.use_system_log) {
         write_to_system_log(level, message);
     }
-} 
\ No newline at end of file
+}
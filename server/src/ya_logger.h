@@ -1,6 +1,10 @@
 #pragma once
 
+#include <pthread.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -27,6 +31,12 @@ typedef enum {
     YA_LOG_LEVEL_OFF = 6
 } ya_log_level_t;
 
+// 编译期保留的最低日志级别（0=TRACE 1=DEBUG 2=INFO ...），低于它的日志调用点整体编译掉
+// 发布构建由 CMake 设为 1，TRACE 不进入二进制
+#ifndef YA_LOG_COMPILED_LEVEL
+#define YA_LOG_COMPILED_LEVEL 0
+#endif
+
 // 日志配置结构
 typedef struct {
     ya_log_level_t level;          // 当前日志级别
@@ -35,13 +45,24 @@ typedef struct {
     int use_system_log;            // 是否使用系统日志
     size_t max_file_size;          // 单个日志文件最大大小(字节)
     int max_backup_files;          // 最大备份文件数
+    int async;                     // 是否异步写日志：调用线程只格式化入队，后台线程批量写出
+    size_t async_queue_size;       // 异步环形缓冲的记录数(0 使用默认值，向上取整为 2 的幂)
 } ya_logger_config_t;
 
+// 异步模式的默认队列长度与单条记录大小（超长的消息会被截断）
+#define YA_LOG_ASYNC_DEFAULT_QUEUE_SIZE 1024
+#define YA_LOG_ASYNC_RECORD_SIZE 512
+
+typedef struct ya_log_async ya_log_async_t;
+
 // 日志上下文结构
 typedef struct {
     ya_logger_config_t config;
     FILE* log_fp;
     char* last_error;
+    size_t file_size;              // 当前日志文件大小，按写入量累计，用于轮转判断
+    ya_log_async_t* async;         // 异步模式状态，同步模式为 NULL
+    pthread_mutex_t write_lock;    // 串行化写文件、file_size 累计与轮转（同步模式下多个线程都会写日志）
 } ya_logger_t;
 
 // 日志格式化选项
@@ -56,6 +77,15 @@ typedef struct {
 // 全局日志实例
 extern ya_logger_t* g_logger;
 
+// 全局日志实例当前的日志级别（未初始化时为 OFF），由 init/set_level/destroy 维护
+extern atomic_int g_log_level;
+
+// 日志宏在求值参数和格式化之前先做级别检查：编译期级别 + 一次 relaxed 原子读
+static inline bool ya_log_enabled(ya_log_level_t level) {
+    return level >= YA_LOG_COMPILED_LEVEL && level < YA_LOG_LEVEL_OFF &&
+           (int)level >= atomic_load_explicit(&g_log_level, memory_order_relaxed);
+}
+
 // 初始化日志系统
 ya_logger_t* ya_logger_init(const ya_logger_config_t* config);
 
@@ -65,6 +95,9 @@ void ya_logger_destroy(ya_logger_t* logger);
 // 设置日志级别
 void ya_logger_set_level(ya_logger_t* logger, ya_log_level_t level);
 
+// 异步模式下因队列满而丢弃的日志条数（同步模式恒为 0）
+uint64_t ya_logger_dropped(const ya_logger_t* logger);
+
 // 获取日志级别名称
 const char* ya_logger_level_name(ya_log_level_t level);
 
@@ -73,29 +106,28 @@ void ya_logger_log(ya_logger_t* logger, ya_log_level_t level,
                   const char* file, int line, const char* func,
                   const char* format, ...);
 
-// 日志宏定义
-#define YA_LOG_TRACE(format, ...) \
-    ya_logger_log(g_logger, YA_LOG_LEVEL_TRACE, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+// 日志宏定义：级别不满足时不调用 ya_logger_log，参数也不求值
+#define YA_LOG_AT(level, format, ...) \
+    (ya_log_enabled(level) \
+         ? ya_logger_log(g_logger, level, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__) \
+         : (void)0)
+
+#define YA_LOG_TRACE(format, ...) YA_LOG_AT(YA_LOG_LEVEL_TRACE, format, ##__VA_ARGS__)
 
-#define YA_LOG_DEBUG(format, ...) \
-    ya_logger_log(g_logger, YA_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#define YA_LOG_DEBUG(format, ...) YA_LOG_AT(YA_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
 
-#define YA_LOG_INFO(format, ...) \
-    ya_logger_log(g_logger, YA_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#define YA_LOG_INFO(format, ...) YA_LOG_AT(YA_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
 
-#define YA_LOG_WARN(format, ...) \
-    ya_logger_log(g_logger, YA_LOG_LEVEL_WARN, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#define YA_LOG_WARN(format, ...) YA_LOG_AT(YA_LOG_LEVEL_WARN, format, ##__VA_ARGS__)
 
-#define YA_LOG_ERROR(format, ...) \
-    ya_logger_log(g_logger, YA_LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#define YA_LOG_ERROR(format, ...) YA_LOG_AT(YA_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
 
-#define YA_LOG_FATAL(format, ...) \
-    ya_logger_log(g_logger, YA_LOG_LEVEL_FATAL, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__)
+#define YA_LOG_FATAL(format, ...) YA_LOG_AT(YA_LOG_LEVEL_FATAL, format, ##__VA_ARGS__)
 
 // 条件日志宏
 #define YA_LOG_IF(level, condition, format, ...) \
     do { \
-        if (condition) { \
+        if (ya_log_enabled(level) && (condition)) { \
             ya_logger_log(g_logger, level, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__); \
         } \
     } while(0)
@@ -0,0 +1,107 @@
+#include "ya_metrics.h"
+#include "ya_client_manager.h"
+#include "ya_event.h"
+#include "ya_input_queue.h"
+#include "ya_logger.h"
+#include "input/keyboard/sequencer.h"
+
+#include <string.h>
+
+extern YA_ServerContext svr_context;
+
+// 注入后端错误码（rs.h YAError）的标签值
+static const struct {
+    YAError code;
+    const char *name;
+} error_codes[] = {
+    {PlatformError, "platform_error"},
+    {ClipboardError, "clipboard_error"},
+    {InvalidInput, "invalid_input"},
+    {UnsupportedOperation, "unsupported_operation"},
+    {NotFound, "not_found"},
+};
+
+#define ERROR_CODE_COUNT (sizeof(error_codes) / sizeof(error_codes[0]))
+
+static void family(struct evbuffer *out, const char *name, const char *type, const char *help) {
+    evbuffer_add_printf(out, "# TYPE mousehero_%s %s\n# HELP mousehero_%s %s\n", name, type, name, help);
+}
+
+static void sample(struct evbuffer *out, const char *name, unsigned long long value) {
+    evbuffer_add_printf(out, "mousehero_%s %llu\n", name, value);
+}
+
+static void write_connections(struct evbuffer *out, const ya_server_stats_t *stats) {
+    family(out, "connections", "gauge", "Active session connections.");
+    sample(out, "connections", stats->active_connections);
+
+    family(out, "connections_accepted", "counter", "Session connections accepted since start.");
+    sample(out, "connections_accepted_total", stats->total_connections);
+
+    family(out, "clients", "gauge", "Registered clients.");
+    sample(out, "clients", ya_client_get_count(&svr_context.client_manager));
+}
+
+// 按事件类型的分发计数，所有已知类型都输出（包括 0），时间序列保持稳定
+static void write_events(struct evbuffer *out, const ya_server_stats_t *stats) {
+    family(out, "events", "counter", "Events dispatched to handlers (handled) or rejected by transport, order or authorization checks.");
+    for (uint32_t type = 0; type < YA_EVENT_TYPE_COUNT; type++) {
+        const char *name = ya_event_type_name(type);
+        if (strcmp(name, "UNKNOWN") == 0) {
+            continue;
+        }
+        evbuffer_add_printf(out, "mousehero_events_total{type=\"%s\",result=\"handled\"} %llu\n", name,
+                            (unsigned long long)stats->event_types[type].handled);
+        evbuffer_add_printf(out, "mousehero_events_total{type=\"%s\",result=\"rejected\"} %llu\n", name,
+                            (unsigned long long)stats->event_types[type].rejected);
+    }
+}
+
+static void write_errors(struct evbuffer *out, const ya_server_stats_t *stats) {
+    family(out, "parse_errors", "counter", "Frames or datagrams dropped because they could not be decoded.");
+    evbuffer_add_printf(out, "mousehero_parse_errors_total{transport=\"session\"} %llu\n",
+                        (unsigned long long)stats->session_parse_errors);
+    evbuffer_add_printf(out, "mousehero_parse_errors_total{transport=\"command\"} %llu\n",
+                        (unsigned long long)stats->command_parse_errors);
+
+    family(out, "stale_events_dropped", "counter", "Events dropped as duplicate, stale or out of order by event index.");
+    sample(out, "stale_events_dropped_total", stats->order_dropped);
+
+    family(out, "udp_rejected", "counter", "Datagrams rejected by token, source or type checks.");
+    sample(out, "udp_rejected_total", stats->udp_rejected);
+
+    // 动作级失败来自 ya_input_execute，按键步骤在时间线上异步执行，失败单独计数
+    family(out, "injection_errors", "counter", "Input injections that failed, by backend error code.");
+    for (size_t i = 0; i < ERROR_CODE_COUNT; i++) {
+        evbuffer_add_printf(out, "mousehero_injection_errors_total{source=\"action\",code=\"%s\"} %llu\n",
+                            error_codes[i].name, (unsigned long long)ya_input_queue_errors(error_codes[i].code));
+        evbuffer_add_printf(out, "mousehero_injection_errors_total{source=\"key_step\",code=\"%s\"} %llu\n",
+                            error_codes[i].name, (unsigned long long)key_sequencer_step_errors(error_codes[i].code));
+    }
+}
+
+static void write_queues(struct evbuffer *out) {
+    family(out, "key_sequencer_depth", "gauge", "Key programs waiting on the keystroke sequencer timeline.");
+    sample(out, "key_sequencer_depth", key_sequencer_depth());
+
+    family(out, "input_queue_max_depth", "gauge", "Peak depth of the input injection queue.");
+    sample(out, "input_queue_max_depth", ya_input_queue_max_depth());
+
+    family(out, "input_queue_dropped", "counter", "Input actions dropped because the injection queue was full.");
+    sample(out, "input_queue_dropped_total", ya_input_queue_dropped());
+
+    family(out, "log_dropped", "counter", "Log records dropped because the async logger queue was full.");
+    sample(out, "log_dropped_total", ya_logger_dropped(g_logger));
+}
+
+size_t ya_metrics_render(const ya_server_stats_t *stats, struct evbuffer *out) {
+    size_t before = evbuffer_get_length(out);
+
+    write_connections(out, stats);
+    write_events(out, stats);
+    write_errors(out, stats);
+    write_queues(out);
+    evbuffer_add(out, "# EOF\n", 6);
+
+    return evbuffer_get_length(out) - before;
+}
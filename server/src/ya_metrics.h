@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <event2/buffer.h>
+
+#include "ya_server.h"
+
+/**
+ * OpenMetrics 文本格式的运行指标（HTTP GET /metrics）
+ *
+ * 连接数、按事件类型的分发计数、解析错误、序号过期丢弃、按后端错误码的注入失败、
+ * 注入队列和按键时间线深度、日志丢弃数。所有数值都是已有计数器的快照，
+ * 渲染时只读取不加锁，不影响输入路径。
+ */
+
+// OpenMetrics 响应的 Content-Type
+#define YA_METRICS_CONTENT_TYPE "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+// 把指标追加到 out 末尾（以 "# EOF" 结束），返回追加的字节数
+size_t ya_metrics_render(const ya_server_stats_t *stats, struct evbuffer *out);
@@ -44,6 +44,10 @@ ya_mouse_filter_t *ya_mouse_filter_create(void) {
     ctx->vey = 0.0f;    // 速度 EMA y (v2)
     ctx->frac_x = 0.0f; // 子像素累积
     ctx->frac_y = 0.0f;
+    ctx->scroll_frac_x = 0.0f; // 平滑滚动累积
+    ctx->scroll_frac_y = 0.0f;
+    ctx->wheel_acc_x = 0;
+    ctx->wheel_acc_y = 0;
     return ctx;
 }
 
@@ -58,6 +62,10 @@ void ya_mouse_filter_reset_state(ya_mouse_filter_t *ctx) {
     ctx->vey = 0.0f;
     ctx->frac_x = 0.0f; // 重置子像素累积
     ctx->frac_y = 0.0f;
+    ctx->scroll_frac_x = 0.0f; // 重置平滑滚动累积
+    ctx->scroll_frac_y = 0.0f;
+    ctx->wheel_acc_x = 0;
+    ctx->wheel_acc_y = 0;
     YA_LOG_TRACE("[mf] Filter state reset: EMA velocity and subpixel accumulation cleared");
 }
 
@@ -176,3 +184,37 @@ bool ya_mouse_filter_process(ya_mouse_filter_t *ctx,
     *out_count = 1;
     return true;
 }
+
+// 单轴平滑滚动量化：小数累积为高精度单位，高精度单位累积为整格
+static void scroll_axis(float notches, float *frac, int *acc, int *hires, int *notch) {
+    *frac += notches * (float)YA_SCROLL_HIRES_PER_NOTCH;
+
+    int q = 0;
+    if (fabsf(*frac) >= 1.0f) {
+        q = (int)(*frac > 0.0f ? floorf(*frac) : ceilf(*frac));
+        *frac -= (float)q;
+    }
+
+    *hires = q;
+    *notch = 0;
+    if (q == 0) return;
+
+    // 方向反转时重新开始累计整格，避免反向滚动少量距离就触发一格
+    if ((q > 0 && *acc < 0) || (q < 0 && *acc > 0)) {
+        *acc = 0;
+    }
+    *acc += q;
+    *notch = *acc / YA_SCROLL_HIRES_PER_NOTCH;
+    *acc -= *notch * YA_SCROLL_HIRES_PER_NOTCH;
+}
+
+bool ya_mouse_filter_scroll(ya_mouse_filter_t *ctx, float notches_x, float notches_y, ya_scroll_step_t *out) {
+    if (!ctx || !out) return false;
+
+    scroll_axis(notches_x, &ctx->scroll_frac_x, &ctx->wheel_acc_x, &out->hires_x, &out->notch_x);
+    scroll_axis(notches_y, &ctx->scroll_frac_y, &ctx->wheel_acc_y, &out->hires_y, &out->notch_y);
+
+    YA_LOG_TRACE("[mf] scroll in=(%.3f,%.3f) hires=(%d,%d) notch=(%d,%d) acc=(%d,%d)", notches_x, notches_y,
+                 out->hires_x, out->hires_y, out->notch_x, out->notch_y, ctx->wheel_acc_x, ctx->wheel_acc_y);
+    return out->hires_x != 0 || out->hires_y != 0;
+}
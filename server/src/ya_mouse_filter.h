@@ -16,6 +16,12 @@ typedef struct ya_mouse_filter {
     // 状态 - 子像素累积 (v2 和 v3 都使用)
     float frac_x; // 子像素累计 x
     float frac_y; // 子像素累计 y
+
+    // 状态 - 平滑滚动累积（MOUSE_SMOOTH_SCROLL）
+    float scroll_frac_x; // 不足 1 个高精度单位的余量 x
+    float scroll_frac_y; // 不足 1 个高精度单位的余量 y
+    int   wheel_acc_x;   // 距离下一个整格的高精度单位累计 x
+    int   wheel_acc_y;   // 距离下一个整格的高精度单位累计 y
 } ya_mouse_filter_t;
 
 typedef struct {
@@ -23,6 +29,17 @@ typedef struct {
     int dy;
 } ya_mouse_step_t;
 
+// 每格滚轮对应的高精度单位（REL_WHEEL_HI_RES 约定 120）
+#define YA_SCROLL_HIRES_PER_NOTCH 120
+
+// 一次平滑滚动的输出：高精度单位与同一帧里对应的整格数
+typedef struct {
+    int hires_x; // 水平，正数向右
+    int hires_y; // 垂直，正数向上
+    int notch_x;
+    int notch_y;
+} ya_scroll_step_t;
+
 // 创建/销毁每客户端滤波上下文
 ya_mouse_filter_t *ya_mouse_filter_create(void);
 void ya_mouse_filter_destroy(ya_mouse_filter_t *ctx);
@@ -70,6 +87,12 @@ void ya_mouse_filter_set_low_latency_thresholds(ya_mouse_filter_t *ctx,
 // 总开关：启用/关闭全部滤波与插值算法；关闭时直接透传输入位移
 void ya_mouse_filter_set_algorithms_enabled(ya_mouse_filter_t *ctx, bool enabled);
 
+// 平滑滚动：累积小数格距离，输出 1/120 格的高精度单位和对应的整格数
+// 输入: notches_x/notches_y 为格数（可以是小数，水平正数向右，垂直正数向上）
+// 整格在累计满 YA_SCROLL_HIRES_PER_NOTCH 个高精度单位时输出，方向反转时丢弃未满一格的累计
+// 返回: true 表示有输出（out 中至少一个高精度单位不为 0）
+bool ya_mouse_filter_scroll(ya_mouse_filter_t *ctx, float notches_x, float notches_y, ya_scroll_step_t *out);
+
 // 处理一次来自客户端的相对移动输入，输出若干步平滑后的微步
 // 输入: dx, dy 为相对位移（与原实现一致，单位: 像素）
 // 输出: steps 用于承载微步，最多写入 steps_cap 个；实际写入数量置于 *out_count
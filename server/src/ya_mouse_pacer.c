@@ -0,0 +1,192 @@
+#include "ya_mouse_pacer.h"
+#include "ya_config.h"
+#include "ya_logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern YA_Config config;
+
+typedef struct
+{
+    uint64_t due_us; // 单调时钟下的回放时刻
+    int32_t dx;
+    int32_t dy;
+} ya_paced_sample_t;
+
+struct ya_mouse_pacer
+{
+    struct event *timer;
+    ya_mouse_pacer_emit_fn emit;
+    void *ctx;
+
+    // 环形队列，按 due_us 递增
+    ya_paced_sample_t queue[YA_MOUSE_PACER_CAPACITY];
+    size_t head;
+    size_t count;
+};
+
+static ya_mouse_batch_mode_t g_batch_mode = YA_MOUSE_BATCH_IMMEDIATE;
+
+static uint64_t now_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ull + (uint64_t)now.tv_nsec / 1000ull;
+}
+
+void ya_mouse_pacer_init(void)
+{
+    const char *mode = ya_config_get(&config, "input", "mouse_batch_pacing");
+    g_batch_mode = (mode && strcmp(mode, "paced") == 0) ? YA_MOUSE_BATCH_PACED : YA_MOUSE_BATCH_IMMEDIATE;
+
+    YA_LOG_INFO("Mouse batch pacing: %s", g_batch_mode == YA_MOUSE_BATCH_PACED ? "paced" : "immediate");
+}
+
+ya_mouse_batch_mode_t ya_mouse_pacer_mode(void)
+{
+    return g_batch_mode;
+}
+
+// 回放队首的一个采样
+static void emit_front(ya_mouse_pacer_t *pacer)
+{
+    ya_paced_sample_t *s = &pacer->queue[pacer->head];
+    pacer->head = (pacer->head + 1) % YA_MOUSE_PACER_CAPACITY;
+    pacer->count--;
+    pacer->emit(pacer->ctx, s->dx, s->dy);
+}
+
+// 回放所有已到期的采样，并为下一个采样设置定时器
+static void run_due(ya_mouse_pacer_t *pacer)
+{
+    uint64_t now = now_us();
+    while (pacer->count > 0 && pacer->queue[pacer->head].due_us <= now)
+    {
+        emit_front(pacer);
+    }
+
+    if (pacer->count > 0)
+    {
+        uint64_t wait = pacer->queue[pacer->head].due_us - now;
+        struct timeval tv = {.tv_sec = (long)(wait / 1000000ull), .tv_usec = (long)(wait % 1000000ull)};
+        evtimer_add(pacer->timer, &tv);
+    }
+    else
+    {
+        evtimer_del(pacer->timer);
+    }
+}
+
+static void pacer_timer_cb(evutil_socket_t fd, short events, void *arg)
+{
+    (void)fd;
+    (void)events;
+    run_due((ya_mouse_pacer_t *)arg);
+}
+
+ya_mouse_pacer_t *ya_mouse_pacer_create(struct event_base *base, ya_mouse_pacer_emit_fn emit, void *ctx)
+{
+    if (!base || !emit)
+    {
+        return NULL;
+    }
+
+    ya_mouse_pacer_t *pacer = calloc(1, sizeof(*pacer));
+    if (!pacer)
+    {
+        return NULL;
+    }
+
+    pacer->timer = evtimer_new(base, pacer_timer_cb, pacer);
+    if (!pacer->timer)
+    {
+        free(pacer);
+        return NULL;
+    }
+
+    pacer->emit = emit;
+    pacer->ctx = ctx;
+    return pacer;
+}
+
+void ya_mouse_pacer_destroy(ya_mouse_pacer_t *pacer)
+{
+    if (!pacer)
+    {
+        return;
+    }
+
+    // 丢弃未回放的采样：客户端已断开，不再产生输入
+    event_free(pacer->timer);
+    free(pacer);
+}
+
+void ya_mouse_pacer_push(ya_mouse_pacer_t *pacer, const YAMouseSample *samples, size_t count)
+{
+    if (!pacer || !samples || count == 0)
+    {
+        return;
+    }
+
+    uint64_t now = now_us();
+    uint64_t due = now;
+    if (pacer->count > 0)
+    {
+        // 接在上一批之后；如果积压已超过上限，先把积压全部回放，从当前时刻重新开始
+        size_t tail = (pacer->head + pacer->count - 1) % YA_MOUSE_PACER_CAPACITY;
+        due = pacer->queue[tail].due_us + samples[0].dt_us;
+        if (due > now + YA_MOUSE_PACER_MAX_LAG_US)
+        {
+            ya_mouse_pacer_flush(pacer);
+            due = now;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            due += samples[i].dt_us;
+        }
+        if (due > now + YA_MOUSE_PACER_MAX_LAG_US)
+        {
+            // 批内的异常间隔（如客户端卡顿）不应拖慢回放
+            due = now + YA_MOUSE_PACER_MAX_LAG_US;
+        }
+
+        if (pacer->count == YA_MOUSE_PACER_CAPACITY)
+        {
+            // 队列满：提前回放最早的采样，保证位移不丢失
+            emit_front(pacer);
+        }
+
+        size_t slot = (pacer->head + pacer->count) % YA_MOUSE_PACER_CAPACITY;
+        pacer->queue[slot].due_us = due;
+        pacer->queue[slot].dx = samples[i].dx;
+        pacer->queue[slot].dy = samples[i].dy;
+        pacer->count++;
+    }
+
+    run_due(pacer);
+}
+
+void ya_mouse_pacer_flush(ya_mouse_pacer_t *pacer)
+{
+    if (!pacer)
+    {
+        return;
+    }
+
+    while (pacer->count > 0)
+    {
+        emit_front(pacer);
+    }
+    evtimer_del(pacer->timer);
+}
+
+size_t ya_mouse_pacer_pending(const ya_mouse_pacer_t *pacer)
+{
+    return pacer ? pacer->count : 0;
+}
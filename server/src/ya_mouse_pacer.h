@@ -0,0 +1,43 @@
+#pragma once
+
+#include <event2/event.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ya_event.h"
+
+// MOUSE_MOVE_BATCH 的回放方式（[input] mouse_batch_pacing）
+typedef enum {
+    YA_MOUSE_BATCH_IMMEDIATE = 0, // 收到后立即整批回放（默认）
+    YA_MOUSE_BATCH_PACED = 1,     // 按采样的原始时间间隔回放
+} ya_mouse_batch_mode_t;
+
+// 排队等待回放的最大时长（微秒），超出时立即回放积压的采样，避免延迟堆积
+#define YA_MOUSE_PACER_MAX_LAG_US 50000
+
+// 排队采样的容量（两个满批次）
+#define YA_MOUSE_PACER_CAPACITY (YA_MOUSE_BATCH_MAX_SAMPLES * 2)
+
+// 回放一个采样（dx/dy 与 MOUSE_MOVE 的 lparam/rparam 同单位）
+typedef void (*ya_mouse_pacer_emit_fn)(void *ctx, int32_t dx, int32_t dy);
+
+typedef struct ya_mouse_pacer ya_mouse_pacer_t;
+
+// 读取配置（[input] mouse_batch_pacing = immediate | paced）
+void ya_mouse_pacer_init(void);
+
+// 当前回放方式
+ya_mouse_batch_mode_t ya_mouse_pacer_mode(void);
+
+// 创建/销毁每客户端回放器，定时器挂在 base 上
+ya_mouse_pacer_t *ya_mouse_pacer_create(struct event_base *base, ya_mouse_pacer_emit_fn emit, void *ctx);
+void ya_mouse_pacer_destroy(ya_mouse_pacer_t *pacer);
+
+// 按 dt_us 排队一批采样，已到期的采样立即回放
+void ya_mouse_pacer_push(ya_mouse_pacer_t *pacer, const YAMouseSample *samples, size_t count);
+
+// 立即回放所有排队的采样（例如收到 MOUSE_STOP 时）
+void ya_mouse_pacer_flush(ya_mouse_pacer_t *pacer);
+
+// 排队中的采样数
+size_t ya_mouse_pacer_pending(const ya_mouse_pacer_t *pacer);
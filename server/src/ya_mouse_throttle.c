@@ -1,131 +1,161 @@
 #include "ya_mouse_throttle.h"
 #include "ya_logger.h"
 
+#include <stdint.h>
+#include <stdlib.h>
 #include <time.h>
 
-typedef struct
+struct ya_mouse_throttle
 {
-    struct timespec last_emit;
+    struct event *timer;
+    ya_mouse_throttle_emit_fn emit;
+    void *ctx;
+
+    uint64_t last_emit_us; // 单调时钟下的上次输出时刻
     bool has_last_emit;
     int accum_dx;
     int accum_dy;
-} YAMouseThrottleState;
-
-static YAMouseThrottleState g_mouse_throttle = {
-    .has_last_emit = false,
-    .accum_dx = 0,
-    .accum_dy = 0,
 };
 
-// 优化后的节流间隔：客户端已做平滑，服务端可以更激进地减少延迟
-static const double THROTTLE_INTERVAL_LOW_SPEED_MS = 4.0;   // 低速：4ms (250Hz) - 更低延迟
-static const double THROTTLE_INTERVAL_HIGH_SPEED_MS = 8.0;  // 高速：8ms (125Hz) - 大幅减少延迟
-static const int LOW_SPEED_THRESHOLD = 3; // 累积位移阈值（像素）- 更敏感
-
-static double timespec_diff_ms(const struct timespec *lhs, const struct timespec *rhs)
+static uint64_t now_us(void)
 {
-    const double sec = (double)(lhs->tv_sec - rhs->tv_sec);
-    const double nsec = (double)(lhs->tv_nsec - rhs->tv_nsec);
-    return sec * 1000.0 + nsec / 1000000.0;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ull + (uint64_t)now.tv_nsec / 1000ull;
 }
 
-// 计算当前累积的移动速度（像素）
-static int get_accumulated_distance(void)
+// 自适应节流：根据累积移动距离选择间隔（曼哈顿距离，避免sqrt）
+static uint64_t current_interval_us(const ya_mouse_throttle_t *throttle)
 {
-    int dx = g_mouse_throttle.accum_dx;
-    int dy = g_mouse_throttle.accum_dy;
-    // 使用曼哈顿距离作为速度估计（避免sqrt）
-    return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+    int distance = abs(throttle->accum_dx) + abs(throttle->accum_dy);
+    return distance < YA_MOUSE_THROTTLE_LOW_SPEED_PX ? YA_MOUSE_THROTTLE_LOW_SPEED_US
+                                                     : YA_MOUSE_THROTTLE_HIGH_SPEED_US;
 }
 
-void ya_mouse_throttle_reset(void)
+// 输出累积的位移并记录输出时刻
+static bool emit_accumulated(ya_mouse_throttle_t *throttle, uint64_t now)
 {
-    g_mouse_throttle.accum_dx = 0;
-    g_mouse_throttle.accum_dy = 0;
-    g_mouse_throttle.has_last_emit = false;
+    throttle->last_emit_us = now;
+    throttle->has_last_emit = true;
+    if (throttle->accum_dx == 0 && throttle->accum_dy == 0)
+    {
+        return false;
+    }
+
+    int dx = throttle->accum_dx;
+    int dy = throttle->accum_dy;
+    throttle->accum_dx = 0;
+    throttle->accum_dy = 0;
+    throttle->emit(throttle->ctx, dx, dy);
+    return true;
 }
 
-bool ya_mouse_throttle_collect(int dx, int dy, bool force_flush, int *out_dx, int *out_dy)
+// 间隔已到则输出，否则把定时器设到间隔到期时刻
+static void run_due(ya_mouse_throttle_t *throttle)
 {
-    if (!out_dx || !out_dy)
+    uint64_t now = now_us();
+    uint64_t interval = current_interval_us(throttle);
+    uint64_t elapsed = throttle->has_last_emit ? now - throttle->last_emit_us : interval;
+
+    YA_LOG_TRACE("[throttle] accum=(%d,%d), interval=%lluus, elapsed=%lluus", throttle->accum_dx,
+                 throttle->accum_dy, (unsigned long long)interval, (unsigned long long)elapsed);
+
+    if (elapsed >= interval)
     {
-        return false;
+        evtimer_del(throttle->timer);
+        emit_accumulated(throttle, now);
+        return;
     }
 
-    g_mouse_throttle.accum_dx += dx;
-    g_mouse_throttle.accum_dy += dy;
+    if (throttle->accum_dx != 0 || throttle->accum_dy != 0)
+    {
+        uint64_t wait = interval - elapsed;
+        struct timeval tv = {.tv_sec = (long)(wait / 1000000ull), .tv_usec = (long)(wait % 1000000ull)};
+        evtimer_add(throttle->timer, &tv);
+    }
+}
 
-    struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
+static void throttle_timer_cb(evutil_socket_t fd, short events, void *arg)
+{
+    (void)fd;
+    (void)events;
+    run_due((ya_mouse_throttle_t *)arg);
+}
 
-    bool should_emit = force_flush;
-    if (!should_emit)
+ya_mouse_throttle_t *ya_mouse_throttle_create(struct event_base *base, ya_mouse_throttle_emit_fn emit, void *ctx)
+{
+    if (!base || !emit)
     {
-        if (!g_mouse_throttle.has_last_emit)
-        {
-            should_emit = true;
-        }
-        else
-        {
-            double elapsed = timespec_diff_ms(&now, &g_mouse_throttle.last_emit);
-            // 自适应节流：根据累积移动距离选择间隔
-            int distance = get_accumulated_distance();
-            double threshold = (distance < LOW_SPEED_THRESHOLD) 
-                ? THROTTLE_INTERVAL_LOW_SPEED_MS 
-                : THROTTLE_INTERVAL_HIGH_SPEED_MS;
-            
-            YA_LOG_TRACE("[throttle] distance=%d, threshold=%.1fms, elapsed=%.1fms", 
-                         distance, threshold, elapsed);
-            
-            if (elapsed >= threshold)
-            {
-                should_emit = true;
-            }
-        }
+        return NULL;
     }
 
-    if (!should_emit)
+    ya_mouse_throttle_t *throttle = calloc(1, sizeof(*throttle));
+    if (!throttle)
     {
-        return false;
+        return NULL;
     }
 
-    if (g_mouse_throttle.accum_dx == 0 && g_mouse_throttle.accum_dy == 0)
+    throttle->timer = evtimer_new(base, throttle_timer_cb, throttle);
+    if (!throttle->timer)
     {
-        g_mouse_throttle.last_emit = now;
-        g_mouse_throttle.has_last_emit = true;
-        return false;
+        free(throttle);
+        return NULL;
     }
 
-    *out_dx = g_mouse_throttle.accum_dx;
-    *out_dy = g_mouse_throttle.accum_dy;
-    g_mouse_throttle.accum_dx = 0;
-    g_mouse_throttle.accum_dy = 0;
-    g_mouse_throttle.last_emit = now;
-    g_mouse_throttle.has_last_emit = true;
-    return true;
+    throttle->emit = emit;
+    throttle->ctx = ctx;
+    return throttle;
 }
 
-bool ya_mouse_throttle_flush(int *out_dx, int *out_dy)
+void ya_mouse_throttle_destroy(ya_mouse_throttle_t *throttle)
 {
-    if (!out_dx || !out_dy)
+    if (!throttle)
     {
-        return false;
+        return;
+    }
+
+    // 丢弃未输出的位移：客户端已断开，不再产生输入
+    event_free(throttle->timer);
+    free(throttle);
+}
+
+void ya_mouse_throttle_push(ya_mouse_throttle_t *throttle, int dx, int dy)
+{
+    if (!throttle)
+    {
+        return;
     }
 
-    if (g_mouse_throttle.accum_dx == 0 && g_mouse_throttle.accum_dy == 0)
+    throttle->accum_dx += dx;
+    throttle->accum_dy += dy;
+    run_due(throttle);
+}
+
+bool ya_mouse_throttle_flush(ya_mouse_throttle_t *throttle)
+{
+    if (!throttle)
     {
         return false;
     }
 
-    *out_dx = g_mouse_throttle.accum_dx;
-    *out_dy = g_mouse_throttle.accum_dy;
-    g_mouse_throttle.accum_dx = 0;
-    g_mouse_throttle.accum_dy = 0;
-    
-    struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    g_mouse_throttle.last_emit = now;
-    g_mouse_throttle.has_last_emit = true;
-    
-    return true;
-}
\ No newline at end of file
+    evtimer_del(throttle->timer);
+    return emit_accumulated(throttle, now_us());
+}
+
+void ya_mouse_throttle_reset(ya_mouse_throttle_t *throttle)
+{
+    if (!throttle)
+    {
+        return;
+    }
+
+    evtimer_del(throttle->timer);
+    throttle->accum_dx = 0;
+    throttle->accum_dy = 0;
+    throttle->has_last_emit = false;
+}
+
+bool ya_mouse_throttle_pending(const ya_mouse_throttle_t *throttle)
+{
+    return throttle && (throttle->accum_dx != 0 || throttle->accum_dy != 0);
+}
@@ -1,13 +1,31 @@
 #pragma once
 
+#include <event2/event.h>
 #include <stdbool.h>
 
-// mouse throttle used to batch relative moves before calling move_mouse().
-void ya_mouse_throttle_reset(void);
+// 协议 v2 的鼠标节流器：按客户端累积相对位移，按自适应间隔合并输出
+// 间隔未到时挂定时器，即使之后没有新的包，累积的位移也会在间隔到期时输出
+#define YA_MOUSE_THROTTLE_LOW_SPEED_US 4000  // 低速：4ms (250Hz)
+#define YA_MOUSE_THROTTLE_HIGH_SPEED_US 8000 // 高速：8ms (125Hz)
+#define YA_MOUSE_THROTTLE_LOW_SPEED_PX 3     // 累积位移（曼哈顿距离）低于该值视为低速
 
-// Accumulate delta. When ready to emit (interval elapsed or force_flush=true), returns true and
-// writes aggregated delta into out_dx/out_dy. When not ready, returns false and leaves outputs untouched.
-bool ya_mouse_throttle_collect(int dx, int dy, bool force_flush, int *out_dx, int *out_dy);
+// 输出一次合并后的位移（像素）
+typedef void (*ya_mouse_throttle_emit_fn)(void *ctx, int dx, int dy);
 
-// Flush any accumulated movement immediately (for touch stop events)
-bool ya_mouse_throttle_flush(int *out_dx, int *out_dy);
\ No newline at end of file
+typedef struct ya_mouse_throttle ya_mouse_throttle_t;
+
+// 创建/销毁每客户端节流器，定时器挂在 base 上
+ya_mouse_throttle_t *ya_mouse_throttle_create(struct event_base *base, ya_mouse_throttle_emit_fn emit, void *ctx);
+void ya_mouse_throttle_destroy(ya_mouse_throttle_t *throttle);
+
+// 累积位移：距上次输出已满间隔时立即输出，否则等定时器到期输出
+void ya_mouse_throttle_push(ya_mouse_throttle_t *throttle, int dx, int dy);
+
+// 立即输出累积的位移（例如收到 MOUSE_STOP 时），返回是否有输出
+bool ya_mouse_throttle_flush(ya_mouse_throttle_t *throttle);
+
+// 丢弃累积的位移并清除计时，下一次 push 立即输出
+void ya_mouse_throttle_reset(ya_mouse_throttle_t *throttle);
+
+// 是否有等待输出的位移
+bool ya_mouse_throttle_pending(const ya_mouse_throttle_t *throttle);
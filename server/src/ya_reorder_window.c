@@ -0,0 +1,54 @@
+#include "ya_reorder_window.h"
+
+#include <time.h>
+
+uint32_t ya_reorder_now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000ull + (uint64_t)now.tv_nsec / 1000000ull);
+}
+
+ya_reorder_result_t ya_reorder_window_accept(ya_reorder_window_t *window, uint32_t index, uint32_t now_ms)
+{
+    if (!window || index == 0)
+    {
+        return YA_REORDER_DROP;
+    }
+
+    if (index > window->high)
+    {
+        // 窗口前移：记录中间被跳过的序号的时刻，迟到的事件据此判断是否超时
+        uint32_t shift = index - window->high;
+        uint32_t first_skipped = shift > YA_REORDER_WINDOW_SIZE ? index - YA_REORDER_WINDOW_SIZE : window->high + 1;
+        for (uint32_t i = first_skipped; i < index; i++)
+        {
+            window->skipped_ms[i % YA_REORDER_WINDOW_SIZE] = now_ms;
+        }
+
+        window->seen = shift >= YA_REORDER_WINDOW_SIZE ? 1 : (window->seen << shift) | 1;
+        window->high = index;
+        return YA_REORDER_IN_ORDER;
+    }
+
+    uint32_t offset = window->high - index;
+    if (offset >= YA_REORDER_WINDOW_SIZE)
+    {
+        return YA_REORDER_DROP;
+    }
+
+    uint64_t bit = (uint64_t)1 << offset;
+    if (window->seen & bit)
+    {
+        // 重复的数据报
+        return YA_REORDER_DROP;
+    }
+
+    if ((uint32_t)(now_ms - window->skipped_ms[index % YA_REORDER_WINDOW_SIZE]) > YA_REORDER_MAX_WAIT_MS)
+    {
+        return YA_REORDER_DROP;
+    }
+
+    window->seen |= bit;
+    return YA_REORDER_LATE;
+}
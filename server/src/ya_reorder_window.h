@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+// 乱序窗口覆盖的序号范围（seen 位图的位数）
+#define YA_REORDER_WINDOW_SIZE 64
+
+// 被跳过的序号最多等待多久（毫秒），超时后迟到的事件直接丢弃
+#define YA_REORDER_MAX_WAIT_MS 100
+
+typedef enum {
+    YA_REORDER_IN_ORDER = 0, // 序号大于已接受的最大序号
+    YA_REORDER_LATE = 1,     // 迟到，但仍在窗口和等待时限内且未被接受过
+    YA_REORDER_DROP = 2,     // 重复、超出窗口或等待超时
+} ya_reorder_result_t;
+
+// 每客户端的乱序窗口，全零即为初始状态（序号 0 视为无效）
+typedef struct {
+    uint32_t high;                                   // 已接受的最大序号
+    uint64_t seen;                                   // bit i 表示序号 high - i 已接受
+    uint32_t skipped_ms[YA_REORDER_WINDOW_SIZE];     // 按 index % 窗口大小记录该序号被跳过的时刻
+} ya_reorder_window_t;
+
+// 判断一个序号能否被接受，并更新窗口；now_ms 为单调时钟毫秒数
+ya_reorder_result_t ya_reorder_window_accept(ya_reorder_window_t *window, uint32_t index, uint32_t now_ms);
+
+// 单调时钟毫秒数（32 位回绕，只用于计算差值）
+uint32_t ya_reorder_now_ms(void);
@@ -22,12 +22,18 @@
 #include <event2/thread.h>
 #include <event2/dns.h>
 
+#include "ya_input_queue.h"
+#include "ya_latency.h"
 #include "ya_logger.h"
+#include "ya_mouse_pacer.h"
 #include "ya_server.h"
 #include "ya_server_command.h"
 #include "ya_server_discover.h"
+#include "ya_server_handler.h"
 #include "ya_server_session.h"
 #include "ya_server_http.h"
+#include "ya_socket_tuning.h"
+#include "ya_trace.h"
 #include "ya_utils.h"
 
 #ifdef USE_UINPUT
@@ -36,6 +42,7 @@
 #endif
 #include "input/facade.h"
 #include "input/keyboard/clipboard.h"
+#include "input/keyboard/sequencer.h"
 
 extern YA_ServerContext svr_context;
 extern YA_Config config;
@@ -47,6 +54,10 @@ void fatal_cb(int code)
 
 void stop()
 {
+    // 先执行完排队的注入动作，再关闭输入后端
+    ya_input_queue_stop();
+    ya_input_queue_detach();
+
 #ifdef USE_UINPUT
     // 关闭输入后端
     xkbmap_free();
@@ -83,6 +94,9 @@ void stop()
         svr_context.macs_csv = NULL;
     }
 
+    // 事件循环和注入线程都已停止，不会再有写入
+    ya_trace_close();
+
     YA_LOG_DEBUG("Stopped");
 }
 
@@ -176,28 +190,250 @@ void ya_server_stats_inc_commands(bool success) {
     }
 }
 
-size_t ya_server_stats_pack(const ya_server_stats_t *stats, char *buffer, size_t buffer_size) {
-    mpack_writer_t writer;
-    mpack_writer_init(&writer, buffer, buffer_size);
+void ya_server_stats_record_read(uint32_t frames, bool budget_exhausted) {
+    svr_context.stats.session_reads++;
+    svr_context.stats.session_frames += frames;
+    if (frames > svr_context.stats.max_frames_per_read) {
+        svr_context.stats.max_frames_per_read = frames;
+    }
+    if (budget_exhausted) {
+        svr_context.stats.read_budget_yields++;
+    }
+}
 
-    mpack_start_map(&writer, 4);
-    
-    mpack_write_cstr(&writer, "total_connections");
-    mpack_write_u32(&writer, stats->total_connections);
+void ya_server_stats_record_command_wakeup(uint32_t datagrams) {
+    svr_context.stats.command_wakeups++;
+    svr_context.stats.command_datagrams += datagrams;
+    if (datagrams > svr_context.stats.max_datagrams_per_wakeup) {
+        svr_context.stats.max_datagrams_per_wakeup = datagrams;
+    }
+}
+
+void ya_server_stats_record_udp_pointer(bool accepted) {
+    if (accepted) {
+        svr_context.stats.udp_pointer_events++;
+    } else {
+        svr_context.stats.udp_rejected++;
+    }
+}
+
+void ya_server_stats_record_session_parse_error(void) {
+    svr_context.stats.session_parse_errors++;
+}
+
+void ya_server_stats_record_command_parse_error(void) {
+    svr_context.stats.command_parse_errors++;
+}
+
+void ya_server_stats_record_event_order(bool late, bool accepted) {
+    if (late) {
+        svr_context.stats.order_late++;
+        if (accepted) {
+            svr_context.stats.order_merged++;
+        }
+    }
+    if (!accepted) {
+        svr_context.stats.order_dropped++;
+    }
+}
+
+void ya_server_stats_record_event(YAEventType type, bool accepted) {
+    ya_server_stats_inc_commands(accepted);
+    if ((uint32_t)type >= YA_EVENT_TYPE_COUNT) {
+        return;
+    }
+    if (accepted) {
+        svr_context.stats.event_types[type].handled++;
+    } else {
+        svr_context.stats.event_types[type].rejected++;
+    }
+}
+
+// 一个直方图的摘要（纳秒），with_buckets 时附带非空桶 [上界, 计数]
+// 注入阶段的直方图由注入线程写入，先复制一份一致的副本再输出
+static void write_histogram(mpack_writer_t *writer, const ya_histogram_t *live, bool with_buckets) {
+    ya_histogram_snapshot_t snapshot;
+    ya_histogram_snapshot(live, &snapshot);
+    const ya_histogram_snapshot_t *histogram = &snapshot;
+
+    uint32_t used = 0;
+    for (size_t i = 0; i < YA_HISTOGRAM_BUCKETS; i++) {
+        if (with_buckets && histogram->buckets[i]) {
+            used++;
+        }
+    }
+
+    mpack_start_map(writer, with_buckets ? 9 : 8);
+    mpack_write_cstr(writer, "count");
+    mpack_write_u64(writer, histogram->count);
+    mpack_write_cstr(writer, "min");
+    mpack_write_u64(writer, histogram->min);
+    mpack_write_cstr(writer, "mean");
+    mpack_write_u64(writer, histogram->count ? histogram->sum / histogram->count : 0);
+    mpack_write_cstr(writer, "p50");
+    mpack_write_u64(writer, ya_histogram_percentile(histogram, 0.50));
+    mpack_write_cstr(writer, "p90");
+    mpack_write_u64(writer, ya_histogram_percentile(histogram, 0.90));
+    mpack_write_cstr(writer, "p99");
+    mpack_write_u64(writer, ya_histogram_percentile(histogram, 0.99));
+    mpack_write_cstr(writer, "p999");
+    mpack_write_u64(writer, ya_histogram_percentile(histogram, 0.999));
+    mpack_write_cstr(writer, "max");
+    mpack_write_u64(writer, histogram->max);
+    if (!with_buckets) {
+        mpack_finish_map(writer);
+        return;
+    }
+    mpack_write_cstr(writer, "buckets");
+    mpack_start_array(writer, used);
+    for (size_t i = 0; i < YA_HISTOGRAM_BUCKETS; i++) {
+        if (histogram->buckets[i]) {
+            mpack_start_array(writer, 2);
+            mpack_write_u64(writer, ya_histogram_bucket_upper(i));
+            mpack_write_u64(writer, histogram->buckets[i]);
+            mpack_finish_array(writer);
+        }
+    }
+    mpack_finish_array(writer);
+    mpack_finish_map(writer);
+}
+
+static bool latency_seen(uint32_t type) {
+    for (int stage = 0; stage < YA_LATENCY_STAGE_COUNT; stage++) {
+        if (ya_histogram_count(ya_latency_histogram(type, (ya_latency_stage_t)stage))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ya_server_stats_write_latency(mpack_writer_t *writer, bool with_buckets) {
+    uint32_t seen_types = 0;
+    for (uint32_t type = 0; type < YA_EVENT_TYPE_COUNT; type++) {
+        if (latency_seen(type)) {
+            seen_types++;
+        }
+    }
+
+    mpack_start_map(writer, seen_types);
+    for (uint32_t type = 0; type < YA_EVENT_TYPE_COUNT; type++) {
+        if (!latency_seen(type)) {
+            continue;
+        }
+        mpack_write_cstr(writer, ya_event_type_name((YAEventType)type));
+        mpack_start_map(writer, YA_LATENCY_STAGE_COUNT);
+        for (int stage = 0; stage < YA_LATENCY_STAGE_COUNT; stage++) {
+            mpack_write_cstr(writer, ya_latency_stage_name((ya_latency_stage_t)stage));
+            write_histogram(writer, ya_latency_histogram(type, (ya_latency_stage_t)stage), with_buckets);
+        }
+        mpack_finish_map(writer);
+    }
+    mpack_finish_map(writer);
+}
+
+// 在线客户端的事件速率与收发字节数
+static void write_clients(mpack_writer_t *writer) {
+    ya_client_manager_t *manager = &svr_context.client_manager;
+    uint32_t count = ya_client_get_count(manager);
+    uint32_t now_s = (uint32_t)(ya_latency_now_ns() / 1000000000ull);
+
+    mpack_start_array(writer, count);
+    for (uint32_t i = 0; i < count; i++) {
+        const ya_client_t *client = ya_client_at(manager, i);
+        mpack_start_map(writer, 6);
+        mpack_write_cstr(writer, "uid");
+        mpack_write_u32(writer, client->uid);
+        mpack_write_cstr(writer, "connected_at");
+        mpack_write_i64(writer, (int64_t)client->connected_at);
+        mpack_write_cstr(writer, "events");
+        mpack_write_u64(writer, client->events);
+        mpack_write_cstr(writer, "events_per_sec");
+        mpack_write_u32(writer, ya_client_events_per_sec(client, now_s));
+        mpack_write_cstr(writer, "bytes_in");
+        mpack_write_u64(writer, client->bytes_in);
+        mpack_write_cstr(writer, "bytes_out");
+        mpack_write_u64(writer, client->bytes_out);
+        mpack_finish_map(writer);
+    }
+    mpack_finish_array(writer);
+}
+
+void ya_server_stats_write(const ya_server_stats_t *stats, mpack_writer_t *writer) {
+    mpack_start_map(writer, 20);
     
-    mpack_write_cstr(&writer, "active_connections");
-    mpack_write_u32(&writer, stats->active_connections);
+    mpack_write_cstr(writer, "total_connections");
+    mpack_write_u32(writer, stats->total_connections);
     
-    mpack_write_cstr(&writer, "total_commands");
-    mpack_write_u32(&writer, stats->total_commands);
+    mpack_write_cstr(writer, "active_connections");
+    mpack_write_u32(writer, stats->active_connections);
     
-    mpack_write_cstr(&writer, "failed_commands");
-    mpack_write_u32(&writer, stats->failed_commands);
+    mpack_write_cstr(writer, "total_commands");
+    mpack_write_u32(writer, stats->total_commands);
     
-    mpack_finish_map(&writer);
+    mpack_write_cstr(writer, "failed_commands");
+    mpack_write_u32(writer, stats->failed_commands);
+
+    mpack_write_cstr(writer, "session_reads");
+    mpack_write_u64(writer, stats->session_reads);
+
+    mpack_write_cstr(writer, "session_frames");
+    mpack_write_u64(writer, stats->session_frames);
+
+    mpack_write_cstr(writer, "max_frames_per_read");
+    mpack_write_u32(writer, stats->max_frames_per_read);
+
+    mpack_write_cstr(writer, "read_budget_yields");
+    mpack_write_u32(writer, stats->read_budget_yields);
+
+    mpack_write_cstr(writer, "session_parse_errors");
+    mpack_write_u64(writer, stats->session_parse_errors);
+
+    mpack_write_cstr(writer, "command_wakeups");
+    mpack_write_u64(writer, stats->command_wakeups);
+
+    mpack_write_cstr(writer, "command_datagrams");
+    mpack_write_u64(writer, stats->command_datagrams);
+
+    mpack_write_cstr(writer, "max_datagrams_per_wakeup");
+    mpack_write_u32(writer, stats->max_datagrams_per_wakeup);
+
+    mpack_write_cstr(writer, "udp_pointer_events");
+    mpack_write_u64(writer, stats->udp_pointer_events);
+
+    mpack_write_cstr(writer, "udp_rejected");
+    mpack_write_u64(writer, stats->udp_rejected);
+
+    mpack_write_cstr(writer, "command_parse_errors");
+    mpack_write_u64(writer, stats->command_parse_errors);
+
+    mpack_write_cstr(writer, "order_late");
+    mpack_write_u64(writer, stats->order_late);
+
+    mpack_write_cstr(writer, "order_merged");
+    mpack_write_u64(writer, stats->order_merged);
+
+    mpack_write_cstr(writer, "order_dropped");
+    mpack_write_u64(writer, stats->order_dropped);
+
+    mpack_write_cstr(writer, "latency");
+    ya_server_stats_write_latency(writer, true);
+
+    mpack_write_cstr(writer, "clients");
+    write_clients(writer);
+
+    mpack_finish_map(writer);
+}
+
+size_t ya_server_stats_pack(const ya_server_stats_t *stats, char *buffer, size_t buffer_size) {
+    mpack_writer_t writer;
+    mpack_writer_init(&writer, buffer, buffer_size);
+
+    ya_server_stats_write(stats, &writer);
 
     size_t size = mpack_writer_buffer_used(&writer);
-    mpack_writer_destroy(&writer);
+    if (mpack_writer_destroy(&writer) != mpack_ok) {
+        return 0;
+    }
 
     return size;
 }
@@ -235,6 +471,21 @@ int start_server() {
 
     // Initialize clipboard helper (reads config)
     clipboard_helper_init();
+
+    // 按键步骤间隔（reads config）
+    key_sequencer_init();
+
+    // 批量指针采样的回放方式（reads config）
+    ya_mouse_pacer_init();
+
+    // 会话连接的套接字调优（reads config）
+    ya_socket_tuning_init();
+
+    // 输入事件二进制跟踪（reads config，配置了 [trace] file 才启用）
+    ya_trace_init();
+
+    // 输入注入线程：事件循环只解码和放入队列，按键时序等待不再阻塞事件循环
+    ya_input_queue_start(ya_input_execute);
     
     event_enable_debug_mode();
     event_set_fatal_callback(fatal_cb);
@@ -247,6 +498,9 @@ int start_server() {
     // 初始化客户端管理器
     ya_client_manager_init(&svr_context.client_manager);
 
+    // TEXT_GET 在注入线程上读取，结果回到事件循环线程回复
+    ya_input_queue_attach(svr_context.base, handle_input_get_result);
+
     struct event *signal_event = evsignal_new(svr_context.base, SIGINT, signal_cb, NULL);
     event_add(signal_event, NULL);
 
@@ -6,6 +6,8 @@
 
 #include "ya_config.h"
 #include "ya_client_manager.h"
+#include "ya_event.h"
+#include "mpack/mpack.h"
 
 // 服务器状态枚举
 typedef enum {
@@ -23,12 +25,41 @@ typedef struct {
     bool discovery_ready;       // 发现服务就绪状态
 } ya_server_components_state_t;
 
+// 单个事件类型的分发统计
+typedef struct {
+    uint64_t handled;               // 交给处理函数的事件数
+    uint64_t rejected;              // 因传输方式、序号或未授权被拒绝的事件数
+} ya_event_type_stats_t;
+
 // 服务器统计信息
 typedef struct {
     uint32_t total_connections;     // 总连接数
     uint32_t active_connections;    // 活动连接数
     uint32_t total_commands;        // 总命令数
     uint32_t failed_commands;       // 失败命令数
+
+    // 会话读路径统计（每次读回调处理的帧数）
+    uint64_t session_reads;         // 会话读回调次数
+    uint64_t session_frames;        // 会话读回调处理的帧总数
+    uint32_t max_frames_per_read;   // 单次读回调处理帧数峰值
+    uint32_t read_budget_yields;    // 帧预算耗尽后让出事件循环的次数
+    uint64_t session_parse_errors;  // 会话连接上无法解码而丢弃的帧数（含失步断开）
+
+    // 命令服务（UDP）接收统计（每次唤醒处理的数据报数）
+    uint64_t command_wakeups;           // 命令服务读回调次数
+    uint64_t command_datagrams;         // 处理的数据报总数
+    uint32_t max_datagrams_per_wakeup;  // 单次唤醒处理数据报数峰值
+    uint64_t udp_pointer_events;        // 通过 UDP 指针通道注入的鼠标移动数
+    uint64_t udp_rejected;              // 令牌、来源或类型校验失败而丢弃的数据报数
+    uint64_t command_parse_errors;      // 无法解码为一帧而丢弃的数据报数
+
+    // 事件序号统计
+    uint64_t order_late;                // 序号低于已处理最大序号的迟到事件数
+    uint64_t order_merged;              // 迟到但仍被合并的鼠标移动数
+    uint64_t order_dropped;             // 因重复、过期或乱序被丢弃的事件数
+
+    // 按事件类型的分发统计，下标为 YAEventType
+    ya_event_type_stats_t event_types[YA_EVENT_TYPE_COUNT];
 } ya_server_stats_t;
 
 typedef struct
@@ -85,10 +116,24 @@ bool ya_server_all_components_ready(const ya_server_components_state_t *state);
 void ya_server_stats_inc_connections(void);
 void ya_server_stats_dec_connections(void);
 void ya_server_stats_inc_commands(bool success);
-
-// 将统计信息序列化为MessagePack格式
+void ya_server_stats_record_read(uint32_t frames, bool budget_exhausted);
+void ya_server_stats_record_command_wakeup(uint32_t datagrams);
+void ya_server_stats_record_udp_pointer(bool accepted);
+void ya_server_stats_record_session_parse_error(void);
+void ya_server_stats_record_command_parse_error(void);
+void ya_server_stats_record_event_order(bool late, bool accepted);
+void ya_server_stats_record_event(YAEventType type, bool accepted);
+
+// 将统计信息序列化为MessagePack格式：计数器、按事件类型的各阶段延迟直方图（ya_latency.h）、
+// 每个在线客户端的事件速率和收发字节数
 size_t ya_server_stats_pack(const ya_server_stats_t *stats, char *buffer, size_t buffer_size);
 
+// 同上，写入调用方的 writer（HTTP /metrics 使用可增长的 writer）
+void ya_server_stats_write(const ya_server_stats_t *stats, mpack_writer_t *writer);
+
+// 只写入按事件类型的各阶段延迟（只列出出现过的类型），/status 不带分桶
+void ya_server_stats_write_latency(mpack_writer_t *writer, bool with_buckets);
+
 // 废弃的旧接口，为了向后兼容暂时保留，但返回新的类型
 ya_client_t *get_client_by_id(uint32_t uid);
 ya_client_t *get_client_by_fd(evutil_socket_t fd);
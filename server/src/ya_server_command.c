@@ -1,12 +1,22 @@
+#ifdef __linux__
+// recvmmsg / sendmmsg
+#define _GNU_SOURCE
+#endif
+
 #include "ya_server_command.h"
+#include "ya_config.h"
 #include "ya_event.h"
+#include "ya_latency.h"
 #include "ya_logger.h"
 #include "ya_server.h"
 #include "ya_server_handler.h"
 #include "ya_utils.h"
 #include "ya_client_manager.h"
 
+#include <errno.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #ifndef _WIN32
@@ -30,8 +40,44 @@ static void conn_eventcb(struct bufferevent *, short, void *);
 static void signal_cb(evutil_socket_t, short, void *);
 static void udp_readcb(evutil_socket_t sock, short events, void *user_data);
 
+extern YA_Config config;
+
+// 单个数据报的最大长度
+#define YA_COMMAND_DATAGRAM_SIZE 2048
+
+// 每次唤醒最多接收的数据报数（[command] recv_batch，1 表示逐个接收）
+#define YA_COMMAND_DEFAULT_BATCH 32
+#define YA_COMMAND_MAX_BATCH 64
+
+static unsigned int g_recv_batch = YA_COMMAND_DEFAULT_BATCH;
+
+// 批量收发缓冲区：命令服务只在事件循环线程中运行，使用静态存储避免每次唤醒分配
+static uint8_t g_datagrams[YA_COMMAND_MAX_BATCH][YA_COMMAND_DATAGRAM_SIZE];
+static struct sockaddr_in g_peers[YA_COMMAND_MAX_BATCH];
+static uint8_t g_replies[YA_COMMAND_MAX_BATCH][YA_EVENT_FRAME_STACK_SIZE];
+
+static void load_recv_batch(void)
+{
+    const char *batch_str = ya_config_get(&config, "command", "recv_batch");
+    if (batch_str)
+    {
+        long batch = strtol(batch_str, NULL, 10);
+        if (batch < 1)
+        {
+            batch = 1;
+        }
+        if (batch > YA_COMMAND_MAX_BATCH)
+        {
+            batch = YA_COMMAND_MAX_BATCH;
+        }
+        g_recv_batch = (unsigned int)batch;
+    }
+}
+
 int run_command_server()
 {
+    load_recv_batch();
+
     svr_context.command_fd = socket(AF_INET, SOCK_DGRAM, 0);
     if (svr_context.command_fd < 0)
     {
@@ -68,51 +114,258 @@ int run_command_server()
     return 0;
 }
 
-static void udp_readcb(evutil_socket_t sock, short events, void *user_data)
+// UDP 数据报是否来自客户端 TCP 会话的对端 IP
+static bool from_session_peer(const ya_client_t *client, const struct sockaddr_in *addr)
 {
-    struct event_base *base = svr_context.base;
-    struct sockaddr_in addr;
-    socklen_t addr_len = sizeof(addr);
-    uint8_t buffer[2048];
+    return client->peer_addr.sin_family == AF_INET && client->peer_addr.sin_addr.s_addr == addr->sin_addr.s_addr;
+}
 
-    int len = recvfrom(sock, buffer, sizeof(buffer), 0, (struct sockaddr *)&addr, &addr_len);
-    if (len < 0)
+// 处理 v5 UDP 指针数据报：令牌、对端 IP 都与 uid 的 TCP 会话一致才注入
+static void handle_pointer_datagram(const uint8_t *data, size_t len, const struct sockaddr_in *addr,
+                                    uint64_t readable_ns)
+{
+    YAEvent request = {0};
+    uint64_t token = 0;
+    if (ya_decode_pointer_datagram(data, len, &request, &token) != (int)len)
     {
-        YA_LOG_DEBUG("Error receiving data.");
+        // 其余紧凑记录（点击、滚轮、按键）只能走 TCP
+        ya_server_stats_record_udp_pointer(false);
         return;
     }
+    uint64_t decoded_ns = ya_latency_now_ns();
 
-    struct evbuffer *input = evbuffer_new();
-    evbuffer_add(input, buffer, len);
+    ya_client_t *client = get_client_by_id(request.header.uid);
+    if (!client || client->state != YA_CLIENT_ACTIVE || client->session_token == 0 ||
+        client->session_token != token || !from_session_peer(client, addr))
+    {
+        YA_LOG_TRACE("Rejected UDP pointer datagram for uid=%u", request.header.uid);
+        ya_server_stats_record_udp_pointer(false);
+        return;
+    }
 
-    YAPackageSize size = {0};
-    ya_get_package_size(input, &size);
-    if (len != (size.totalSize + 4))
+    // UDP 指针通道使用独立的序号：与 TCP 上的点击、按键交错到达时互不丢弃；
+    // 乱序到达的移动在窗口内合并，只丢弃重复或等待超时的
+    ya_reorder_result_t order =
+        ya_reorder_window_accept(&client->udp_pointer_window, request.header.index, ya_reorder_now_ms());
+    if (order != YA_REORDER_IN_ORDER)
+    {
+        ya_server_stats_record_event_order(true, order == YA_REORDER_LATE);
+    }
+    if (order == YA_REORDER_DROP)
     {
         return;
     }
 
-    // remove total size and header size
-    evbuffer_drain(input, sizeof(uint32_t) * 2);
+    ya_server_stats_record_udp_pointer(true);
+    client->bytes_in += len;
+
+    // 指针通道不经过 process_server_event，在这里登记延迟和事件计数
+    ya_latency_begin_event(MOUSE_MOVE, readable_ns, decoded_ns);
+    ya_client_count_event(client, (uint32_t)(decoded_ns / 1000000000ull));
+    handle_mouse_move(NULL, &request, client);
+    ya_latency_end_event();
+}
+
+// 旧格式的帧只凭 uid 定位会话：已知对端地址时必须来自同一 IP；
+// 持有令牌的会话只接受心跳，输入必须走带令牌的指针数据报或 TCP
+static bool accept_frame(const ya_client_t *client, const YAEvent *request, const struct sockaddr_in *addr)
+{
+    if (client->peer_addr.sin_family == AF_INET && !from_session_peer(client, addr))
+    {
+        return false;
+    }
+    return client->session_token == 0 || request->header.type == HEARTBEAT;
+}
+
+// 没有在线会话的 uid（未授权、已断开或伪造）只接受心跳和发现，其余帧一律丢弃
+static bool accept_unbound_frame(const YAEvent *request)
+{
+    return request->header.type == HEARTBEAT || request->header.type == DISCOVER;
+}
+
+// 处理一个数据报；回复写入 reply 并返回长度，0 表示无需回复（或已直接发送）
+// readable_ns 为本次唤醒的时刻，用于延迟统计
+static int handle_datagram(evutil_socket_t sock, const uint8_t *data, size_t len, const struct sockaddr_in *addr,
+                           uint8_t *reply, size_t reply_cap, uint64_t readable_ns)
+{
+    if (len > 0 && data[0] == YA_PACKED_MAGIC)
+    {
+        handle_pointer_datagram(data, len, addr, readable_ns);
+        return 0;
+    }
 
+    // 直接在数据报缓冲区上解码，一个数据报必须正好是一帧
     YAEvent request = {0};
-    if (ya_parse_event(input, &request, &size) < 0)
+    if (ya_decode_frame(data, len, &request) != (int)len)
     {
-        return;
+        ya_server_stats_record_command_parse_error();
+        ya_free_event_param(&request);
+        return 0;
     }
+    request.readable_ns = readable_ns;
+    request.decoded_ns = ya_latency_now_ns();
 
     ya_client_t *client = get_client_by_id(request.header.uid);
+    if (client && client->state != YA_CLIENT_ACTIVE)
+    {
+        client = NULL;
+    }
+    if (client ? !accept_frame(client, &request, addr) : !accept_unbound_frame(&request))
+    {
+        YA_LOG_TRACE("Rejected UDP frame type %d for uid=%u", request.header.type, request.header.uid);
+        ya_server_stats_record_udp_pointer(false);
+        ya_free_event_param(&request);
+        return 0;
+    }
+    if (client)
+    {
+        client->bytes_in += len;
+    }
+
     YAEvent *response = process_server_event(NULL, &request, client);
+    ya_free_event_param(&request);
 
+    int length = 0;
     if (NULL != response)
     {
-        uint8_t *rsp = NULL;
-        int length = ya_serialize_event(response, &rsp);
-        sendto(sock, rsp, length, 0, (struct sockaddr *)&addr, addr_len);
+        length = ya_serialize_event_to(response, reply, reply_cap);
+        if (length < 0)
+        {
+            // 帧超出回复缓冲区，退回堆上序列化并立即发送
+            uint8_t *rsp = NULL;
+            int rsp_length = ya_serialize_event(response, &rsp);
+            if (rsp)
+            {
+                sendto(sock, rsp, rsp_length, 0, (const struct sockaddr *)addr, sizeof(*addr));
+            }
 
-        safe_free((void **)&rsp);
+            if (client && rsp_length > 0)
+            {
+                client->bytes_out += (uint64_t)rsp_length;
+            }
+            safe_free((void **)&rsp);
+            length = 0;
+        }
+        else if (client)
+        {
+            client->bytes_out += (uint64_t)length;
+        }
     }
 
     ya_free_event(response);
-    evbuffer_free(input);
-}
\ No newline at end of file
+    return length;
+}
+
+#ifdef __linux__
+// 一次 recvmmsg 收取多个数据报，回复汇总后用一次 sendmmsg 发出
+static void udp_read_batch(evutil_socket_t sock)
+{
+    struct mmsghdr msgs[YA_COMMAND_MAX_BATCH];
+    struct iovec iovs[YA_COMMAND_MAX_BATCH];
+    struct mmsghdr replies[YA_COMMAND_MAX_BATCH];
+    struct iovec reply_iovs[YA_COMMAND_MAX_BATCH];
+
+    for (unsigned int i = 0; i < g_recv_batch; i++)
+    {
+        iovs[i].iov_base = g_datagrams[i];
+        iovs[i].iov_len = YA_COMMAND_DATAGRAM_SIZE;
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name = &g_peers[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(g_peers[i]);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    uint64_t readable_ns = ya_latency_now_ns();
+    int n = recvmmsg(sock, msgs, g_recv_batch, MSG_DONTWAIT, NULL);
+    if (n <= 0)
+    {
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            YA_LOG_DEBUG("Error receiving data.");
+        }
+        return;
+    }
+
+    unsigned int reply_count = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+        {
+            // 超长数据报，丢弃
+            continue;
+        }
+
+        int length = handle_datagram(sock, g_datagrams[i], msgs[i].msg_len, &g_peers[i], g_replies[reply_count],
+                                     sizeof(g_replies[reply_count]), readable_ns);
+        if (length > 0)
+        {
+            reply_iovs[reply_count].iov_base = g_replies[reply_count];
+            reply_iovs[reply_count].iov_len = (size_t)length;
+            memset(&replies[reply_count], 0, sizeof(replies[reply_count]));
+            replies[reply_count].msg_hdr.msg_name = &g_peers[i];
+            replies[reply_count].msg_hdr.msg_namelen = msgs[i].msg_hdr.msg_namelen;
+            replies[reply_count].msg_hdr.msg_iov = &reply_iovs[reply_count];
+            replies[reply_count].msg_hdr.msg_iovlen = 1;
+            reply_count++;
+        }
+    }
+
+    unsigned int sent = 0;
+    while (sent < reply_count)
+    {
+        int r = sendmmsg(sock, replies + sent, reply_count - sent, 0);
+        if (r <= 0)
+        {
+            YA_LOG_DEBUG("Failed to send %u replies.", reply_count - sent);
+            break;
+        }
+        sent += (unsigned int)r;
+    }
+
+    ya_server_stats_record_command_wakeup((uint32_t)n);
+}
+#endif
+
+static void udp_readcb(evutil_socket_t sock, short events, void *user_data)
+{
+#ifdef __linux__
+    if (g_recv_batch > 1)
+    {
+        udp_read_batch(sock);
+        return;
+    }
+#endif
+
+    // 逐个接收：非 Linux 平台没有 recvmmsg，循环 recvfrom 直到读空或达到批量上限
+    uint32_t datagrams = 0;
+    uint64_t readable_ns = ya_latency_now_ns();
+    while (datagrams < g_recv_batch)
+    {
+        struct sockaddr_in addr;
+        socklen_t addr_len = sizeof(addr);
+
+        int len = recvfrom(sock, g_datagrams[0], YA_COMMAND_DATAGRAM_SIZE, 0, (struct sockaddr *)&addr, &addr_len);
+        if (len < 0)
+        {
+            if (datagrams == 0)
+            {
+                YA_LOG_DEBUG("Error receiving data.");
+            }
+            break;
+        }
+        datagrams++;
+
+        int length = handle_datagram(sock, g_datagrams[0], (size_t)len, &addr, g_replies[0], sizeof(g_replies[0]),
+                                     readable_ns);
+        if (length > 0)
+        {
+            sendto(sock, g_replies[0], length, 0, (struct sockaddr *)&addr, addr_len);
+        }
+    }
+
+    if (datagrams > 0)
+    {
+        ya_server_stats_record_command_wakeup(datagrams);
+    }
+}
@@ -116,30 +116,20 @@ void *run_loop(void *param)
         socklen_t addr_len = sizeof(cli_addr);
         uint8_t buffer[REQUEST_BUFFER_SIZE];
 
-        size_t n = recvfrom(svr.sockfd, buffer, REQUEST_BUFFER_SIZE, 0, (struct sockaddr *)&cli_addr, &addr_len);
-
-        struct evbuffer *input = evbuffer_new();
-        evbuffer_add(input, buffer, n);
-
-        YAPackageSize size = {0};
-        ya_get_package_size(input, &size);
-        if (n != (size.totalSize + 4))
+        ssize_t n = recvfrom(svr.sockfd, buffer, REQUEST_BUFFER_SIZE, 0, (struct sockaddr *)&cli_addr, &addr_len);
+        if (n <= 0)
         {
             continue;
         }
 
-        // for UDP, remove total size and header size
-        evbuffer_drain(input, sizeof(uint32_t) * 2);
-
+        // 数据报必须恰好是一个完整的帧
+        // 任何类型的帧都可能解码出堆上的参数（例如 TEXT_INPUT 的文本），判断完立即释放
         YAEvent requestEvent = {0};
-        if (ya_parse_event(input, &requestEvent, &size) < 0)
-        {
-            continue;
-        }
-
-        YADiscoverEventRequest *request = requestEvent.param;
-
-        if (request->magic != DISCOVERY_MAGIC)
+        bool accepted = ya_decode_frame(buffer, (size_t)n, &requestEvent) == n &&
+                        requestEvent.header.type == DISCOVER && requestEvent.param &&
+                        ((YADiscoverEventRequest *)requestEvent.param)->magic == DISCOVERY_MAGIC;
+        ya_free_event_param(&requestEvent);
+        if (!accepted)
         {
             continue;
         }
@@ -160,12 +150,14 @@ void *run_loop(void *param)
 
         YAEvent responseEvent = {.header = responseHeader, .param = &response, .param_len = sizeof(response)};
 
-        uint8_t *rsp = NULL;
-        int rspLength = ya_serialize_event(&responseEvent, &rsp);
+        uint8_t rsp[YA_EVENT_FRAME_STACK_SIZE];
+        int rspLength = ya_serialize_event_to(&responseEvent, rsp, sizeof(rsp));
+        if (rspLength < 0)
+        {
+            continue;
+        }
 
         sendto(svr.sockfd, rsp, rspLength, 0, (struct sockaddr *)&cli_addr, addr_len);
-
-        safe_free((void **)&rsp);
     }
 
     return NULL;
@@ -5,6 +5,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <event2/buffer.h>
+
 #include "input/keyboard/handler.h"
 #include "input/keyboard/clipboard.h"
 #include "keycode_map.h"
@@ -13,11 +15,15 @@
 #include "ya_client_manager.h"
 #include "ya_event.h"
 #include "ya_logger.h"
+#include "ya_input_queue.h"
+#include "ya_latency.h"
 #include "ya_mouse_filter.h"
+#include "ya_mouse_pacer.h"
 #include "ya_mouse_throttle.h"
 #include "ya_utils.h"
 #include "ya_server.h"
 #include "ya_server_handler.h"
+#include "ya_trace.h"
 #include "ya_power_scripts.h"
 #include "input/facade.h"
 
@@ -100,7 +106,7 @@ YAEvent *assign_response(YAEvent *request_event, size_t response_param_len)
     return resposne_event;
 }
 
-YAEvent *handle_authorize(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_authorize(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
     if (!event || !event->param)
     {
@@ -146,8 +152,12 @@ YAEvent *handle_authorize(struct bufferevent *bev, YAEvent *event)
 
     if (response->success)
     {
+        // 会话连接已传入自己的客户端；没有连接上下文的调用方退回按 fd 查找
         evutil_socket_t fd = bufferevent_getfd(bev);
-        ya_client_t *client = ya_client_find_by_fd(&svr_context.client_manager, fd);
+        if (!client)
+        {
+            client = ya_client_find_by_fd(&svr_context.client_manager, fd);
+        }
         if (!client)
         {
             YA_LOG_ERROR("Authorize failed: no client bound to fd=%d, closing connection", (int)fd);
@@ -159,9 +169,21 @@ YAEvent *handle_authorize(struct bufferevent *bev, YAEvent *event)
         client->bev = bev; // The connection owns the bufferevent
         response->uid = client->uid;
         
-        // 保存客户端协议版本到客户端结构体
-        client->protocol_version = client_version;
-        YA_LOG_INFO("Client %u authorized with protocol version %u", client->uid, client_version);
+        // 保存协商后的协议版本（取双方较低者），决定后续可用的编码（如 v4 紧凑记录）
+        client->protocol_version = client_version < YA_PROTOCOL_VERSION ? client_version : YA_PROTOCOL_VERSION;
+        YA_LOG_INFO("Client %u authorized with protocol version %u (client %u)", client->uid,
+                    client->protocol_version, client_version);
+
+        // v5 客户端的鼠标移动可以走 UDP：签发随机会话令牌，UDP 数据报凭令牌和对端 IP 绑定到本会话
+        client->session_token = 0;
+        if (client->protocol_version >= YA_PROTOCOL_UDP_POINTER_VERSION)
+        {
+            while (client->session_token == 0)
+            {
+                evutil_secure_rng_get_bytes(&client->session_token, sizeof(client->session_token));
+            }
+        }
+        response->session_token = client->session_token;
 
         // 填充端口（主机序）
         response->session_port = ntohs(svr_context.session_sock_addr.sin_port);
@@ -196,7 +218,7 @@ YAEvent *handle_authorize(struct bufferevent *bev, YAEvent *event)
     return response_event;
 }
 
-YAEvent *handle_session_option(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_session_option(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
     (void)bev;
     if (!event || !event->param)
@@ -205,7 +227,6 @@ YAEvent *handle_session_option(struct bufferevent *bev, YAEvent *event)
         return NULL;
     }
 
-    ya_client_t *client = ya_client_find_by_uid(&svr_context.client_manager, event->header.uid);
     if (!client)
     {
         YA_LOG_WARN("SESSION_OPTION: client not found for uid=%u", event->header.uid);
@@ -227,7 +248,7 @@ YAEvent *handle_session_option(struct bufferevent *bev, YAEvent *event)
     return NULL;
 }
 
-YAEvent *handle_heartbeat(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_heartbeat(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
     if (!event)
     {
@@ -245,32 +266,63 @@ YAEvent *handle_heartbeat(struct bufferevent *bev, YAEvent *event)
     return response;
 }
 
-YAEvent *handle_mouse_move(struct bufferevent *bev, YAEvent *event)
-{
 #ifndef YAYA_TESTS
-    if (!event || !event->param)
+// 注入在独立线程上执行，事件循环只负责放入队列
+static void inject_mouse_move(int dx, int dy)
+{
+    ya_input_action_t action = {.type = YA_INPUT_MOVE, .move = {.dx = dx, .dy = dy}};
+    ya_input_queue_push(&action);
+}
+
+// 协议 v2：节流后的位移经完整滤波器拆成若干微步注入
+static void apply_filtered_mouse_move(ya_client_t *client, int dx_px, int dy_px)
+{
+    YA_LOG_TRACE("[handler v2] After throttle: (%d,%d)", dx_px, dy_px);
+
+    ya_mouse_step_t steps[128];
+    size_t out_n = 0;
+
+    if (client->mouse_filter)
     {
-        YA_LOG_ERROR("Invalid mouse move event or parameters");
-        return NULL;
+        ya_mouse_filter_process(client->mouse_filter, dx_px, dy_px, steps, 
+                               (sizeof(steps) / sizeof(steps[0])), &out_n);
+    }
+    else 
+    {
+        steps[0].dx = dx_px;
+        steps[0].dy = dy_px;
+        out_n = 1;
     }
 
-    const YACommonEventRequest *request = (YACommonEventRequest *)event->param;
-    if (event->param_len != sizeof(YACommonEventRequest))
+    for (size_t i = 0; i < out_n; ++i)
     {
-        YA_LOG_ERROR("Invalid mouse move parameter size");
-        return NULL;
+        int dx = steps[i].dx;
+        int dy = steps[i].dy;
+        if (dx == 0 && dy == 0)
+            continue;
+        
+        inject_mouse_move(dx, dy);
     }
+}
 
-    ya_client_t *client = ya_client_find_by_uid(&svr_context.client_manager, event->header.uid);
-    if (!client)
+// 节流器输出合并位移时的回调（可能由定时器触发，此时客户端可能已断开）
+static void emit_throttled_mouse_move(void *ctx, int dx, int dy)
+{
+    ya_client_t *client = (ya_client_t *)ctx;
+    if (client->state != YA_CLIENT_ACTIVE)
     {
-        YA_LOG_WARN("Mouse move: client not found for uid=%u, Ignore.", event->header.uid);
-        return NULL;
+        return;
     }
+    apply_filtered_mouse_move(client, dx, dy);
+}
 
+// 处理一个指针采样（lparam/rparam 为客户端放大后的位移），MOUSE_MOVE 和 MOUSE_MOVE_BATCH 共用
+// index 为采样所属事件的命令序号，只用于跟踪记录
+static void apply_mouse_move(ya_client_t *client, uint32_t index, int32_t lparam, int32_t rparam)
+{
     const double kRecvScale = 100.0; // 与前端 MouseController.kSendScale 保持一致
-    const int rx = (int)request->lparam;
-    const int ry = (int)request->rparam;
+    const int rx = (int)lparam;
+    const int ry = (int)rparam;
     const double fdx = ((double)rx) / kRecvScale;
     const double fdy = ((double)ry) / kRecvScale;
 
@@ -283,7 +335,7 @@ YAEvent *handle_mouse_move(struct bufferevent *bev, YAEvent *event)
         if (!client->mouse_filter)
         {
             YA_LOG_ERROR("Client mouse_filter not initialized");
-            return NULL;
+            return;
         }
 
         // 累积浮点位移
@@ -309,14 +361,13 @@ YAEvent *handle_mouse_move(struct bufferevent *bev, YAEvent *event)
 
         YA_LOG_TRACE("[handler v3] Subpixel: frac=(%.3f,%.3f) output=(%d,%d)", 
                      client->mouse_filter->frac_x, client->mouse_filter->frac_y, dx, dy);
+        YA_TRACE(.type = MOUSE_MOVE, .stage = YA_TRACE_MOVE, .flags = (uint8_t)client->protocol_version,
+                 .uid = client->uid, .index = index, .raw_dx = rx, .raw_dy = ry, .float_dx = (float)fdx,
+                 .float_dy = (float)fdy, .out_dx = dx, .out_dy = dy);
 
         if (dx != 0 || dy != 0)
         {
-            YAError e = input_mouse_move(dx, dy);
-            if (e != Success)
-            {
-                YA_LOG_ERROR("Failed to move mouse: (%d,%d) error=%d", dx, dy, e);
-            }
+            inject_mouse_move(dx, dy);
         }
     }
     else
@@ -326,51 +377,115 @@ YAEvent *handle_mouse_move(struct bufferevent *bev, YAEvent *event)
         const int dy_px = (int)(fdy >= 0.0 ? fdy + 0.5 : fdy - 0.5);
 
         YA_LOG_TRACE("[handler v2] Received: raw=(%d,%d) -> pixels=(%d,%d)", rx, ry, dx_px, dy_px);
+        YA_TRACE(.type = MOUSE_MOVE, .stage = YA_TRACE_MOVE, .flags = (uint8_t)client->protocol_version,
+                 .uid = client->uid, .index = index, .raw_dx = rx, .raw_dy = ry, .float_dx = (float)fdx,
+                 .float_dy = (float)fdy, .out_dx = dx_px, .out_dy = dy_px);
 
-        int out_dx = dx_px;
-        int out_dy = dy_px;
-        if (!ya_mouse_throttle_collect(dx_px, dy_px, false, &out_dx, &out_dy))
+        // 节流器按客户端懒创建；创建失败时不节流，直接送入滤波器
+        if (!client->mouse_throttle)
         {
-            YA_LOG_TRACE("[handler v2] Throttled, accumulated but not emitted yet");
-            return NULL;
+            client->mouse_throttle = ya_mouse_throttle_create(svr_context.base, emit_throttled_mouse_move, client);
+        }
+        if (client->mouse_throttle)
+        {
+            ya_mouse_throttle_push(client->mouse_throttle, dx_px, dy_px);
+            return;
         }
+        apply_filtered_mouse_move(client, dx_px, dy_px);
+    }
+}
 
-        YA_LOG_TRACE("[handler v2] After throttle: (%d,%d)", out_dx, out_dy);
+// 回放器定时回放采样时的回调
+static void emit_paced_mouse_move(void *ctx, int32_t dx, int32_t dy)
+{
+    ya_client_t *client = (ya_client_t *)ctx;
+    if (client->state != YA_CLIENT_ACTIVE)
+    {
+        return;
+    }
+    // 回放时原事件已处理完，记录最近接受的序号
+    apply_mouse_move(client, client->command_index, dx, dy);
+}
+#endif
 
-        ya_mouse_step_t steps[128];
-        size_t out_n = 0;
+YAEvent *handle_mouse_move(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
+{
+#ifndef YAYA_TESTS
+    if (!event || !event->param)
+    {
+        YA_LOG_ERROR("Invalid mouse move event or parameters");
+        return NULL;
+    }
 
-        if (client->mouse_filter)
+    const YACommonEventRequest *request = (YACommonEventRequest *)event->param;
+    if (event->param_len != sizeof(YACommonEventRequest))
+    {
+        YA_LOG_ERROR("Invalid mouse move parameter size");
+        return NULL;
+    }
+
+    if (!client)
+    {
+        YA_LOG_WARN("Mouse move: client not found for uid=%u, Ignore.", event->header.uid);
+        return NULL;
+    }
+
+    // 单个采样与回放中的批次交错时，先把排队的采样回放完，保持位移顺序
+    ya_mouse_pacer_flush(client->mouse_pacer);
+    apply_mouse_move(client, event->header.index, request->lparam, request->rparam);
+#endif
+    return NULL;
+}
+
+YAEvent *handle_mouse_move_batch(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
+{
+#ifndef YAYA_TESTS
+    if (!event || !event->param)
+    {
+        YA_LOG_ERROR("Invalid mouse move batch event or parameters");
+        return NULL;
+    }
+
+    const YAMouseMoveBatchEventRequest *request = (YAMouseMoveBatchEventRequest *)event->param;
+    if (event->param_len != sizeof(YAMouseMoveBatchEventRequest) || request->count > YA_MOUSE_BATCH_MAX_SAMPLES)
+    {
+        YA_LOG_ERROR("Invalid mouse move batch parameter size");
+        return NULL;
+    }
+
+    if (!client)
+    {
+        YA_LOG_WARN("Mouse move batch: client not found for uid=%u, Ignore.", event->header.uid);
+        return NULL;
+    }
+
+    YA_LOG_TRACE("[handler] Mouse move batch: %u samples", request->count);
+
+    if (ya_mouse_pacer_mode() == YA_MOUSE_BATCH_PACED)
+    {
+        // 按原始采样间隔回放：回放器按需懒创建
+        if (!client->mouse_pacer)
         {
-            ya_mouse_filter_process(client->mouse_filter, out_dx, out_dy, steps, 
-                                   (sizeof(steps) / sizeof(steps[0])), &out_n);
+            client->mouse_pacer = ya_mouse_pacer_create(svr_context.base, emit_paced_mouse_move, client);
         }
-        else 
+        if (client->mouse_pacer)
         {
-            steps[0].dx = out_dx;
-            steps[0].dy = out_dy;
-            out_n = 1;
+            ya_mouse_pacer_push(client->mouse_pacer, request->samples, request->count);
+            return NULL;
         }
+        YA_LOG_WARN("Failed to create mouse pacer for client %u, replaying immediately", client->uid);
+    }
 
-        for (size_t i = 0; i < out_n; ++i)
-        {
-            int dx = steps[i].dx;
-            int dy = steps[i].dy;
-            if (dx == 0 && dy == 0)
-                continue;
-            
-            YAError e = input_mouse_move(dx, dy);
-            if (e != Success)
-            {
-                YA_LOG_ERROR("Failed to move mouse (step %zu/%zu): %d", i + 1, out_n, e);
-            }
-        }
+    // 立即回放：依次送入子像素累积，合并后的整数位移逐个注入
+    for (uint32_t i = 0; i < request->count; i++)
+    {
+        apply_mouse_move(client, event->header.index, request->samples[i].dx, request->samples[i].dy);
     }
 #endif
     return NULL;
 }
 
-YAEvent *handle_mouse_stop(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_mouse_stop(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
 #ifndef YAYA_TESTS
     if (!event)
@@ -379,13 +494,15 @@ YAEvent *handle_mouse_stop(struct bufferevent *bev, YAEvent *event)
         return NULL;
     }
 
-    ya_client_t *client = ya_client_find_by_uid(&svr_context.client_manager, event->header.uid);
     if (!client)
     {
         YA_LOG_WARN("Mouse stop: client not found for uid=%u, Ignore.", event->header.uid);
         return NULL;
     }
 
+    // 先回放排队中的批量采样，再重置状态
+    ya_mouse_pacer_flush(client->mouse_pacer);
+
     if (client->protocol_version >= 3)
     {
         // 新架构 (v3+): 只重置子像素累积
@@ -400,53 +517,21 @@ YAEvent *handle_mouse_stop(struct bufferevent *bev, YAEvent *event)
         // 旧架构 (v2): 刷新节流器并重置滤波器
         YA_LOG_TRACE("[handler v2] Mouse stop, flushing throttle and resetting filter");
 
-        int out_dx = 0, out_dy = 0;
-        if (ya_mouse_throttle_flush(&out_dx, &out_dy))
-        {
-            YA_LOG_TRACE("[handler v2] Flushed throttle: (%d,%d)", out_dx, out_dy);
-
-            ya_mouse_step_t steps[128];
-            size_t out_n = 0;
-
-            if (client->mouse_filter)
-            {
-                ya_mouse_filter_process(client->mouse_filter, out_dx, out_dy, steps, 
-                                       (sizeof(steps) / sizeof(steps[0])), &out_n);
-            }
-            else
-            {
-                steps[0].dx = out_dx;
-                steps[0].dy = out_dy;
-                out_n = 1;
-            }
-
-            for (size_t i = 0; i < out_n; ++i)
-            {
-                int dx = steps[i].dx;
-                int dy = steps[i].dy;
-                if (dx == 0 && dy == 0)
-                    continue;
-
-                YAError e = input_mouse_move(dx, dy);
-                if (e != Success)
-                {
-                    YA_LOG_ERROR("Failed to move mouse (flush step %zu/%zu): %d", i + 1, out_n, e);
-                }
-            }
-        }
+        // 只刷新本客户端的节流器，其他客户端累积的位移不受影响
+        ya_mouse_throttle_flush(client->mouse_throttle);
 
         if (client->mouse_filter)
         {
             ya_mouse_filter_reset_state(client->mouse_filter);
         }
 
-        ya_mouse_throttle_reset();
+        ya_mouse_throttle_reset(client->mouse_throttle);
     }
 #endif
     return NULL;
 }
 
-YAEvent *handle_mouse_click(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_mouse_click(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
 #ifndef YAYA_TESTS
     if (!event || !event->param)
@@ -505,31 +590,23 @@ YAEvent *handle_mouse_click(struct bufferevent *bev, YAEvent *event)
     YA_LOG_TRACE("Mouse click mapped {btn=%d, dir=%d} from {lparam=%d, rparam=%d}", (int)btn, (int)dir, request->lparam,
                  request->rparam);
 
-    YAError err = Success;
-    if (request->rparam == 3)
-    {
-        // DoubleClick: 连续两次 Click
-        err = input_mouse_button(btn, Click);
-        if (err == Success)
-        {
-            err = input_mouse_button(btn, Click);
-        }
-    }
-    else
-    {
-        err = input_mouse_button(btn, dir);
-    }
-    
-    if (err != Success)
+    // 按时间回放的批量采样先全部放入队列，按键落在之前的移动结束的位置
+    if (client)
     {
-        YA_LOG_ERROR("Mouse button event failed (dir=%d, double=%d): error %d",
-                     (int)dir, request->rparam == 3, err);
+        ya_mouse_pacer_flush(client->mouse_pacer);
     }
+
+    // DoubleClick: 连续两次 Click
+    ya_input_action_t action = {
+        .type = YA_INPUT_BUTTON,
+        .button = {.button = btn, .dir = dir, .double_click = request->rparam == 3},
+    };
+    ya_input_queue_push(&action);
 #endif
     return NULL;
 }
 
-YAEvent *handle_mouse_scroll(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_mouse_scroll(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
 #ifndef YAYA_TESTS
     if (!event || !event->param)
@@ -564,16 +641,67 @@ YAEvent *handle_mouse_scroll(struct bufferevent *bev, YAEvent *event)
                                        : "right";
     YA_LOG_TRACE("Mouse wheel amount=%d, direction=%s", steps, dir_str);
 
-    YAError err = input_mouse_scroll(steps, dir);
-    if (err != Success)
+    // 滚轮同样排在之前的移动之后
+    if (client)
+    {
+        ya_mouse_pacer_flush(client->mouse_pacer);
+    }
+
+    ya_input_action_t action = {.type = YA_INPUT_SCROLL, .scroll = {.amount = steps, .dir = dir}};
+    ya_input_queue_push(&action);
+#endif
+    return NULL;
+}
+
+YAEvent *handle_mouse_smooth_scroll(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
+{
+#ifndef YAYA_TESTS
+    if (!event || !event->param)
+    {
+        YA_LOG_ERROR("Invalid mouse smooth scroll event or parameters");
+        return NULL;
+    }
+
+    const YACommonEventRequest *request = (YACommonEventRequest *)event->param;
+    if (event->param_len != sizeof(YACommonEventRequest))
+    {
+        YA_LOG_ERROR("Invalid mouse smooth scroll parameter size");
+        return NULL;
+    }
+
+    if (!client || !client->mouse_filter)
+    {
+        YA_LOG_WARN("Mouse smooth scroll: client not found for uid=%u, Ignore.", event->header.uid);
+        return NULL;
+    }
+
+    // 协议：lparam 水平（正数向右）、rparam 垂直（正数向上），单位 1/YA_SMOOTH_SCROLL_SCALE 格
+    // 与指针子像素累积一样按客户端累积小数，只在凑满 1/120 格时注入
+    const float kMaxNotches = 1000.0f;
+    float notches_x = fmaxf(-kMaxNotches, fminf(kMaxNotches, (float)request->lparam / YA_SMOOTH_SCROLL_SCALE));
+    float notches_y = fmaxf(-kMaxNotches, fminf(kMaxNotches, (float)request->rparam / YA_SMOOTH_SCROLL_SCALE));
+
+    ya_scroll_step_t step;
+    if (!ya_mouse_filter_scroll(client->mouse_filter, notches_x, notches_y, &step))
     {
-        YA_LOG_ERROR("Mouse scroll failed: error %d", err);
+        return NULL;
     }
+
+    YA_LOG_TRACE("Mouse smooth scroll: in=(%d,%d) hires=(%d,%d) notch=(%d,%d)", request->lparam, request->rparam,
+                 step.hires_x, step.hires_y, step.notch_x, step.notch_y);
+
+    ya_mouse_pacer_flush(client->mouse_pacer);
+    ya_input_action_t action = {
+        .type = YA_INPUT_SMOOTH_SCROLL,
+        .smooth_scroll = {.hires_x = step.hires_x, .hires_y = step.hires_y, .notch_x = step.notch_x,
+                          .notch_y = step.notch_y},
+    };
+    ya_input_queue_push(&action);
 #endif
     return NULL;
 }
 
-YAEvent *handle_keyboard(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_keyboard(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
 #ifndef YAYA_TESTS
     if (!event || !event->param)
@@ -619,11 +747,15 @@ YAEvent *handle_keyboard(struct bufferevent *bev, YAEvent *event)
         is_char = true;
     }
     
-    // Delegate to keyboard handler
-    YAError err;
+    // Delegate to keyboard handler on the injection thread (key timing sleeps happen there)
+    ya_input_action_t action;
     if (is_char) {
         // Character input: pass codepoint directly
-        err = keyboard_char(req->code, req->mods, dir);
+        action.type = YA_INPUT_KEY_CHAR;
+        action.key_char.codepoint = req->code;
+        action.key_char.mods = req->mods;
+        action.key_char.dir = dir;
+        action.key_char.owner = client ? client->uid : 0;
     } else {
         // Function key: convert protocol code to CKey first
         enum CKey key;
@@ -631,110 +763,92 @@ YAEvent *handle_keyboard(struct bufferevent *bev, YAEvent *event)
             YA_LOG_ERROR("Unknown YA key code: 0x%X", req->code);
             return NULL;
         }
-        err = keyboard_function_key(key, req->mods, dir);
-    }
-    
-    if (err != Success)
-    {
-        YA_LOG_ERROR("Keyboard input failed: error %d", err);
+        action.type = YA_INPUT_KEY_FUNCTION;
+        action.key_function.key = key;
+        action.key_function.mods = req->mods;
+        action.key_function.dir = dir;
     }
+    ya_input_queue_push(&action);
 #endif
     return NULL;
 }
 
-YAEvent *handle_input_text(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_input_text(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
 #ifndef YAYA_TESTS
     const YATextInputEventRequest *request = (YATextInputEventRequest *)event->param;
+    if (!request || !request->text)
+    {
+        return NULL;
+    }
 
-
-    #ifdef USE_UINPUT
-    enum YAError err = PlatformError;
-    #else
-    enum YAError err = enter_text(request->text);
-    #endif
-    if (err != Success)
+    // 文本由队列接管，执行后释放
+    ya_input_action_t action = {.type = YA_INPUT_TEXT, .text = {.text = strdup(request->text)}};
+    if (action.text.text)
     {
-        clipboard_paste_text(request->text);
+        ya_input_queue_push(&action);
     }
 #endif
     return NULL;
 }
 
-YAEvent *handle_input_get(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_input_get(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
 #ifndef YAYA_TESTS
-    YAEvent *response_event = assign_response(event, sizeof(YAInputGetEventResponse));
-    YAInputGetEventResponse *response = response_event->param;
-    enum YAError err;
-
-#ifdef __APPLE__
-    enum CKey modifier = Meta;
-#else
-    enum CKey modifier = Control;
-#endif
-
-    // 全选并复制: Modifier + A, Modifier + C（静默执行）
-    err = input_key_action(modifier, Press);
-    if (err != Success)
-    {
-        goto cleanup;
-    }
-
-    err = key_action_with_code('a', Click);
-    if (err != Success)
+    if (!client)
     {
-        input_key_action(modifier, Release);
-        goto cleanup;
+        return NULL;
     }
 
-    err = key_action_with_code('c', Click);
-    if (err != Success)
-    {
-        input_key_action(modifier, Release);
-        goto cleanup;
-    }
+    // 全选复制和读取剪贴板在注入线程上排在之前的动作之后执行，
+    // 结果由 handle_input_get_result 在事件循环线程上回复，不在这里等待注入完成
+    ya_input_action_t action = {.type = YA_INPUT_TEXT_GET,
+                                .text_get = {.owner = client->uid, .index = event->header.index}};
+    ya_input_queue_push(&action);
+#endif
+    return NULL;
+}
 
-    err = input_key_action(modifier, Release);
-    if (err != Success)
+void handle_input_get_result(uint32_t owner, uint32_t index, char *text)
+{
+    if (!text)
     {
-        goto cleanup;
+        // 读取失败不回复，与同步读取时一致
+        return;
     }
 
-    // 取消选择
-    err = mouse_button(Left, Click);
-    if (err != Success)
+    ya_client_t *client = ya_client_find_by_uid(&svr_context.client_manager, owner);
+    if (!client || !client->bev)
     {
-        goto cleanup;
+        YA_LOG_DEBUG("Client %u gone before input text was read, dropped", owner);
+        free(text);
+        return;
     }
 
-    // 获取剪贴板内容
-    const char *clipboard_text = clipboard_get();
-    if (clipboard_text == NULL)
+    YAEvent request = {0};
+    request.header.type = TEXT_GET;
+    request.header.uid = owner;
+    request.header.index = index;
+    YAEvent *response_event = assign_response(&request, sizeof(YAInputGetEventResponse));
+    if (!response_event)
     {
-        goto cleanup;
+        free(text);
+        return;
     }
+    ((YAInputGetEventResponse *)response_event->param)->text = text;
 
-    // 复制文本到响应结构
-    response->text = strdup(clipboard_text);
-    if (response->text == NULL)
+    struct evbuffer *output = bufferevent_get_output(client->bev);
+    size_t queued = evbuffer_get_length(output);
+    if (ya_serialize_event_to_evbuffer(response_event, output) < 0)
     {
-        free_string((char *)clipboard_text);
-        goto cleanup;
+        YA_LOG_WARN("Failed to serialize input text for client %u", owner);
     }
+    client->bytes_out += evbuffer_get_length(output) - queued;
 
-    free_string((char *)clipboard_text);
-    return response_event;
-
-cleanup:
     ya_free_event(response_event);
-    return NULL;
-#else
-    return NULL;
-#endif
 }
 
-YAEvent *handle_poweroff(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_poweroff(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
     YA_LOG_TRACE("Power (shutdown) request received");
 
@@ -767,7 +881,7 @@ YAEvent *handle_poweroff(struct bufferevent *bev, YAEvent *event)
     return response;
 }
 
-YAEvent *handle_restart(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_restart(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
     YA_LOG_TRACE("Restart request received");
 
@@ -800,7 +914,7 @@ YAEvent *handle_restart(struct bufferevent *bev, YAEvent *event)
     return response;
 }
 
-YAEvent *handle_sleep(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_sleep(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
     YA_LOG_TRACE("Sleep request received");
 
@@ -835,7 +949,7 @@ YAEvent *handle_sleep(struct bufferevent *bev, YAEvent *event)
 
 
 // CONTROL 统一入口（跨平台可见）：根据 lparam 选择具体电源操作
-YAEvent *handle_control(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_control(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
     (void)bev;
     if (!event || !event->param)
@@ -849,18 +963,18 @@ YAEvent *handle_control(struct bufferevent *bev, YAEvent *event)
     switch (op)
     {
     case CONTROL_OP_SHUTDOWN:
-        return handle_poweroff(bev, event);
+        return handle_poweroff(bev, event, client);
     case CONTROL_OP_RESTART:
-        return handle_restart(bev, event);
+        return handle_restart(bev, event, client);
     case CONTROL_OP_SLEEP:
-        return handle_sleep(bev, event);
+        return handle_sleep(bev, event, client);
     default:
         YA_LOG_WARN("Unknown CONTROL op: %d", op);
         return assign_response(event, 0);
     }
 }
 
-YAEvent *handle_discover(struct bufferevent *bev, YAEvent *event)
+YAEvent *handle_discover(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
     YADiscoverEventRequest *request = event->param;
 
@@ -877,67 +991,98 @@ YAEvent *handle_discover(struct bufferevent *bev, YAEvent *event)
     return response;
 }
 
-// 事件处理函数映射表
-static const struct
+// 按事件类型索引的分发表，由 YA_EVENT_TYPE_TABLE 展开：分发只需一次下标访问
+typedef struct
 {
-    YAEventType type;
     ya_event_handler_t handler;
-} event_handlers[] = {
-    {MOUSE_MOVE, handle_mouse_move},
-    {MOUSE_STOP, handle_mouse_stop},
-    {MOUSE_CLICK, handle_mouse_click},
-    {MOUSE_WHEEL, handle_mouse_scroll},
-    {KEYBOARD, handle_keyboard}, 
-    {TEXT_INPUT, handle_input_text},
-    {TEXT_GET, handle_input_get},
-    {DISCOVER, handle_discover},
-    {AUTHORIZE, handle_authorize},
-    {HEARTBEAT, handle_heartbeat},
-    {SESSION_OPTION, handle_session_option},
-    {CONTROL, handle_control}
+    uint32_t flags; // YA_EVENT_* 分发标志
+} ya_event_dispatch_t;
+
+static const ya_event_dispatch_t event_dispatch[YA_EVENT_TYPE_COUNT] = {
+#define YA_EVENT_DISPATCH(name, value, parser, serializer, handler, flags) [name] = {handler, flags},
+    YA_EVENT_TYPE_TABLE(YA_EVENT_DISPATCH)
+#undef YA_EVENT_DISPATCH
 };
 
-// 查找事件处理函数
-static ya_event_handler_t find_event_handler(YAEventType type)
+// 查找事件分发项，未知类型返回 NULL
+static const ya_event_dispatch_t *find_event_dispatch(YAEventType type)
 {
-    for (size_t i = 0; i < sizeof(event_handlers) / sizeof(event_handlers[0]); i++)
+    if ((uint32_t)type >= YA_EVENT_TYPE_COUNT || !event_dispatch[type].handler)
     {
-        if (event_handlers[i].type == type)
-        {
-            return event_handlers[i].handler;
-        }
+        return NULL;
     }
-    return NULL;
-}
-
-// 检查事件是否需要命令序号验证
-static bool need_command_index_check(YAEventType type)
-{
-    // DISCOVER和AUTHORIZE是基础事件，不需要命令序号验证
-    return type != DISCOVER && type != AUTHORIZE && type != HEARTBEAT;
+    return &event_dispatch[type];
 }
 
 // 验证命令序号
-static bool validate_command_index(ya_client_t *client, YAEvent *event)
+// MOUSE_MOVE 的位移可以交换顺序：迟到但仍在乱序窗口内的移动直接合并进位移累加器，
+// 只丢弃重复或等待超时的；点击、按键等其他事件保持严格递增
+static bool validate_command_index(ya_client_t *client, YAEvent *event, uint32_t flags)
 {
-    if (!client || event->header.direction != REQUEST || !need_command_index_check(event->header.type))
+    // DISCOVER、AUTHORIZE、HEARTBEAT 等基础事件不做命令序号验证
+    if (!client || event->header.direction != REQUEST || !(flags & (YA_EVENT_ORDERED | YA_EVENT_REORDER)))
     {
         return true;
     }
 
-    // 如果命令序号小于等于当前序号，说明是旧命令，丢弃
-    if (event->header.index <= client->command_index)
+    bool late = event->header.index <= client->command_index;
+    bool accepted = !late;
+    if (flags & YA_EVENT_REORDER)
+    {
+        accepted = ya_reorder_window_accept(&client->move_window, event->header.index, ya_reorder_now_ms()) !=
+                   YA_REORDER_DROP;
+    }
+
+    if (late || !accepted)
+    {
+        ya_server_stats_record_event_order(late, accepted);
+    }
+
+    if (!accepted)
     {
+        // 如果命令序号小于等于当前序号，说明是旧命令，丢弃
         YA_LOG_TRACE("Discarding old command with index %d (current index: %d)", event->header.index,
                      client->command_index);
         return false;
     }
 
     // 更新命令序号
-    client->command_index = event->header.index;
+    if (!late)
+    {
+        client->command_index = event->header.index;
+    }
     return true;
 }
 
+// 处理函数直接使用连接上已解析的客户端，不再按 UID 查表
+// 请求头 UID 与连接绑定的客户端不一致时（如授权前 UID 为0）按未知客户端处理；授权请求本身除外
+static ya_client_t *bound_client(ya_client_t *client, const YAEvent *event)
+{
+    if (!client || event->header.type == AUTHORIZE || client->uid == event->header.uid)
+    {
+        return client;
+    }
+    return NULL;
+}
+
+// 记录事件的分发或丢弃；带 lparam/rparam 的请求一并记录原始参数
+static void trace_event(const YAEvent *event, ya_trace_stage_t stage, int32_t result)
+{
+    if (!ya_trace_enabled())
+    {
+        return;
+    }
+
+    const YACommonEventRequest *common = NULL;
+    if (event->param && event->param_len == sizeof(YACommonEventRequest))
+    {
+        common = (const YACommonEventRequest *)event->param;
+    }
+    YA_TRACE(.type = (uint16_t)event->header.type, .stage = (uint8_t)stage, .uid = event->header.uid,
+             .index = event->header.index, .raw_dx = common ? common->lparam : 0,
+             .raw_dy = common ? common->rparam : 0, .result = result);
+}
+
 YAEvent *process_server_event(struct bufferevent *bev, YAEvent *event, ya_client_t *client)
 {
     if (!event)
@@ -945,27 +1090,56 @@ YAEvent *process_server_event(struct bufferevent *bev, YAEvent *event, ya_client
         return NULL;
     }
 
-    ya_event_handler_t handler = find_event_handler(event->header.type);
-    if (!handler)
+    const ya_event_dispatch_t *dispatch = find_event_dispatch(event->header.type);
+    if (!dispatch)
     {
         YA_LOG_ERROR("Unknown event type: %d", event->header.type);
         return NULL;
     }
 
+    // 会话连接传入 bev，命令数据报没有 bev
+    uint32_t transport = bev ? YA_EVENT_TCP : YA_EVENT_UDP;
+    if (!(dispatch->flags & transport))
+    {
+        YA_LOG_WARN("Event %s is not allowed over %s, dropped", ya_event_type_name(event->header.type),
+                    bev ? "TCP" : "UDP");
+        ya_server_stats_record_event(event->header.type, false);
+        trace_event(event, YA_TRACE_DROP, YA_TRACE_DROP_TRANSPORT);
+        return NULL;
+    }
+
+    // 先确认请求来自连接绑定的客户端，被拒绝的帧不能推进命令序号和乱序窗口
+    ya_client_t *sender = bound_client(client, event);
+    if ((dispatch->flags & YA_EVENT_NEED_CLIENT) && !sender)
+    {
+        YA_LOG_WARN("%s: client not found for uid=%u, Ignore.", ya_event_type_name(event->header.type),
+                    event->header.uid);
+        ya_server_stats_record_event(event->header.type, false);
+        trace_event(event, YA_TRACE_DROP, YA_TRACE_DROP_NO_CLIENT);
+        return NULL;
+    }
+
     // 对于非AUTHORIZE和DISCOVER事件，检查命令序号
-    if (client && event->header.direction == REQUEST && need_command_index_check(event->header.type))
+    if (!validate_command_index(client, event, dispatch->flags))
     {
-        if (event->header.index <= client->command_index)
-        {
-            YA_LOG_TRACE("Discarding old command with index %d (current index: %d)", event->header.index,
-                         client->command_index);
-            return NULL;
-        }
-        client->command_index = event->header.index;
+        ya_server_stats_record_event(event->header.type, false);
+        trace_event(event, YA_TRACE_DROP, YA_TRACE_DROP_STALE);
+        return NULL;
     }
 
     if (event->header.type != HEARTBEAT) {
         YA_LOG_TRACE("Processing event type: %d, index: %d", event->header.type, event->header.index);
     }
-    return handler(bev, event);
+    ya_server_stats_record_event(event->header.type, true);
+    trace_event(event, YA_TRACE_DISPATCH, 0);
+
+    // 处理函数放入注入队列的动作关联到本事件，注入完成时统计端到端延迟
+    ya_latency_begin_event(event->header.type, event->readable_ns, event->decoded_ns);
+    if (sender)
+    {
+        ya_client_count_event(sender, (uint32_t)(ya_latency_now_ns() / 1000000000ull));
+    }
+    YAEvent *response = dispatch->handler(bev, event, sender);
+    ya_latency_end_event();
+    return response;
 }
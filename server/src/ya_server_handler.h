@@ -6,27 +6,32 @@
 #include "ya_client_manager.h"
 
 // 事件处理函数类型
-typedef YAEvent* (*ya_event_handler_t)(struct bufferevent *bev, YAEvent *event);
+typedef YAEvent* (*ya_event_handler_t)(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
 
 // 辅助函数声明
 YAEvent *assign_response(YAEvent *request_event, size_t response_param_len);
 
 // 事件处理函数声明
-YAEvent *handle_authorize(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_heartbeat(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_mouse_move(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_mouse_stop(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_mouse_click(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_mouse_scroll(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_keyboard(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_input_text(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_input_get(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_clipboard_get(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_clipboard_set(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_poweroff(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_restart(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_control(struct bufferevent *bev, YAEvent *event);
-YAEvent *handle_discover(struct bufferevent *bev, YAEvent *event);
+YAEvent *handle_authorize(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_heartbeat(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_mouse_move(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_mouse_move_batch(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_mouse_stop(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_mouse_click(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_mouse_scroll(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_mouse_smooth_scroll(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_keyboard(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_input_text(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_input_get(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_clipboard_get(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_clipboard_set(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_poweroff(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_restart(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_control(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+YAEvent *handle_discover(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
+
+// 注入线程读到输入框文本后在事件循环线程上回复 TEXT_GET（ya_input_text_result_fn）
+void handle_input_get_result(uint32_t owner, uint32_t index, char *text);
 
 // 主事件处理函数
 YAEvent *process_server_event(struct bufferevent *bev, YAEvent *event, ya_client_t *client);
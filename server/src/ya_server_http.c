@@ -9,6 +9,7 @@
 #include <unistd.h>
 #include "ya_server.h"
 #include "ya_config.h"
+#include "ya_metrics.h"
 
 static struct evhttp* g_http_server = NULL;
 
@@ -19,6 +20,7 @@ typedef void (*http_request_handler)(const char* request_data, size_t request_le
 static void process_request(struct evhttp_request* req, http_request_handler handler);
 static void handle_command(const char* request_data, size_t request_len, mpack_writer_t* writer);
 static void handle_status(const char* request_data, size_t request_len, mpack_writer_t* writer);
+static void handle_metrics(const char* request_data, size_t request_len, mpack_writer_t* writer);
 static void handle_get_config(const char* request_data, size_t request_len, mpack_writer_t* writer);
 static void handle_post_config(const char* request_data, size_t request_len, mpack_writer_t* writer);
 
@@ -71,7 +73,7 @@ static void handle_status(const char* request_data, size_t request_len, mpack_wr
     extern YA_ServerContext svr_context;
     extern YA_Config config;
 
-    mpack_start_map(writer, 4);
+    mpack_start_map(writer, 10);
 
     // 1. 服务器状态
     mpack_write_cstr(writer, "server_status");
@@ -90,22 +92,20 @@ static void handle_status(const char* request_data, size_t request_len, mpack_wr
 
     // 3. 客户端列表
     mpack_write_cstr(writer, "connected_clients");
-    mpack_start_array(writer, ya_client_get_count(&svr_context.client_manager));
-    for (int i = 0; i < YA_CLIENT_HASH_SIZE; ++i) {
-        for (ya_client_t* client = svr_context.client_manager.buckets[i]; client != NULL; client = client->next) {
-            if (client->state == YA_CLIENT_ACTIVE) {
-                char client_addr[INET_ADDRSTRLEN];
-                ya_get_peer_addr(client->fd, client_addr, sizeof(client_addr));
-                mpack_start_map(writer, 3);
-                mpack_write_cstr(writer, "uid");
-                mpack_write_u32(writer, client->uid);
-                mpack_write_cstr(writer, "address");
-                mpack_write_cstr(writer, client_addr);
-                mpack_write_cstr(writer, "connected_at");
-                mpack_write_u64(writer, (uint64_t)client->connected_at);
-                mpack_finish_map(writer);
-            }
-        }
+    uint32_t client_count = ya_client_get_count(&svr_context.client_manager);
+    mpack_start_array(writer, client_count);
+    for (uint32_t i = 0; i < client_count; ++i) {
+        ya_client_t* client = ya_client_at(&svr_context.client_manager, i);
+        char client_addr[INET_ADDRSTRLEN];
+        ya_get_peer_addr(client->fd, client_addr, sizeof(client_addr));
+        mpack_start_map(writer, 3);
+        mpack_write_cstr(writer, "uid");
+        mpack_write_u32(writer, client->uid);
+        mpack_write_cstr(writer, "address");
+        mpack_write_cstr(writer, client_addr);
+        mpack_write_cstr(writer, "connected_at");
+        mpack_write_u64(writer, (uint64_t)client->connected_at);
+        mpack_finish_map(writer);
     }
     mpack_finish_array(writer);
 
@@ -114,7 +114,119 @@ static void handle_status(const char* request_data, size_t request_len, mpack_wr
     const char* log_file = ya_config_get(&config, "logger", "file");
     mpack_write_cstr(writer, log_file ? log_file : "");
 
+    // 5. 异步日志因队列满丢弃的条数
+    mpack_write_cstr(writer, "log_dropped");
+    mpack_write_u64(writer, ya_logger_dropped(g_logger));
+
+    // 6. 会话读路径统计（每次唤醒处理的帧数）
+    const ya_server_stats_t* stats = &svr_context.stats;
+    mpack_write_cstr(writer, "session_io");
+    mpack_start_map(writer, 5);
+    mpack_write_cstr(writer, "reads");
+    mpack_write_u64(writer, stats->session_reads);
+    mpack_write_cstr(writer, "frames");
+    mpack_write_u64(writer, stats->session_frames);
+    mpack_write_cstr(writer, "frames_per_read");
+    mpack_write_double(writer, stats->session_reads ? (double)stats->session_frames / (double)stats->session_reads : 0.0);
+    mpack_write_cstr(writer, "max_frames_per_read");
+    mpack_write_u32(writer, stats->max_frames_per_read);
+    mpack_write_cstr(writer, "budget_yields");
+    mpack_write_u32(writer, stats->read_budget_yields);
+    mpack_finish_map(writer);
+
+    // 7. 命令服务接收统计（每次唤醒处理的数据报数）
+    mpack_write_cstr(writer, "command_io");
+    mpack_start_map(writer, 6);
+    mpack_write_cstr(writer, "wakeups");
+    mpack_write_u64(writer, stats->command_wakeups);
+    mpack_write_cstr(writer, "datagrams");
+    mpack_write_u64(writer, stats->command_datagrams);
+    mpack_write_cstr(writer, "datagrams_per_wakeup");
+    mpack_write_double(writer, stats->command_wakeups ? (double)stats->command_datagrams / (double)stats->command_wakeups : 0.0);
+    mpack_write_cstr(writer, "max_datagrams_per_wakeup");
+    mpack_write_u32(writer, stats->max_datagrams_per_wakeup);
+    mpack_write_cstr(writer, "udp_pointer_events");
+    mpack_write_u64(writer, stats->udp_pointer_events);
+    mpack_write_cstr(writer, "udp_rejected");
+    mpack_write_u64(writer, stats->udp_rejected);
     mpack_finish_map(writer);
+
+    // 8. 事件序号统计（迟到、合并、丢弃）
+    mpack_write_cstr(writer, "event_order");
+    mpack_start_map(writer, 3);
+    mpack_write_cstr(writer, "late");
+    mpack_write_u64(writer, stats->order_late);
+    mpack_write_cstr(writer, "merged");
+    mpack_write_u64(writer, stats->order_merged);
+    mpack_write_cstr(writer, "dropped");
+    mpack_write_u64(writer, stats->order_dropped);
+    mpack_finish_map(writer);
+
+    // 9. 按事件类型的分发统计（只列出出现过的类型）
+    uint32_t seen_types = 0;
+    for (uint32_t type = 0; type < YA_EVENT_TYPE_COUNT; ++type) {
+        if (stats->event_types[type].handled || stats->event_types[type].rejected) {
+            seen_types++;
+        }
+    }
+    mpack_write_cstr(writer, "event_types");
+    mpack_start_map(writer, seen_types);
+    for (uint32_t type = 0; type < YA_EVENT_TYPE_COUNT; ++type) {
+        const ya_event_type_stats_t* entry = &stats->event_types[type];
+        if (!entry->handled && !entry->rejected) {
+            continue;
+        }
+        mpack_write_cstr(writer, ya_event_type_name(type));
+        mpack_start_map(writer, 2);
+        mpack_write_cstr(writer, "handled");
+        mpack_write_u64(writer, entry->handled);
+        mpack_write_cstr(writer, "rejected");
+        mpack_write_u64(writer, entry->rejected);
+        mpack_finish_map(writer);
+    }
+    mpack_finish_map(writer);
+
+    // 10. 按事件类型的各阶段延迟摘要（纳秒，完整分桶见 /metrics）
+    mpack_write_cstr(writer, "latency");
+    ya_server_stats_write_latency(writer, false);
+
+    mpack_finish_map(writer);
+}
+
+// 处理指标查询：默认返回 OpenMetrics 文本（ya_metrics.h）；
+// Accept 为 application/x-msgpack 时返回 msgpack 格式的计数器、各阶段延迟直方图、客户端流量
+static void handle_metrics_request(struct evhttp_request *req, void *arg) {
+    extern YA_ServerContext svr_context;
+
+    if (evhttp_request_get_command(req) != EVHTTP_REQ_GET) {
+        evhttp_send_error(req, HTTP_BADMETHOD, "Only GET method is allowed");
+        return;
+    }
+
+    const char* accept = evhttp_find_header(evhttp_request_get_input_headers(req), "Accept");
+    if (accept && strstr(accept, "application/x-msgpack")) {
+        process_request(req, handle_metrics);
+        return;
+    }
+
+    struct evbuffer* buf = evbuffer_new();
+    if (!buf) {
+        evhttp_send_error(req, HTTP_INTERNAL, "Failed to create response buffer");
+        return;
+    }
+
+    ya_metrics_render(&svr_context.stats, buf);
+
+    struct evkeyvalq* headers = evhttp_request_get_output_headers(req);
+    evhttp_add_header(headers, "Content-Type", YA_METRICS_CONTENT_TYPE);
+    evhttp_send_reply(req, HTTP_OK, "OK", buf);
+
+    evbuffer_free(buf);
+}
+
+static void handle_metrics(const char* request_data, size_t request_len, mpack_writer_t* writer) {
+    extern YA_ServerContext svr_context;
+    ya_server_stats_write(&svr_context.stats, writer);
 }
 
 // 处理配置获取请求
@@ -310,6 +422,7 @@ int run_http_server(void) {
     evhttp_set_cb(g_http_server, "/command", handle_command_request, NULL);
     evhttp_set_cb(g_http_server, "/status", handle_status_request, NULL);
     evhttp_set_cb(g_http_server, "/config", handle_config_request, NULL);
+    evhttp_set_cb(g_http_server, "/metrics", handle_metrics_request, NULL);
 
     YA_LOG_INFO("HTTP server listening on %s", svr_context.http_addr);
     return 0;
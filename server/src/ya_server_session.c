@@ -1,5 +1,6 @@
 // #include <netdb.h>
 #include <stdint.h>
+#include <string.h>
 
 #ifndef _WIN32
 #include <netinet/in.h>
@@ -16,12 +17,21 @@
 #include <event2/util.h>
 
 #include "ya_event.h"
+#include "ya_input_queue.h"
+#include "ya_latency.h"
 #include "ya_logger.h"
 #include "ya_server.h"
 #include "ya_server_handler.h"
 #include "ya_server_session.h"
+#include "ya_socket_tuning.h"
 #include "ya_utils.h"
 
+// 单次读回调最多处理的帧数，超出后让出事件循环，避免单个连接饿死其他连接
+#define YA_SESSION_MAX_FRAMES_PER_READ 64
+
+// 单帧允许的最大长度（总长度字段），超出视为协议错误
+#define YA_SESSION_MAX_FRAME_SIZE (256 * 1024)
+
 static void accept_cb(struct evconnlistener *, evutil_socket_t, struct sockaddr *, int socklen, void *);
 static void accept_error_cb(struct evconnlistener *, void *);
 static void conn_readcb(struct bufferevent *, void *);
@@ -64,6 +74,15 @@ static void accept_cb(struct evconnlistener *listener, evutil_socket_t fd, struc
         return;
     }
 
+    // 低延迟套接字选项（[network]），失败时保持系统默认值继续服务
+    ya_socket_tuning_apply(fd, ya_socket_tuning());
+
+    // 记录对端地址，用于校验 UDP 指针数据报的来源
+    if (sa && sa->sa_family == AF_INET && socklen >= (int)sizeof(client->peer_addr))
+    {
+        memcpy(&client->peer_addr, sa, sizeof(client->peer_addr));
+    }
+
     // 更新连接统计
     ya_server_stats_inc_connections();
 
@@ -78,6 +97,89 @@ static void accept_error_cb(struct evconnlistener *listener, void *ctx)
     YA_LOG_DEBUG("Session server accept error.");
 }
 
+// 关闭连接：更新统计、移除客户端、释放bufferevent并归还连接持有的引用
+static void close_connection(ya_client_t *client)
+{
+    // 更新连接统计
+    ya_server_stats_dec_connections();
+
+    // 标记客户端断开并移出活跃列表和 fd 索引，最后一个引用归还时回收槽位
+    ya_client_remove(&svr_context.client_manager, client->uid);
+
+    // 释放该客户端输入字符时锁存的修饰键
+    ya_input_action_t release = {.type = YA_INPUT_KEY_RELEASE, .key_release = {.owner = client->uid}};
+    ya_input_queue_push(&release);
+
+    // 清理bufferevent
+    if (client->bev) {
+        bufferevent_free(client->bev);
+        client->bev = NULL;
+    }
+
+    // 减少引用计数，可能会触发客户端清理
+    ya_client_unref(&svr_context.client_manager, client);
+}
+
+// 检查输入缓冲区头部是否有一个完整的帧
+// 返回 1 表示完整帧可用（out_len 为帧总字节数），0 表示需要更多数据，-1 表示字节流非法
+static int peek_frame(ya_client_t *client, struct evbuffer *input, bool *out_packed, size_t *out_len)
+{
+    size_t len = evbuffer_get_length(input);
+    unsigned char lead[2];
+    if (evbuffer_copyout(input, lead, sizeof(lead)) < (ev_ssize_t)sizeof(lead))
+    {
+        return 0;
+    }
+
+    // v4 紧凑记录以魔数开头，普通帧的首字节是长度字段的最高字节（总为0）
+    if (lead[0] == YA_PACKED_MAGIC && client->protocol_version >= YA_PROTOCOL_PACKED_VERSION)
+    {
+        size_t record_size = ya_packed_record_size(lead[1]);
+        if (record_size == 0)
+        {
+            YA_LOG_WARN("Invalid packed record type %u from client %u", lead[1], client->uid);
+            return -1;
+        }
+
+        *out_packed = true;
+        *out_len = record_size;
+        return len >= record_size ? 1 : 0;
+    }
+
+    if (len < YA_FRAME_PREFIX_SIZE)
+    {
+        // 长度前缀尚未收全
+        return 0;
+    }
+
+    YAPackageSize size = {0};
+    if (ya_get_package_size(input, &size) < 0 || size.totalSize > YA_SESSION_MAX_FRAME_SIZE)
+    {
+        YA_LOG_WARN("Invalid frame size from client %u (total=%u, header=%u)", client->uid, size.totalSize,
+                    size.headerSize);
+        return -1;
+    }
+
+    *out_packed = false;
+    *out_len = (size_t)size.totalSize + sizeof(uint32_t);
+    return len >= *out_len ? 1 : 0;
+}
+
+// 从输入缓冲区取出一个完整的帧并解码，无论成功与否都会消费整帧
+static int read_frame(struct evbuffer *input, bool packed, size_t frame_len, YAEvent *request)
+{
+    // 整帧只拉成连续内存一次，直接在这段内存上解码
+    const uint8_t *data = evbuffer_pullup(input, frame_len);
+    int consumed = -1;
+    if (data)
+    {
+        consumed = packed ? ya_decode_packed_event(data, frame_len, request)
+                          : ya_decode_frame(data, frame_len, request);
+    }
+    evbuffer_drain(input, frame_len);
+    return consumed == (int)frame_len ? 0 : -1;
+}
+
 static void conn_readcb(struct bufferevent *bev, void *user_data)
 {
     ya_client_t *client = (ya_client_t *)user_data;
@@ -85,46 +187,82 @@ static void conn_readcb(struct bufferevent *bev, void *user_data)
         return;
     }
 
+    // 本次回调处理的所有帧都从这一刻开始计算延迟
+    uint64_t readable_ns = ya_latency_now_ns();
+
+    // 内核会自动恢复延迟 ACK，每次读取后重新开启 QUICKACK
+    ya_socket_tuning_rearm_quickack(client->fd, ya_socket_tuning());
+
     struct evbuffer *input = bufferevent_get_input(bev);
     struct evbuffer *output = bufferevent_get_output(bev);
 
-    YAPackageSize size = {0};
-    ya_get_package_size(input, &size);
+    // 增加引用计数，保证循环期间客户端不会被释放
+    ya_client_ref(client);
 
-    int len = evbuffer_get_length(input);
-    if (len < (size.totalSize + 4))
+    // 手机端经常把多个帧合并进一个TCP段：循环处理缓冲区里所有完整的帧，
+    // 否则剩余的帧要等到下一个字节到达才会被处理。
+    // 每次回调最多处理 YA_SESSION_MAX_FRAMES_PER_READ 帧，避免单个连接独占事件循环。
+    uint32_t frames = 0;
+    bool budget_exhausted = false;
+    while (client->state == YA_CLIENT_ACTIVE)
     {
-        return;
-    }
+        bool packed = false;
+        size_t frame_len = 0;
+        int ready = peek_frame(client, input, &packed, &frame_len);
+        if (ready < 0)
+        {
+            // 字节流已失步，只能断开连接
+            ya_server_stats_record_session_parse_error();
+            close_connection(client);
+            break;
+        }
 
-    // remove total size and header size
-    evbuffer_drain(input, sizeof(uint32_t) * 2);
+        if (ready == 0)
+        {
+            // 半帧，等待后续数据
+            break;
+        }
 
-    YAEvent request = {0};
-    if (ya_parse_event(input, &request, &size) < 0)
-    {
-        return;
-    }
+        if (frames >= YA_SESSION_MAX_FRAMES_PER_READ)
+        {
+            // 预算耗尽但仍有完整帧：延迟到下一轮事件循环继续处理
+            budget_exhausted = true;
+            bufferevent_trigger(bev, EV_READ, BEV_TRIG_IGNORE_WATERMARKS | BEV_TRIG_DEFER_CALLBACKS);
+            break;
+        }
 
-    // 增加引用计数
-    ya_client_ref(client);
+        frames++;
+        client->bytes_in += frame_len;
 
-    YAEvent *response = process_server_event(bev, &request, (struct ya_client *)client);
+        YAEvent request = {0};
+        if (read_frame(input, packed, frame_len, &request) < 0)
+        {
+            ya_free_event_param(&request);
+            ya_server_stats_record_session_parse_error();
+            YA_LOG_WARN("Failed to parse frame from client %u, dropped", client->uid);
+            continue;
+        }
+        request.readable_ns = readable_ns;
+        request.decoded_ns = ya_latency_now_ns();
 
-    if (response)
-    {
-        uint8_t *rsp = NULL;
-        int length = ya_serialize_event(response, &rsp);
+        YAEvent *response = process_server_event(bev, &request, (struct ya_client *)client);
+        ya_free_event_param(&request);
 
-        if (rsp)
+        if (response)
         {
-            evbuffer_add(output, rsp, length);
-            safe_free((void **)&rsp);
+            size_t queued = evbuffer_get_length(output);
+            if (ya_serialize_event_to_evbuffer(response, output) < 0)
+            {
+                YA_LOG_WARN("Failed to serialize response for client %u", client->uid);
+            }
+            client->bytes_out += evbuffer_get_length(output) - queued;
         }
+
+        ya_free_event(response);
     }
 
-    ya_free_event(response);
-    
+    ya_server_stats_record_read(frames, budget_exhausted);
+
     // 减少引用计数
     ya_client_unref(&svr_context.client_manager, client);
 }
@@ -136,20 +274,7 @@ static void conn_eventcb(struct bufferevent *bev, short events, void *user_data)
         ya_client_t *client = (ya_client_t *)user_data;
         if (client)
         {
-            // 更新连接统计
-            ya_server_stats_dec_connections();
-            
-            // 标记客户端状态为断开连接
-            client->state = YA_CLIENT_DISCONNECTING;
-            
-            // 清理bufferevent
-            if (client->bev) {
-                bufferevent_free(client->bev);
-                client->bev = NULL;
-            }
-            
-            // 减少引用计数，可能会触发客户端清理
-            ya_client_unref(&svr_context.client_manager, client);
+            close_connection(client);
         }
 
         YA_LOG_DEBUG("Connection closed.");
@@ -0,0 +1,155 @@
+#include "ya_socket_tuning.h"
+#include "ya_config.h"
+#include "ya_logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+extern YA_Config config;
+
+static ya_socket_tuning_t g_tuning = {
+    .tcp_nodelay = true,
+    .tcp_quickack = true,
+    .dscp = -1,
+    .priority = -1,
+    .sndbuf = 0,
+    .rcvbuf = 0,
+};
+
+static bool read_bool(const char *section, const char *key, bool default_value)
+{
+    const char *value = ya_config_get(&config, section, key);
+    if (!value)
+    {
+        return default_value;
+    }
+    return strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+}
+
+// 读取整数配置，超出 [min, max] 时使用默认值
+static int read_int(const char *section, const char *key, int min, int max, int default_value)
+{
+    const char *value = ya_config_get(&config, section, key);
+    if (!value || value[0] == '\0')
+    {
+        return default_value;
+    }
+
+    char *end = NULL;
+    long parsed = strtol(value, &end, 10);
+    if (*end != '\0' || parsed < min || parsed > max)
+    {
+        YA_LOG_WARN("Invalid [%s] %s=%s, using default", section, key, value);
+        return default_value;
+    }
+    return (int)parsed;
+}
+
+void ya_socket_tuning_init(void)
+{
+    g_tuning.tcp_nodelay = read_bool("network", "tcp_nodelay", true);
+    g_tuning.tcp_quickack = read_bool("network", "tcp_quickack", true);
+
+    const char *dscp = ya_config_get(&config, "network", "dscp");
+    if (dscp && strcmp(dscp, "ef") == 0)
+    {
+        g_tuning.dscp = YA_DSCP_EF;
+    }
+    else
+    {
+        g_tuning.dscp = read_int("network", "dscp", 0, 63, -1);
+    }
+
+    g_tuning.priority = read_int("network", "priority", 0, 6, -1);
+    g_tuning.sndbuf = read_int("network", "sndbuf", 0, 64 * 1024 * 1024, 0);
+    g_tuning.rcvbuf = read_int("network", "rcvbuf", 0, 64 * 1024 * 1024, 0);
+
+    YA_LOG_INFO("Socket tuning: nodelay=%d quickack=%d dscp=%d priority=%d sndbuf=%d rcvbuf=%d",
+                g_tuning.tcp_nodelay, g_tuning.tcp_quickack, g_tuning.dscp, g_tuning.priority, g_tuning.sndbuf,
+                g_tuning.rcvbuf);
+}
+
+const ya_socket_tuning_t *ya_socket_tuning(void)
+{
+    return &g_tuning;
+}
+
+static int set_int_option(evutil_socket_t fd, int level, int name, int value, const char *label)
+{
+    if (setsockopt(fd, level, name, (const void *)&value, sizeof(value)) < 0)
+    {
+        YA_LOG_WARN("Failed to set %s=%d on fd=%d: %s", label, value, (int)fd,
+                    evutil_socket_error_to_string(EVUTIL_SOCKET_ERROR()));
+        return -1;
+    }
+    return 0;
+}
+
+int ya_socket_tuning_apply(evutil_socket_t fd, const ya_socket_tuning_t *tuning)
+{
+    if (fd < 0 || !tuning)
+    {
+        return -1;
+    }
+
+    int rc = 0;
+    if (tuning->tcp_nodelay)
+    {
+        rc |= set_int_option(fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+    }
+
+#ifdef TCP_QUICKACK
+    if (tuning->tcp_quickack)
+    {
+        rc |= set_int_option(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+    }
+#endif
+
+    if (tuning->dscp >= 0)
+    {
+        rc |= set_int_option(fd, IPPROTO_IP, IP_TOS, tuning->dscp << 2, "IP_TOS");
+    }
+
+#ifdef SO_PRIORITY
+    if (tuning->priority >= 0)
+    {
+        rc |= set_int_option(fd, SOL_SOCKET, SO_PRIORITY, tuning->priority, "SO_PRIORITY");
+    }
+#endif
+
+    if (tuning->sndbuf > 0)
+    {
+        rc |= set_int_option(fd, SOL_SOCKET, SO_SNDBUF, tuning->sndbuf, "SO_SNDBUF");
+    }
+
+    if (tuning->rcvbuf > 0)
+    {
+        rc |= set_int_option(fd, SOL_SOCKET, SO_RCVBUF, tuning->rcvbuf, "SO_RCVBUF");
+    }
+
+    return rc ? -1 : 0;
+}
+
+void ya_socket_tuning_rearm_quickack(evutil_socket_t fd, const ya_socket_tuning_t *tuning)
+{
+#ifdef TCP_QUICKACK
+    if (tuning && tuning->tcp_quickack)
+    {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+    }
+#else
+    (void)fd;
+    (void)tuning;
+#endif
+}
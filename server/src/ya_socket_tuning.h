@@ -0,0 +1,29 @@
+#pragma once
+
+#include <event2/util.h>
+#include <stdbool.h>
+
+// DSCP EF（Expedited Forwarding），IP_TOS 取值为 EF << 2
+#define YA_DSCP_EF 46
+
+// 会话连接的套接字调优（[network] 配置段），在 accept 时应用
+typedef struct {
+    bool tcp_nodelay;   // 关闭 Nagle，小响应帧立即发出（默认开启）
+    bool tcp_quickack;  // 关闭延迟 ACK（仅 Linux，默认开启，每次读回调后重新设置）
+    int dscp;           // IP_TOS 中的 DSCP 值，-1 表示不设置
+    int priority;       // SO_PRIORITY（仅 Linux，0..6），-1 表示不设置
+    int sndbuf;         // SO_SNDBUF 字节数，0 表示使用系统默认值
+    int rcvbuf;         // SO_RCVBUF 字节数，0 表示使用系统默认值
+} ya_socket_tuning_t;
+
+// 读取配置（[network] tcp_nodelay / tcp_quickack / dscp / priority / sndbuf / rcvbuf）
+void ya_socket_tuning_init(void);
+
+// 当前生效的调优参数
+const ya_socket_tuning_t *ya_socket_tuning(void);
+
+// 对一个 TCP 套接字应用调优参数；任一选项设置失败返回 -1（其余选项仍会设置）
+int ya_socket_tuning_apply(evutil_socket_t fd, const ya_socket_tuning_t *tuning);
+
+// TCP_QUICKACK 在 Linux 上不是持久选项，内核会自动恢复延迟 ACK，需要在每次读取后重新设置
+void ya_socket_tuning_rearm_quickack(evutil_socket_t fd, const ya_socket_tuning_t *tuning);
@@ -0,0 +1,160 @@
+#include "ya_trace.h"
+#include "ya_config.h"
+#include "ya_logger.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+extern YA_Config config;
+
+atomic_bool g_trace_enabled = false;
+
+static ya_trace_header_t *g_header = NULL;
+static ya_trace_record_t *g_records = NULL;
+static uint64_t g_mask = 0;
+static size_t g_map_size = 0;
+
+static uint64_t clock_ns(clockid_t clock)
+{
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+void ya_trace_init(void)
+{
+    const char *file = ya_config_get(&config, "trace", "file");
+    if (!file || !*file)
+    {
+        return;
+    }
+
+    uint32_t capacity = 0;
+    const char *capacity_str = ya_config_get(&config, "trace", "capacity");
+    if (capacity_str)
+    {
+        long value = atol(capacity_str);
+        if (value > 0 && value <= (1L << 24))
+        {
+            capacity = (uint32_t)value;
+        }
+        else
+        {
+            YA_LOG_WARN("Invalid [trace] capacity '%s', using %d", capacity_str, YA_TRACE_DEFAULT_CAPACITY);
+        }
+    }
+
+    ya_trace_open(file, capacity);
+}
+
+#ifdef _WIN32
+int ya_trace_open(const char *path, uint32_t capacity)
+{
+    (void)capacity;
+    YA_LOG_WARN("Binary trace is not supported on this platform, ignoring [trace] file=%s", path);
+    return -1;
+}
+
+void ya_trace_close(void)
+{
+}
+#else
+int ya_trace_open(const char *path, uint32_t capacity)
+{
+    if (!path || g_header)
+    {
+        return -1;
+    }
+
+    uint32_t count = 1;
+    uint32_t requested = capacity ? capacity : YA_TRACE_DEFAULT_CAPACITY;
+    while (count < requested)
+    {
+        count <<= 1;
+    }
+
+    size_t size = sizeof(ya_trace_header_t) + (size_t)count * sizeof(ya_trace_record_t);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        YA_LOG_ERROR("Failed to open trace file %s: %s", path, strerror(errno));
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        YA_LOG_ERROR("Failed to size trace file %s: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    // 共享映射：记录直接落在页缓存里，进程崩溃也不丢
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        YA_LOG_ERROR("Failed to map trace file %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    // 新文件内容全为零，记录的 seq 为 0 即视为空槽位
+    ya_trace_header_t *header = (ya_trace_header_t *)map;
+    memcpy(header->magic, YA_TRACE_MAGIC, sizeof(header->magic));
+    header->version = YA_TRACE_VERSION;
+    header->record_size = sizeof(ya_trace_record_t);
+    header->capacity = count;
+    header->pid = (uint32_t)getpid();
+    header->start_mono_ns = clock_ns(CLOCK_MONOTONIC);
+    header->start_real_ns = clock_ns(CLOCK_REALTIME);
+    atomic_init(&header->head, 0);
+
+    g_header = header;
+    g_records = (ya_trace_record_t *)(header + 1);
+    g_mask = count - 1;
+    g_map_size = size;
+    atomic_store_explicit(&g_trace_enabled, true, memory_order_release);
+
+    YA_LOG_INFO("Binary trace enabled: %s (%u records)", path, count);
+    return 0;
+}
+
+void ya_trace_close(void)
+{
+    if (!g_header)
+    {
+        return;
+    }
+
+    atomic_store_explicit(&g_trace_enabled, false, memory_order_release);
+    msync(g_header, g_map_size, MS_ASYNC);
+    munmap(g_header, g_map_size);
+    g_header = NULL;
+    g_records = NULL;
+    g_map_size = 0;
+}
+#endif
+
+void ya_trace_write(const ya_trace_event_t *event)
+{
+    if (!g_header || !event)
+    {
+        return;
+    }
+
+    uint64_t pos = atomic_fetch_add_explicit(&g_header->head, 1, memory_order_relaxed);
+    ya_trace_record_t *record = &g_records[pos & g_mask];
+
+    // 先标记槽位正在写入，读取方据此跳过写了一半的记录
+    atomic_store_explicit(&record->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    record->ts_ns = clock_ns(CLOCK_MONOTONIC);
+    record->event = *event;
+    atomic_store_explicit(&record->seq, pos + 1, memory_order_release);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * 输入事件二进制跟踪
+ *
+ * 用于排查延迟：每个阶段写一条定长记录到 mmap 的环形文件（[trace] file），
+ * 写满后覆盖最旧的记录。进程崩溃后文件内容仍在页缓存中，可以离线读取：
+ *   python3 tools/ya_trace_dump.py <file> [--csv | --chrome]
+ *
+ * 写入只有一次原子自增和一次 48 字节拷贝，未启用时只有一次原子读取，可以常开。
+ * 事件循环线程和注入线程都会写入（多生产者）。
+ *
+ * 文件布局（小端，字段定义见下方结构体）：
+ *   ya_trace_header_t（64 字节） + capacity 条 ya_trace_record_t（每条 64 字节）
+ * 第 n 条记录（从 0 计）位于槽位 n % capacity，写完后 seq = n + 1；
+ * seq 为 0 或与槽位不符的记录正在被覆盖，读取时跳过。
+ */
+
+#define YA_TRACE_MAGIC "YATRACE1"
+#define YA_TRACE_VERSION 1
+
+// 默认记录条数（4 MiB），向上取整为 2 的幂
+#define YA_TRACE_DEFAULT_CAPACITY 65536
+
+// 记录所属阶段
+typedef enum {
+    YA_TRACE_DISPATCH = 0, // 事件通过校验，交给处理函数（type 为 YAEventType）
+    YA_TRACE_DROP = 1,     // 事件在分发前被丢弃（type 为 YAEventType，result 为 ya_trace_drop_t）
+    YA_TRACE_MOVE = 2,     // 指针采样换算为像素位移（raw/float/out 均有效，flags 为协议版本）
+    YA_TRACE_INJECT = 3,   // 注入线程执行完一个动作（type 为 ya_input_action_type_t，result 为 YAError）
+} ya_trace_stage_t;
+
+// DROP 记录的丢弃原因
+typedef enum {
+    YA_TRACE_DROP_TRANSPORT = 1, // 事件不允许从该传输到达
+    YA_TRACE_DROP_STALE = 2,     // 命令序号过旧或重复
+    YA_TRACE_DROP_NO_CLIENT = 3, // 未绑定已授权的客户端
+} ya_trace_drop_t;
+
+// 一条记录的内容（调用方填写）
+typedef struct {
+    uint16_t type;    // 事件类型或注入动作类型，见 ya_trace_stage_t
+    uint8_t stage;    // ya_trace_stage_t
+    uint8_t flags;
+    uint32_t uid;     // 客户端 uid，注入阶段为 0
+    uint32_t index;   // 命令序号
+    int32_t raw_dx;   // 请求中的原始参数（lparam/rparam）
+    int32_t raw_dy;
+    float float_dx;   // 换算后的浮点位移
+    float float_dy;
+    int32_t out_dx;   // 输出的整数位移
+    int32_t out_dy;
+    int32_t result;   // 后端返回值或丢弃原因
+    uint8_t reserved[8];
+} ya_trace_event_t;
+
+typedef struct {
+    atomic_uint_least64_t seq; // 0 表示正在写入，写完后为写入序号 + 1
+    uint64_t ts_ns;            // CLOCK_MONOTONIC 纳秒
+    ya_trace_event_t event;
+} ya_trace_record_t;
+
+typedef struct {
+    char magic[8];                  // YA_TRACE_MAGIC
+    uint32_t version;               // YA_TRACE_VERSION
+    uint32_t record_size;           // sizeof(ya_trace_record_t)
+    uint32_t capacity;              // 记录条数（2 的幂）
+    uint32_t pid;
+    uint64_t start_mono_ns;         // 打开时的 CLOCK_MONOTONIC，与下一项一起把 ts_ns 换算为墙钟时间
+    uint64_t start_real_ns;         // 打开时的 CLOCK_REALTIME
+    atomic_uint_least64_t head;     // 已写入的记录总数
+    uint8_t reserved[16];
+} ya_trace_header_t;
+
+_Static_assert(sizeof(ya_trace_event_t) == 48, "trace event layout is part of the file format");
+_Static_assert(sizeof(ya_trace_record_t) == 64, "trace record layout is part of the file format");
+_Static_assert(sizeof(ya_trace_header_t) == 64, "trace header layout is part of the file format");
+
+extern atomic_bool g_trace_enabled;
+
+// 读取配置（[trace] file / capacity），配置了 file 时打开跟踪文件
+void ya_trace_init(void);
+
+// 创建（截断）跟踪文件并映射，capacity 为 0 时使用默认值；失败返回 -1
+int ya_trace_open(const char *path, uint32_t capacity);
+
+// 停止跟踪并解除映射；调用前写入方（事件循环、注入线程）必须已停止
+void ya_trace_close(void);
+
+// 写入一条记录，时间戳和序号由此函数填写
+void ya_trace_write(const ya_trace_event_t *event);
+
+static inline bool ya_trace_enabled(void)
+{
+    return atomic_load_explicit(&g_trace_enabled, memory_order_relaxed);
+}
+
+// 按字段写入一条记录，例如 YA_TRACE(.stage = YA_TRACE_MOVE, .uid = uid, .out_dx = dx)；
+// 未启用时不构造记录
+#define YA_TRACE(...)                                                                                                  \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (ya_trace_enabled())                                                                                        \
+        {                                                                                                              \
+            ya_trace_write(&(const ya_trace_event_t){__VA_ARGS__});                                                    \
+        }                                                                                                              \
+    } while (0)
@@ -1,9 +1,11 @@
 #include <stdlib.h>
+#include <string.h>
 #include <unity.h>
 #include <event2/event.h>
 #include <event2/bufferevent.h>
 #include <event2/buffer.h>
 #include "../src/ya_client_manager.h"
+#include "../src/ya_event.h"
 
 static ya_client_manager_t manager;
 static struct event_base *base;
@@ -34,11 +36,10 @@ void test_client_manager_init(void) {
     ya_client_manager_init(&test_manager);
     
     TEST_ASSERT_EQUAL_UINT32(0, test_manager.client_count);
-    TEST_ASSERT_EQUAL_UINT32(1, test_manager.next_uid);
-    
-    for (int i = 0; i < YA_CLIENT_HASH_SIZE; i++) {
-        TEST_ASSERT_NULL(test_manager.buckets[i]);
-    }
+    TEST_ASSERT_EQUAL_UINT32(0, test_manager.active_count);
+    TEST_ASSERT_EQUAL_UINT32(0, test_manager.slot_count);
+    TEST_ASSERT_EQUAL_UINT32(0, test_manager.free_head);
+    TEST_ASSERT_NULL(test_manager.slots);
     
     // 测试无效参数
     ya_client_manager_init(NULL);
@@ -55,13 +56,15 @@ void test_client_create(void) {
     ya_client_t *client = ya_client_create(&manager, fd, bev);
     TEST_ASSERT_NOT_NULL(client);
     TEST_ASSERT_EQUAL_INT(fd, client->fd);
-    TEST_ASSERT_EQUAL_UINT32(1, client->uid);
+    TEST_ASSERT_NOT_EQUAL(0, client->uid);
+    TEST_ASSERT_EQUAL_UINT32(0, client->uid & YA_CLIENT_SLOT_MASK);  // 第一个槽位
+    TEST_ASSERT_EQUAL_UINT32(1, client->uid >> YA_CLIENT_SLOT_BITS); // 第一代
     TEST_ASSERT_EQUAL_UINT32(1, client->ref_count);
     TEST_ASSERT_EQUAL_INT(YA_CLIENT_ACTIVE, client->state);
     TEST_ASSERT_EQUAL_PTR(bev, client->bev);
     
     TEST_ASSERT_EQUAL_UINT32(1, manager.client_count);
-    TEST_ASSERT_EQUAL_UINT32(2, manager.next_uid);
+    TEST_ASSERT_EQUAL_UINT32(1, manager.slot_count);
     
     // 测试无效参数
     TEST_ASSERT_NULL(ya_client_create(NULL, fd, bev));
@@ -233,14 +236,13 @@ void test_client_cleanup(void) {
     
     // 验证清理结果
     TEST_ASSERT_EQUAL_UINT32(0, ya_client_get_count(&manager));
-    for (int i = 0; i < YA_CLIENT_HASH_SIZE; i++) {
-        TEST_ASSERT_NULL(manager.buckets[i]);
-    }
+    TEST_ASSERT_EQUAL_UINT32(0, manager.client_count);
+    TEST_ASSERT_NULL(manager.slots);
+    TEST_ASSERT_NULL(ya_client_find_by_fd(&manager, 10));
 }
 
-// 测试哈希冲突处理
-void test_hash_collision(void) {
-    // 创建两个客户端，使其产生哈希冲突
+// 测试槽位复用：旧 UID 不会指向复用同一槽位的新客户端
+void test_slot_reuse_generation(void) {
     evutil_socket_t fd1 = 10;
     evutil_socket_t fd2 = 11;
     struct bufferevent *bev1 = bufferevent_socket_new(base, fd1, BEV_OPT_CLOSE_ON_FREE);
@@ -248,28 +250,28 @@ void test_hash_collision(void) {
     
     ya_client_t *client1 = ya_client_create(&manager, fd1, bev1);
     TEST_ASSERT_NOT_NULL(client1);
+    uint32_t stale_uid = client1->uid;
+    
+    // 释放后同一槽位被新客户端复用，代数加一
+    ya_client_unref(&manager, client1);
+    ya_client_remove(&manager, stale_uid);
+    TEST_ASSERT_EQUAL_UINT32(0, ya_client_get_count(&manager));
     
-    // 手动设置第二个客户端的UID，使其与第一个客户端产生相同的哈希值
-    uint32_t uid2 = client1->uid + YA_CLIENT_HASH_SIZE;
-    manager.next_uid = uid2;
     ya_client_t *client2 = ya_client_create(&manager, fd2, bev2);
     TEST_ASSERT_NOT_NULL(client2);
+    TEST_ASSERT_EQUAL_UINT32(stale_uid & YA_CLIENT_SLOT_MASK, client2->uid & YA_CLIENT_SLOT_MASK);
+    TEST_ASSERT_NOT_EQUAL(stale_uid, client2->uid);
+    TEST_ASSERT_EQUAL_UINT32(1, manager.slot_count);
     
-    // 验证两个客户端都能被正确找到
-    ya_client_t *found1 = ya_client_find_by_uid(&manager, client1->uid);
-    ya_client_t *found2 = ya_client_find_by_uid(&manager, client2->uid);
-    TEST_ASSERT_NOT_NULL(found1);
-    TEST_ASSERT_NOT_NULL(found2);
-    TEST_ASSERT_EQUAL_PTR(client1, found1);
-    TEST_ASSERT_EQUAL_PTR(client2, found2);
+    // 旧 UID 查找不到，也不能移除新客户端
+    TEST_ASSERT_NULL(ya_client_find_by_uid(&manager, stale_uid));
+    ya_client_remove(&manager, stale_uid);
+    TEST_ASSERT_EQUAL_INT(YA_CLIENT_ACTIVE, client2->state);
+    TEST_ASSERT_EQUAL_PTR(client2, ya_client_find_by_uid(&manager, client2->uid));
     
-    // 测试在链表中间删除客户端（删除第一个客户端）
-    ya_client_remove(&manager, client1->uid);
-    
-    // 验证第二个客户端仍然可以找到
-    found2 = ya_client_find_by_uid(&manager, client2->uid);
-    TEST_ASSERT_NOT_NULL(found2);
-    TEST_ASSERT_EQUAL_PTR(client2, found2);
+    // 旧客户端的 fd 索引已移除
+    TEST_ASSERT_NULL(ya_client_find_by_fd(&manager, fd1));
+    TEST_ASSERT_EQUAL_PTR(client2, ya_client_find_by_fd(&manager, fd2));
     
     // 清理
     ya_client_remove(&manager, client2->uid);
@@ -303,50 +305,94 @@ void test_get_count_null(void) {
     TEST_ASSERT_EQUAL_UINT32(0, ya_client_get_count(NULL));
 }
 
-// 测试UID溢出和回绕
-void test_uid_overflow(void) {
-    // 设置next_uid接近溢出点
-    manager.next_uid = UINT32_MAX - 1;
-    
-    evutil_socket_t fd1 = 10;
-    struct bufferevent *bev1 = bufferevent_socket_new(base, fd1, BEV_OPT_CLOSE_ON_FREE);
-    ya_client_t *client1 = ya_client_create(&manager, fd1, bev1);
+// 测试代数回绕：跳过0，UID 永远不为0
+void test_generation_wraparound(void) {
+    evutil_socket_t fd = 10;
+    struct bufferevent *bev1 = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
+    ya_client_t *client1 = ya_client_create(&manager, fd, bev1);
     TEST_ASSERT_NOT_NULL(client1);
-    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX - 1, client1->uid);
     
-    // 下一个客户端应该触发溢出处理
-    evutil_socket_t fd2 = 11;
-    struct bufferevent *bev2 = bufferevent_socket_new(base, fd2, BEV_OPT_CLOSE_ON_FREE);
-    ya_client_t *client2 = ya_client_create(&manager, fd2, bev2);
-    TEST_ASSERT_NOT_NULL(client2);
-    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, client2->uid);
+    // 把槽位代数设为最大值，释放后应回绕到1
+    manager.slots[0].generation = YA_CLIENT_GENERATION_MAX;
+    client1->uid = (YA_CLIENT_GENERATION_MAX << YA_CLIENT_SLOT_BITS);
+    TEST_ASSERT_EQUAL_PTR(client1, ya_client_find_by_uid(&manager, client1->uid));
+    ya_client_unref(&manager, client1);
+    ya_client_remove(&manager, client1->uid);
+    TEST_ASSERT_EQUAL_UINT32(1, manager.slots[0].generation);
     
-    // 再下一个应该回绕到1
-    evutil_socket_t fd3 = 12;
-    struct bufferevent *bev3 = bufferevent_socket_new(base, fd3, BEV_OPT_CLOSE_ON_FREE);
-    ya_client_t *client3 = ya_client_create(&manager, fd3, bev3);
-    TEST_ASSERT_NOT_NULL(client3);
-    TEST_ASSERT_EQUAL_UINT32(1, client3->uid);
-    TEST_ASSERT_EQUAL_UINT32(2, manager.next_uid);  // 下次应该分配2
+    struct bufferevent *bev2 = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
+    ya_client_t *client2 = ya_client_create(&manager, fd, bev2);
+    TEST_ASSERT_NOT_NULL(client2);
+    TEST_ASSERT_EQUAL_UINT32(1u << YA_CLIENT_SLOT_BITS, client2->uid);
     
-    // 清理
-    ya_client_remove(&manager, client1->uid);
     ya_client_remove(&manager, client2->uid);
-    ya_client_remove(&manager, client3->uid);
 }
 
-// 测试next_uid为0的边界情况
-void test_next_uid_zero(void) {
-    manager.next_uid = 0;
+// 测试最大代数生成的 UID 能经协议头编码后原样解码
+void test_max_generation_uid_round_trip(void) {
+    uint32_t uid = (YA_CLIENT_GENERATION_MAX << YA_CLIENT_SLOT_BITS) | YA_CLIENT_SLOT_MASK;
+    TEST_ASSERT_TRUE(uid <= INT32_MAX);
+
+    YAEvent event = {0};
+    event.header.type = HEARTBEAT;
+    event.header.direction = REQUEST;
+    event.header.uid = uid;
+    event.header.index = 1;
+
+    uint8_t *frame = NULL;
+    int len = ya_serialize_event(&event, &frame);
+    TEST_ASSERT_TRUE(len > 0);
+
+    YAEvent decoded = {0};
+    TEST_ASSERT_EQUAL(len, ya_decode_frame(frame, (size_t)len, &decoded));
+    TEST_ASSERT_EQUAL_UINT32(uid, decoded.header.uid);
+    TEST_ASSERT_EQUAL(HEARTBEAT, decoded.header.type);
+
+    ya_free_event_param(&decoded);
+    free(frame);
+}
+
+// 测试空闲槽位复用与活跃列表紧凑
+void test_free_list_and_active_list(void) {
+    ya_client_t *clients[4];
+    for (int i = 0; i < 4; i++) {
+        struct bufferevent *bev = bufferevent_socket_new(base, 10 + i, BEV_OPT_CLOSE_ON_FREE);
+        clients[i] = ya_client_create(&manager, 10 + i, bev);
+        TEST_ASSERT_NOT_NULL(clients[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, manager.slot_count);
     
-    evutil_socket_t fd = 10;
-    struct bufferevent *bev = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
-    ya_client_t *client = ya_client_create(&manager, fd, bev);
+    // 断开中间的客户端，活跃列表只剩其余3个
+    uint32_t removed_slot = clients[1]->uid & YA_CLIENT_SLOT_MASK;
+    ya_client_unref(&manager, clients[1]);
+    ya_client_remove(&manager, clients[1]->uid);
+    TEST_ASSERT_EQUAL_UINT32(3, ya_client_get_count(&manager));
+    
+    bool seen[4] = {false};
+    for (uint32_t i = 0; i < ya_client_get_count(&manager); i++) {
+        ya_client_t *client = ya_client_at(&manager, i);
+        TEST_ASSERT_NOT_NULL(client);
+        TEST_ASSERT_EQUAL_INT(YA_CLIENT_ACTIVE, client->state);
+        seen[client->fd - 10] = true;
+    }
+    TEST_ASSERT_TRUE(seen[0] && !seen[1] && seen[2] && seen[3]);
+    TEST_ASSERT_NULL(ya_client_at(&manager, 3));
+    TEST_ASSERT_NULL(ya_client_at(NULL, 0));
+    
+    // 新客户端复用空闲槽位，不增加槽位数
+    struct bufferevent *bev = bufferevent_socket_new(base, 20, BEV_OPT_CLOSE_ON_FREE);
+    ya_client_t *client = ya_client_create(&manager, 20, bev);
     TEST_ASSERT_NOT_NULL(client);
-    TEST_ASSERT_EQUAL_UINT32(1, client->uid);  // 应该从1开始
-    TEST_ASSERT_EQUAL_UINT32(2, manager.next_uid);
+    TEST_ASSERT_EQUAL_UINT32(removed_slot, client->uid & YA_CLIENT_SLOT_MASK);
+    TEST_ASSERT_EQUAL_UINT32(4, manager.slot_count);
+    TEST_ASSERT_EQUAL_UINT32(4, ya_client_get_count(&manager));
     
     ya_client_remove(&manager, client->uid);
+    for (int i = 0; i < 4; i++) {
+        if (i != 1) {
+            ya_client_remove(&manager, clients[i]->uid);
+        }
+    }
 }
 
 // 测试客户端创建时的参数验证
@@ -382,22 +428,16 @@ void test_ref_count_underflow(void) {
     ya_client_remove(&manager, client->uid);
 }
 
-// 测试复杂的哈希冲突场景
-void test_complex_hash_collision(void) {
+// 测试删除中间槽位后其余客户端仍可查找
+void test_remove_middle_slot(void) {
     ya_client_t *clients[10];
     
-    // 创建多个客户端，强制产生哈希冲突
     for (int i = 0; i < 10; i++) {
         evutil_socket_t fd = 20 + i;
         struct bufferevent *bev = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
-        
-        // 手动设置UID使其产生冲突
-        uint32_t target_uid = 100 + i * YA_CLIENT_HASH_SIZE;  // 都映射到同一个bucket
-        manager.next_uid = target_uid;
-        
         clients[i] = ya_client_create(&manager, fd, bev);
         TEST_ASSERT_NOT_NULL(clients[i]);
-        TEST_ASSERT_EQUAL_UINT32(target_uid, clients[i]->uid);
+        TEST_ASSERT_EQUAL_UINT32((uint32_t)i, clients[i]->uid & YA_CLIENT_SLOT_MASK);
     }
     
     // 验证所有客户端都能正确找到
@@ -407,21 +447,22 @@ void test_complex_hash_collision(void) {
         TEST_ASSERT_EQUAL_PTR(clients[i], found);
     }
     
-    // 测试在链表中间删除客户端
+    // 删除中间的客户端
     ya_client_remove(&manager, clients[5]->uid);
     TEST_ASSERT_NULL(ya_client_find_by_uid(&manager, clients[5]->uid));
+    TEST_ASSERT_NULL(ya_client_find_by_fd(&manager, 25));
     
     // 验证其他客户端仍然可以找到
     for (int i = 0; i < 10; i++) {
         if (i != 5) {
-            ya_client_t *found = ya_client_find_by_uid(&manager, clients[i]->uid);
-            TEST_ASSERT_NOT_NULL(found);
+            TEST_ASSERT_EQUAL_PTR(clients[i], ya_client_find_by_uid(&manager, clients[i]->uid));
+            TEST_ASSERT_EQUAL_PTR(clients[i], ya_client_find_by_fd(&manager, 20 + i));
         }
     }
     
     // 清理剩余客户端
     for (int i = 0; i < 10; i++) {
-        if (i != 5) {  // 客户端5已经被删除
+        if (i != 5) {  // 客户端5仍有初始引用，断开后由 cleanup 释放
             ya_client_remove(&manager, clients[i]->uid);
         }
     }
@@ -452,6 +493,41 @@ void test_find_disconnected_client(void) {
 }
 
 // 测试大量客户端的性能
+// 模拟会话关闭连接的步骤：移除客户端、释放 bufferevent、归还连接持有的引用
+static void close_like_session(ya_client_t *client) {
+    ya_client_remove(&manager, client->uid);
+    bufferevent_free(client->bev);
+    client->bev = NULL;
+    ya_client_unref(&manager, client);
+}
+
+// 测试连接关闭后槽位被回收：反复建立/关闭超过槽位上限次也不会耗尽
+void test_closed_sessions_release_slots(void) {
+    for (uint32_t i = 0; i < YA_CLIENT_MAX_SLOTS + 16; i++) {
+        evutil_socket_t fd = 10 + (evutil_socket_t)(i % 8);
+        struct bufferevent *bev = bufferevent_socket_new(base, fd, 0);
+        TEST_ASSERT_NOT_NULL(bev);
+        ya_client_t *client = ya_client_create(&manager, fd, bev);
+        TEST_ASSERT_NOT_NULL(client);
+
+        if (i % 2) {
+            // 读回调处理帧期间关闭：回调持有的引用归还后才释放
+            ya_client_ref(client);
+            close_like_session(client);
+            TEST_ASSERT_EQUAL_UINT32(0, ya_client_get_count(&manager));
+            TEST_ASSERT_NULL(ya_client_find_by_fd(&manager, fd));
+            ya_client_unref(&manager, client);
+        } else {
+            close_like_session(client);
+        }
+
+        TEST_ASSERT_EQUAL_UINT32(0, ya_client_get_count(&manager));
+        TEST_ASSERT_EQUAL_UINT32(0, manager.client_count);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1, manager.slot_count);
+}
+
 void test_many_clients_performance(void) {
     const int client_count = 100;
     ya_client_t *clients[client_count];
@@ -529,34 +605,6 @@ void test_remove_nonexistent_client(void) {
     TEST_ASSERT_EQUAL_UINT32(initial_count, ya_client_get_count(&manager));
 }
 
-#ifdef DEBUG
-// 测试调试统计功能（仅在DEBUG模式下）
-void test_debug_collision_stats(void) {
-    // 这个测试需要在DEBUG模式下编译才能执行
-    // 创建一些客户端来触发统计更新
-    const int client_count = 20;
-    ya_client_t *clients[client_count];
-    
-    for (int i = 0; i < client_count; i++) {
-        evutil_socket_t fd = 200 + i;
-        struct bufferevent *bev = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
-        
-        // 手动设置UID产生一些冲突
-        if (i % 3 == 0) {
-            manager.next_uid = 1000 + (i / 3) * YA_CLIENT_HASH_SIZE;
-        }
-        
-        clients[i] = ya_client_create(&manager, fd, bev);
-        TEST_ASSERT_NOT_NULL(clients[i]);
-    }
-    
-    // 清理
-    for (int i = 0; i < client_count; i++) {
-        ya_client_remove(&manager, clients[i]->uid);
-    }
-}
-#endif
-
 // 测试内存分配失败的情况
 // 注意：这个测试需要特殊的内存分配钩子来模拟失败，
 // 在实际环境中可能无法直接测试，但我们可以检查错误处理逻辑
@@ -599,7 +647,7 @@ void test_operations_on_empty_manager(void) {
     
     // 状态应该保持不变
     TEST_ASSERT_EQUAL_UINT32(0, ya_client_get_count(&manager));
-    TEST_ASSERT_EQUAL_UINT32(1, manager.next_uid);
+    TEST_ASSERT_EQUAL_UINT32(0, manager.slot_count);
 }
 
 // 测试状态转换的边界情况
@@ -656,6 +704,33 @@ void test_ref_unref_edge_cases(void) {
     TEST_ASSERT_NULL(ya_client_find_by_uid(&manager, uid));
 }
 
+// 测试每客户端事件计数与每秒事件数
+void test_client_event_rate(void) {
+    ya_client_t client;
+    memset(&client, 0, sizeof(client));
+
+    for (int i = 0; i < 5; i++) {
+        ya_client_count_event(&client, 100);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, ya_client_events_per_sec(&client, 100));
+    TEST_ASSERT_EQUAL_UINT32(5, ya_client_events_per_sec(&client, 101));
+
+    for (int i = 0; i < 3; i++) {
+        ya_client_count_event(&client, 101);
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, ya_client_events_per_sec(&client, 101));
+    TEST_ASSERT_EQUAL_UINT32(3, ya_client_events_per_sec(&client, 102));
+    TEST_ASSERT_EQUAL_UINT32(0, ya_client_events_per_sec(&client, 103));
+
+    // 空闲超过一秒后，前一秒计为0
+    ya_client_count_event(&client, 110);
+    TEST_ASSERT_EQUAL_UINT32(0, ya_client_events_per_sec(&client, 110));
+    TEST_ASSERT_EQUAL_UINT64(9, client.events);
+
+    ya_client_count_event(NULL, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, ya_client_events_per_sec(NULL, 0));
+}
+
 int main(void) {
     UNITY_BEGIN();
     
@@ -667,18 +742,20 @@ int main(void) {
     RUN_TEST(test_client_state_transition);
     RUN_TEST(test_multiple_clients);
     RUN_TEST(test_client_cleanup);
-    RUN_TEST(test_hash_collision);
+    RUN_TEST(test_slot_reuse_generation);
     RUN_TEST(test_zero_ref_count_removal);
     RUN_TEST(test_manager_cleanup_null);
     RUN_TEST(test_get_count_null);
     
     // 新增的测试用例
-    RUN_TEST(test_uid_overflow);
-    RUN_TEST(test_next_uid_zero);
+    RUN_TEST(test_generation_wraparound);
+    RUN_TEST(test_max_generation_uid_round_trip);
+    RUN_TEST(test_free_list_and_active_list);
     RUN_TEST(test_client_create_invalid_params);
     RUN_TEST(test_ref_count_underflow);
-    RUN_TEST(test_complex_hash_collision);
+    RUN_TEST(test_remove_middle_slot);
     RUN_TEST(test_find_disconnected_client);
+    RUN_TEST(test_closed_sessions_release_slots);
     RUN_TEST(test_many_clients_performance);
     RUN_TEST(test_ref_count_in_remove);
     RUN_TEST(test_remove_nonexistent_client);
@@ -686,10 +763,7 @@ int main(void) {
     RUN_TEST(test_operations_on_empty_manager);
     RUN_TEST(test_client_state_edge_cases);
     RUN_TEST(test_ref_unref_edge_cases);
-    
-#ifdef DEBUG
-    RUN_TEST(test_debug_collision_stats);
-#endif
+    RUN_TEST(test_client_event_rate);
     
     return UNITY_END();
 } 
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include <unity.h>
+#include <string.h>
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include "../src/ya_server.h"
+#include "../src/ya_server_handler.h"
+#include "../src/ya_input_queue.h"
+
+YA_ServerContext svr_context;
+YA_Config config;
+
+static struct bufferevent *bev;
+static ya_client_t *client;
+static int executed;  // 注入线程执行的动作数
+
+static void record_action(const ya_input_action_t *action) {
+    (void)action;
+    executed++;
+}
+
+void setUp(void) {
+    memset(&svr_context, 0, sizeof(svr_context));
+    ya_config_init(&config);
+    ya_client_manager_init(&svr_context.client_manager);
+    svr_context.base = event_base_new();
+    TEST_ASSERT_NOT_NULL(svr_context.base);
+
+    bev = bufferevent_socket_new(svr_context.base, -1, 0);
+    TEST_ASSERT_NOT_NULL(bev);
+    client = ya_client_create(&svr_context.client_manager, 0, bev);
+    TEST_ASSERT_NOT_NULL(client);
+
+    executed = 0;
+    TEST_ASSERT_EQUAL(0, ya_input_queue_start(record_action));
+}
+
+void tearDown(void) {
+    ya_input_queue_stop();
+    // 客户端释放时一并释放它的 bufferevent
+    ya_client_unref(&svr_context.client_manager, client);
+    ya_client_manager_cleanup(&svr_context.client_manager);
+    event_base_free(svr_context.base);
+    ya_config_free(&config);
+}
+
+static YAEvent make_click(uint32_t uid, uint32_t index, YACommonEventRequest *click) {
+    click->lparam = 0; // Left
+    click->rparam = 2; // Click
+    YAEvent event = {0};
+    event.header.type = MOUSE_CLICK;
+    event.header.direction = REQUEST;
+    event.header.uid = uid;
+    event.header.index = index;
+    event.param = click;
+    event.param_len = sizeof(*click);
+    return event;
+}
+
+// 测试绑定客户端从会话连接发来的点击正常注入
+void test_dispatch_tcp_click_injected(void) {
+    YACommonEventRequest click;
+    YAEvent event = make_click(client->uid, 1, &click);
+
+    TEST_ASSERT_NULL(process_server_event(bev, &event, client));
+    ya_input_queue_drain();
+
+    TEST_ASSERT_EQUAL_UINT64(1, svr_context.stats.event_types[MOUSE_CLICK].handled);
+    TEST_ASSERT_EQUAL_UINT64(0, svr_context.stats.event_types[MOUSE_CLICK].rejected);
+    TEST_ASSERT_EQUAL_UINT32(1, client->command_index);
+}
+
+// 测试 flags 不含 YA_EVENT_UDP 的事件从命令数据报（bev 为 NULL）到达时被丢弃
+void test_dispatch_tcp_only_event_dropped_over_udp(void) {
+    YACommonEventRequest click;
+    YAEvent event = make_click(client->uid, 1, &click);
+
+    TEST_ASSERT_NULL(process_server_event(NULL, &event, client));
+    ya_input_queue_drain();
+
+    TEST_ASSERT_EQUAL(0, executed);
+    TEST_ASSERT_EQUAL_UINT64(0, svr_context.stats.event_types[MOUSE_CLICK].handled);
+    TEST_ASSERT_EQUAL_UINT64(1, svr_context.stats.event_types[MOUSE_CLICK].rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, client->command_index);
+}
+
+// 测试 YA_EVENT_NEED_CLIENT：请求头 uid 与连接绑定的客户端不一致时拒绝，且不推进命令序号
+void test_dispatch_need_client_rejects_foreign_uid(void) {
+    YACommonEventRequest click;
+    YAEvent event = make_click(client->uid + 1, 1, &click);
+
+    TEST_ASSERT_NULL(process_server_event(bev, &event, client));
+
+    event.header.uid = 0;  // 授权前的 uid
+    TEST_ASSERT_NULL(process_server_event(bev, &event, client));
+
+    // 没有绑定客户端的连接同样拒绝
+    TEST_ASSERT_NULL(process_server_event(bev, &event, NULL));
+    ya_input_queue_drain();
+
+    TEST_ASSERT_EQUAL(0, executed);
+    TEST_ASSERT_EQUAL_UINT64(0, svr_context.stats.event_types[MOUSE_CLICK].handled);
+    TEST_ASSERT_EQUAL_UINT64(3, svr_context.stats.event_types[MOUSE_CLICK].rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, client->command_index);
+
+    // 被拒绝的帧没有占用序号，同一序号的合法请求仍然接受
+    event.header.uid = client->uid;
+    TEST_ASSERT_NULL(process_server_event(bev, &event, client));
+    TEST_ASSERT_EQUAL_UINT64(1, svr_context.stats.event_types[MOUSE_CLICK].handled);
+    TEST_ASSERT_EQUAL_UINT32(1, client->command_index);
+}
+
+// 测试注入线程交回的 TEXT_GET 结果写到请求客户端的会话连接，客户端已断开时丢弃
+void test_text_get_result_replies_to_owner(void) {
+    struct evbuffer *output = bufferevent_get_output(bev);
+
+    handle_input_get_result(client->uid + 1, 5, strdup("stale"));
+    TEST_ASSERT_EQUAL(0, evbuffer_get_length(output));
+
+    handle_input_get_result(client->uid, 5, strdup("hello"));
+    size_t len = evbuffer_get_length(output);
+    TEST_ASSERT_TRUE(len > 0);
+    TEST_ASSERT_EQUAL_UINT64(len, client->bytes_out);
+
+    YAEvent reply = {0};
+    TEST_ASSERT_EQUAL((int)len, ya_decode_frame(evbuffer_pullup(output, -1), len, &reply));
+    TEST_ASSERT_EQUAL(TEXT_GET, reply.header.type);
+    TEST_ASSERT_EQUAL(RESPONSE, reply.header.direction);
+    TEST_ASSERT_EQUAL_UINT32(client->uid, reply.header.uid);
+    TEST_ASSERT_EQUAL_UINT32(5, reply.header.index);
+    TEST_ASSERT_EQUAL_STRING("hello", ((YAInputGetEventResponse *)reply.param)->text);
+    ya_free_event_param(&reply);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_dispatch_tcp_click_injected);
+    RUN_TEST(test_dispatch_tcp_only_event_dropped_over_udp);
+    RUN_TEST(test_dispatch_need_client_rejects_foreign_uid);
+    RUN_TEST(test_text_get_result_replies_to_owner);
+
+    return UNITY_END();
+}
@@ -151,13 +151,13 @@ void test_ya_parse_event_header_wrong_array_size(void)
 
 void test_ya_parse_event_no_body(void)
 {
-    // 测试POWER事件（无body）
+    // 测试HEARTBEAT事件（无body）
     struct evbuffer *buffer = evbuffer_new();
     YAEvent event = {0};
     
     char *header_data = NULL;
     size_t header_size = 0;
-    int result = create_event_header_msgpack(999, POWER, REQUEST, 888, &header_data, &header_size);
+    int result = create_event_header_msgpack(999, HEARTBEAT, REQUEST, 888, &header_data, &header_size);
     TEST_ASSERT_EQUAL(0, result);
     
     evbuffer_add(buffer, header_data, header_size);
@@ -166,10 +166,10 @@ void test_ya_parse_event_no_body(void)
     
     result = ya_parse_event(buffer, &event, &pkg_size);
     if (result < 0) {
-        TEST_IGNORE_MESSAGE("POWER event has no parser - this is expected");
+        TEST_IGNORE_MESSAGE("HEARTBEAT event has no parser - this is expected");
     } else {
-        TEST_ASSERT_EQUAL(POWER, event.header.type);
-        TEST_ASSERT_NULL(event.param); // POWER事件无参数
+        TEST_ASSERT_EQUAL(HEARTBEAT, event.header.type);
+        TEST_ASSERT_NULL(event.param); // HEARTBEAT事件无参数
     }
     
     ya_free_event_param(&event);
@@ -219,6 +219,86 @@ void test_ya_parse_event_with_body(void)
     evbuffer_free(buffer);
 }
 
+void test_ya_parse_event_inline_common(void)
+{
+    // 测试内联解析：定长参数写入事件自带的存储，不占用堆内存
+    struct evbuffer *buffer = evbuffer_new();
+    YAEvent event = {0};
+
+    char *header_data = NULL;
+    size_t header_size = 0;
+    int result = create_event_header_msgpack(111, MOUSE_MOVE, REQUEST, 222, &header_data, &header_size);
+    TEST_ASSERT_EQUAL(0, result);
+
+    char *body_data = NULL;
+    size_t body_size = 0;
+    result = create_common_request_msgpack(-3, 7, &body_data, &body_size);
+    TEST_ASSERT_EQUAL(0, result);
+
+    evbuffer_add(buffer, header_data, header_size);
+    evbuffer_add(buffer, body_data, body_size);
+
+    YAPackageSize size = {.totalSize = (uint32_t)(header_size + body_size + 4),
+                         .headerSize = (uint32_t)header_size,
+                         .bodySize = (uint32_t)body_size};
+
+    result = ya_parse_event_inline(buffer, &event, &size);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(MOUSE_MOVE, event.header.type);
+    TEST_ASSERT_EQUAL_PTR(&event.inline_param, event.param);
+    TEST_ASSERT_EQUAL(sizeof(YACommonEventRequest), event.param_len);
+    TEST_ASSERT_EQUAL(-3, event.inline_param.common.lparam);
+    TEST_ASSERT_EQUAL(7, event.inline_param.common.rparam);
+    TEST_ASSERT_EQUAL(0, evbuffer_get_length(buffer));
+
+    // 内联参数不会被free，只是清空指针
+    ya_free_event_param(&event);
+    TEST_ASSERT_NULL(event.param);
+
+    free(header_data);
+    free(body_data);
+    evbuffer_free(buffer);
+}
+
+void test_ya_parse_event_inline_text_input(void)
+{
+    // 变长参数即使走内联解析也仍然分配在堆上
+    struct evbuffer *buffer = evbuffer_new();
+    YAEvent event = {0};
+
+    char *header_data = NULL;
+    size_t header_size = 0;
+    int result = create_event_header_msgpack(1, TEXT_INPUT, REQUEST, 1, &header_data, &header_size);
+    TEST_ASSERT_EQUAL(0, result);
+
+    char *body_data = NULL;
+    size_t body_size = 0;
+    mpack_writer_t writer;
+    mpack_writer_init_growable(&writer, &body_data, &body_size);
+    mpack_write_cstr(&writer, "hello");
+    TEST_ASSERT_EQUAL(mpack_ok, mpack_writer_destroy(&writer));
+
+    evbuffer_add(buffer, header_data, header_size);
+    evbuffer_add(buffer, body_data, body_size);
+
+    YAPackageSize size = {.totalSize = (uint32_t)(header_size + body_size + 4),
+                         .headerSize = (uint32_t)header_size,
+                         .bodySize = (uint32_t)body_size};
+
+    result = ya_parse_event_inline(buffer, &event, &size);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_NOT_NULL(event.param);
+    TEST_ASSERT_TRUE(event.param != (void *)&event.inline_param);
+    TEST_ASSERT_EQUAL_STRING("hello", ((YATextInputEventRequest *)event.param)->text);
+
+    ya_free_event_param(&event);
+    TEST_ASSERT_NULL(event.param);
+
+    free(header_data);
+    free(body_data);
+    evbuffer_free(buffer);
+}
+
 void test_ya_parse_event_insufficient_body_data(void)
 {
     // 测试体部数据不足的情况
@@ -247,7 +327,7 @@ void test_ya_serialize_event_null_param(void)
 {
     // 测试空参数的事件序列化
     YAEvent event = {0};
-    event.header.type = POWER;
+    event.header.type = HEARTBEAT;
     event.header.direction = REQUEST;
     event.header.uid = 123;
     event.header.index = 1;
@@ -261,7 +341,14 @@ void test_ya_serialize_event_null_param(void)
     TEST_ASSERT_TRUE(result >= 0);
     if (output) {
         free(output);
+        output = NULL;
     }
+
+    // 有 body 的事件缺少参数时只写 header，不能解引用空参数
+    event.header.type = MOUSE_MOVE;
+    result = ya_serialize_event(&event, &output);
+    TEST_ASSERT_TRUE(result > 0);
+    free(output);
 }
 
 void test_ya_serialize_event_common_request(void)
@@ -286,6 +373,357 @@ void test_ya_serialize_event_common_request(void)
     }
 }
 
+void test_ya_serialize_event_to_matches_heap(void)
+{
+    // 单次写入栈缓冲区的结果应与堆上序列化逐字节一致
+    YAEvent event = {0};
+    event.header.type = MOUSE_MOVE;
+    event.header.direction = REQUEST;
+    event.header.uid = 456;
+    event.header.index = 2;
+
+    YACommonEventRequest req = {-100, 200};
+    event.param = &req;
+    event.param_len = sizeof(req);
+
+    uint8_t *heap = NULL;
+    int heap_len = ya_serialize_event(&event, &heap);
+    TEST_ASSERT_TRUE(heap_len > (int)YA_FRAME_PREFIX_SIZE);
+
+    uint8_t frame[YA_EVENT_FRAME_STACK_SIZE];
+    int frame_len = ya_serialize_event_to(&event, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL(heap_len, frame_len);
+    TEST_ASSERT_EQUAL_MEMORY(heap, frame, frame_len);
+
+    // 缓冲区不足时返回-1
+    TEST_ASSERT_EQUAL(-1, ya_serialize_event_to(&event, frame, frame_len - 1));
+
+    // 直接写入evbuffer
+    struct evbuffer *out = evbuffer_new();
+    TEST_ASSERT_EQUAL(frame_len, ya_serialize_event_to_evbuffer(&event, out));
+    TEST_ASSERT_EQUAL(frame_len, evbuffer_get_length(out));
+    TEST_ASSERT_EQUAL_MEMORY(heap, evbuffer_pullup(out, -1), frame_len);
+
+    YAPackageSize size = {0};
+    ya_get_package_size(out, &size);
+    TEST_ASSERT_EQUAL(frame_len - 4, size.totalSize);
+
+    evbuffer_free(out);
+    free(heap);
+}
+
+void test_packed_record_round_trip(void)
+{
+    // v4 紧凑记录：编码后直接按偏移解码
+    YACommonEventRequest move = {-1234, 5678};
+    YAEvent event = {0};
+    event.header.type = MOUSE_MOVE;
+    event.header.direction = REQUEST;
+    event.header.uid = 0x01020304;
+    event.header.index = 77;
+    event.param = &move;
+    event.param_len = sizeof(move);
+
+    uint8_t record[YA_PACKED_MAX_SIZE];
+    TEST_ASSERT_EQUAL(YA_PACKED_POINTER_SIZE, ya_encode_packed_event(&event, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_HEX8(YA_PACKED_MAGIC, record[0]);
+    TEST_ASSERT_EQUAL_HEX8(MOUSE_MOVE, record[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, record[4]);
+
+    YAEvent decoded = {0};
+    TEST_ASSERT_EQUAL(YA_PACKED_POINTER_SIZE, ya_decode_packed_event(record, YA_PACKED_POINTER_SIZE, &decoded));
+    TEST_ASSERT_EQUAL(MOUSE_MOVE, decoded.header.type);
+    TEST_ASSERT_EQUAL(REQUEST, decoded.header.direction);
+    TEST_ASSERT_EQUAL_UINT32(0x01020304, decoded.header.uid);
+    TEST_ASSERT_EQUAL_UINT32(77, decoded.header.index);
+    TEST_ASSERT_EQUAL_PTR(&decoded.inline_param, decoded.param);
+    TEST_ASSERT_EQUAL(-1234, decoded.inline_param.common.lparam);
+    TEST_ASSERT_EQUAL(5678, decoded.inline_param.common.rparam);
+
+    // 键盘记录带 mods
+    YAKeyboardEventRequest key = {'a', 2, CHORD_MOD_CTRL | CHORD_MOD_SHIFT};
+    event.header.type = KEYBOARD;
+    event.param = &key;
+    event.param_len = sizeof(key);
+    TEST_ASSERT_EQUAL(YA_PACKED_KEYBOARD_SIZE, ya_encode_packed_event(&event, record, sizeof(record)));
+
+    memset(&decoded, 0, sizeof(decoded));
+    TEST_ASSERT_EQUAL(YA_PACKED_KEYBOARD_SIZE, ya_decode_packed_event(record, sizeof(record), &decoded));
+    TEST_ASSERT_EQUAL('a', decoded.inline_param.keyboard.code);
+    TEST_ASSERT_EQUAL(2, decoded.inline_param.keyboard.op);
+    TEST_ASSERT_EQUAL_UINT32(CHORD_MOD_CTRL | CHORD_MOD_SHIFT, decoded.inline_param.keyboard.mods);
+
+    // 平滑滚动与指针记录同尺寸
+    YACommonEventRequest scroll = {-250, 1500};
+    event.header.type = MOUSE_SMOOTH_SCROLL;
+    event.param = &scroll;
+    event.param_len = sizeof(scroll);
+    TEST_ASSERT_EQUAL(YA_PACKED_POINTER_SIZE, ya_encode_packed_event(&event, record, sizeof(record)));
+
+    memset(&decoded, 0, sizeof(decoded));
+    TEST_ASSERT_EQUAL(YA_PACKED_POINTER_SIZE, ya_decode_packed_event(record, sizeof(record), &decoded));
+    TEST_ASSERT_EQUAL(MOUSE_SMOOTH_SCROLL, decoded.header.type);
+    TEST_ASSERT_EQUAL(-250, decoded.inline_param.common.lparam);
+    TEST_ASSERT_EQUAL(1500, decoded.inline_param.common.rparam);
+}
+
+void test_packed_record_invalid(void)
+{
+    uint8_t record[YA_PACKED_MAX_SIZE] = {YA_PACKED_MAGIC, MOUSE_MOVE};
+    YAEvent decoded = {0};
+
+    // 数据不足时需要更多字节
+    TEST_ASSERT_EQUAL(0, ya_decode_packed_event(record, 1, &decoded));
+    // 只有 3 字节时保留位不完整，不能读取第 4 个字节
+    record[3] = 1;
+    TEST_ASSERT_EQUAL(0, ya_decode_packed_event(record, 3, &decoded));
+    record[3] = 0;
+    TEST_ASSERT_EQUAL(0, ya_decode_packed_event(record, YA_PACKED_POINTER_SIZE - 1, &decoded));
+
+    // 控制面事件没有紧凑格式
+    record[1] = AUTHORIZE;
+    TEST_ASSERT_EQUAL(-1, ya_decode_packed_event(record, sizeof(record), &decoded));
+
+    // 保留位必须为0
+    record[1] = MOUSE_MOVE;
+    record[3] = 1;
+    TEST_ASSERT_EQUAL(-1, ya_decode_packed_event(record, sizeof(record), &decoded));
+
+    // 普通帧（首字节为0）不是紧凑记录
+    record[0] = 0;
+    TEST_ASSERT_EQUAL(-1, ya_decode_packed_event(record, sizeof(record), &decoded));
+
+    YAEvent text = {0};
+    text.header.type = TEXT_INPUT;
+    TEST_ASSERT_EQUAL(-1, ya_encode_packed_event(&text, record, sizeof(record)));
+}
+
+void test_pointer_datagram_round_trip(void)
+{
+    // v5 UDP 指针数据报：紧凑 MOUSE_MOVE 记录 + 会话令牌
+    YACommonEventRequest move = {-7, 300};
+    YAEvent event = {0};
+    event.header.type = MOUSE_MOVE;
+    event.header.direction = REQUEST;
+    event.header.uid = 3;
+    event.header.index = 99;
+    event.param = &move;
+    event.param_len = sizeof(move);
+
+    uint8_t datagram[YA_POINTER_DATAGRAM_SIZE];
+    uint64_t token = 0x0123456789ABCDEFull;
+    TEST_ASSERT_EQUAL(YA_POINTER_DATAGRAM_SIZE, ya_encode_pointer_datagram(&event, token, datagram, sizeof(datagram)));
+    TEST_ASSERT_EQUAL_HEX8(0x01, datagram[YA_PACKED_POINTER_SIZE]);
+    TEST_ASSERT_EQUAL_HEX8(0xEF, datagram[YA_POINTER_DATAGRAM_SIZE - 1]);
+
+    YAEvent decoded = {0};
+    uint64_t decoded_token = 0;
+    TEST_ASSERT_EQUAL(YA_POINTER_DATAGRAM_SIZE,
+                      ya_decode_pointer_datagram(datagram, sizeof(datagram), &decoded, &decoded_token));
+    TEST_ASSERT_TRUE(decoded_token == token);
+    TEST_ASSERT_EQUAL(MOUSE_MOVE, decoded.header.type);
+    TEST_ASSERT_EQUAL_UINT32(3, decoded.header.uid);
+    TEST_ASSERT_EQUAL_UINT32(99, decoded.header.index);
+    TEST_ASSERT_EQUAL(-7, decoded.inline_param.common.lparam);
+    TEST_ASSERT_EQUAL(300, decoded.inline_param.common.rparam);
+
+    // 缺少令牌的紧凑记录不是指针数据报
+    TEST_ASSERT_EQUAL(-1, ya_decode_pointer_datagram(datagram, YA_PACKED_POINTER_SIZE, &decoded, &decoded_token));
+
+    // 点击不能走 UDP 指针通道
+    event.header.type = MOUSE_CLICK;
+    TEST_ASSERT_EQUAL(-1, ya_encode_pointer_datagram(&event, token, datagram, sizeof(datagram)));
+    datagram[1] = MOUSE_CLICK;
+    TEST_ASSERT_EQUAL(-1, ya_decode_pointer_datagram(datagram, sizeof(datagram), &decoded, &decoded_token));
+}
+
+void test_authorize_response_session_token(void)
+{
+    // v5 客户端的授权响应在末尾携带会话令牌
+    YAAuthorizeEventResponse resp = {0};
+    resp.success = true;
+    resp.uid = 8;
+    resp.client_version = YA_PROTOCOL_UDP_POINTER_VERSION;
+    resp.session_token = 0xFEDCBA9876543210ull;
+
+    YAEvent event = {0};
+    event.header.type = AUTHORIZE;
+    event.header.direction = RESPONSE;
+    event.param = &resp;
+    event.param_len = sizeof(resp);
+
+    uint8_t frame[YA_EVENT_FRAME_STACK_SIZE];
+    int frame_len = ya_serialize_event_to(&event, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(frame_len > 0);
+
+    YAPackageSize size = {0};
+    TEST_ASSERT_EQUAL(YA_FRAME_PREFIX_SIZE, ya_decode_package_size(frame, (size_t)frame_len, &size));
+
+    mpack_reader_t reader;
+    mpack_reader_init_data(&reader, (const char *)frame + YA_FRAME_PREFIX_SIZE + size.headerSize, size.bodySize);
+    TEST_ASSERT_EQUAL(9, mpack_expect_array(&reader));
+    for (int i = 0; i < 8; i++) {
+        mpack_discard(&reader);
+    }
+    TEST_ASSERT_TRUE(mpack_expect_u64(&reader) == resp.session_token);
+    mpack_done_array(&reader);
+    TEST_ASSERT_EQUAL(mpack_ok, mpack_reader_destroy(&reader));
+
+    // 旧客户端仍然是8个字段
+    resp.client_version = 3;
+    frame_len = ya_serialize_event_to(&event, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(frame_len > 0);
+    ya_decode_package_size(frame, (size_t)frame_len, &size);
+    mpack_reader_init_data(&reader, (const char *)frame + YA_FRAME_PREFIX_SIZE + size.headerSize, size.bodySize);
+    TEST_ASSERT_EQUAL(8, mpack_expect_array(&reader));
+    mpack_reader_destroy(&reader);
+}
+
+void test_mouse_move_batch_round_trip(void)
+{
+    // 批量采样：[dt_us, dx, dy, ...] 扁平数组，内联解析
+    YAMouseMoveBatchEventRequest batch = {.count = 3};
+    for (uint32_t i = 0; i < batch.count; i++) {
+        batch.samples[i].dt_us = 4000 * i;
+        batch.samples[i].dx = 150 + (int32_t)i;
+        batch.samples[i].dy = -20 - (int32_t)i;
+    }
+
+    YAEvent event = {0};
+    event.header.type = MOUSE_MOVE_BATCH;
+    event.header.direction = REQUEST;
+    event.header.uid = 1;
+    event.header.index = 9;
+    event.param = &batch;
+    event.param_len = sizeof(batch);
+
+    struct evbuffer *buf = evbuffer_new();
+    TEST_ASSERT_TRUE(ya_serialize_event_to_evbuffer(&event, buf) > 0);
+
+    YAPackageSize size = {0};
+    ya_get_package_size(buf, &size);
+    evbuffer_drain(buf, YA_FRAME_PREFIX_SIZE);
+
+    YAEvent parsed = {0};
+    TEST_ASSERT_EQUAL(0, ya_parse_event_inline(buf, &parsed, &size));
+    TEST_ASSERT_EQUAL(MOUSE_MOVE_BATCH, parsed.header.type);
+    TEST_ASSERT_EQUAL_PTR(&parsed.inline_param, parsed.param);
+    TEST_ASSERT_EQUAL_UINT32(3, parsed.inline_param.mouse_batch.count);
+    TEST_ASSERT_EQUAL_UINT32(8000, parsed.inline_param.mouse_batch.samples[2].dt_us);
+    TEST_ASSERT_EQUAL(152, parsed.inline_param.mouse_batch.samples[2].dx);
+    TEST_ASSERT_EQUAL(-22, parsed.inline_param.mouse_batch.samples[2].dy);
+    ya_free_event_param(&parsed);
+
+    // 元素个数不是3的倍数时解析失败
+    char *header_data = NULL;
+    size_t header_size = 0;
+    create_event_header_msgpack(1, MOUSE_MOVE_BATCH, REQUEST, 10, &header_data, &header_size);
+    char *body_data = NULL;
+    size_t body_size = 0;
+    mpack_writer_t writer;
+    mpack_writer_init_growable(&writer, &body_data, &body_size);
+    mpack_start_array(&writer, 2);
+    mpack_write_u32(&writer, 0);
+    mpack_write_i32(&writer, 1);
+    mpack_finish_array(&writer);
+    mpack_writer_destroy(&writer);
+
+    evbuffer_add(buf, header_data, header_size);
+    evbuffer_add(buf, body_data, body_size);
+    YAPackageSize bad = {.totalSize = (uint32_t)(header_size + body_size + 4),
+                         .headerSize = (uint32_t)header_size,
+                         .bodySize = (uint32_t)body_size};
+    memset(&parsed, 0, sizeof(parsed));
+    TEST_ASSERT_EQUAL(-1, ya_parse_event_inline(buf, &parsed, &bad));
+    ya_free_event_param(&parsed);
+
+    free(header_data);
+    free(body_data);
+    evbuffer_free(buf);
+}
+
+void test_ya_decode_frame_span(void)
+{
+    // 直接在连续内存上解码完整帧
+    YACommonEventRequest move = {12, -34};
+    YAEvent event = {0};
+    event.header.type = MOUSE_MOVE;
+    event.header.direction = REQUEST;
+    event.header.uid = 5;
+    event.header.index = 6;
+    event.param = &move;
+    event.param_len = sizeof(move);
+
+    uint8_t frame[YA_EVENT_FRAME_STACK_SIZE];
+    int frame_len = ya_serialize_event_to(&event, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(frame_len > 0);
+
+    YAEvent decoded = {0};
+    TEST_ASSERT_EQUAL(frame_len, ya_decode_frame(frame, frame_len, &decoded));
+    TEST_ASSERT_EQUAL(MOUSE_MOVE, decoded.header.type);
+    TEST_ASSERT_EQUAL_UINT32(5, decoded.header.uid);
+    TEST_ASSERT_EQUAL_UINT32(6, decoded.header.index);
+    TEST_ASSERT_EQUAL_PTR(&decoded.inline_param, decoded.param);
+    TEST_ASSERT_EQUAL(12, decoded.inline_param.common.lparam);
+    TEST_ASSERT_EQUAL(-34, decoded.inline_param.common.rparam);
+    ya_free_event_param(&decoded);
+
+    // 半帧返回0
+    memset(&decoded, 0, sizeof(decoded));
+    TEST_ASSERT_EQUAL(0, ya_decode_frame(frame, 4, &decoded));
+    TEST_ASSERT_EQUAL(0, ya_decode_frame(frame, frame_len - 1, &decoded));
+
+    // 头部长度超过总长度
+    frame[7] = 0xFF;
+    TEST_ASSERT_EQUAL(-1, ya_decode_frame(frame, frame_len, &decoded));
+}
+
+void test_ya_decode_package_size_span(void)
+{
+    // 长度前缀解码不依赖 evbuffer
+    uint8_t prefix[YA_FRAME_PREFIX_SIZE] = {0, 0, 0, 100, 0, 0, 0, 20};
+    YAPackageSize info = {0};
+    TEST_ASSERT_EQUAL(YA_FRAME_PREFIX_SIZE, ya_decode_package_size(prefix, sizeof(prefix), &info));
+    TEST_ASSERT_EQUAL_UINT32(100, info.totalSize);
+    TEST_ASSERT_EQUAL_UINT32(20, info.headerSize);
+    TEST_ASSERT_EQUAL_UINT32(76, info.bodySize);
+
+    // 不足8字节
+    TEST_ASSERT_EQUAL(0, ya_decode_package_size(prefix, 7, &info));
+
+    // 头部长度超过总长度
+    prefix[7] = 100;
+    TEST_ASSERT_EQUAL(-1, ya_decode_package_size(prefix, sizeof(prefix), &info));
+}
+
+void test_ya_decode_event_header_span(void)
+{
+    // 头部后面跟着 body 时只消费头部
+    uint8_t data[64];
+    mpack_writer_t writer;
+    mpack_writer_init(&writer, (char *)data, sizeof(data));
+    mpack_start_array(&writer, 4);
+    mpack_write_u32(&writer, 7);
+    mpack_write_u32(&writer, KEYBOARD);
+    mpack_write_u32(&writer, REQUEST);
+    mpack_write_u32(&writer, 9);
+    mpack_finish_array(&writer);
+    size_t header_len = mpack_writer_buffer_used(&writer);
+    mpack_write_u32(&writer, 42);
+    size_t total_len = mpack_writer_buffer_used(&writer);
+    TEST_ASSERT_EQUAL(mpack_ok, mpack_writer_destroy(&writer));
+
+    YAEventHeader header = {0};
+    TEST_ASSERT_EQUAL((int)header_len, ya_decode_event_header(data, total_len, &header));
+    TEST_ASSERT_EQUAL_UINT32(7, header.uid);
+    TEST_ASSERT_EQUAL(KEYBOARD, header.type);
+    TEST_ASSERT_EQUAL(REQUEST, header.direction);
+    TEST_ASSERT_EQUAL_UINT32(9, header.index);
+
+    // 截断的头部
+    TEST_ASSERT_EQUAL(-1, ya_decode_event_header(data, header_len - 1, &header));
+}
+
 void test_ya_serialize_event_text_input(void)
 {
     // 测试文本输入事件的序列化
@@ -392,7 +830,7 @@ void test_ya_free_event_param_simple(void)
 {
     // 测试释放简单参数
     YAEvent event = {0};
-    event.header.type = POWER;
+    event.header.type = HEARTBEAT;
     event.param = NULL;
     event.param_len = 0;
     
@@ -445,7 +883,7 @@ void test_event_types_basic(void)
     uint8_t *output = NULL;
     
     // 测试无参数事件类型
-    YAEventType no_param_types[] = {RESTART, POWER, HABERNATE};
+    YAEventType no_param_types[] = {MOUSE_STOP, HEARTBEAT};
     
     for (int i = 0; i < sizeof(no_param_types)/sizeof(no_param_types[0]); i++) {
         event.header.type = no_param_types[i];
@@ -472,7 +910,7 @@ void test_event_types_with_params(void)
     uint8_t *output = NULL;
     
     // 测试需要参数的事件类型
-    YAEventType param_types[] = {MOUSE_MOVE, MOUSE_CLICK, MOUSE_WHEEL, KEYBOARD};
+    YAEventType param_types[] = {MOUSE_MOVE, MOUSE_CLICK, MOUSE_WHEEL, MOUSE_SMOOTH_SCROLL};
     
     for (int i = 0; i < sizeof(param_types)/sizeof(param_types[0]); i++) {
         event.header.type = param_types[i];
@@ -511,10 +949,27 @@ void test_event_type_values(void)
     TEST_ASSERT_EQUAL(0x5, TEXT_INPUT);
     TEST_ASSERT_EQUAL(0x6, TEXT_GET);
     TEST_ASSERT_EQUAL(0x7, DISCOVER);
-    TEST_ASSERT_EQUAL(0x8, RESTART);
-    TEST_ASSERT_EQUAL(0x9, POWER);
+    TEST_ASSERT_EQUAL(0x8, MOUSE_STOP);
+    TEST_ASSERT_EQUAL(0x9, CONTROL);
     TEST_ASSERT_EQUAL(0xA, AUTHORIZE);
-    TEST_ASSERT_EQUAL(0xB, HABERNATE);
+    TEST_ASSERT_EQUAL(0xB, HEARTBEAT);
+    TEST_ASSERT_EQUAL(0xC, SESSION_OPTION);
+    TEST_ASSERT_EQUAL(0xD, MOUSE_MOVE_BATCH);
+    TEST_ASSERT_EQUAL(0xE, MOUSE_SMOOTH_SCROLL);
+}
+
+void test_event_type_names(void)
+{
+    // 类型名来自事件类型总表
+    TEST_ASSERT_EQUAL_STRING("MOUSE_MOVE", ya_event_type_name(MOUSE_MOVE));
+    TEST_ASSERT_EQUAL_STRING("AUTHORIZE", ya_event_type_name(AUTHORIZE));
+    TEST_ASSERT_EQUAL_STRING("MOUSE_SMOOTH_SCROLL", ya_event_type_name(MOUSE_SMOOTH_SCROLL));
+    TEST_ASSERT_EQUAL(MOUSE_SMOOTH_SCROLL + 1, YA_EVENT_TYPE_COUNT);
+
+    // 表外的值
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", ya_event_type_name(0));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", ya_event_type_name(YA_EVENT_TYPE_COUNT));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", ya_event_type_name(0xFFFFFFFFu));
 }
 
 void test_client_type_values(void)
@@ -668,10 +1123,10 @@ void test_ya_parse_event_complete_flow(void)
 {
     struct evbuffer *buf = evbuffer_new();
     
-    // 使用简单的POWER事件，没有参数，不容易出错
+    // 使用简单的HEARTBEAT事件，没有参数，不容易出错
     YAEvent event = {0};
     event.header.uid = 1234;
-    event.header.type = POWER;
+    event.header.type = HEARTBEAT;
     event.header.direction = REQUEST;
     event.header.index = 5;
     
@@ -693,11 +1148,11 @@ void test_ya_parse_event_complete_flow(void)
     
     // 验证解析结果
     TEST_ASSERT_EQUAL_UINT32(1234, parsed_event.header.uid);
-    TEST_ASSERT_EQUAL_INT(POWER, parsed_event.header.type);
+    TEST_ASSERT_EQUAL_INT(HEARTBEAT, parsed_event.header.type);
     TEST_ASSERT_EQUAL_INT(REQUEST, parsed_event.header.direction);
     TEST_ASSERT_EQUAL_UINT32(5, parsed_event.header.index);
     
-    // POWER事件没有参数
+    // HEARTBEAT事件没有参数
     TEST_ASSERT_NULL(parsed_event.param);
     
     ya_free_event_param(&parsed_event);
@@ -711,29 +1166,20 @@ void test_serialize_all_event_types(void)
     uint8_t *data = NULL;
     int len;
     
-    // 测试POWER事件（无payload）
-    YAEvent power_event = {0};
-    power_event.header.type = POWER;
-    power_event.header.direction = REQUEST;
-    len = ya_serialize_event(&power_event, &data);
-    TEST_ASSERT_GREATER_THAN(0, len);
-    free(data);
-    data = NULL;
-    
-    // 测试RESTART事件（无payload）
-    YAEvent restart_event = {0};
-    restart_event.header.type = RESTART;
-    restart_event.header.direction = REQUEST; 
-    len = ya_serialize_event(&restart_event, &data);
+    // 测试HEARTBEAT事件（无payload）
+    YAEvent heartbeat_event = {0};
+    heartbeat_event.header.type = HEARTBEAT;
+    heartbeat_event.header.direction = REQUEST;
+    len = ya_serialize_event(&heartbeat_event, &data);
     TEST_ASSERT_GREATER_THAN(0, len);
     free(data);
     data = NULL;
     
-    // 测试HABERNATE事件（无payload）
-    YAEvent habernate_event = {0};
-    habernate_event.header.type = HABERNATE;
-    habernate_event.header.direction = REQUEST;
-    len = ya_serialize_event(&habernate_event, &data);
+    // 测试MOUSE_STOP事件（无payload）
+    YAEvent stop_event = {0};
+    stop_event.header.type = MOUSE_STOP;
+    stop_event.header.direction = REQUEST; 
+    len = ya_serialize_event(&stop_event, &data);
     TEST_ASSERT_GREATER_THAN(0, len);
     free(data);
     data = NULL;
@@ -754,7 +1200,7 @@ void test_serialize_all_event_types(void)
     YAEvent keyboard_event = {0};
     keyboard_event.header.type = KEYBOARD;
     keyboard_event.header.direction = REQUEST;
-    YACommonEventRequest kb_req = {65, 0}; // 'A' key
+    YAKeyboardEventRequest kb_req = {65, 0, 0}; // 'A' key
     keyboard_event.param = &kb_req;
     keyboard_event.param_len = sizeof(kb_req);
     len = ya_serialize_event(&keyboard_event, &data);
@@ -772,7 +1218,7 @@ void test_get_serializer_parser_coverage(void)
     
     // 测试所有支持的事件类型
     YAEventType types[] = {MOUSE_MOVE, MOUSE_CLICK, MOUSE_WHEEL, KEYBOARD, TEXT_INPUT, 
-                           TEXT_GET, AUTHORIZE, DISCOVER, POWER, RESTART, HABERNATE};
+                           TEXT_GET, AUTHORIZE, DISCOVER, MOUSE_STOP, HEARTBEAT};
     int type_count = sizeof(types) / sizeof(types[0]);
     
     for (int i = 0; i < type_count; i++) {
@@ -782,6 +1228,7 @@ void test_get_serializer_parser_coverage(void)
         
         // 为需要参数的事件类型设置参数
         YACommonEventRequest common_req = {100, 200};
+        YAKeyboardEventRequest key_req = {65, 2, CHORD_MOD_SHIFT};
         YATextInputEventRequest text_req = {"test"};
         YAInputGetEventResponse text_resp = {"response"};  
         YAAuthorizeEventResponse auth_resp = {true, 1001};
@@ -791,10 +1238,13 @@ void test_get_serializer_parser_coverage(void)
         case MOUSE_MOVE:
         case MOUSE_CLICK:
         case MOUSE_WHEEL:
-        case KEYBOARD:
             event.param = &common_req;
             event.param_len = sizeof(common_req);
             break;
+        case KEYBOARD:
+            event.param = &key_req;
+            event.param_len = sizeof(key_req);
+            break;
         case TEXT_INPUT:
             event.param = &text_req;
             event.param_len = sizeof(text_req);
@@ -812,7 +1262,7 @@ void test_get_serializer_parser_coverage(void)
             event.param_len = sizeof(disc_resp);
             break;
         default:
-            // POWER, RESTART, HABERNATE 无参数
+            // MOUSE_STOP, HEARTBEAT 无参数
             break;
         }
         
@@ -1040,10 +1490,10 @@ void test_ya_parse_event_all_paths(void)
 {
     struct evbuffer *buf = evbuffer_new();
     
-    // 测试没有body的事件（POWER事件）
+    // 测试没有body的事件（HEARTBEAT事件）
     YAEvent no_body_event = {0};
     no_body_event.header.uid = 1111;
-    no_body_event.header.type = POWER;
+    no_body_event.header.type = HEARTBEAT;
     no_body_event.header.direction = REQUEST;
     no_body_event.header.index = 20;
     
@@ -1062,10 +1512,10 @@ void test_ya_parse_event_all_paths(void)
     TEST_ASSERT_EQUAL_INT(0, result);
     
     TEST_ASSERT_EQUAL_UINT32(1111, parsed.header.uid);
-    TEST_ASSERT_EQUAL_INT(POWER, parsed.header.type);
+    TEST_ASSERT_EQUAL_INT(HEARTBEAT, parsed.header.type);
     TEST_ASSERT_EQUAL_INT(REQUEST, parsed.header.direction);
     TEST_ASSERT_EQUAL_UINT32(20, parsed.header.index);
-    TEST_ASSERT_NULL(parsed.param); // POWER事件无参数
+    TEST_ASSERT_NULL(parsed.param); // HEARTBEAT事件无参数
     
     free(serialized);
     evbuffer_free(buf);
@@ -1089,12 +1539,12 @@ void test_comprehensive_round_trip(void)
         {AUTHORIZE, RESPONSE, true},
         {DISCOVER, REQUEST, true},
         {DISCOVER, RESPONSE, true},
-        {POWER, REQUEST, false},
-        {RESTART, REQUEST, false},
-        {HABERNATE, REQUEST, false}
+        {MOUSE_STOP, REQUEST, false},
+        {HEARTBEAT, REQUEST, false}
     };
     
     YACommonEventRequest common_req = {500, 600};
+    YAKeyboardEventRequest key_req = {66, 2, CHORD_MOD_CTRL};
     YATextInputEventRequest text_req = {"Round Trip Test"};
     YAInputGetEventResponse get_resp = {"Get Round Trip"};
     YAAuthorizeEventRequest auth_req = {CLIENT_ANDROID, 103};
@@ -1118,10 +1568,13 @@ void test_comprehensive_round_trip(void)
             case MOUSE_MOVE:
             case MOUSE_CLICK:
             case MOUSE_WHEEL:
-            case KEYBOARD:
                 original.param = &common_req;
                 original.param_len = sizeof(common_req);
                 break;
+            case KEYBOARD:
+                original.param = &key_req;
+                original.param_len = sizeof(key_req);
+                break;
             case TEXT_INPUT:
                 original.param = &text_req;
                 original.param_len = sizeof(text_req);
@@ -1148,9 +1601,7 @@ void test_comprehensive_round_trip(void)
                     original.param_len = sizeof(disc_resp);
                 }
                 break;
-            case POWER:
-            case RESTART:
-            case HABERNATE:
+            default:
                 // 这些无参数事件
                 break;
             }
@@ -1193,9 +1644,8 @@ void test_comprehensive_round_trip(void)
 void test_additional_enum_values(void)
 {
     // 测试额外的事件类型
-    TEST_ASSERT_EQUAL(0x8, RESTART);
-    TEST_ASSERT_EQUAL(0x9, POWER);
-    TEST_ASSERT_EQUAL(0xB, HABERNATE);
+    TEST_ASSERT_EQUAL(0x8, MOUSE_STOP);
+    TEST_ASSERT_EQUAL(0xB, HEARTBEAT);
     
     // 测试客户端类型
     TEST_ASSERT_EQUAL(0x1, CLIENT_IOS);
@@ -1208,22 +1658,11 @@ void test_additional_serialization_types(void)
     uint8_t *data = NULL;
     int len;
     
-    // 测试RESTART事件（无payload）
-    YAEvent restart_event = {0};
-    restart_event.header.type = RESTART;
-    restart_event.header.direction = REQUEST;
-    len = ya_serialize_event(&restart_event, &data);
-    TEST_ASSERT_GREATER_THAN(0, len);
-    if (data) {
-        free(data);
-        data = NULL;
-    }
-    
-    // 测试HABERNATE事件（无payload）
-    YAEvent hibernate_event = {0};
-    hibernate_event.header.type = HABERNATE;
-    hibernate_event.header.direction = REQUEST;
-    len = ya_serialize_event(&hibernate_event, &data);
+    // 测试MOUSE_STOP事件（无payload）
+    YAEvent stop_event = {0};
+    stop_event.header.type = MOUSE_STOP;
+    stop_event.header.direction = REQUEST;
+    len = ya_serialize_event(&stop_event, &data);
     TEST_ASSERT_GREATER_THAN(0, len);
     if (data) {
         free(data);
@@ -1234,7 +1673,7 @@ void test_additional_serialization_types(void)
     YAEvent keyboard_event = {0};
     keyboard_event.header.type = KEYBOARD;
     keyboard_event.header.direction = REQUEST;
-    YACommonEventRequest kb_req = {65, 1}; // 'A' key press
+    YAKeyboardEventRequest kb_req = {65, 1, 0}; // 'A' key release
     keyboard_event.param = &kb_req;
     keyboard_event.param_len = sizeof(kb_req);
     len = ya_serialize_event(&keyboard_event, &data);
@@ -1281,6 +1720,15 @@ int main(void)
     // Serialization tests
     RUN_TEST(test_ya_serialize_event_null_param);
     RUN_TEST(test_ya_serialize_event_common_request);
+    RUN_TEST(test_ya_serialize_event_to_matches_heap);
+    RUN_TEST(test_packed_record_round_trip);
+    RUN_TEST(test_packed_record_invalid);
+    RUN_TEST(test_pointer_datagram_round_trip);
+    RUN_TEST(test_authorize_response_session_token);
+    RUN_TEST(test_mouse_move_batch_round_trip);
+    RUN_TEST(test_ya_decode_frame_span);
+    RUN_TEST(test_ya_decode_package_size_span);
+    RUN_TEST(test_ya_decode_event_header_span);
     RUN_TEST(test_ya_serialize_event_text_input);
     RUN_TEST(test_ya_serialize_event_authorize_response);
     RUN_TEST(test_ya_serialize_event_discover_response);
@@ -1297,9 +1745,11 @@ int main(void)
     RUN_TEST(test_event_types_with_params);
     RUN_TEST(test_event_direction_values);
     RUN_TEST(test_event_type_values);
+    RUN_TEST(test_event_type_names);
     RUN_TEST(test_client_type_values);
     
     // Package size tests
+    RUN_TEST(test_ya_get_package_size_insufficient_data);
     RUN_TEST(test_ya_get_package_size_valid_data);
     
     // Parser tests - 暂时忽略有问题的测试
@@ -1311,6 +1761,8 @@ int main(void)
     RUN_TEST(test_ya_parse_event_insufficient_body_data);
     RUN_TEST(test_parse_invalid_msgpack_body);
     RUN_TEST(test_round_trip_serialization);
+    RUN_TEST(test_ya_parse_event_inline_common);
+    RUN_TEST(test_ya_parse_event_inline_text_input);
     
     // 添加简单安全的测试
     RUN_TEST(test_ya_parse_event_no_body);
@@ -0,0 +1,75 @@
+#include <unity.h>
+#include <string.h>
+#include "../src/ya_histogram.h"
+
+static ya_histogram_t histogram;
+static ya_histogram_snapshot_t snapshot;
+
+void setUp(void) {
+    memset(&histogram, 0, sizeof(histogram));
+}
+
+void tearDown(void) {
+}
+
+// 测试小值精确分桶，桶之间连续无重叠
+void test_histogram_buckets_contiguous(void) {
+    for (uint64_t v = 0; v < YA_HISTOGRAM_SUB_COUNT; v++) {
+        TEST_ASSERT_EQUAL(v, ya_histogram_bucket_index(v));
+        TEST_ASSERT_EQUAL_UINT64(v, ya_histogram_bucket_upper(v));
+    }
+
+    for (size_t i = 1; i + 1 < YA_HISTOGRAM_BUCKETS; i++) {
+        uint64_t upper = ya_histogram_bucket_upper(i);
+        TEST_ASSERT_EQUAL(i, ya_histogram_bucket_index(upper));
+        TEST_ASSERT_EQUAL(i + 1, ya_histogram_bucket_index(upper + 1));
+    }
+}
+
+// 测试相对误差不超过 1/YA_HISTOGRAM_SUB_COUNT，超出范围的值计入最后一个桶
+void test_histogram_relative_error(void) {
+    const uint64_t values[] = {9, 100, 1000, 12345, 999999, 50000000, 4000000000ull};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        uint64_t upper = ya_histogram_bucket_upper(ya_histogram_bucket_index(values[i]));
+        TEST_ASSERT_TRUE(upper >= values[i]);
+        TEST_ASSERT_TRUE(upper - values[i] <= values[i] / YA_HISTOGRAM_SUB_COUNT);
+    }
+
+    TEST_ASSERT_EQUAL(YA_HISTOGRAM_BUCKETS - 1, ya_histogram_bucket_index(1ull << YA_HISTOGRAM_MAX_BITS));
+    TEST_ASSERT_EQUAL(YA_HISTOGRAM_BUCKETS - 1, ya_histogram_bucket_index(UINT64_MAX));
+}
+
+// 测试计数、最值与分位数
+void test_histogram_percentiles(void) {
+    ya_histogram_snapshot(&histogram, &snapshot);
+    TEST_ASSERT_EQUAL_UINT64(0, snapshot.count);
+    TEST_ASSERT_EQUAL_UINT64(0, ya_histogram_percentile(&snapshot, 0.5));
+
+    for (uint64_t v = 1; v <= 1000; v++) {
+        ya_histogram_record(&histogram, v * 1000);
+    }
+
+    TEST_ASSERT_EQUAL_UINT64(1000, ya_histogram_count(&histogram));
+    ya_histogram_snapshot(&histogram, &snapshot);
+    TEST_ASSERT_EQUAL_UINT64(1000, snapshot.count);
+    TEST_ASSERT_EQUAL_UINT64(1000, snapshot.min);
+    TEST_ASSERT_EQUAL_UINT64(1000000, snapshot.max);
+    TEST_ASSERT_EQUAL_UINT64(500500000ull, snapshot.sum);
+
+    uint64_t p50 = ya_histogram_percentile(&snapshot, 0.50);
+    uint64_t p99 = ya_histogram_percentile(&snapshot, 0.99);
+    TEST_ASSERT_TRUE(p50 >= 500000 && p50 <= 500000 + 500000 / YA_HISTOGRAM_SUB_COUNT);
+    TEST_ASSERT_TRUE(p99 >= 990000 && p99 <= 1000000);
+    TEST_ASSERT_EQUAL_UINT64(1000000, ya_histogram_percentile(&snapshot, 1.0));
+    TEST_ASSERT_EQUAL_UINT64(1000, ya_histogram_percentile(&snapshot, 0.0));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_histogram_buckets_contiguous);
+    RUN_TEST(test_histogram_relative_error);
+    RUN_TEST(test_histogram_percentiles);
+
+    return UNITY_END();
+}
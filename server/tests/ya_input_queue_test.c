@@ -0,0 +1,232 @@
+#include <unity.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <event2/event.h>
+#include "../src/ya_config.h"
+#include "../src/ya_input_queue.h"
+
+YA_Config config;  // 默认执行器的剪贴板回退读取 [clipboard] 配置
+
+#define RECORD_MAX 4096
+
+// 注入线程上执行的动作记录
+static ya_input_action_type_t recorded_types[RECORD_MAX];
+static int32_t recorded_dx[RECORD_MAX];
+static char recorded_text[64];
+static atomic_int recorded;
+static atomic_bool gate_closed;
+static pthread_t executor_thread;
+
+static void record_execute(const ya_input_action_t *action) {
+    // gate_closed 时阻塞第一个动作，模拟按键时序等待把注入线程占住
+    while (atomic_load(&gate_closed)) {
+        usleep(100);
+    }
+
+    int n = atomic_load(&recorded);
+    if (n < RECORD_MAX) {
+        recorded_types[n] = action->type;
+        recorded_dx[n] = action->type == YA_INPUT_MOVE ? action->move.dx : 0;
+        if (action->type == YA_INPUT_TEXT) {
+            strncpy(recorded_text, action->text.text, sizeof(recorded_text) - 1);
+        }
+    }
+    if (action->type == YA_INPUT_TEXT_GET) {
+        ya_input_queue_complete_text(action, strdup("selected"));
+    }
+    executor_thread = pthread_self();
+    atomic_store(&recorded, n + 1);
+}
+
+void setUp(void) {
+    atomic_store(&recorded, 0);
+    atomic_store(&gate_closed, false);
+    memset(recorded_text, 0, sizeof(recorded_text));
+    TEST_ASSERT_EQUAL(0, ya_input_queue_start(record_execute));
+}
+
+void tearDown(void) {
+    atomic_store(&gate_closed, false);
+    ya_input_queue_stop();
+}
+
+static void push_move(int32_t dx, int32_t dy) {
+    ya_input_action_t action = {.type = YA_INPUT_MOVE, .move = {dx, dy}};
+    TEST_ASSERT_TRUE(ya_input_queue_push(&action));
+}
+
+// 测试动作按放入顺序在注入线程上执行，drain 返回时全部执行完毕
+void test_input_queue_order_and_drain(void) {
+    push_move(1, 0);
+    ya_input_action_t button = {.type = YA_INPUT_BUTTON, .button = {.button = Left, .dir = Press}};
+    TEST_ASSERT_TRUE(ya_input_queue_push(&button));
+    ya_input_action_t key = {.type = YA_INPUT_KEY_CHAR, .key_char = {.codepoint = 'a', .dir = Click}};
+    TEST_ASSERT_TRUE(ya_input_queue_push(&key));
+    push_move(2, 0);
+
+    ya_input_queue_drain();
+    TEST_ASSERT_EQUAL(4, atomic_load(&recorded));
+    TEST_ASSERT_EQUAL(YA_INPUT_MOVE, recorded_types[0]);
+    TEST_ASSERT_EQUAL(YA_INPUT_BUTTON, recorded_types[1]);
+    TEST_ASSERT_EQUAL(YA_INPUT_KEY_CHAR, recorded_types[2]);
+    TEST_ASSERT_EQUAL(YA_INPUT_MOVE, recorded_types[3]);
+    TEST_ASSERT_EQUAL_INT32(2, recorded_dx[3]);
+    TEST_ASSERT_FALSE(pthread_equal(executor_thread, pthread_self()));
+}
+
+// 测试注入线程被占住时 push 不阻塞调用方
+void test_input_queue_push_does_not_wait_for_execution(void) {
+    atomic_store(&gate_closed, true);
+    for (int i = 0; i < 100; i++) {
+        push_move(1, 0);
+    }
+    TEST_ASSERT_EQUAL(0, atomic_load(&recorded));
+
+    atomic_store(&gate_closed, false);
+    ya_input_queue_drain();
+    TEST_ASSERT_EQUAL(100, atomic_load(&recorded));
+    TEST_ASSERT_TRUE(ya_input_queue_max_depth() >= 99);
+}
+
+// 测试队列满时移动被合并而不是丢失
+void test_input_queue_full_coalesces_moves(void) {
+    atomic_store(&gate_closed, true);
+    int total = YA_INPUT_QUEUE_CAPACITY + 500;
+    for (int i = 0; i < total; i++) {
+        push_move(1, 0);
+    }
+
+    atomic_store(&gate_closed, false);
+    ya_input_queue_drain();
+
+    int n = atomic_load(&recorded);
+    TEST_ASSERT_TRUE(n <= YA_INPUT_QUEUE_CAPACITY + 1);
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += recorded_dx[i];
+    }
+    TEST_ASSERT_EQUAL(total, sum);
+    TEST_ASSERT_EQUAL_UINT64(0, ya_input_queue_dropped());
+}
+
+// 测试队列满时合并的位移在之后没有新输入的情况下也会被执行
+void test_input_queue_pending_move_injected_without_new_input(void) {
+    atomic_store(&gate_closed, true);
+    int total = YA_INPUT_QUEUE_CAPACITY + 10;
+    for (int i = 0; i < total; i++) {
+        push_move(1, 0);
+    }
+
+    // 不再放入任何动作，也不调用 drain
+    atomic_store(&gate_closed, false);
+    int sum = 0;
+    for (int waited = 0; waited < 2000 && sum < total; waited++) {
+        usleep(1000);
+        sum = 0;
+        int n = atomic_load(&recorded);
+        for (int i = 0; i < n && i < RECORD_MAX; i++) {
+            sum += recorded_dx[i];
+        }
+    }
+    TEST_ASSERT_EQUAL(total, sum);
+}
+
+// 测试文本由队列接管：调用方放入后即可释放自己的缓冲区
+void test_input_queue_text_ownership(void) {
+    char *text = strdup("hello");
+    ya_input_action_t action = {.type = YA_INPUT_TEXT, .text = {text}};
+    TEST_ASSERT_TRUE(ya_input_queue_push(&action));
+
+    ya_input_queue_drain();
+    TEST_ASSERT_EQUAL(1, atomic_load(&recorded));
+    TEST_ASSERT_EQUAL_STRING("hello", recorded_text);
+}
+
+// TEXT_GET 结果回调记录
+static uint32_t result_owner;
+static uint32_t result_index;
+static char *result_text;
+static pthread_t result_thread;
+
+static void record_text_result(uint32_t owner, uint32_t index, char *text) {
+    result_owner = owner;
+    result_index = index;
+    result_text = text;
+    result_thread = pthread_self();
+}
+
+// 测试 TEXT_GET 在注入线程上执行，结果在事件循环线程上交回
+void test_input_queue_text_get_result_on_loop(void) {
+    struct event_base *base = event_base_new();
+    TEST_ASSERT_NOT_NULL(base);
+    TEST_ASSERT_EQUAL(0, ya_input_queue_attach(base, record_text_result));
+    result_text = NULL;
+
+    ya_input_action_t action = {.type = YA_INPUT_TEXT_GET, .text_get = {.owner = 7, .index = 42}};
+    TEST_ASSERT_TRUE(ya_input_queue_push(&action));
+    ya_input_queue_drain();
+    TEST_ASSERT_NULL(result_text);
+
+    event_base_loop(base, EVLOOP_ONCE | EVLOOP_NONBLOCK);
+    TEST_ASSERT_NOT_NULL(result_text);
+    TEST_ASSERT_EQUAL_STRING("selected", result_text);
+    TEST_ASSERT_EQUAL_UINT32(7, result_owner);
+    TEST_ASSERT_EQUAL_UINT32(42, result_index);
+    TEST_ASSERT_TRUE(pthread_equal(result_thread, pthread_self()));
+    free(result_text);
+
+    ya_input_queue_detach();
+    event_base_free(base);
+}
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+// 测试队列满时非移动动作立即丢弃，不在调用线程上等待
+void test_input_queue_full_drops_without_waiting(void) {
+    atomic_store(&gate_closed, true);
+    for (int i = 0; i < YA_INPUT_QUEUE_CAPACITY; i++) {
+        push_move(1, 0);
+    }
+
+    uint64_t dropped = ya_input_queue_dropped();
+    ya_input_action_t button = {.type = YA_INPUT_BUTTON, .button = {.button = Left, .dir = Click}};
+    uint64_t start = now_ms();
+    TEST_ASSERT_FALSE(ya_input_queue_push(&button));
+    TEST_ASSERT_TRUE(now_ms() - start < 50);
+    TEST_ASSERT_EQUAL_UINT64(dropped + 1, ya_input_queue_dropped());
+
+    atomic_store(&gate_closed, false);
+}
+
+// 测试重复启动和空参数
+void test_input_queue_invalid_params(void) {
+    TEST_ASSERT_EQUAL(-1, ya_input_queue_start(record_execute));
+    TEST_ASSERT_FALSE(ya_input_queue_push(NULL));
+
+    ya_input_queue_stop();
+    TEST_ASSERT_EQUAL(-1, ya_input_queue_start(NULL));
+    TEST_ASSERT_EQUAL(0, ya_input_queue_start(record_execute));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_input_queue_order_and_drain);
+    RUN_TEST(test_input_queue_push_does_not_wait_for_execution);
+    RUN_TEST(test_input_queue_full_coalesces_moves);
+    RUN_TEST(test_input_queue_pending_move_injected_without_new_input);
+    RUN_TEST(test_input_queue_text_ownership);
+    RUN_TEST(test_input_queue_text_get_result_on_loop);
+    RUN_TEST(test_input_queue_full_drops_without_waiting);
+    RUN_TEST(test_input_queue_invalid_params);
+
+    return UNITY_END();
+}
@@ -0,0 +1,214 @@
+#include <unity.h>
+#include <string.h>
+#include <time.h>
+#include "../src/ya_config.h"
+#include "../src/input/keyboard/sequencer.h"
+
+YA_Config config;  // key_sequencer_init 读取 [input] 配置
+
+#define RECORD_MAX 64
+
+// 记录执行的按键步骤
+static key_step_t recorded[RECORD_MAX];
+static uint64_t recorded_ms[RECORD_MAX];
+static int recorded_count;
+static uint32_t fail_code;  // 执行到该 code 的按下时返回错误（0 = 不出错）
+
+static uint64_t now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000ull + (uint64_t)now.tv_nsec / 1000000ull;
+}
+
+static YAError record_step(const key_step_t *step) {
+    if (fail_code != 0 && step->code == fail_code && step->dir != Release) {
+        return PlatformError;
+    }
+    if (recorded_count < RECORD_MAX) {
+        recorded[recorded_count] = *step;
+        recorded_ms[recorded_count] = now_ms();
+        recorded_count++;
+    }
+    return Success;
+}
+
+// Shift 按下 → A 单击 → Shift 释放
+static void build_shift_a(key_program_t *program) {
+    key_program_init(program);
+    int shift = key_program_add(program, KEY_STEP_KEY, Shift, Press, true);
+    key_program_add(program, KEY_STEP_KEY, A, Click, true);
+    program->release_from = program->count;
+    key_program_add_release(program, shift, true);
+}
+
+void setUp(void) {
+    memset(recorded, 0, sizeof(recorded));
+    recorded_count = 0;
+    fail_code = 0;
+    key_sequencer_set_executor(record_step);
+    key_sequencer_set_step_delay_ms(0);
+}
+
+void tearDown(void) {
+    key_sequencer_flush();
+    key_sequencer_set_executor(NULL);
+    key_sequencer_set_step_delay_ms(KEY_STEP_DEFAULT_DELAY_MS);
+}
+
+// 测试配置解析
+void test_sequencer_delay_from_config(void) {
+    ya_config_init(&config);
+    key_sequencer_init();
+    TEST_ASSERT_EQUAL(0, key_sequencer_step_delay_ms());
+
+    ya_config_set(&config, "input", "key_step_delay_ms", "25");
+    key_sequencer_init();
+    TEST_ASSERT_EQUAL(25, key_sequencer_step_delay_ms());
+
+    ya_config_set(&config, "input", "key_step_delay_ms", "-3");
+    key_sequencer_init();
+    TEST_ASSERT_EQUAL(KEY_STEP_DEFAULT_DELAY_MS, key_sequencer_step_delay_ms());
+
+    ya_config_set(&config, "input", "key_step_delay_ms", "0");
+    key_sequencer_init();
+    TEST_ASSERT_EQUAL(0, key_sequencer_step_delay_ms());
+    ya_config_free(&config);
+}
+
+// 测试 0 ms 间隔时提交即全部执行
+void test_sequencer_zero_delay_runs_immediately(void) {
+    key_program_t program;
+    build_shift_a(&program);
+
+    TEST_ASSERT_EQUAL(Success, key_sequencer_submit(&program));
+    TEST_ASSERT_EQUAL(3, recorded_count);
+    TEST_ASSERT_TRUE(key_sequencer_idle());
+    TEST_ASSERT_EQUAL(-1, key_sequencer_run_due());
+
+    TEST_ASSERT_EQUAL(Shift, recorded[0].code);
+    TEST_ASSERT_EQUAL(Press, recorded[0].dir);
+    TEST_ASSERT_EQUAL(A, recorded[1].code);
+    TEST_ASSERT_EQUAL(Click, recorded[1].dir);
+    TEST_ASSERT_EQUAL(Shift, recorded[2].code);
+    TEST_ASSERT_EQUAL(Release, recorded[2].dir);
+}
+
+// 测试提交不等待：后续步骤在到期后才执行
+void test_sequencer_submit_does_not_sleep(void) {
+    key_sequencer_set_step_delay_ms(20);
+    key_program_t program;
+    build_shift_a(&program);
+
+    uint64_t start = now_ms();
+    TEST_ASSERT_EQUAL(Success, key_sequencer_submit(&program));
+    TEST_ASSERT_TRUE(now_ms() - start < 10);
+    TEST_ASSERT_EQUAL(1, recorded_count);
+    TEST_ASSERT_FALSE(key_sequencer_idle());
+
+    int wait_ms = key_sequencer_run_due();
+    TEST_ASSERT_TRUE(wait_ms > 0 && wait_ms <= 20);
+    TEST_ASSERT_EQUAL(1, recorded_count);
+
+    key_sequencer_flush();
+    TEST_ASSERT_EQUAL(3, recorded_count);
+    TEST_ASSERT_TRUE(recorded_ms[1] - recorded_ms[0] >= 19);
+    TEST_ASSERT_TRUE(recorded_ms[2] - recorded_ms[1] >= 19);
+    TEST_ASSERT_TRUE(key_sequencer_idle());
+}
+
+// 测试连续字符流水执行：下一个程序紧接上一个程序的最后一步
+void test_sequencer_pipelines_programs(void) {
+    key_sequencer_set_step_delay_ms(15);
+    key_program_t program;
+    build_shift_a(&program);
+
+    uint64_t start = now_ms();
+    TEST_ASSERT_EQUAL(Success, key_sequencer_submit(&program));
+    TEST_ASSERT_EQUAL(Success, key_sequencer_submit(&program));
+    TEST_ASSERT_TRUE(recorded_count <= 1);
+
+    key_sequencer_flush();
+    TEST_ASSERT_EQUAL(6, recorded_count);
+    for (int i = 1; i < 6; i++) {
+        TEST_ASSERT_TRUE(recorded_ms[i] - recorded_ms[i - 1] >= 14);
+    }
+    // 5 个间隔，第二个程序没有额外等待
+    TEST_ASSERT_TRUE(recorded_ms[5] - start < 5 * 15 + 40);
+}
+
+// 测试按下阶段失败：跳过剩余按下步骤，只释放已按下的键
+void test_sequencer_failure_releases_pressed(void) {
+    key_program_t program;
+    key_program_init(&program);
+    int shift = key_program_add(&program, KEY_STEP_KEY, Shift, Press, true);
+    int ctrl = key_program_add(&program, KEY_STEP_KEY, Control, Press, true);
+    key_program_add(&program, KEY_STEP_KEY, A, Click, true);
+    program.release_from = program.count;
+    key_program_add_release(&program, ctrl, true);
+    key_program_add_release(&program, shift, true);
+
+    fail_code = Control;
+    uint64_t errors = key_sequencer_step_errors(PlatformError);
+    key_sequencer_set_step_delay_ms(5);
+    TEST_ASSERT_EQUAL(Success, key_sequencer_submit(&program));
+    TEST_ASSERT_EQUAL(1, key_sequencer_depth());
+    key_sequencer_flush();
+    TEST_ASSERT_EQUAL(0, key_sequencer_depth());
+    TEST_ASSERT_EQUAL_UINT64(errors + 1, key_sequencer_step_errors(PlatformError));
+    TEST_ASSERT_EQUAL_UINT64(0, key_sequencer_step_errors(Success));
+
+    TEST_ASSERT_EQUAL(2, recorded_count);
+    TEST_ASSERT_EQUAL(Shift, recorded[0].code);
+    TEST_ASSERT_EQUAL(Press, recorded[0].dir);
+    TEST_ASSERT_EQUAL(Shift, recorded[1].code);
+    TEST_ASSERT_EQUAL(Release, recorded[1].dir);
+}
+
+// 测试同步执行：包含最后一步之后的间隔
+void test_sequencer_run_sync(void) {
+    key_sequencer_set_step_delay_ms(10);
+    key_program_t program;
+    build_shift_a(&program);
+
+    uint64_t start = now_ms();
+    TEST_ASSERT_EQUAL(Success, key_sequencer_run_sync(&program));
+    TEST_ASSERT_EQUAL(3, recorded_count);
+    TEST_ASSERT_TRUE(now_ms() - start >= 29);
+    TEST_ASSERT_TRUE(key_sequencer_idle());
+
+    fail_code = A;
+    recorded_count = 0;
+    TEST_ASSERT_EQUAL(PlatformError, key_sequencer_run_sync(&program));
+    TEST_ASSERT_EQUAL(2, recorded_count);
+    TEST_ASSERT_EQUAL(Release, recorded[1].dir);
+}
+
+// 测试非法程序
+void test_sequencer_invalid_program(void) {
+    key_program_t program;
+    key_program_init(&program);
+    TEST_ASSERT_EQUAL(InvalidInput, key_sequencer_submit(NULL));
+    TEST_ASSERT_EQUAL(InvalidInput, key_sequencer_submit(&program));
+    TEST_ASSERT_EQUAL(InvalidInput, key_sequencer_run_sync(&program));
+    TEST_ASSERT_EQUAL(-1, key_program_add_release(&program, 0, false));
+
+    for (int i = 0; i < KEY_PROGRAM_MAX_STEPS; i++) {
+        TEST_ASSERT_EQUAL(i, key_program_add(&program, KEY_STEP_KEY, A, Click, false));
+    }
+    TEST_ASSERT_EQUAL(-1, key_program_add(&program, KEY_STEP_KEY, A, Click, false));
+    TEST_ASSERT_TRUE(key_sequencer_idle());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_sequencer_delay_from_config);
+    RUN_TEST(test_sequencer_zero_delay_runs_immediately);
+    RUN_TEST(test_sequencer_submit_does_not_sleep);
+    RUN_TEST(test_sequencer_pipelines_programs);
+    RUN_TEST(test_sequencer_failure_releases_pressed);
+    RUN_TEST(test_sequencer_run_sync);
+    RUN_TEST(test_sequencer_invalid_program);
+
+    return UNITY_END();
+}
@@ -0,0 +1,74 @@
+#include <unity.h>
+#include "../src/ya_event.h"
+#include "../src/ya_latency.h"
+
+void setUp(void) {
+    ya_latency_reset();
+}
+
+void tearDown(void) {
+}
+
+// 测试解码、分发两段在交给处理函数时记录
+void test_latency_begin_event(void) {
+    uint64_t now = ya_latency_now_ns();
+    ya_latency_begin_event(MOUSE_MOVE, now - 5000, now - 2000);
+
+    ya_histogram_snapshot_t decode, dispatch;
+    ya_histogram_snapshot(ya_latency_histogram(MOUSE_MOVE, YA_LATENCY_DECODE), &decode);
+    ya_histogram_snapshot(ya_latency_histogram(MOUSE_MOVE, YA_LATENCY_DISPATCH), &dispatch);
+    TEST_ASSERT_EQUAL_UINT64(1, decode.count);
+    TEST_ASSERT_EQUAL_UINT64(3000, decode.max);
+    TEST_ASSERT_EQUAL_UINT64(1, dispatch.count);
+    TEST_ASSERT_TRUE(dispatch.max >= 2000);
+
+    ya_latency_origin_t origin = ya_latency_current_origin();
+    TEST_ASSERT_EQUAL_UINT32(MOUSE_MOVE, origin.type);
+    TEST_ASSERT_EQUAL_UINT64(now - 5000, origin.readable_ns);
+    TEST_ASSERT_TRUE(origin.dispatch_ns >= now);
+
+    ya_latency_end_event();
+    TEST_ASSERT_EQUAL_UINT64(0, ya_latency_current_origin().readable_ns);
+}
+
+// 测试注入完成后记录注入段和总延迟
+void test_latency_record_injected(void) {
+    uint64_t now = ya_latency_now_ns();
+    ya_latency_origin_t origin = {.type = KEYBOARD, .readable_ns = now - 10000, .dispatch_ns = now - 4000};
+    ya_latency_record_injected(&origin);
+
+    ya_histogram_snapshot_t inject, total;
+    ya_histogram_snapshot(ya_latency_histogram(KEYBOARD, YA_LATENCY_INJECT), &inject);
+    ya_histogram_snapshot(ya_latency_histogram(KEYBOARD, YA_LATENCY_TOTAL), &total);
+    TEST_ASSERT_EQUAL_UINT64(1, inject.count);
+    TEST_ASSERT_TRUE(inject.min >= 4000);
+    TEST_ASSERT_EQUAL_UINT64(1, total.count);
+    TEST_ASSERT_TRUE(total.min >= 10000);
+    TEST_ASSERT_EQUAL_UINT64(0, ya_histogram_count(ya_latency_histogram(MOUSE_MOVE, YA_LATENCY_TOTAL)));
+}
+
+// 测试未记录时刻的事件和动作不统计
+void test_latency_untimed(void) {
+    ya_latency_begin_event(MOUSE_CLICK, 0, 0);
+    TEST_ASSERT_EQUAL_UINT64(0, ya_latency_current_origin().readable_ns);
+    TEST_ASSERT_EQUAL_UINT64(0, ya_histogram_count(ya_latency_histogram(MOUSE_CLICK, YA_LATENCY_DECODE)));
+
+    ya_latency_origin_t origin = {0};
+    ya_latency_record_injected(&origin);
+    ya_latency_record_injected(NULL);
+    TEST_ASSERT_EQUAL_UINT64(0, ya_histogram_count(ya_latency_histogram(MOUSE_CLICK, YA_LATENCY_TOTAL)));
+
+    TEST_ASSERT_NULL(ya_latency_histogram(YA_EVENT_TYPE_COUNT, YA_LATENCY_DECODE));
+    TEST_ASSERT_NULL(ya_latency_histogram(MOUSE_MOVE, YA_LATENCY_STAGE_COUNT));
+    TEST_ASSERT_EQUAL_STRING("total", ya_latency_stage_name(YA_LATENCY_TOTAL));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_latency_begin_event);
+    RUN_TEST(test_latency_record_injected);
+    RUN_TEST(test_latency_untimed);
+
+    return UNITY_END();
+}
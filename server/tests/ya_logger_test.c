@@ -1,3 +1,7 @@
+// 本测试验证运行时 TRACE 输出，不受发布构建的编译期级别影响
+#undef YA_LOG_COMPILED_LEVEL
+#define YA_LOG_COMPILED_LEVEL 0
+
 #include "unity.h"
 #include "ya_logger.h"
 #include <stdio.h>
@@ -7,6 +11,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <pthread.h>
 
 // 测试日志文件路径
 #define TEST_LOG_FILE "/tmp/test.log"
@@ -512,6 +517,217 @@ void test_logger_formatting(void) {
     ya_logger_destroy(logger);
 }
 
+static int evaluated_args;
+
+static int count_evaluation(void) {
+    return ++evaluated_args;
+}
+
+// 测试宏在级别不满足时不求值参数，全局级别随 init/set_level/destroy 更新
+void test_logger_level_short_circuit(void) {
+    ya_logger_config_t config = {
+        .level = YA_LOG_LEVEL_INFO,
+        .log_file = NULL,
+        .use_console = 0,
+        .use_system_log = 0,
+    };
+
+    ya_logger_t* logger = ya_logger_init(&config);
+    TEST_ASSERT_NOT_NULL(logger);
+    TEST_ASSERT_EQUAL(YA_LOG_LEVEL_INFO, atomic_load(&g_log_level));
+    TEST_ASSERT_FALSE(ya_log_enabled(YA_LOG_LEVEL_DEBUG));
+    TEST_ASSERT_TRUE(ya_log_enabled(YA_LOG_LEVEL_INFO));
+
+    evaluated_args = 0;
+    YA_LOG_TRACE("skipped %d", count_evaluation());
+    YA_LOG_DEBUG("skipped %d", count_evaluation());
+    YA_LOG_IF(YA_LOG_LEVEL_DEBUG, count_evaluation() > 0, "skipped");
+    TEST_ASSERT_EQUAL_INT(0, evaluated_args);
+    YA_LOG_INFO("evaluated %d", count_evaluation());
+    TEST_ASSERT_EQUAL_INT(1, evaluated_args);
+
+    ya_logger_set_level(logger, YA_LOG_LEVEL_TRACE);
+    TEST_ASSERT_TRUE(ya_log_enabled(YA_LOG_LEVEL_TRACE));
+    YA_LOG_TRACE("evaluated %d", count_evaluation());
+    TEST_ASSERT_EQUAL_INT(2, evaluated_args);
+
+    // OFF 级别从不输出；销毁全局实例后全部关闭
+    TEST_ASSERT_FALSE(ya_log_enabled(YA_LOG_LEVEL_OFF));
+    ya_logger_destroy(logger);
+    TEST_ASSERT_NULL(g_logger);
+    TEST_ASSERT_FALSE(ya_log_enabled(YA_LOG_LEVEL_FATAL));
+}
+
+// 统计文件中包含 pattern 的行数
+static int count_lines_with(const char* path, const char* pattern) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        return 0;
+    }
+    char line[1024];
+    int count = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (strstr(line, pattern)) {
+            count++;
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+// 测试异步模式：销毁时写完队列，顺序不变，超长消息截断
+void test_logger_async_write(void) {
+    ya_logger_config_t config = {
+        .level = YA_LOG_LEVEL_DEBUG,
+        .log_file = TEST_LOG_FILE,
+        .use_console = 0,
+        .use_system_log = 0,
+        .max_file_size = 1024 * 1024,
+        .max_backup_files = 1,
+        .async = 1,
+        .async_queue_size = 100,
+    };
+
+    ya_logger_t* logger = ya_logger_init(&config);
+    TEST_ASSERT_NOT_NULL(logger);
+    TEST_ASSERT_NOT_NULL(logger->async);
+
+    for (int i = 0; i < 50; i++) {
+        YA_LOG_INFO("async message %02d", i);
+    }
+    YA_LOG_TRACE("async filtered");
+
+    char long_message[2048];
+    memset(long_message, 'x', sizeof(long_message) - 1);
+    long_message[sizeof(long_message) - 1] = '\0';
+    YA_LOG_WARN("%s", long_message);
+
+    ya_logger_destroy(logger);
+    TEST_ASSERT_NULL(g_logger);
+
+    // 50 条在 128 条的队列内，不丢
+    TEST_ASSERT_EQUAL_INT(50, count_lines_with(TEST_LOG_FILE, "async message"));
+    TEST_ASSERT_EQUAL_INT(0, count_lines_with(TEST_LOG_FILE, "async filtered"));
+    TEST_ASSERT_EQUAL_INT(1, count_lines_with(TEST_LOG_FILE, "(message truncated)"));
+
+    FILE* fp = fopen(TEST_LOG_FILE, "r");
+    TEST_ASSERT_NOT_NULL(fp);
+    char line[1024];
+    int expected = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char* found = strstr(line, "async message ");
+        if (found) {
+            TEST_ASSERT_EQUAL_INT(expected++, atoi(found + strlen("async message ")));
+        } else {
+            TEST_ASSERT_TRUE(strlen(line) <= YA_LOG_ASYNC_RECORD_SIZE);
+        }
+    }
+    fclose(fp);
+}
+
+// 测试异步模式队列满时丢弃并计数，不阻塞调用方
+void test_logger_async_overflow(void) {
+    ya_logger_config_t config = {
+        .level = YA_LOG_LEVEL_INFO,
+        .log_file = TEST_LOG_FILE,
+        .use_console = 0,
+        .use_system_log = 0,
+        .max_file_size = 0,
+        .max_backup_files = 0,
+        .async = 1,
+        .async_queue_size = 4,
+    };
+
+    ya_logger_t* logger = ya_logger_init(&config);
+    TEST_ASSERT_NOT_NULL(logger);
+
+    const int total = 5000;
+    for (int i = 0; i < total; i++) {
+        YA_LOG_INFO("async message %d", i);
+    }
+    uint64_t dropped = ya_logger_dropped(logger);
+    ya_logger_destroy(logger);
+
+    // 写出的条数加丢弃的条数等于调用次数
+    int written = count_lines_with(TEST_LOG_FILE, "async message");
+    TEST_ASSERT_EQUAL_INT(total, written + (int)dropped);
+    if (dropped > 0) {
+        TEST_ASSERT_GREATER_THAN(0, count_lines_with(TEST_LOG_FILE, "log records dropped"));
+    }
+    TEST_ASSERT_EQUAL_UINT64(0, ya_logger_dropped(NULL));
+}
+
+// 测试异步模式下按内存中累计的大小轮转
+void test_logger_async_rotation(void) {
+    ya_logger_config_t config = {
+        .level = YA_LOG_LEVEL_DEBUG,
+        .log_file = TEST_LOG_FILE,
+        .use_console = 0,
+        .use_system_log = 0,
+        .max_file_size = 200,
+        .max_backup_files = 3,
+        .async = 1,
+        .async_queue_size = 64,
+    };
+
+    ya_logger_t* logger = ya_logger_init(&config);
+    TEST_ASSERT_NOT_NULL(logger);
+
+    for (int i = 0; i < 30; i++) {
+        YA_LOG_INFO("Test log rotation message %d with some padding to make it longer...", i);
+    }
+    ya_logger_destroy(logger);
+
+    struct stat st;
+    TEST_ASSERT_EQUAL(0, stat(TEST_LOG_FILE ".1", &st));
+    TEST_ASSERT_EQUAL(0, stat(TEST_LOG_FILE ".2", &st));
+    TEST_ASSERT_EQUAL(0, stat(TEST_LOG_FILE ".3", &st));
+    TEST_ASSERT_EQUAL(0, stat(TEST_LOG_FILE, &st));
+    TEST_ASSERT_LESS_OR_EQUAL(config.max_file_size * 2, st.st_size);
+}
+
+#define CONCURRENT_WRITERS 4
+#define CONCURRENT_MESSAGES 500
+
+static void* concurrent_writer(void* arg) {
+    int id = (int)(intptr_t)arg;
+    for (int i = 0; i < CONCURRENT_MESSAGES; i++) {
+        YA_LOG_INFO("writer %d message %d with some padding to make it longer...", id, i);
+    }
+    return NULL;
+}
+
+// 测试同步模式下多个线程同时写日志并触发轮转：累计大小与文件实际大小一致
+void test_logger_sync_concurrent_rotation(void) {
+    ya_logger_config_t config = {
+        .level = YA_LOG_LEVEL_DEBUG,
+        .log_file = TEST_LOG_FILE,
+        .use_console = 0,
+        .use_system_log = 0,
+        .max_file_size = 1024,
+        .max_backup_files = 3
+    };
+
+    ya_logger_t* logger = ya_logger_init(&config);
+    TEST_ASSERT_NOT_NULL(logger);
+
+    pthread_t threads[CONCURRENT_WRITERS];
+    for (int i = 0; i < CONCURRENT_WRITERS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, concurrent_writer, (void*)(intptr_t)i));
+    }
+    for (int i = 0; i < CONCURRENT_WRITERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    struct stat st;
+    TEST_ASSERT_EQUAL(0, stat(TEST_LOG_FILE, &st));
+    TEST_ASSERT_EQUAL((size_t)st.st_size, logger->file_size);
+    TEST_ASSERT_LESS_OR_EQUAL(config.max_file_size * 2, st.st_size);
+    TEST_ASSERT_EQUAL(0, stat(TEST_LOG_FILE ".3", &st));
+
+    ya_logger_destroy(logger);
+}
+
 // 运行所有测试
 int main(void) {
     UNITY_BEGIN();
@@ -525,6 +741,11 @@ int main(void) {
     RUN_TEST(test_error_handling);
     RUN_TEST(test_system_logging);
     RUN_TEST(test_logger_formatting);
+    RUN_TEST(test_logger_level_short_circuit);
+    RUN_TEST(test_logger_async_write);
+    RUN_TEST(test_logger_async_overflow);
+    RUN_TEST(test_logger_async_rotation);
+    RUN_TEST(test_logger_sync_concurrent_rotation);
     
     return UNITY_END();
 } 
\ No newline at end of file
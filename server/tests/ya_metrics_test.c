@@ -0,0 +1,87 @@
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <event2/buffer.h>
+#include "../src/ya_metrics.h"
+
+YA_ServerContext svr_context;
+YA_Config config;
+
+static struct evbuffer *buffer;
+
+void setUp(void) {
+    memset(&svr_context, 0, sizeof(svr_context));
+    buffer = evbuffer_new();
+    TEST_ASSERT_NOT_NULL(buffer);
+}
+
+void tearDown(void) {
+    evbuffer_free(buffer);
+}
+
+// 取出渲染结果（以 NUL 结尾，由调用方释放）
+static char *take_text(void) {
+    size_t len = evbuffer_get_length(buffer);
+    char *text = malloc(len + 1);
+    TEST_ASSERT_NOT_NULL(text);
+    evbuffer_remove(buffer, text, len);
+    text[len] = '\0';
+    return text;
+}
+
+// 测试计数器按 OpenMetrics 格式输出，并以 # EOF 结束
+void test_metrics_render_counters(void) {
+    ya_server_stats_t stats = {0};
+    stats.active_connections = 2;
+    stats.total_connections = 7;
+    stats.session_parse_errors = 3;
+    stats.command_parse_errors = 4;
+    stats.order_dropped = 5;
+    stats.event_types[MOUSE_MOVE].handled = 42;
+    stats.event_types[KEYBOARD].rejected = 1;
+
+    size_t len = ya_metrics_render(&stats, buffer);
+    TEST_ASSERT_EQUAL(evbuffer_get_length(buffer), len);
+
+    char *text = take_text();
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE mousehero_connections gauge\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_connections 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE mousehero_connections_accepted counter\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_connections_accepted_total 7\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_events_total{type=\"MOUSE_MOVE\",result=\"handled\"} 42\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_events_total{type=\"KEYBOARD\",result=\"rejected\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_parse_errors_total{transport=\"session\"} 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_parse_errors_total{transport=\"command\"} 4\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_stale_events_dropped_total 5\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_injection_errors_total{source=\"action\",code=\"platform_error\"} 0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_key_sequencer_depth 0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "mousehero_log_dropped_total 0\n"));
+    TEST_ASSERT_NULL(strstr(text, "UNKNOWN"));
+
+    size_t text_len = strlen(text);
+    TEST_ASSERT_TRUE(text_len > 6);
+    TEST_ASSERT_EQUAL_STRING("# EOF\n", text + text_len - 6);
+    free(text);
+}
+
+// 测试同一缓冲区重复渲染：每次追加一份完整的输出
+void test_metrics_render_reuses_buffer(void) {
+    ya_server_stats_t stats = {0};
+
+    size_t first = ya_metrics_render(&stats, buffer);
+    evbuffer_drain(buffer, first);
+    TEST_ASSERT_EQUAL(0, evbuffer_get_length(buffer));
+
+    size_t second = ya_metrics_render(&stats, buffer);
+    TEST_ASSERT_EQUAL(first, second);
+    TEST_ASSERT_EQUAL(second, evbuffer_get_length(buffer));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_metrics_render_counters);
+    RUN_TEST(test_metrics_render_reuses_buffer);
+
+    return UNITY_END();
+}
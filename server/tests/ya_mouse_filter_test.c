@@ -0,0 +1,102 @@
+#include <unity.h>
+#include "../src/ya_mouse_filter.h"
+
+static ya_mouse_filter_t *filter;
+
+void setUp(void) {
+    filter = ya_mouse_filter_create();
+}
+
+void tearDown(void) {
+    ya_mouse_filter_destroy(filter);
+    filter = NULL;
+}
+
+// 测试小数格累积为高精度单位，余量留到下一次
+void test_scroll_accumulates_fractions(void) {
+    ya_scroll_step_t step;
+
+    // 0.004 格 = 0.48 个高精度单位，不输出
+    TEST_ASSERT_FALSE(ya_mouse_filter_scroll(filter, 0.0f, 0.004f, &step));
+    TEST_ASSERT_EQUAL(0, step.hires_y);
+
+    // 累计 0.96 个单位仍不足 1
+    TEST_ASSERT_FALSE(ya_mouse_filter_scroll(filter, 0.0f, 0.004f, &step));
+
+    // 累计 1.44 个单位，输出 1 个
+    TEST_ASSERT_TRUE(ya_mouse_filter_scroll(filter, 0.0f, 0.004f, &step));
+    TEST_ASSERT_EQUAL(1, step.hires_y);
+    TEST_ASSERT_EQUAL(0, step.notch_y);
+    TEST_ASSERT_EQUAL(0, step.hires_x);
+}
+
+// 测试高精度单位累计满 120 个时输出整格
+void test_scroll_emits_matching_notch(void) {
+    ya_scroll_step_t step;
+    int hires = 0;
+    int notches = 0;
+
+    // 10 次 0.25 格 = 2.5 格
+    for (int i = 0; i < 10; i++) {
+        ya_mouse_filter_scroll(filter, 0.0f, 0.25f, &step);
+        hires += step.hires_y;
+        notches += step.notch_y;
+        if (i == 2) {
+            TEST_ASSERT_EQUAL(0, notches); // 0.75 格
+        }
+        if (i == 3) {
+            TEST_ASSERT_EQUAL(1, notches); // 第 4 次凑满 1 格
+        }
+    }
+    TEST_ASSERT_EQUAL(300, hires);
+    TEST_ASSERT_EQUAL(2, notches);
+
+    // 一次超过一格：剩余 60 + 300 = 360，输出 3 格
+    ya_mouse_filter_scroll(filter, 0.0f, 2.5f, &step);
+    TEST_ASSERT_EQUAL(300, step.hires_y);
+    TEST_ASSERT_EQUAL(3, step.notch_y);
+}
+
+// 测试方向反转时丢弃未满一格的累计
+void test_scroll_direction_change_resets_notch(void) {
+    ya_scroll_step_t step;
+
+    ya_mouse_filter_scroll(filter, 0.9f, 0.0f, &step);
+    TEST_ASSERT_EQUAL(108, step.hires_x);
+    TEST_ASSERT_EQUAL(0, step.notch_x);
+
+    // 反向 0.2 格不会触发反向整格，也不会抵消出正向整格
+    ya_mouse_filter_scroll(filter, -0.2f, 0.0f, &step);
+    TEST_ASSERT_EQUAL(-24, step.hires_x);
+    TEST_ASSERT_EQUAL(0, step.notch_x);
+
+    // 继续反向到满一格（24 + 96 = 120）
+    ya_mouse_filter_scroll(filter, -0.8f, 0.0f, &step);
+    TEST_ASSERT_EQUAL(-96, step.hires_x);
+    TEST_ASSERT_EQUAL(-1, step.notch_x);
+}
+
+// 测试重置状态清除滚动累积
+void test_scroll_reset_state(void) {
+    ya_scroll_step_t step;
+
+    ya_mouse_filter_scroll(filter, 0.0f, -0.5f, &step);
+    ya_mouse_filter_reset_state(filter);
+    ya_mouse_filter_scroll(filter, 0.0f, -0.5f, &step);
+    TEST_ASSERT_EQUAL(-60, step.hires_y);
+    TEST_ASSERT_EQUAL(0, step.notch_y);
+
+    TEST_ASSERT_FALSE(ya_mouse_filter_scroll(NULL, 1.0f, 1.0f, &step));
+    TEST_ASSERT_FALSE(ya_mouse_filter_scroll(filter, 1.0f, 1.0f, NULL));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_scroll_accumulates_fractions);
+    RUN_TEST(test_scroll_emits_matching_notch);
+    RUN_TEST(test_scroll_direction_change_resets_notch);
+    RUN_TEST(test_scroll_reset_state);
+
+    return UNITY_END();
+}
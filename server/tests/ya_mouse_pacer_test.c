@@ -0,0 +1,210 @@
+#include <stdlib.h>
+#include <unity.h>
+#include <event2/event.h>
+#include "../src/ya_config.h"
+#include "../src/ya_input_queue.h"
+#include "../src/ya_mouse_pacer.h"
+
+YA_Config config;  // ya_mouse_pacer_init 读取 [input] 配置
+
+static struct event_base *base;
+static ya_mouse_pacer_t *pacer;
+
+// 记录回放结果
+static int emitted;
+static int sum_dx;
+static int sum_dy;
+
+static void record_emit(void *ctx, int32_t dx, int32_t dy) {
+    (void)ctx;
+    emitted++;
+    sum_dx += dx;
+    sum_dy += dy;
+}
+
+static void stop_loop(evutil_socket_t fd, short events, void *arg) {
+    (void)fd;
+    (void)events;
+    event_base_loopexit((struct event_base *)arg, NULL);
+}
+
+// 运行事件循环 ms 毫秒
+static void run_loop_ms(int ms) {
+    struct timeval tv = {.tv_sec = ms / 1000, .tv_usec = (ms % 1000) * 1000};
+    event_base_once(base, -1, EV_TIMEOUT, stop_loop, base, &tv);
+    event_base_dispatch(base);
+}
+
+void setUp(void) {
+    emitted = 0;
+    sum_dx = 0;
+    sum_dy = 0;
+
+    base = event_base_new();
+    TEST_ASSERT_NOT_NULL(base);
+
+    pacer = ya_mouse_pacer_create(base, record_emit, NULL);
+    TEST_ASSERT_NOT_NULL(pacer);
+}
+
+void tearDown(void) {
+    ya_mouse_pacer_destroy(pacer);
+    pacer = NULL;
+
+    if (base) {
+        event_base_free(base);
+        base = NULL;
+    }
+}
+
+// 测试配置解析
+void test_pacer_mode_from_config(void) {
+    ya_config_init(&config);
+    ya_mouse_pacer_init();
+    TEST_ASSERT_EQUAL(YA_MOUSE_BATCH_IMMEDIATE, ya_mouse_pacer_mode());
+
+    ya_config_set(&config, "input", "mouse_batch_pacing", "paced");
+    ya_mouse_pacer_init();
+    TEST_ASSERT_EQUAL(YA_MOUSE_BATCH_PACED, ya_mouse_pacer_mode());
+
+    ya_config_set(&config, "input", "mouse_batch_pacing", "immediate");
+    ya_mouse_pacer_init();
+    TEST_ASSERT_EQUAL(YA_MOUSE_BATCH_IMMEDIATE, ya_mouse_pacer_mode());
+    ya_config_free(&config);
+}
+
+// 测试首个采样立即回放，其余按间隔回放
+void test_pacer_replays_at_sample_timing(void) {
+    YAMouseSample samples[4] = {
+        {0, 100, -100},
+        {10000, 100, -100},
+        {10000, 100, -100},
+        {10000, 100, -100},
+    };
+
+    ya_mouse_pacer_push(pacer, samples, 4);
+    TEST_ASSERT_EQUAL(1, emitted);
+    TEST_ASSERT_EQUAL(3, ya_mouse_pacer_pending(pacer));
+
+    run_loop_ms(100);
+    TEST_ASSERT_EQUAL(4, emitted);
+    TEST_ASSERT_EQUAL(400, sum_dx);
+    TEST_ASSERT_EQUAL(-400, sum_dy);
+    TEST_ASSERT_EQUAL(0, ya_mouse_pacer_pending(pacer));
+}
+
+// 测试flush立即回放所有排队采样
+void test_pacer_flush(void) {
+    YAMouseSample samples[3] = {
+        {0, 1, 2},
+        {20000, 3, 4},
+        {20000, 5, 6},
+    };
+
+    ya_mouse_pacer_push(pacer, samples, 3);
+    TEST_ASSERT_EQUAL(1, emitted);
+
+    ya_mouse_pacer_flush(pacer);
+    TEST_ASSERT_EQUAL(3, emitted);
+    TEST_ASSERT_EQUAL(9, sum_dx);
+    TEST_ASSERT_EQUAL(12, sum_dy);
+    TEST_ASSERT_EQUAL(0, ya_mouse_pacer_pending(pacer));
+}
+
+// 注入线程上执行的动作顺序
+#define ORDER_MAX 16
+static ya_input_action_type_t order[ORDER_MAX];
+static int order_count;
+
+static void record_order(const ya_input_action_t *action) {
+    if (order_count < ORDER_MAX) {
+        order[order_count] = action->type;
+    }
+    order_count++;
+}
+
+static void emit_to_queue(void *ctx, int32_t dx, int32_t dy) {
+    (void)ctx;
+    ya_input_action_t move = {.type = YA_INPUT_MOVE, .move = {dx, dy}};
+    ya_input_queue_push(&move);
+}
+
+// 测试按键前先 flush：排队中的采样先进入注入队列，按键落在之前移动结束的位置
+void test_pacer_flush_orders_before_button(void) {
+    order_count = 0;
+    TEST_ASSERT_EQUAL(0, ya_input_queue_start(record_order));
+    ya_mouse_pacer_t *queued = ya_mouse_pacer_create(base, emit_to_queue, NULL);
+    TEST_ASSERT_NOT_NULL(queued);
+
+    YAMouseSample samples[3] = {
+        {0, 1, 0},
+        {20000, 1, 0},
+        {20000, 1, 0},
+    };
+    ya_mouse_pacer_push(queued, samples, 3);
+    TEST_ASSERT_EQUAL(2, ya_mouse_pacer_pending(queued));
+
+    // 处理函数在放入按键/滚轮动作前的步骤
+    ya_mouse_pacer_flush(queued);
+    ya_input_action_t button = {.type = YA_INPUT_BUTTON, .button = {.button = Left, .dir = Click}};
+    ya_input_queue_push(&button);
+
+    // 原来的采样时间过后也不会再有移动追加在按键之后
+    run_loop_ms(60);
+    ya_input_queue_drain();
+    int executed = order_count;
+    ya_mouse_pacer_destroy(queued);
+    ya_input_queue_stop();
+
+    TEST_ASSERT_EQUAL(4, executed);
+    TEST_ASSERT_EQUAL(YA_INPUT_MOVE, order[0]);
+    TEST_ASSERT_EQUAL(YA_INPUT_MOVE, order[1]);
+    TEST_ASSERT_EQUAL(YA_INPUT_MOVE, order[2]);
+    TEST_ASSERT_EQUAL(YA_INPUT_BUTTON, order[3]);
+}
+
+// 测试积压超过上限时不会堆积延迟，也不会丢失位移
+void test_pacer_bounded_lag(void) {
+    YAMouseSample samples[YA_MOUSE_BATCH_MAX_SAMPLES];
+    for (int i = 0; i < YA_MOUSE_BATCH_MAX_SAMPLES; i++) {
+        samples[i].dt_us = 8000;
+        samples[i].dx = 1;
+        samples[i].dy = 0;
+    }
+
+    // 连续推入多批，总时长远超 YA_MOUSE_PACER_MAX_LAG_US
+    for (int batch = 0; batch < 5; batch++) {
+        ya_mouse_pacer_push(pacer, samples, YA_MOUSE_BATCH_MAX_SAMPLES);
+        TEST_ASSERT_TRUE(ya_mouse_pacer_pending(pacer) <= YA_MOUSE_PACER_CAPACITY);
+    }
+
+    run_loop_ms(2 * YA_MOUSE_PACER_MAX_LAG_US / 1000 + 20);
+    TEST_ASSERT_EQUAL(5 * YA_MOUSE_BATCH_MAX_SAMPLES, emitted);
+    TEST_ASSERT_EQUAL(5 * YA_MOUSE_BATCH_MAX_SAMPLES, sum_dx);
+}
+
+// 测试空参数
+void test_pacer_null_params(void) {
+    TEST_ASSERT_NULL(ya_mouse_pacer_create(NULL, record_emit, NULL));
+    TEST_ASSERT_NULL(ya_mouse_pacer_create(base, NULL, NULL));
+
+    ya_mouse_pacer_push(NULL, NULL, 0);
+    ya_mouse_pacer_push(pacer, NULL, 3);
+    ya_mouse_pacer_flush(NULL);
+    ya_mouse_pacer_destroy(NULL);
+    TEST_ASSERT_EQUAL(0, ya_mouse_pacer_pending(NULL));
+    TEST_ASSERT_EQUAL(0, emitted);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pacer_mode_from_config);
+    RUN_TEST(test_pacer_replays_at_sample_timing);
+    RUN_TEST(test_pacer_flush);
+    RUN_TEST(test_pacer_flush_orders_before_button);
+    RUN_TEST(test_pacer_bounded_lag);
+    RUN_TEST(test_pacer_null_params);
+
+    return UNITY_END();
+}
@@ -0,0 +1,159 @@
+#include <stdlib.h>
+#include <unity.h>
+#include <event2/event.h>
+#include "../src/ya_mouse_throttle.h"
+
+static struct event_base *base;
+static ya_mouse_throttle_t *throttle;
+
+// 记录每个节流器的输出结果
+typedef struct {
+    int emitted;
+    int sum_dx;
+    int sum_dy;
+} emit_record_t;
+
+static emit_record_t record;
+
+static void record_emit(void *ctx, int dx, int dy) {
+    emit_record_t *r = (emit_record_t *)ctx;
+    r->emitted++;
+    r->sum_dx += dx;
+    r->sum_dy += dy;
+}
+
+static void stop_loop(evutil_socket_t fd, short events, void *arg) {
+    (void)fd;
+    (void)events;
+    event_base_loopexit((struct event_base *)arg, NULL);
+}
+
+// 运行事件循环 ms 毫秒
+static void run_loop_ms(int ms) {
+    struct timeval tv = {.tv_sec = ms / 1000, .tv_usec = (ms % 1000) * 1000};
+    event_base_once(base, -1, EV_TIMEOUT, stop_loop, base, &tv);
+    event_base_dispatch(base);
+}
+
+void setUp(void) {
+    record = (emit_record_t){0};
+
+    base = event_base_new();
+    TEST_ASSERT_NOT_NULL(base);
+
+    throttle = ya_mouse_throttle_create(base, record_emit, &record);
+    TEST_ASSERT_NOT_NULL(throttle);
+}
+
+void tearDown(void) {
+    ya_mouse_throttle_destroy(throttle);
+    throttle = NULL;
+
+    if (base) {
+        event_base_free(base);
+        base = NULL;
+    }
+}
+
+// 测试首个位移立即输出，间隔内的位移合并
+void test_throttle_first_push_emits(void) {
+    ya_mouse_throttle_push(throttle, 5, -5);
+    TEST_ASSERT_EQUAL_INT(1, record.emitted);
+    TEST_ASSERT_EQUAL_INT(5, record.sum_dx);
+    TEST_ASSERT_EQUAL_INT(-5, record.sum_dy);
+
+    ya_mouse_throttle_push(throttle, 2, 0);
+    ya_mouse_throttle_push(throttle, 3, 1);
+    TEST_ASSERT_EQUAL_INT(1, record.emitted);
+    TEST_ASSERT_TRUE(ya_mouse_throttle_pending(throttle));
+}
+
+// 测试间隔到期后即使没有新的包也会输出累积的位移
+void test_throttle_timer_flushes_remainder(void) {
+    ya_mouse_throttle_push(throttle, 1, 1);
+    ya_mouse_throttle_push(throttle, 4, 2);
+    ya_mouse_throttle_push(throttle, 3, 0);
+    TEST_ASSERT_EQUAL_INT(1, record.emitted);
+
+    run_loop_ms(30);
+    TEST_ASSERT_EQUAL_INT(2, record.emitted);
+    TEST_ASSERT_EQUAL_INT(8, record.sum_dx);
+    TEST_ASSERT_EQUAL_INT(3, record.sum_dy);
+    TEST_ASSERT_FALSE(ya_mouse_throttle_pending(throttle));
+
+    // 没有累积时定时器不再触发
+    run_loop_ms(20);
+    TEST_ASSERT_EQUAL_INT(2, record.emitted);
+}
+
+// 测试刷新与重置
+void test_throttle_flush_and_reset(void) {
+    ya_mouse_throttle_push(throttle, 1, 0);
+    ya_mouse_throttle_push(throttle, 6, 0);
+    TEST_ASSERT_TRUE(ya_mouse_throttle_flush(throttle));
+    TEST_ASSERT_EQUAL_INT(2, record.emitted);
+    TEST_ASSERT_EQUAL_INT(7, record.sum_dx);
+    TEST_ASSERT_FALSE(ya_mouse_throttle_flush(throttle));
+
+    // 重置丢弃累积，下一次位移立即输出
+    ya_mouse_throttle_push(throttle, 9, 9);
+    ya_mouse_throttle_reset(throttle);
+    TEST_ASSERT_FALSE(ya_mouse_throttle_pending(throttle));
+    ya_mouse_throttle_push(throttle, 1, 2);
+    TEST_ASSERT_EQUAL_INT(3, record.emitted);
+    TEST_ASSERT_EQUAL_INT(8, record.sum_dx);
+    TEST_ASSERT_EQUAL_INT(2, record.sum_dy);
+
+    run_loop_ms(20);
+    TEST_ASSERT_EQUAL_INT(3, record.emitted);
+}
+
+// 测试两个客户端的节流器互不影响
+void test_throttle_clients_isolated(void) {
+    emit_record_t other_record = {0};
+    ya_mouse_throttle_t *other = ya_mouse_throttle_create(base, record_emit, &other_record);
+    TEST_ASSERT_NOT_NULL(other);
+
+    ya_mouse_throttle_push(throttle, 1, 0);
+    ya_mouse_throttle_push(other, 0, 1);
+    ya_mouse_throttle_push(throttle, 10, 0);
+    ya_mouse_throttle_push(other, 0, 20);
+
+    // 一个客户端的 MOUSE_STOP 只刷新它自己的累积
+    TEST_ASSERT_TRUE(ya_mouse_throttle_flush(other));
+    TEST_ASSERT_EQUAL_INT(2, other_record.emitted);
+    TEST_ASSERT_EQUAL_INT(0, other_record.sum_dx);
+    TEST_ASSERT_EQUAL_INT(21, other_record.sum_dy);
+    TEST_ASSERT_EQUAL_INT(1, record.emitted);
+    TEST_ASSERT_TRUE(ya_mouse_throttle_pending(throttle));
+
+    run_loop_ms(30);
+    TEST_ASSERT_EQUAL_INT(2, record.emitted);
+    TEST_ASSERT_EQUAL_INT(11, record.sum_dx);
+    TEST_ASSERT_EQUAL_INT(0, record.sum_dy);
+    TEST_ASSERT_EQUAL_INT(2, other_record.emitted);
+
+    ya_mouse_throttle_destroy(other);
+}
+
+// 测试无效参数
+void test_throttle_null_params(void) {
+    TEST_ASSERT_NULL(ya_mouse_throttle_create(NULL, record_emit, NULL));
+    TEST_ASSERT_NULL(ya_mouse_throttle_create(base, NULL, NULL));
+
+    ya_mouse_throttle_push(NULL, 1, 1);
+    TEST_ASSERT_FALSE(ya_mouse_throttle_flush(NULL));
+    ya_mouse_throttle_reset(NULL);
+    TEST_ASSERT_FALSE(ya_mouse_throttle_pending(NULL));
+    ya_mouse_throttle_destroy(NULL);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_throttle_first_push_emits);
+    RUN_TEST(test_throttle_timer_flushes_remainder);
+    RUN_TEST(test_throttle_flush_and_reset);
+    RUN_TEST(test_throttle_clients_isolated);
+    RUN_TEST(test_throttle_null_params);
+    return UNITY_END();
+}
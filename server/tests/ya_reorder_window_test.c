@@ -0,0 +1,76 @@
+#include <unity.h>
+#include <string.h>
+#include "../src/ya_reorder_window.h"
+
+static ya_reorder_window_t window;
+
+void setUp(void) {
+    memset(&window, 0, sizeof(window));
+}
+
+void tearDown(void) {
+}
+
+// 测试按顺序到达
+void test_reorder_in_order(void) {
+    for (uint32_t i = 1; i <= 100; i++) {
+        TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, i, 0));
+    }
+    TEST_ASSERT_EQUAL_UINT32(100, window.high);
+}
+
+// 测试迟到的序号被合并一次，重复的被丢弃
+void test_reorder_late_merged_once(void) {
+    TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, 1, 1000));
+    TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, 3, 1000));
+    TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, 4, 1001));
+
+    TEST_ASSERT_EQUAL(YA_REORDER_LATE, ya_reorder_window_accept(&window, 2, 1010));
+    TEST_ASSERT_EQUAL(YA_REORDER_DROP, ya_reorder_window_accept(&window, 2, 1011));
+    TEST_ASSERT_EQUAL(YA_REORDER_DROP, ya_reorder_window_accept(&window, 3, 1011));
+    TEST_ASSERT_EQUAL(YA_REORDER_DROP, ya_reorder_window_accept(&window, 4, 1011));
+}
+
+// 测试等待超时后迟到的序号被丢弃
+void test_reorder_bounded_wait(void) {
+    TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, 1, 1000));
+    TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, 4, 1000));
+
+    TEST_ASSERT_EQUAL(YA_REORDER_LATE, ya_reorder_window_accept(&window, 2, 1000 + YA_REORDER_MAX_WAIT_MS));
+    TEST_ASSERT_EQUAL(YA_REORDER_DROP, ya_reorder_window_accept(&window, 3, 1001 + YA_REORDER_MAX_WAIT_MS));
+}
+
+// 测试超出窗口的序号被丢弃
+void test_reorder_outside_window(void) {
+    TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, 1, 0));
+    TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, 1 + YA_REORDER_WINDOW_SIZE * 3, 0));
+
+    // 跳跃超过窗口时，窗口内被跳过的序号仍可合并
+    TEST_ASSERT_EQUAL(YA_REORDER_LATE, ya_reorder_window_accept(&window, YA_REORDER_WINDOW_SIZE * 3, 0));
+    TEST_ASSERT_EQUAL(YA_REORDER_LATE,
+                      ya_reorder_window_accept(&window, 2 + YA_REORDER_WINDOW_SIZE * 2, 0));
+    TEST_ASSERT_EQUAL(YA_REORDER_DROP,
+                      ya_reorder_window_accept(&window, 1 + YA_REORDER_WINDOW_SIZE * 2, 0));
+}
+
+// 测试时钟回绕与无效序号
+void test_reorder_clock_wrap_and_zero(void) {
+    TEST_ASSERT_EQUAL(YA_REORDER_DROP, ya_reorder_window_accept(&window, 0, 0));
+    TEST_ASSERT_EQUAL(YA_REORDER_DROP, ya_reorder_window_accept(NULL, 1, 0));
+
+    TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, 1, UINT32_MAX - 5));
+    TEST_ASSERT_EQUAL(YA_REORDER_IN_ORDER, ya_reorder_window_accept(&window, 3, UINT32_MAX - 5));
+    TEST_ASSERT_EQUAL(YA_REORDER_LATE, ya_reorder_window_accept(&window, 2, 10));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_reorder_in_order);
+    RUN_TEST(test_reorder_late_merged_once);
+    RUN_TEST(test_reorder_bounded_wait);
+    RUN_TEST(test_reorder_outside_window);
+    RUN_TEST(test_reorder_clock_wrap_and_zero);
+
+    return UNITY_END();
+}
@@ -0,0 +1,120 @@
+#include <unity.h>
+#include <string.h>
+#include <stdlib.h>
+#include <event2/event.h>
+#include <event2/util.h>
+#include "../src/ya_server.h"
+#include "../src/ya_server_command.h"
+#include "../src/ya_input_queue.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+YA_ServerContext svr_context;
+YA_Config config;  // run_command_server 读取 [command] 配置
+
+static evutil_socket_t sender_fd = -1;
+static struct sockaddr_in server_addr;
+static int executed;  // 注入线程执行的动作数
+
+static void record_action(const ya_input_action_t *action) {
+    (void)action;
+    executed++;
+}
+
+void setUp(void) {
+    memset(&svr_context, 0, sizeof(svr_context));
+    ya_config_init(&config);
+    ya_client_manager_init(&svr_context.client_manager);
+    svr_context.base = event_base_new();
+    TEST_ASSERT_NOT_NULL(svr_context.base);
+
+    // 绑定到回环地址的随机端口
+    svr_context.command_sock_addr.sin_family = AF_INET;
+    svr_context.command_sock_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    svr_context.command_sock_addr.sin_port = 0;
+    TEST_ASSERT_EQUAL(0, run_command_server());
+
+    socklen_t len = sizeof(server_addr);
+    getsockname(svr_context.command_fd, (struct sockaddr *)&server_addr, &len);
+
+    sender_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    TEST_ASSERT_TRUE(sender_fd >= 0);
+
+    executed = 0;
+    TEST_ASSERT_EQUAL(0, ya_input_queue_start(record_action));
+}
+
+void tearDown(void) {
+    ya_input_queue_stop();
+    evutil_closesocket(sender_fd);
+    evutil_closesocket(svr_context.command_fd);
+    event_base_free(svr_context.base);
+    svr_context.base = NULL;
+    ya_client_manager_cleanup(&svr_context.client_manager);
+    ya_config_free(&config);
+}
+
+// 把一帧作为一个数据报发给命令服务，并运行事件循环处理它
+static void send_frame(YAEvent *event) {
+    uint8_t *frame = NULL;
+    int len = ya_serialize_event(event, &frame);
+    TEST_ASSERT_TRUE(len > 0);
+    TEST_ASSERT_EQUAL(len, sendto(sender_fd, frame, (size_t)len, 0, (struct sockaddr *)&server_addr,
+                                  sizeof(server_addr)));
+    free(frame);
+
+    struct timeval wait = {0, 100 * 1000};
+    event_base_loopexit(svr_context.base, &wait);
+    event_base_dispatch(svr_context.base);
+}
+
+// 测试不存在的 uid 发来的点击被丢弃，不会注入
+void test_unbound_click_dropped(void) {
+    YACommonEventRequest click = {.lparam = Left, .rparam = Click};
+    YAEvent event = {0};
+    event.header.type = MOUSE_CLICK;
+    event.header.direction = REQUEST;
+    event.header.uid = 0xBAD;
+    event.header.index = 1;
+    event.param = &click;
+    event.param_len = sizeof(click);
+
+    send_frame(&event);
+    ya_input_queue_drain();
+
+    TEST_ASSERT_EQUAL(0, executed);
+    TEST_ASSERT_EQUAL_UINT64(1, svr_context.stats.udp_rejected);
+    TEST_ASSERT_EQUAL_UINT64(0, svr_context.stats.event_types[MOUSE_CLICK].handled);
+}
+
+// 测试不存在的 uid 仍然可以发心跳，并收到回复
+void test_unbound_heartbeat_answered(void) {
+    YAEvent event = {0};
+    event.header.type = HEARTBEAT;
+    event.header.direction = REQUEST;
+    event.header.uid = 0xBAD;
+
+    send_frame(&event);
+
+    TEST_ASSERT_EQUAL_UINT64(0, svr_context.stats.udp_rejected);
+    TEST_ASSERT_EQUAL_UINT64(1, svr_context.stats.event_types[HEARTBEAT].handled);
+
+    uint8_t reply[256];
+    ssize_t received = recv(sender_fd, reply, sizeof(reply), MSG_DONTWAIT);
+    TEST_ASSERT_TRUE(received > 0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_unbound_click_dropped);
+    RUN_TEST(test_unbound_heartbeat_answered);
+
+    return UNITY_END();
+}
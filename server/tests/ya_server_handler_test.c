@@ -216,13 +216,13 @@ void test_handle_authorize_null_param(void) {
     event.header.direction = REQUEST;
     event.param = NULL;
     
-    YAEvent *response = handle_authorize(test_bev, &event);
+    YAEvent *response = handle_authorize(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
 // 测试授权事件处理 - 空事件
 void test_handle_authorize_null_event(void) {
-    YAEvent *response = handle_authorize(test_bev, NULL);
+    YAEvent *response = handle_authorize(test_bev, NULL, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -263,7 +263,7 @@ void test_handle_discover_wrong_magic(void) {
     event.param = &discover_req;
     event.param_len = sizeof(discover_req);
     
-    YAEvent *response = handle_discover(test_bev, &event);
+    YAEvent *response = handle_discover(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -284,7 +284,7 @@ void test_handle_habernate(void) {
 
 // 测试休眠事件处理 - 空事件
 void test_handle_habernate_null_event(void) {
-    YAEvent *response = handle_habernate(test_bev, NULL);
+    YAEvent *response = handle_habernate(test_bev, NULL, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -300,7 +300,7 @@ void test_handle_mouse_move(void) {
     event.param = &mouse_req;
     event.param_len = sizeof(mouse_req);
     
-    YAEvent *response = handle_mouse_move(test_bev, &event);
+    YAEvent *response = handle_mouse_move(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response); // 鼠标移动事件不返回响应
 }
 
@@ -310,13 +310,13 @@ void test_handle_mouse_move_null_param(void) {
     event.header.type = MOUSE_MOVE;
     event.param = NULL;
     
-    YAEvent *response = handle_mouse_move(test_bev, &event);
+    YAEvent *response = handle_mouse_move(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
 // 测试鼠标移动事件处理 - 空事件
 void test_handle_mouse_move_null_event(void) {
-    YAEvent *response = handle_mouse_move(test_bev, NULL);
+    YAEvent *response = handle_mouse_move(test_bev, NULL, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -329,7 +329,7 @@ void test_handle_mouse_move_wrong_param_size(void) {
     event.param = &mouse_req;
     event.param_len = sizeof(mouse_req) - 1; // 错误的大小
     
-    YAEvent *response = handle_mouse_move(test_bev, &event);
+    YAEvent *response = handle_mouse_move(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -345,7 +345,7 @@ void test_handle_mouse_click(void) {
     event.param = &mouse_req;
     event.param_len = sizeof(mouse_req);
     
-    YAEvent *response = handle_mouse_click(test_bev, &event);
+    YAEvent *response = handle_mouse_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response); // 鼠标点击事件不返回响应
 }
 
@@ -355,7 +355,7 @@ void test_handle_mouse_click_null_param(void) {
     event.header.type = MOUSE_CLICK;
     event.param = NULL;
     
-    YAEvent *response = handle_mouse_click(test_bev, &event);
+    YAEvent *response = handle_mouse_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -370,7 +370,7 @@ void test_handle_mouse_click_invalid_button(void) {
     event.param = &mouse_req;
     event.param_len = sizeof(mouse_req);
     
-    YAEvent *response = handle_mouse_click(test_bev, &event);
+    YAEvent *response = handle_mouse_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -385,7 +385,7 @@ void test_handle_mouse_click_invalid_direction(void) {
     event.param = &mouse_req;
     event.param_len = sizeof(mouse_req);
     
-    YAEvent *response = handle_mouse_click(test_bev, &event);
+    YAEvent *response = handle_mouse_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -401,7 +401,7 @@ void test_handle_mouse_scroll(void) {
     event.param = &mouse_req;
     event.param_len = sizeof(mouse_req);
     
-    YAEvent *response = handle_mouse_scroll(test_bev, &event);
+    YAEvent *response = handle_mouse_scroll(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response); // 鼠标滚轮事件不返回响应
 }
 
@@ -416,7 +416,7 @@ void test_handle_mouse_scroll_zero_amount(void) {
     event.param = &mouse_req;
     event.param_len = sizeof(mouse_req);
     
-    YAEvent *response = handle_mouse_scroll(test_bev, &event);
+    YAEvent *response = handle_mouse_scroll(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -432,7 +432,7 @@ void test_handle_key_click(void) {
     event.param = &key_req;
     event.param_len = sizeof(key_req);
     
-    YAEvent *response = handle_key_click(test_bev, &event);
+    YAEvent *response = handle_key_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response); // 键盘事件不返回响应
 }
 
@@ -447,7 +447,7 @@ void test_handle_key_click_invalid_direction(void) {
     event.param = &key_req;
     event.param_len = sizeof(key_req);
     
-    YAEvent *response = handle_key_click(test_bev, &event);
+    YAEvent *response = handle_key_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -462,7 +462,7 @@ void test_handle_input_text(void) {
     event.param = &text_req;
     event.param_len = sizeof(text_req);
     
-    YAEvent *response = handle_input_text(test_bev, &event);
+    YAEvent *response = handle_input_text(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response); // 文本输入事件不返回响应
 }
 
@@ -474,7 +474,7 @@ void test_handle_input_get(void) {
     event.header.uid = 1;
     event.header.index = 1;
     
-    YAEvent *response = handle_input_get(test_bev, &event);
+    YAEvent *response = handle_input_get(test_bev, &event, NULL);
     // 由于依赖外部系统调用，这个测试可能会失败，但我们验证基本逻辑
     // TEST_ASSERT_NOT_NULL(response);
     
@@ -489,7 +489,7 @@ void test_handle_power(void) {
     event.header.type = POWER;
     event.header.direction = REQUEST;
     
-    YAEvent *response = handle_power(test_bev, &event);
+    YAEvent *response = handle_power(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response); // 电源事件不返回响应
 }
 
@@ -499,7 +499,7 @@ void test_handle_restart(void) {
     event.header.type = RESTART;
     event.header.direction = REQUEST;
     
-    YAEvent *response = handle_restart(test_bev, &event);
+    YAEvent *response = handle_restart(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response); // 重启事件不返回响应
 }
 
@@ -723,7 +723,7 @@ void test_handle_authorize_client_creation_failure(void) {
     event.param = &auth_req;
     event.param_len = sizeof(auth_req);
     
-    YAEvent *response = handle_authorize(test_bev, &event);
+    YAEvent *response = handle_authorize(test_bev, &event, NULL);
     TEST_ASSERT_NOT_NULL(response);
     
     YAAuthorizeEventResponse *auth_resp = (YAAuthorizeEventResponse *)response->param;
@@ -756,7 +756,7 @@ void test_handle_key_click_error_handling(void) {
     key_req.lparam = 999; // 不存在的键码
     key_req.rparam = Click;
     
-    YAEvent *response = handle_key_click(test_bev, &event);
+    YAEvent *response = handle_key_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -772,25 +772,25 @@ void test_handle_input_text_error_cases(void) {
     
     // 模拟修饰键按下失败的情况
     modifier_key_fail_next = true;
-    YAEvent *response = handle_input_text(test_bev, &event);
+    YAEvent *response = handle_input_text(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     modifier_key_fail_next = false;
     
     // 模拟A键按下失败的情况
     a_key_fail_next = true;
-    response = handle_input_text(test_bev, &event);
+    response = handle_input_text(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     a_key_fail_next = false;
     
     // 模拟修饰键释放失败的情况
     modifier_release_fail_next = true;
-    response = handle_input_text(test_bev, &event);
+    response = handle_input_text(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     modifier_release_fail_next = false;
     
     // 模拟文本输入失败的情况
     enter_text_fail_next = true;
-    response = handle_input_text(test_bev, &event);
+    response = handle_input_text(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     enter_text_fail_next = false;
 }
@@ -805,43 +805,43 @@ void test_handle_input_get_error_cases(void) {
     
     // 模拟修饰键按下失败
     modifier_key_fail_next = true;
-    YAEvent *response = handle_input_get(test_bev, &event);
+    YAEvent *response = handle_input_get(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     modifier_key_fail_next = false;
     
     // 模拟A键按下失败
     a_key_fail_next = true;
-    response = handle_input_get(test_bev, &event);
+    response = handle_input_get(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     a_key_fail_next = false;
     
     // 模拟C键按下失败
     c_key_fail_next = true;
-    response = handle_input_get(test_bev, &event);
+    response = handle_input_get(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     c_key_fail_next = false;
     
     // 模拟修饰键释放失败
     modifier_release_fail_next = true;
-    response = handle_input_get(test_bev, &event);
+    response = handle_input_get(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     modifier_release_fail_next = false;
     
     // 模拟鼠标点击失败
     mouse_click_fail_next = true;
-    response = handle_input_get(test_bev, &event);
+    response = handle_input_get(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     mouse_click_fail_next = false;
     
     // 模拟剪贴板获取失败
     clipboard_get_fail_next = true;
-    response = handle_input_get(test_bev, &event);
+    response = handle_input_get(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     clipboard_get_fail_next = false;
     
     // 模拟内存分配失败（strdup失败）
     strdup_fail_next = true;
-    response = handle_input_get(test_bev, &event);
+    response = handle_input_get(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     strdup_fail_next = false;
 }
@@ -933,13 +933,13 @@ void test_handle_mouse_scroll_error_handling(void) {
     scroll_req.lparam = 0;
     scroll_req.rparam = 1;
     
-    YAEvent *response = handle_mouse_scroll(test_bev, &event);
+    YAEvent *response = handle_mouse_scroll(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     
     // 测试正常滚动
     scroll_req.lparam = 3;
     scroll_req.rparam = 1;
-    response = handle_mouse_scroll(test_bev, &event);
+    response = handle_mouse_scroll(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -955,7 +955,7 @@ void test_handle_mouse_move_error_handling(void) {
     
     // 模拟move_mouse失败
     move_mouse_fail_next = true;
-    YAEvent *response = handle_mouse_move(test_bev, &event);
+    YAEvent *response = handle_mouse_move(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     move_mouse_fail_next = false;
 }
@@ -972,7 +972,7 @@ void test_handle_mouse_click_error_handling(void) {
     
     // 模拟mouse_button失败
     mouse_button_fail_next = true;
-    YAEvent *response = handle_mouse_click(test_bev, &event);
+    YAEvent *response = handle_mouse_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     mouse_button_fail_next = false;
 }
@@ -989,14 +989,14 @@ void test_parameter_size_validation(void) {
     event.header.type = KEYBOARD;
     event.param_len = sizeof(YACommonEventRequest) - 1; // 长度不对
     
-    YAEvent *response = handle_key_click(test_bev, &event);
+    YAEvent *response = handle_key_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     
     // 测试MOUSE_CLICK事件参数长度错误
     event.header.type = MOUSE_CLICK;
     event.param_len = sizeof(YACommonEventRequest) + 1; // 长度不对
     
-    response = handle_mouse_click(test_bev, &event);
+    response = handle_mouse_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -1036,7 +1036,7 @@ void test_handle_authorize_response_param_null(void) {
     // 这个测试很难触发response->param为NULL的情况，
     // 因为assign_response要么成功要么完全失败
     // 但我们可以测试相关的代码路径
-    YAEvent *response = handle_authorize(test_bev, &event);
+    YAEvent *response = handle_authorize(test_bev, &event, NULL);
     TEST_ASSERT_NOT_NULL(response);
     
     ya_free_event(response);
@@ -1055,7 +1055,7 @@ void test_handle_authorize_authorization_failed(void) {
     event.param = &auth_req;
     event.param_len = sizeof(auth_req);
     
-    YAEvent *response = handle_authorize(test_bev, &event);
+    YAEvent *response = handle_authorize(test_bev, &event, NULL);
     TEST_ASSERT_NOT_NULL(response);
     
     YAAuthorizeEventResponse *auth_resp = (YAAuthorizeEventResponse *)response->param;
@@ -1075,7 +1075,7 @@ void test_handle_habernate_assign_response_failure(void) {
     
     // 通过某种方式模拟assign_response失败比较困难
     // 但我们可以至少运行这个代码路径
-    YAEvent *response = handle_habernate(test_bev, &event);
+    YAEvent *response = handle_habernate(test_bev, &event, NULL);
     TEST_ASSERT_NOT_NULL(response);
     
     ya_free_event(response);
@@ -1092,12 +1092,12 @@ void test_handle_mouse_scroll_param_size_error(void) {
     
     // 测试参数长度过小
     event.param_len = sizeof(YACommonEventRequest) - 1;
-    YAEvent *response = handle_mouse_scroll(test_bev, &event);
+    YAEvent *response = handle_mouse_scroll(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     
     // 测试参数长度过大
     event.param_len = sizeof(YACommonEventRequest) + 10;
-    response = handle_mouse_scroll(test_bev, &event);
+    response = handle_mouse_scroll(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
@@ -1117,7 +1117,7 @@ void test_handle_key_click_different_errors(void) {
     
     // 模拟其他类型的错误
     key_action_other_error_next = true;
-    YAEvent *response = handle_key_click(test_bev, &event);
+    YAEvent *response = handle_key_click(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     key_action_other_error_next = false;
 }
@@ -1162,7 +1162,7 @@ void test_platform_specific_modifier_keys(void) {
     
     // 这个测试主要是为了覆盖#ifdef __APPLE__ 的不同分支
     // 在Mac上会使用Meta键，在其他平台使用Control键
-    YAEvent *response = handle_input_text(test_bev, &event);
+    YAEvent *response = handle_input_text(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response); // 文本输入函数通常返回NULL
     
     // 测试TEXT_GET事件
@@ -1172,7 +1172,7 @@ void test_platform_specific_modifier_keys(void) {
     event.param = NULL;
     event.param_len = 0;
     
-    response = handle_input_get(test_bev, &event);
+    response = handle_input_get(test_bev, &event, NULL);
     if (response != NULL) {
         ya_free_event(response);
     }
@@ -1205,13 +1205,13 @@ void test_handle_mouse_scroll_additional_errors(void) {
     event.param_len = sizeof(scroll_req);
     
     // 测试负数滚动量（应该被允许）
-    YAEvent *response = handle_mouse_scroll(test_bev, &event);
+    YAEvent *response = handle_mouse_scroll(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
     
     // 测试很大的滚动量
     scroll_req.lparam = INT_MAX;
     scroll_req.rparam = 1;
-    response = handle_mouse_scroll(test_bev, &event);
+    response = handle_mouse_scroll(test_bev, &event, NULL);
     TEST_ASSERT_NULL(response);
 }
 
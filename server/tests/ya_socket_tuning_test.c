@@ -0,0 +1,108 @@
+#include <unity.h>
+#include <string.h>
+#include <event2/util.h>
+#include "../src/ya_config.h"
+#include "../src/ya_socket_tuning.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+YA_Config config;  // ya_socket_tuning_init 读取 [network] 配置
+
+void setUp(void) {
+    ya_config_init(&config);
+}
+
+void tearDown(void) {
+    ya_config_free(&config);
+}
+
+static int get_int_option(evutil_socket_t fd, int level, int name) {
+    int value = 0;
+    socklen_t len = sizeof(value);
+    getsockopt(fd, level, name, (void *)&value, &len);
+    return value;
+}
+
+// 测试默认配置
+void test_tuning_defaults(void) {
+    ya_socket_tuning_init();
+    const ya_socket_tuning_t *tuning = ya_socket_tuning();
+    TEST_ASSERT_TRUE(tuning->tcp_nodelay);
+    TEST_ASSERT_TRUE(tuning->tcp_quickack);
+    TEST_ASSERT_EQUAL(-1, tuning->dscp);
+    TEST_ASSERT_EQUAL(-1, tuning->priority);
+    TEST_ASSERT_EQUAL(0, tuning->sndbuf);
+    TEST_ASSERT_EQUAL(0, tuning->rcvbuf);
+}
+
+// 测试配置解析
+void test_tuning_from_config(void) {
+    ya_config_set(&config, "network", "tcp_nodelay", "false");
+    ya_config_set(&config, "network", "tcp_quickack", "false");
+    ya_config_set(&config, "network", "dscp", "ef");
+    ya_config_set(&config, "network", "priority", "6");
+    ya_config_set(&config, "network", "sndbuf", "65536");
+    ya_config_set(&config, "network", "rcvbuf", "not-a-number");
+    ya_socket_tuning_init();
+
+    const ya_socket_tuning_t *tuning = ya_socket_tuning();
+    TEST_ASSERT_FALSE(tuning->tcp_nodelay);
+    TEST_ASSERT_FALSE(tuning->tcp_quickack);
+    TEST_ASSERT_EQUAL(YA_DSCP_EF, tuning->dscp);
+    TEST_ASSERT_EQUAL(6, tuning->priority);
+    TEST_ASSERT_EQUAL(65536, tuning->sndbuf);
+    TEST_ASSERT_EQUAL(0, tuning->rcvbuf);
+
+    ya_config_set(&config, "network", "dscp", "64");
+    ya_socket_tuning_init();
+    TEST_ASSERT_EQUAL(-1, ya_socket_tuning()->dscp);
+}
+
+// 测试选项确实设置到套接字上
+void test_tuning_apply(void) {
+    evutil_socket_t fd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    ya_socket_tuning_t tuning = {
+        .tcp_nodelay = true,
+        .tcp_quickack = false,
+        .dscp = YA_DSCP_EF,
+        .priority = -1,
+        .sndbuf = 32768,
+        .rcvbuf = 0,
+    };
+    TEST_ASSERT_EQUAL(0, ya_socket_tuning_apply(fd, &tuning));
+    TEST_ASSERT_NOT_EQUAL(0, get_int_option(fd, IPPROTO_TCP, TCP_NODELAY));
+    TEST_ASSERT_EQUAL(YA_DSCP_EF << 2, get_int_option(fd, IPPROTO_IP, IP_TOS) & 0xFC);
+    TEST_ASSERT_TRUE(get_int_option(fd, SOL_SOCKET, SO_SNDBUF) >= 32768);
+
+    evutil_closesocket(fd);
+}
+
+// 测试空参数
+void test_tuning_invalid_params(void) {
+    ya_socket_tuning_t tuning = {.tcp_nodelay = true, .dscp = -1, .priority = -1};
+    TEST_ASSERT_EQUAL(-1, ya_socket_tuning_apply(-1, &tuning));
+    TEST_ASSERT_EQUAL(-1, ya_socket_tuning_apply(0, NULL));
+    ya_socket_tuning_rearm_quickack(-1, NULL);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_tuning_defaults);
+    RUN_TEST(test_tuning_from_config);
+    RUN_TEST(test_tuning_apply);
+    RUN_TEST(test_tuning_invalid_params);
+
+    return UNITY_END();
+}
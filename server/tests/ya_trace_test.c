@@ -0,0 +1,122 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/ya_config.h"
+#include "../src/ya_trace.h"
+
+#define TEST_TRACE_FILE "test_trace.bin"
+
+YA_Config config;  // ya_trace_init 读取 [trace] 配置
+
+void setUp(void) {
+    ya_config_init(&config);
+    unlink(TEST_TRACE_FILE);
+}
+
+void tearDown(void) {
+    ya_trace_close();
+    ya_config_free(&config);
+    unlink(TEST_TRACE_FILE);
+}
+
+// 读取整个跟踪文件（关闭映射后内容仍在文件里）
+static size_t read_trace(ya_trace_header_t *header, ya_trace_record_t *records, size_t max_records) {
+    FILE *fp = fopen(TEST_TRACE_FILE, "rb");
+    TEST_ASSERT_NOT_NULL(fp);
+    TEST_ASSERT_EQUAL(1, fread(header, sizeof(*header), 1, fp));
+    size_t n = fread(records, sizeof(*records), max_records, fp);
+    fclose(fp);
+    return n;
+}
+
+// 测试未启用时不写入
+void test_trace_disabled(void) {
+    TEST_ASSERT_FALSE(ya_trace_enabled());
+    YA_TRACE(.stage = YA_TRACE_DISPATCH, .uid = 1);
+
+    ya_trace_init();
+    TEST_ASSERT_FALSE(ya_trace_enabled());
+    TEST_ASSERT_EQUAL(-1, access(TEST_TRACE_FILE, F_OK));
+}
+
+// 测试文件头与记录内容
+void test_trace_records(void) {
+    TEST_ASSERT_EQUAL(0, ya_trace_open(TEST_TRACE_FILE, 5));
+    TEST_ASSERT_TRUE(ya_trace_enabled());
+    TEST_ASSERT_EQUAL(-1, ya_trace_open(TEST_TRACE_FILE, 5));
+
+    YA_TRACE(.type = 0x1, .stage = YA_TRACE_MOVE, .flags = 3, .uid = 42, .index = 7, .raw_dx = 150, .raw_dy = -250,
+             .float_dx = 1.5f, .float_dy = -2.5f, .out_dx = 1, .out_dy = -2);
+    YA_TRACE(.type = 0x2, .stage = YA_TRACE_DROP, .uid = 42, .index = 6, .result = YA_TRACE_DROP_STALE);
+    ya_trace_close();
+    TEST_ASSERT_FALSE(ya_trace_enabled());
+
+    ya_trace_header_t header;
+    ya_trace_record_t records[8];
+    TEST_ASSERT_EQUAL(8, read_trace(&header, records, 8));
+    TEST_ASSERT_EQUAL_MEMORY(YA_TRACE_MAGIC, header.magic, 8);
+    TEST_ASSERT_EQUAL_UINT32(YA_TRACE_VERSION, header.version);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(ya_trace_record_t), header.record_size);
+    TEST_ASSERT_EQUAL_UINT32(8, header.capacity);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)getpid(), header.pid);
+    TEST_ASSERT_EQUAL_UINT64(2, atomic_load(&header.head));
+
+    TEST_ASSERT_EQUAL_UINT64(1, atomic_load(&records[0].seq));
+    TEST_ASSERT_TRUE(records[0].ts_ns >= header.start_mono_ns);
+    TEST_ASSERT_EQUAL_UINT16(0x1, records[0].event.type);
+    TEST_ASSERT_EQUAL_UINT8(YA_TRACE_MOVE, records[0].event.stage);
+    TEST_ASSERT_EQUAL_UINT8(3, records[0].event.flags);
+    TEST_ASSERT_EQUAL_UINT32(42, records[0].event.uid);
+    TEST_ASSERT_EQUAL_UINT32(7, records[0].event.index);
+    TEST_ASSERT_EQUAL_INT32(150, records[0].event.raw_dx);
+    TEST_ASSERT_EQUAL_INT32(-250, records[0].event.raw_dy);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, records[0].event.float_dx);
+    TEST_ASSERT_EQUAL_FLOAT(-2.5f, records[0].event.float_dy);
+    TEST_ASSERT_EQUAL_INT32(1, records[0].event.out_dx);
+    TEST_ASSERT_EQUAL_INT32(-2, records[0].event.out_dy);
+
+    TEST_ASSERT_EQUAL_UINT64(2, atomic_load(&records[1].seq));
+    TEST_ASSERT_TRUE(records[1].ts_ns >= records[0].ts_ns);
+    TEST_ASSERT_EQUAL_UINT8(YA_TRACE_DROP, records[1].event.stage);
+    TEST_ASSERT_EQUAL_INT32(YA_TRACE_DROP_STALE, records[1].event.result);
+
+    TEST_ASSERT_EQUAL_UINT64(0, atomic_load(&records[2].seq));
+}
+
+// 测试写满后覆盖最旧的记录
+void test_trace_wraps(void) {
+    ya_config_set(&config, "trace", "file", TEST_TRACE_FILE);
+    ya_config_set(&config, "trace", "capacity", "4");
+    ya_trace_init();
+    TEST_ASSERT_TRUE(ya_trace_enabled());
+
+    for (uint32_t i = 0; i < 10; i++) {
+        YA_TRACE(.stage = YA_TRACE_INJECT, .index = i);
+    }
+    ya_trace_close();
+
+    ya_trace_header_t header;
+    ya_trace_record_t records[4];
+    TEST_ASSERT_EQUAL(4, read_trace(&header, records, 4));
+    TEST_ASSERT_EQUAL_UINT32(4, header.capacity);
+    TEST_ASSERT_EQUAL_UINT64(10, atomic_load(&header.head));
+
+    // 第 n 条记录在槽位 n % 4，只保留最后 4 条（6..9）
+    for (uint32_t slot = 0; slot < 4; slot++) {
+        uint64_t seq = atomic_load(&records[slot].seq);
+        TEST_ASSERT_EQUAL_UINT64(slot, (seq - 1) % 4);
+        TEST_ASSERT_TRUE(seq >= 7);
+        TEST_ASSERT_EQUAL_UINT32((uint32_t)(seq - 1), records[slot].event.index);
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_trace_disabled);
+    RUN_TEST(test_trace_records);
+    RUN_TEST(test_trace_wraps);
+
+    return UNITY_END();
+}
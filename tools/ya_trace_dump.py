@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+服务端输入事件二进制跟踪文件解析工具
+
+服务端在 server.conf 中配置 [trace] file=... 后，把每个事件的分发、丢弃、
+指针换算和注入结果写入 mmap 的环形文件（格式见 server/src/ya_trace.h）。
+本工具离线读取该文件，可在服务运行中或崩溃后使用。
+
+使用：
+  python3 tools/ya_trace_dump.py /tmp/mousehero.trace            # 文本
+  python3 tools/ya_trace_dump.py /tmp/mousehero.trace --csv > t.csv
+  python3 tools/ya_trace_dump.py /tmp/mousehero.trace --chrome > t.json
+    （在 chrome://tracing 或 https://ui.perfetto.dev 中打开）
+
+可选：
+  --uid N     只输出指定客户端的记录（注入记录没有 uid，始终保留）
+  --last N    只输出最后 N 条
+"""
+
+import argparse
+import csv
+import json
+import struct
+import sys
+
+MAGIC = b"YATRACE1"
+VERSION = 1
+
+# 与 ya_trace_header_t / ya_trace_record_t 保持一致（小端）
+HEADER = struct.Struct("<8sIIIIQQQ16x")
+RECORD = struct.Struct("<QQHBBIIiiffiii8x")
+
+STAGES = {0: "dispatch", 1: "drop", 2: "move", 3: "inject"}
+
+# YAEventType（server/src/ya_event.h YA_EVENT_TYPE_TABLE）
+EVENT_TYPES = {
+    0x1: "MOUSE_MOVE",
+    0x2: "MOUSE_CLICK",
+    0x3: "MOUSE_WHEEL",
+    0x4: "KEYBOARD",
+    0x5: "TEXT_INPUT",
+    0x6: "TEXT_GET",
+    0x7: "DISCOVER",
+    0x8: "MOUSE_STOP",
+    0x9: "CONTROL",
+    0xA: "AUTHORIZE",
+    0xB: "HEARTBEAT",
+    0xC: "SESSION_OPTION",
+    0xD: "MOUSE_MOVE_BATCH",
+    0xE: "MOUSE_SMOOTH_SCROLL",
+}
+
+# ya_input_action_type_t（server/src/ya_input_queue.h），注入阶段的 type
+ACTION_TYPES = {
+    0: "MOVE",
+    1: "BUTTON",
+    2: "SCROLL",
+    3: "KEY_CHAR",
+    4: "KEY_FUNCTION",
+    5: "TEXT",
+    6: "KEY_RELEASE",
+    7: "SMOOTH_SCROLL",
+}
+
+# ya_trace_drop_t
+DROP_REASONS = {1: "transport", 2: "stale_index", 3: "no_client"}
+
+FIELDS = [
+    "seq", "ts_ns", "wall_ns", "stage", "type", "uid", "index", "flags",
+    "raw_dx", "raw_dy", "float_dx", "float_dy", "out_dx", "out_dy", "result",
+]
+
+
+def type_name(stage, value):
+    names = ACTION_TYPES if stage == "inject" else EVENT_TYPES
+    return names.get(value, str(value))
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if len(data) < HEADER.size:
+        raise ValueError("file too small for a trace header")
+    magic, version, record_size, capacity, pid, start_mono, start_real, head = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("not a trace file (bad magic %r)" % magic)
+    if version != VERSION or record_size != RECORD.size:
+        raise ValueError("unsupported trace version %d (record size %d)" % (version, record_size))
+    if len(data) < HEADER.size + capacity * record_size:
+        raise ValueError("trace file truncated")
+
+    header = {"pid": pid, "capacity": capacity, "head": head,
+              "start_mono_ns": start_mono, "start_real_ns": start_real}
+
+    records = []
+    for n in range(max(0, head - capacity), head):
+        offset = HEADER.size + (n % capacity) * record_size
+        (seq, ts, etype, stage, flags, uid, index, raw_dx, raw_dy,
+         float_dx, float_dy, out_dx, out_dy, result) = RECORD.unpack_from(data, offset)
+        # 正在写入或已被更新的记录覆盖
+        if seq != n + 1:
+            continue
+        stage_name = STAGES.get(stage, str(stage))
+        records.append({
+            "seq": n,
+            "ts_ns": ts,
+            "wall_ns": start_real + (ts - start_mono),
+            "stage": stage_name,
+            "type": type_name(stage_name, etype),
+            "uid": uid,
+            "index": index,
+            "flags": flags,
+            "raw_dx": raw_dx,
+            "raw_dy": raw_dy,
+            "float_dx": round(float_dx, 4),
+            "float_dy": round(float_dy, 4),
+            "out_dx": out_dx,
+            "out_dy": out_dy,
+            "result": DROP_REASONS.get(result, result) if stage_name == "drop" else result,
+        })
+    return header, records
+
+
+def dump_text(header, records, out):
+    out.write("# pid=%d capacity=%d written=%d kept=%d\n"
+              % (header["pid"], header["capacity"], header["head"], len(records)))
+    base = records[0]["ts_ns"] if records else 0
+    for r in records:
+        out.write("%12.3fus %-8s %-20s uid=%-6d idx=%-8d raw=(%d,%d) float=(%.3f,%.3f) out=(%d,%d) result=%s\n"
+                  % ((r["ts_ns"] - base) / 1000.0, r["stage"], r["type"], r["uid"], r["index"],
+                     r["raw_dx"], r["raw_dy"], r["float_dx"], r["float_dy"], r["out_dx"], r["out_dy"],
+                     r["result"]))
+
+
+def dump_csv(records, out):
+    writer = csv.DictWriter(out, fieldnames=FIELDS)
+    writer.writeheader()
+    for r in records:
+        writer.writerow(r)
+
+
+def dump_chrome(header, records, out):
+    # 每个客户端一条线程轨道，注入线程单独一条（tid 0）
+    events = [{"name": "thread_name", "ph": "M", "pid": header["pid"], "tid": 0,
+               "args": {"name": "injector"}}]
+    for uid in sorted({r["uid"] for r in records if r["stage"] != "inject"}):
+        events.append({"name": "thread_name", "ph": "M", "pid": header["pid"], "tid": uid + 1,
+                       "args": {"name": "client %d" % uid}})
+
+    for r in records:
+        args = {k: r[k] for k in ("index", "raw_dx", "raw_dy", "float_dx", "float_dy",
+                                  "out_dx", "out_dy", "result", "flags")}
+        events.append({
+            "name": "%s %s" % (r["type"], r["stage"]),
+            "cat": r["stage"],
+            "ph": "i",
+            "s": "t",
+            "ts": r["ts_ns"] / 1000.0,
+            "pid": header["pid"],
+            "tid": 0 if r["stage"] == "inject" else r["uid"] + 1,
+            "args": args,
+        })
+    json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, out)
+    out.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Dump a MouseHero server binary input trace")
+    parser.add_argument("file", help="trace file ([trace] file in server.conf)")
+    fmt = parser.add_mutually_exclusive_group()
+    fmt.add_argument("--csv", action="store_true", help="write CSV")
+    fmt.add_argument("--chrome", action="store_true", help="write Chrome trace event JSON")
+    parser.add_argument("--uid", type=int, help="only records of this client uid (inject records are kept)")
+    parser.add_argument("--last", type=int, help="only the last N records")
+    args = parser.parse_args()
+
+    try:
+        header, records = load(args.file)
+    except (OSError, ValueError) as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 1
+
+    if args.uid is not None:
+        records = [r for r in records if r["uid"] == args.uid or r["stage"] == "inject"]
+    if args.last:
+        records = records[-args.last:]
+
+    if args.csv:
+        dump_csv(records, sys.stdout)
+    elif args.chrome:
+        dump_chrome(header, records, sys.stdout)
+    else:
+        dump_text(header, records, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())